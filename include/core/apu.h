@@ -0,0 +1,151 @@
+// include/core/apu.h
+#ifndef APU_H
+#define APU_H
+
+#include <core/utils.h>
+
+struct GameBoy;
+
+// ---------------------------------------------
+// Audio Processing Unit
+// https://gbdev.io/pandocs/Audio.html
+// ---------------------------------------------
+// Four channels (2 pulse, wave, noise) behind 0xFF10 - 0xFF26 & wave RAM at
+// 0xFF30 - 0xFF3F. Like the PPU it is never ticked: apu_sync() catches it up
+// on register access & at the end of every gb_run_frame() (see apu.c).
+#define APU_REG_FIRST 0xFF10
+#define APU_REG_COUNT 0x30 // 0xFF10 - 0xFF3F, wave RAM included
+#define APU_WAVE_FIRST 0xFF30
+
+#define NR52_POWER BIT(7) // Audio on; bits 0 - 3 are the channel status (read only)
+
+#define APU_FRAME_SEQ_CYCLES 8192 // Frame sequencer: 512 Hz, DIV bit 12 falling edges
+
+// Output
+#define APU_SAMPLE_RATE 48000      // Default output rate
+#define APU_MAX_SAMPLE_RATE 96000
+#define APU_BLIP_SIZE 2048         // Samples per side a blip buffer holds
+#define APU_BLIP_PHASE_BITS 5
+#define APU_BLIP_PHASES (1 << APU_BLIP_PHASE_BITS) // Sub-sample step positions
+#define APU_BLIP_TAPS 16           // Band-limited step kernel width (samples)
+
+// What the APU computes (apu_set_mode)
+typedef enum {
+    APU_MODE_FULL,      // Everything, samples included
+    APU_MODE_REGISTERS, // Only what the CPU can read: no waveforms, mixing or samples
+} ApuMode;
+
+typedef struct {
+    bool enabled;   // NR52 status bit
+    bool dac;       // DAC powered (NRx2 bits 3 - 7, NR30 bit 7)
+    u16  length;    // Length timer: steps left before the channel stops
+    u8   volume;    // Envelope volume 0 - 15 (pulse & noise)
+    u8   env_timer; // Envelope pace countdown
+    u16  period;    // 11-bit period (sweep rewrites channel 1's)
+    u8   pos;       // Duty step (pulse) / sample index (wave)
+    u16  lfsr;      // Noise shift register
+    u8   out;       // Digital output 0 - 15 the mix has
+    u64  next;      // Cycle of the next waveform step
+} ApuChannel;
+
+// ---------------------------------------------
+// Audio Ring
+// ---------------------------------------------
+// Single producer (the emulation thread, once per frame) & single consumer
+// (the audio callback). Neither side locks or allocates: each owns its own
+// index & publishes it with a release store. Frames are interleaved stereo
+// i16 (left, right). Indexes count frames ever written / read & wrap freely.
+typedef struct {
+    i16 *data;
+    u32  capacity; // Frames, a power of two
+
+    // Separate cache lines: each side writes only its own
+    u8   pad[64];
+    u32  head;    // Frames written (producer)
+    u64  dropped; // Frames the producer found no room for
+    u8   head_pad[48];
+    u32  tail;    // Frames read (consumer)
+    u64  silence; // Frames the consumer padded with silence
+    u8   tail_pad[48];
+} AudioRing;
+
+// Allocate room for at least `frames` stereo frames (false: out of memory)
+bool audio_ring_init(AudioRing *ring, u32 frames);
+void audio_ring_free(AudioRing *ring);
+
+// Producer: append up to `frames` frames, returns how many fit
+u32  audio_ring_write(AudioRing *ring, const i16 *samples, u32 frames);
+
+// Consumer: fill `frames` frames, padding with silence past what is there.
+// Returns the frames that came from the ring.
+u32  audio_ring_read(AudioRing *ring, i16 *out, u32 frames);
+
+// Frames waiting to be read (either side)
+u32  audio_ring_available(AudioRing *ring);
+
+// ---------------------------------------------
+// APU State
+// ---------------------------------------------
+typedef struct {
+    u8         regs[APU_REG_COUNT]; // As written, read back through a mask
+    ApuChannel ch[4];
+
+    // Channel 1 frequency sweep
+    u8         sweep_timer;
+    bool       sweep_on;
+    bool       sweep_negated; // A subtraction happened since the trigger
+    u16        sweep_shadow;
+
+    // Lazy timing
+    u64        synced;  // gb->cycles the channels were last brought up to date at
+    u64        fs_next; // Cycle of the next frame sequencer step
+    u8         fs_step; // Step it runs (0 - 7)
+
+    // Band-limited synthesis: amplitude steps are added at their cycle into
+    // blip[] & turned into samples at the end of each frame
+    ApuMode    mode;
+    u32        sample_rate;
+    u64        blip_step;  // Samples per cycle, 32.32 fixed point
+    u64        blip_start; // Cycle of blip[.][0]
+    u32        blip_frac;  // Sub-sample position of blip_start
+    float      blip[2][APU_BLIP_SIZE + APU_BLIP_TAPS];
+    float      blip_sum[2]; // Integrator (current amplitude)
+    float      blip_cap[2]; // High-pass filter (output capacitor) charge
+    float      blip_charge; // Capacitor factor per sample
+
+    AudioRing *ring;    // Where finished samples go (NULL: dropped)
+    u64        samples; // Stereo frames produced since reset
+} Apu;
+
+// ---------------------------------------------
+// APU Functions
+// ---------------------------------------------
+
+// Set the DMG post-boot-ROM state (after timer_reset(): steps follow DIV).
+// The output settings are kept.
+void apu_reset(struct GameBoy *gb);
+
+// Send samples at `sample_rate` Hz to `ring` (NULL: drop them)
+void apu_set_output(struct GameBoy *gb, u32 sample_rate, AudioRing *ring);
+
+// Switch between full synthesis & register-only emulation (e.g. headless
+// runs nobody listens to). Kept across resets, like the output settings.
+void apu_set_mode(struct GameBoy *gb, ApuMode mode);
+
+// Run the channels up to gb->cycles
+void apu_sync(struct GameBoy *gb);
+
+// Sync & turn everything synthesized so far into samples
+void apu_end_frame(struct GameBoy *gb);
+
+// DIV was reset: a set bit 12 falling clocks the frame sequencer
+void apu_div_reset(struct GameBoy *gb);
+
+// Restart the output after the channel state was replaced (save states)
+void apu_restart_output(struct GameBoy *gb);
+
+// Register access (0xFF10 - 0xFF3F)
+u8   apu_read(struct GameBoy *gb, u16 addr);
+void apu_write(struct GameBoy *gb, u16 addr, u8 value);
+
+#endif // APU_H
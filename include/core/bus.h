@@ -4,11 +4,121 @@
 #include <core/utils.h>
 #include <gbemu.h>
 
+// ---------------------------------------------
+// Page Table
+// ---------------------------------------------
+// The 64 KB address space is split into 256 pages of 256 bytes. Pages backed
+// by plain memory (ROM, VRAM, WRAM, cart RAM) hold a direct host pointer in
+// gb->read_map / gb->write_map. Everything else is NULL and falls back to the
+// slow path, which routes the access to the owning component.
+#define MMU_PAGE_SHIFT 8
+#define MMU_PAGE_SIZE 0x100
+#define MMU_PAGE_COUNT 0x100
+
+// Build the whole page table from the current cartridge & memory state
+void mmu_map_init(GameBoy *gb);
+
+// Point page_count pages starting at first_page at host memory.
+// A NULL base sends that direction of access to the slow path.
+void mmu_map_pages(GameBoy *gb, u8 first_page, u16 page_count, u8 *read_base, u8 *write_base);
+
+// Map a 16 KB ROM window (0x0000 or 0x4000) to the bank starting at rom_offset
+void mmu_map_rom_bank(GameBoy *gb, u16 window, size_t rom_offset);
+
+// ---------------------------------------------
+// Page Watches
+// ---------------------------------------------
+// A watched page keeps its host memory in gb->write_base but takes writes
+// through the slow path, which notifies the owner of the watch once and then
+// puts the direct pointer back. Every page aliasing the same host memory
+// (e.g. WRAM & echo RAM) is watched together. MMU_WATCH_VRAM is permanent:
+// VRAM writes always reach the PPU.
+#define MMU_WATCH_CODE BIT(0)   // Page holds translated code (JIT)
+#define MMU_WATCH_DECODE BIT(1) // Page holds decode cache records
+#define MMU_WATCH_VRAM BIT(2)   // VRAM: the PPU catches up before each write
+#define MMU_WATCH_SAVE BIT(3)   // Battery RAM page clean since the last save flush
+#define MMU_WATCH_ONCE (MMU_WATCH_CODE | MMU_WATCH_DECODE | MMU_WATCH_SAVE)
+
+void mmu_watch_page(GameBoy *gb, u8 page, u8 flags);
+
+// The pages are about to show other host memory (RAM bank switch): drop their
+// one-shot watches & the decoded/translated code those watches protect
+void mmu_unwatch_pages(GameBoy *gb, u8 first_page, u16 page_count);
+
+// Watch every mapped cartridge RAM page that isn't dirty (battery saves only),
+// so the first write to it marks it for the next flush
+void mmu_watch_save(GameBoy *gb);
+
+// The 256 bytes at `host` (a page's write_base) were changed without going
+// through mmu_write (e.g. a state load): fire the watches on it
+void mmu_host_written(GameBoy *gb, const u8 *host);
+
+// ---------------------------------------------
+// Slow path (everything that is not a plain memory page)
+// ---------------------------------------------
+u8   mmu_read_slow(GameBoy *gb, u16 addr);
+void mmu_write_slow(GameBoy *gb, u16 addr, u8 value);
+
 // ---------------------------------------------
 // Memory read/write
 // ---------------------------------------------
-u8   mmu_read(GameBoy *gb, u16 addr);
-void mmu_write(GameBoy *gb, u16 addr, u8 value);
+// These are the hottest functions in the emulator, so they live here and get
+// inlined into every caller: one table lookup, then either a plain load/store
+// or a call into the slow path.
+
+// Read one byte from memory
+static inline u8 mmu_read(GameBoy *gb, u16 addr) {
+    PROFILE_READ(gb, addr);
+    const u8 *page = gb->read_map[addr >> MMU_PAGE_SHIFT];
+    if (page)
+        return page[addr & 0xFF];
+    return mmu_read_slow(gb, addr);
+}
+
+// Write one byte to memory
+static inline void mmu_write(GameBoy *gb, u16 addr, u8 value) {
+    PROFILE_WRITE(gb, addr);
+    u8 *page = gb->write_map[addr >> MMU_PAGE_SHIFT];
+    if (page) {
+        page[addr & 0xFF] = value;
+        return;
+    }
+    mmu_write_slow(gb, addr, value);
+}
+
+// Read a little-endian 16-bit value
+static inline u16 mmu_read16(GameBoy *gb, u16 addr) {
+    const u8 *page = gb->read_map[addr >> MMU_PAGE_SHIFT];
+    u8        off  = addr & 0xFF;
+
+    // Both bytes on the same mapped page: no second lookup needed
+    if (page && off != 0xFF) {
+        PROFILE_READ(gb, addr);
+        PROFILE_READ(gb, (u16)(addr + 1));
+        return MAKE_U16(page[off + 1], page[off]);
+    }
+
+    u8 lo = mmu_read(gb, addr);
+    u8 hi = mmu_read(gb, (u16)(addr + 1));
+    return MAKE_U16(hi, lo);
+}
+
+// Write a little-endian 16-bit value
+static inline void mmu_write16(GameBoy *gb, u16 addr, u16 value) {
+    u8 *page = gb->write_map[addr >> MMU_PAGE_SHIFT];
+    u8  off  = addr & 0xFF;
+
+    if (page && off != 0xFF) {
+        PROFILE_WRITE(gb, addr);
+        PROFILE_WRITE(gb, (u16)(addr + 1));
+        page[off]     = GET_LOW_BYTE(value);
+        page[off + 1] = GET_HIGH_BYTE(value);
+        return;
+    }
+
+    mmu_write(gb, addr, GET_LOW_BYTE(value));
+    mmu_write(gb, (u16)(addr + 1), GET_HIGH_BYTE(value));
+}
 
 // ---------------------------------------------
 // Debug Helpers
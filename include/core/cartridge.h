@@ -2,6 +2,7 @@
 #ifndef CARTRIDGE_H
 #define CARTRIDGE_H
 
+#include <core/mbc.h>
 #include <core/utils.h>
 #include <stddef.h>
 
@@ -39,30 +40,77 @@ typedef struct {
     u8   version;       // ROM version number
     bool sgb_supported; // Super Game Boy support (sgb_flag == 0x03)
     bool cgb_supported; // Game Boy Color support (0x80 = enhanced, 0xC0 = only)
+    bool has_battery;   // Battery-backed RAM: kept in a save file (savefile.c)
 } CartHeader;
 
+// ---------------------------------------------
+// ROM Image (romstore.c)
+// ---------------------------------------------
+// One per distinct ROM in the process, shared read-only by every cartridge
+// running it. Fields below `refs` are the store's (under its lock).
+typedef struct RomImage {
+    u8              *data;             // Read-only: a file mapping or one heap copy
+    size_t           size;
+    bool             mapped;           // data is mapped from the file
+    u32              crc32;            // CRC-32 & SHA-1 of data: the image's name
+    u8               sha1[SHA1_SIZE];
+
+    u32              refs;
+    bool             from_file;        // Regular file it was opened from, to find it
+    u64              file_dev;         // again without reading it
+    u64              file_ino;
+    i64              file_mtime_ns;
+    struct RomImage *next;
+} RomImage;
+
+typedef struct {
+    u32    images; // Distinct ROMs held
+    u32    refs;   // References to them
+    size_t bytes;  // ROM bytes held (mapped or copied)
+} RomStoreStats;
+
 // ---------------------------------------------
 // Cartridge
 // ---------------------------------------------
+// Battery RAM writes are tracked in pages of this size (the bus's page size)
+#define CART_RAM_PAGE_SIZE 0x100
+#define CART_RAM_DIRTY_WORDS ((128 * 1024 / CART_RAM_PAGE_SIZE) / 64)
+
 typedef struct {
-    u8          *rom;        // ROM data
+    u8          *rom;        // ROM data, never written (image->data if image is set)
     size_t       rom_size;   // ROM size in bytes
+    RomImage    *image;      // Referenced store image (NULL: rom is a heap block owned by
+                             // the cartridge & freed by cart_unload)
+    u64          rom_hash;   // First 8 bytes of the SHA-1 (save states refer to the ROM by it)
     u8          *ram;        // External RAM (for save data)
     size_t       ram_size;   // RAM size in bytes
     RawRomHeader raw_header; // Raw header as read from ROM
     CartHeader   header;     // Parsed header with usable values
-    // MBC-specific state (later)
-    // Battery flag (later)
+    Mbc          mbc;        // Bank controller picked from the header (mbc.c)
+
+    // Battery save (savefile.c)
+    char        *save_path;    // Save file behind ram (NULL: none, ram is plain heap)
+    bool         ram_mapped;   // ram is a shared mapping of save_path
+    u64          ram_dirty[CART_RAM_DIRTY_WORDS]; // Pages of ram written since the last flush
+    u32          save_flushes; // Flushes that wrote anything
 } Cartridge;
 
 // ---------------------------------------------
 // Cartridge Functions
 // ---------------------------------------------
 
-// Load ROM from disk & parse header
+// Load ROM from disk & parse header. The ROM comes from the store: loading
+// a file or content it already holds costs a lookup.
 int         cart_load(Cartridge *cart, const char *path);
 
-// Unlod the cart: Free the allocated memory for RAM & ROM
+// Same from a ROM image in memory (copied once per distinct content,
+// nothing printed; same return codes)
+int         cart_load_buffer(Cartridge *cart, const u8 *data, size_t size);
+
+// Same on top of a store image (takes a reference of its own)
+int         cart_load_image(Cartridge *cart, RomImage *image);
+
+// Unload the cart: Release the ROM, flush the save file, free the RAM
 void        cart_unload(Cartridge *cart);
 
 // Parse raw header into usable format
@@ -86,4 +134,47 @@ const char *get_publisher_name(u16 lic_code, bool is_old_code);
 // Get header checksum
 bool        cart_verify_header_checksum(const Cartridge *cart);
 
+// ---------------------------------------------
+// Battery Save Functions (savefile.c)
+// ---------------------------------------------
+// cart_load() attaches <rom>.sav to battery carts by itself. Writes only
+// mark pages dirty; cart_save_flush() gets them to the disk in one batch.
+
+// Cartridge type has battery-backed RAM
+bool        cart_has_battery(u8 cart_type);
+
+// Save file for a ROM path: the extension replaced by .sav (malloc'd)
+char       *cart_save_path(const char *rom_path);
+
+// Back the cartridge RAM with a save file, created if missing. The file's
+// contents replace the RAM. Returns cart_load codes (1: can't open, 4: RAM).
+int         cart_attach_save(Cartridge *cart, const char *path);
+
+// Flush & let go of the save file (ram is NULL afterwards if it was mapped)
+void        cart_detach_save(Cartridge *cart);
+
+// ram[offset, offset + size) was written
+void        cart_ram_mark_dirty(Cartridge *cart, size_t offset, size_t size);
+bool        cart_ram_is_dirty(const Cartridge *cart, size_t offset);
+
+// Write the dirty pages to the save file (one msync). Returns the pages written.
+u32         cart_save_flush(Cartridge *cart);
+
+// ---------------------------------------------
+// ROM Store Functions (romstore.c)
+// ---------------------------------------------
+// Process-wide & thread-safe. Each returns a counted reference; give every
+// one back with rom_store_release(). The last release unmaps or frees.
+
+// Image of a ROM file: regular files are mapped, others read into the heap.
+// A file seen before isn't read or hashed again. Returns cart_load codes.
+int         rom_store_open(const char *path, RomImage **out);
+
+// Image holding this content, copied in if it is new. Returns cart_load codes.
+int         rom_store_add(const u8 *data, size_t size, RomImage **out);
+
+RomImage   *rom_store_ref(RomImage *image);
+void        rom_store_release(RomImage *image);
+void        rom_store_stats(RomStoreStats *stats);
+
 #endif // CARTRIDGE_H
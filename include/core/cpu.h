@@ -0,0 +1,213 @@
+// include/core/cpu.h
+#ifndef CPU_H
+#define CPU_H
+
+#include <core/utils.h>
+
+struct GameBoy;
+
+// ---------------------------------------------
+// Flags (upper nibble of F)
+// https://gbdev.io/pandocs/CPU_Registers_and_Flags.html
+// ---------------------------------------------
+#define FLAG_Z BIT(7) // Zero
+#define FLAG_N BIT(6) // Subtract
+#define FLAG_H BIT(5) // Half carry
+#define FLAG_C BIT(4) // Carry
+
+// ---------------------------------------------
+// Interrupt bits (IE & IF)
+// https://gbdev.io/pandocs/Interrupts.html
+// ---------------------------------------------
+#define INT_VBLANK BIT(0)
+#define INT_STAT BIT(1)
+#define INT_TIMER BIT(2)
+#define INT_SERIAL BIT(3)
+#define INT_JOYPAD BIT(4)
+#define INT_MASK 0x1F
+
+// ---------------------------------------------
+// LR35902 State
+// ---------------------------------------------
+typedef struct {
+    // Registers
+    u8   a, f;
+    u8   b, c;
+    u8   d, e;
+    u8   h, l;
+    u16  sp;
+    u16  pc;
+
+    // Lazy flags: inside cpu_run() the last flag-setting instruction is kept
+    // here & F is only built when something reads it. cpu->f is up to date
+    // whenever cpu_run() isn't running.
+    u16  flag_res; // Result: Z if the low byte is 0, C is bit 8
+    u8   flag_x;   // Operands (H & N come from these), or N & H themselves
+    u8   flag_y;
+    u8   flag_op;  // How to get N & H (cpu_exec.c)
+
+    // Interrupt & power state
+    bool ime;         // Interrupt master enable
+    bool ime_pending; // EI takes effect after the next instruction
+    bool halted;      // HALT: waiting for (IE & IF) != 0
+    bool halt_bug;    // HALT with IME=0 & pending IRQ: next opcode byte is read twice
+    bool stopped;     // STOP: waiting for a joypad interrupt
+    bool locked;      // Illegal opcode: the CPU hangs until reset
+
+    // Statistics
+    u64  instructions; // Retired instructions since reset
+    u64  idle_cycles;  // Cycles spent in HALT/STOP (or locked), not in save states
+    u64  idle_skips;   // Jumps ahead to the next event while idle
+} CPU;
+
+// ---------------------------------------------
+// 16-bit Register Pairs
+// ---------------------------------------------
+static inline u16 cpu_get_bc(const CPU *cpu) {
+    return MAKE_U16(cpu->b, cpu->c);
+}
+static inline u16 cpu_get_de(const CPU *cpu) {
+    return MAKE_U16(cpu->d, cpu->e);
+}
+static inline u16 cpu_get_hl(const CPU *cpu) {
+    return MAKE_U16(cpu->h, cpu->l);
+}
+static inline u16 cpu_get_af(const CPU *cpu) {
+    return MAKE_U16(cpu->a, cpu->f);
+}
+
+static inline void cpu_set_bc(CPU *cpu, u16 val) {
+    cpu->b = GET_HIGH_BYTE(val);
+    cpu->c = GET_LOW_BYTE(val);
+}
+static inline void cpu_set_de(CPU *cpu, u16 val) {
+    cpu->d = GET_HIGH_BYTE(val);
+    cpu->e = GET_LOW_BYTE(val);
+}
+static inline void cpu_set_hl(CPU *cpu, u16 val) {
+    cpu->h = GET_HIGH_BYTE(val);
+    cpu->l = GET_LOW_BYTE(val);
+}
+static inline void cpu_set_af(CPU *cpu, u16 val) {
+    cpu->a = GET_HIGH_BYTE(val);
+    cpu->f = GET_LOW_BYTE(val) & 0xF0; // Lower nibble of F is always 0
+}
+
+// ---------------------------------------------
+// CPU Functions
+// ---------------------------------------------
+
+// Clear all CPU state
+void cpu_init(CPU *cpu);
+
+// Set the registers to the DMG post-boot-ROM values (PC = 0x0100)
+void cpu_reset(CPU *cpu);
+
+// Run instructions until at least `budget` cycles have elapsed.
+// gb->cycles is advanced as instructions retire; returns the cycles used.
+u32  cpu_run(struct GameBoy *gb, u32 budget);
+
+// Execute a single instruction (or interrupt dispatch / halted tick)
+u32  cpu_step(struct GameBoy *gb);
+
+// Request an interrupt (sets the matching IF bit)
+void cpu_request_interrupt(struct GameBoy *gb, u8 interrupt);
+
+// Stack helpers (used by instruction handlers & interrupt dispatch)
+void cpu_push(struct GameBoy *gb, u16 val);
+u16  cpu_pop(struct GameBoy *gb);
+
+// Enter HALT (handles the HALT bug)
+void cpu_halt(struct GameBoy *gb);
+
+// Service the highest priority pending interrupt; returns cycles used (0 if none)
+u32  cpu_service_interrupt(struct GameBoy *gb);
+
+// ---------------------------------------------
+// Decode Cache (cpu_decode.c)
+// ---------------------------------------------
+// Optional (gb->decode_enabled): the interpreter fetches instructions as
+// pre-decoded records instead of reading the opcode & operands through the
+// MMU every time. There is one record per byte of ROM/VRAM/WRAM/cart RAM,
+// found through gb->decode_map (parallel to gb->read_map), so ROM records are
+// keyed by bank offset and stay valid forever. RAM pages holding records are
+// watched (MMU_WATCH_DECODE) and the first write to one drops its records.
+typedef struct {
+    u16 imm;    // d8/a8/r8/CB opcode in the low byte, or d16/a16
+    u8  op;     // Opcode (indexes the handler tables)
+    u8  length; // Instruction length in bytes, 0 = not decoded yet
+} DecodedOp;
+
+typedef struct {
+    u64 hits;          // Instructions fetched from a cached record
+    u64 misses;        // Instructions decoded from memory
+    u64 invalidations; // RAM pages whose records were dropped by a write
+} CpuDecodeStats;
+
+// Decode the instruction at pc: into its cache record if the page has one
+// (& the whole instruction is on that page), otherwise into `scratch`
+const DecodedOp *cpu_decode_miss(struct GameBoy *gb, u16 pc, DecodedOp *scratch);
+
+// Records backing one 256-byte host page (NULL if the memory is not cached).
+// Used by the page table to fill gb->decode_map.
+DecodedOp *cpu_decode_records(struct GameBoy *gb, const u8 *host_page);
+
+// Drop the records of one 256-byte host page (its memory was written)
+void cpu_decode_invalidate(struct GameBoy *gb, const u8 *host_page);
+
+// Drop every record (e.g. after loading a new ROM or restoring memory)
+void cpu_decode_flush(struct GameBoy *gb);
+
+// Release the decode cache
+void cpu_decode_free(struct GameBoy *gb);
+
+// Copy the decode cache counters (all zero if the cache never ran)
+void cpu_decode_get_stats(const struct GameBoy *gb, CpuDecodeStats *out);
+
+// ---------------------------------------------
+// Block JIT (cpu_jit.c)
+// ---------------------------------------------
+// Optional x86-64 backend. Guest basic blocks are translated to host code the
+// first time they run and cached by the host address of their first byte, so
+// the (ROM bank, PC) pair is implicit in the key. The interpreter stays in
+// charge of everything the translator does not handle.
+typedef struct {
+    u64 blocks_compiled; // Blocks translated
+    u64 blocks_executed; // Translated blocks entered
+    u64 interp_steps;    // Instructions run by the interpreter instead
+    u64 invalidations;   // Blocks dropped because their RAM page was written
+    u64 flushes;         // Whole-cache flushes (code buffer or block table full)
+} CpuJitStats;
+
+// True if this build & host can run translated code
+bool cpu_jit_available(void);
+
+// Same contract as cpu_run(), with translated blocks where possible.
+// Falls back to cpu_run() entirely if the JIT is unavailable or could not be
+// set up (gb->jit_failed, not retried).
+u32  cpu_jit_run(struct GameBoy *gb, u32 budget);
+
+// Drop all blocks translated from the 256-byte host page `host_page`
+void cpu_jit_invalidate(struct GameBoy *gb, const u8 *host_page);
+
+// Drop every translated block (e.g. after loading a new ROM)
+void cpu_jit_flush(struct GameBoy *gb);
+
+// Release the JIT state
+void cpu_jit_free(struct GameBoy *gb);
+
+// Copy the JIT counters (all zero if the JIT never ran)
+void cpu_jit_get_stats(const struct GameBoy *gb, CpuJitStats *out);
+
+// ---------------------------------------------
+// Opcode Tables (cpu_tables.c)
+// ---------------------------------------------
+// Cycle counts are in T-cycles (4.19 MHz clock). For conditional branches
+// cpu_cycles holds the not-taken count and cpu_cycles_taken the taken one.
+// CB-prefixed counts include the fetch of the 0xCB prefix itself.
+extern const u8 cpu_cycles[256];
+extern const u8 cpu_cycles_taken[256];
+extern const u8 cpu_cb_cycles[256];
+extern const u8 cpu_op_length[256];
+
+#endif // !CPU_H
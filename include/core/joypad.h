@@ -0,0 +1,48 @@
+// include/core/joypad.h
+#ifndef JOYPAD_H
+#define JOYPAD_H
+
+#include <core/utils.h>
+
+struct GameBoy;
+
+// ---------------------------------------------
+// Joypad
+// https://gbdev.io/pandocs/Joypad_Input.html
+// ---------------------------------------------
+// P1 (0xFF00) selects the d-pad and/or the buttons row with bits 4 & 5
+// (0 = selected) & reads the selected keys back in bits 0 - 3, 0 = pressed.
+// The frontend hands in the held keys as a JOYPAD_* mask.
+#define JOYPAD_RIGHT BIT(0)
+#define JOYPAD_LEFT BIT(1)
+#define JOYPAD_UP BIT(2)
+#define JOYPAD_DOWN BIT(3)
+#define JOYPAD_A BIT(4)
+#define JOYPAD_B BIT(5)
+#define JOYPAD_SELECT BIT(6)
+#define JOYPAD_START BIT(7)
+
+#define P1_SELECT_DPAD BIT(4)
+#define P1_SELECT_BUTTONS BIT(5)
+
+typedef struct {
+    u8 select;  // P1 bits 4 & 5 as written
+    u8 buttons; // Held keys, JOYPAD_* bits
+} Joypad;
+
+// ---------------------------------------------
+// Joypad Functions
+// ---------------------------------------------
+
+// Nothing selected, nothing held (P1 reads 0xCF)
+void joypad_reset(struct GameBoy *gb);
+
+// Set the held keys. A key going down on a selected row requests the joypad
+// interrupt (& ends STOP).
+void joypad_set_buttons(struct GameBoy *gb, u8 buttons);
+
+// Register access (0xFF00)
+u8   joypad_read(struct GameBoy *gb);
+void joypad_write(struct GameBoy *gb, u8 value);
+
+#endif // JOYPAD_H
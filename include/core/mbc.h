@@ -0,0 +1,76 @@
+// include/core/mbc.h
+#ifndef MBC_H
+#define MBC_H
+
+#include <core/utils.h>
+#include <stddef.h>
+
+struct GameBoy;
+
+// ---------------------------------------------
+// Memory Bank Controllers
+// https://gbdev.io/pandocs/MBCs.html
+// ---------------------------------------------
+// The controller is picked once from the cartridge type. Its register writes
+// (0x0000 - 0x7FFF) go to a handler of its own, which works out the ROM & RAM
+// banks only when a register changes & points the page table at them. Reads
+// never see the MBC: banked ROM & RAM are plain page table entries.
+// What the table can't serve (disabled RAM, MBC2's 4-bit RAM, the MBC3
+// clock) goes to the controller's RAM handlers from the slow path.
+
+typedef enum {
+    MBC_NONE, // ROM only, ROM + RAM (& unsupported controllers)
+    MBC_1,
+    MBC_2,
+    MBC_3,
+    MBC_5,
+} MbcType;
+
+#define MBC2_RAM_SIZE 512 // Built in: 512 x 4 bits
+
+typedef void (*MbcWriteFn)(struct GameBoy *gb, u16 addr, u8 value);
+typedef u8 (*MbcReadFn)(struct GameBoy *gb, u16 addr);
+typedef void (*MbcUpdateFn)(struct GameBoy *gb);
+
+typedef struct {
+    MbcType     type;
+    bool        has_rtc;   // MBC3 with TIMER
+    MbcWriteFn  write;     // Register writes (0x0000 - 0x7FFF)
+    MbcUpdateFn update;    // Registers -> banks below, remapping what changed
+    MbcReadFn   ram_read;  // 0xA000 - 0xBFFF when the page table has nothing there
+    MbcWriteFn  ram_write;
+
+    // Registers as last written
+    bool        ram_enable; // 0x0A written to 0x0000 - 0x1FFF
+    u16         rom_bank;   // ROM bank register(s), as written
+    u8          bank_hi;    // MBC1: upper bank bits, MBC3: RAM bank / RTC register, MBC5: RAM bank
+    u8          mode;       // MBC1 banking mode
+
+    // Derived from the registers: what the page table currently shows
+    size_t      rom0_offset; // ROM behind 0x0000 - 0x3FFF
+    size_t      rom1_offset; // ROM behind 0x4000 - 0x7FFF
+    bool        ram_on;      // Cartridge RAM mapped at 0xA000 - 0xBFFF
+    size_t      ram_offset;  // RAM behind 0xA000 - 0xBFFF
+    u32         rom_mask;    // 16 KB ROM banks - 1 (rounded up to a power of two)
+    u32         ram_mask;    // 8 KB RAM banks - 1
+
+    // MBC3 real-time clock: S, M, H, DL, DH. It counts emulated time, so it
+    // only runs while the game does.
+    u8          rtc[5];
+    u8          rtc_latched[5];
+    u8          rtc_latch;  // Last value written to 0x6000 - 0x7FFF
+    u64         rtc_synced; // Cycle up to which rtc[] is counted
+} Mbc;
+
+// ---------------------------------------------
+// MBC Functions
+// ---------------------------------------------
+
+// Pick the controller for a cartridge type & reset its registers.
+// Returns the cartridge RAM size in bytes (MBC2 has its own, not in the header).
+size_t mbc_init(Mbc *mbc, u8 cart_type, size_t rom_size, size_t ram_size);
+
+// Point the ROM & RAM windows of the page table at the current banks
+void   mbc_map(struct GameBoy *gb);
+
+#endif // MBC_H
@@ -0,0 +1,39 @@
+// include/core/pixel.h
+#ifndef PIXEL_H
+#define PIXEL_H
+
+#include <core/utils.h>
+#include <stddef.h>
+
+// ---------------------------------------------
+// Pixel Kernels
+// ---------------------------------------------
+// The two inner loops of the PPU, in one implementation per instruction set:
+//
+// decode:  2bpp tile rows (low plane byte, high plane byte) -> one color
+//          index (0-3) per byte, 8 per row. `rows` rows are read from `planes`
+//          & 8 * rows indices written to `dst`; 20 rows are one scanline. With
+//          `xflip`, each row comes out mirrored.
+// palette: `n` color indices -> shades (0-3) through a BGP/OBP0/OBP1 value.
+//
+// Every kernel set gives exactly the same output as the scalar one.
+typedef enum {
+    PIXEL_SCALAR,
+    PIXEL_SSE2,
+    PIXEL_AVX2,
+    PIXEL_ISA_COUNT,
+} PixelIsa;
+
+typedef struct {
+    const char *name;
+    void (*decode)(u8 *dst, const u8 *planes, size_t rows, bool xflip);
+    void (*palette)(u8 *dst, const u8 *src, u8 palette, size_t n);
+} PixelKernels;
+
+// Kernels for `isa`, or NULL if this build/host can't run them
+const PixelKernels *pixel_kernels(PixelIsa isa);
+
+// Fastest kernels the host supports (CPUID on x86-64, scalar elsewhere)
+const PixelKernels *pixel_kernels_best(void);
+
+#endif // PIXEL_H
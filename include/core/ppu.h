@@ -0,0 +1,152 @@
+// include/core/ppu.h
+#ifndef PPU_H
+#define PPU_H
+
+#include <core/pixel.h>
+#include <core/utils.h>
+
+struct GameBoy;
+
+// ---------------------------------------------
+// Screen & Timing
+// https://gbdev.io/pandocs/Rendering.html
+// ---------------------------------------------
+#define SCREEN_WIDTH 160
+#define SCREEN_HEIGHT 144
+
+#define PPU_LINE_CYCLES 456  // Dots per scanline (1 dot = 1 T-cycle)
+#define PPU_LINES 154        // 144 visible + 10 VBlank
+#define PPU_OAM_CYCLES 80    // Mode 2 length
+#define PPU_DRAW_CYCLES 172  // Mode 3 length (fixed: no sprite/SCX penalties)
+#define PPU_FRAME_CYCLES (PPU_LINE_CYCLES * PPU_LINES)
+
+// ---------------------------------------------
+// LCDC (0xFF40) & STAT (0xFF41) bits
+// https://gbdev.io/pandocs/LCDC.html
+// ---------------------------------------------
+#define LCDC_BG_ENABLE BIT(0)  // BG & window enable
+#define LCDC_OBJ_ENABLE BIT(1) // Sprites enable
+#define LCDC_OBJ_SIZE BIT(2)   // 0 = 8x8, 1 = 8x16 sprites
+#define LCDC_BG_MAP BIT(3)     // BG tile map at 0x9C00 (else 0x9800)
+#define LCDC_TILE_DATA BIT(4)  // Tiles at 0x8000 unsigned (else 0x8800 signed)
+#define LCDC_WIN_ENABLE BIT(5) // Window enable
+#define LCDC_WIN_MAP BIT(6)    // Window tile map at 0x9C00 (else 0x9800)
+#define LCDC_ENABLE BIT(7)     // LCD & PPU enable
+
+#define STAT_MODE 0x03        // Current mode (read only)
+#define STAT_LYC_EQUAL BIT(2) // LY == LYC (read only)
+#define STAT_HBLANK_INT BIT(3)
+#define STAT_VBLANK_INT BIT(4)
+#define STAT_OAM_INT BIT(5)
+#define STAT_LYC_INT BIT(6)
+#define STAT_INT_MASK 0x78
+
+// OAM attribute bits (byte 3 of each 4-byte sprite entry)
+#define OBJ_PALETTE BIT(4)  // OBP1 (else OBP0)
+#define OBJ_XFLIP BIT(5)
+#define OBJ_YFLIP BIT(6)
+#define OBJ_PRIORITY BIT(7) // Behind BG colors 1-3
+
+#define OBJ_COUNT 40     // Sprites in OAM
+#define OBJ_PER_LINE 10  // Sprites the PPU picks per scanline
+
+// ---------------------------------------------
+// Decoded Tiles
+// ---------------------------------------------
+// Tile data (0x8000 - 0x97FF) is also kept decoded: one 2-bit color index per
+// byte, 8 rows of 8 pixels per tile, so BG/window/sprite fetches are plain
+// byte copies. ppu_write_vram() re-decodes the row a tile data write touches.
+// Sprites can additionally use a pre-mirrored copy for X-flip (on unless the
+// build defines BAREDMG_NO_TILE_XFLIP).
+#define TILE_COUNT 384
+
+typedef u8 TileRow[8];
+
+typedef enum {
+    PPU_MODE_HBLANK = 0,
+    PPU_MODE_VBLANK = 1,
+    PPU_MODE_OAM    = 2,
+    PPU_MODE_DRAW   = 3,
+} PpuMode;
+
+// ---------------------------------------------
+// PPU State
+// ---------------------------------------------
+// The PPU is never ticked. Its position in the frame is a pure function of
+// gb->cycles (see ppu.c), and pixels are only produced by ppu_sync(), which
+// catches up from `synced` to the current cycle whenever something could
+// observe or change the result. Interrupts come from scheduler events.
+typedef struct {
+    // Registers (0xFF40 - 0xFF4B)
+    u8   lcdc;
+    u8   stat; // Interrupt select bits only, mode & LYC flag are derived
+    u8   scy, scx;
+    u8   lyc;
+    u8   dma;
+    u8   bgp, obp0, obp1;
+    u8   wy, wx;
+
+    // Lazy timing
+    u64  frame_base;   // gb->cycles at which line 0 of a frame started
+    u64  synced;       // gb->cycles the picture was last brought up to date at
+    u8   ly;           // Line being drawn at `synced`
+    u8   drawn;        // Pixels of line `ly` already output
+    u8   window_line;  // Internal window line counter
+    bool window_y;     // WY matched LY at some line of this frame
+    bool window_drawn; // The window covered a pixel of line `ly`
+
+    // Sprites selected for line `ly` (OAM indices, in drawing priority order)
+    u8   obj_count;
+    u8   obj[OBJ_PER_LINE];
+
+    // Tile decode & palette kernels picked for this host (pixel.h)
+    const PixelKernels *pix;
+
+    // No pixels & no tile decoding, only timing, registers & interrupts
+    // (ppu_set_drawing). A host setting: kept across resets.
+    bool no_draw;
+
+    // Decoded tile data (tile index = (address - 0x8000) / 16)
+    TileRow tiles[TILE_COUNT][8];
+#ifndef BAREDMG_NO_TILE_XFLIP
+    TileRow tiles_xflip[TILE_COUNT][8];
+#endif
+
+    // Output: shades 0 (white) - 3 (black). The back buffer is being drawn,
+    // the other one holds the last completed frame.
+    u8   frame[2][SCREEN_HEIGHT][SCREEN_WIDTH];
+    u8   back;
+    u64  frames; // Completed frames since reset
+} Ppu;
+
+// ---------------------------------------------
+// PPU Functions
+// ---------------------------------------------
+
+// Set the DMG post-boot-ROM state (LCD on, line 0 starting now)
+void ppu_reset(struct GameBoy *gb);
+
+// Draw everything up to gb->cycles
+void ppu_sync(struct GameBoy *gb);
+
+// Switch drawing off (the last frame stays as it was) or back on
+void ppu_set_drawing(struct GameBoy *gb, bool on);
+
+// Register access (0xFF40 - 0xFF4B)
+u8   ppu_read(struct GameBoy *gb, u16 addr);
+void ppu_write(struct GameBoy *gb, u16 addr, u8 value);
+
+// VRAM & OAM writes (the picture is caught up first)
+void ppu_write_vram(struct GameBoy *gb, u16 addr, u8 value);
+void ppu_write_oam(struct GameBoy *gb, u16 addr, u8 value);
+
+// Re-decode every tile (after writing gb->vram directly)
+void ppu_refresh_tiles(struct GameBoy *gb);
+
+// Last completed frame, SCREEN_HEIGHT rows of SCREEN_WIDTH shades
+const u8 *ppu_framebuffer(struct GameBoy *gb);
+
+// SCHED_PPU handler: VBlank start or a rising edge of the STAT interrupt line
+void ppu_event(struct GameBoy *gb, u64 when);
+
+#endif // PPU_H
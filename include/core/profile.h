@@ -0,0 +1,100 @@
+// include/core/profile.h
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <core/utils.h>
+#include <stdio.h>
+
+// ---------------------------------------------
+// Guest Profile (BAREDMG_PROFILE builds)
+// ---------------------------------------------
+// Counters compiled into the hot paths: every executed opcode (base & CB),
+// every mmu_read/mmu_write by address region (I/O also by register) & every
+// bank an MBC actually switched. Without BAREDMG_PROFILE the PROFILE_*
+// macros expand to nothing and GameBoy has no counters at all.
+typedef enum {
+    PROF_ROM0,     // 0x0000 - 0x3FFF
+    PROF_ROMX,     // 0x4000 - 0x7FFF (writes: MBC registers)
+    PROF_VRAM,     // 0x8000 - 0x9FFF
+    PROF_SRAM,     // 0xA000 - 0xBFFF
+    PROF_WRAM,     // 0xC000 - 0xDFFF
+    PROF_ECHO,     // 0xE000 - 0xFDFF
+    PROF_OAM,      // 0xFE00 - 0xFE9F
+    PROF_UNUSABLE, // 0xFEA0 - 0xFEFF
+    PROF_IO,       // 0xFF00 - 0xFF7F (per register in io_reads/io_writes)
+    PROF_HRAM,     // 0xFF80 - 0xFFFE
+    PROF_IE,       // 0xFFFF
+    PROF_REGION_COUNT,
+} ProfRegion;
+
+typedef struct {
+    u64 ops[256];    // Base opcodes, including 0xCB itself
+    u64 cb_ops[256]; // CB-prefixed opcodes
+    u64 reads[PROF_REGION_COUNT];
+    u64 writes[PROF_REGION_COUNT];
+    u64 io_reads[0x80]; // By register, 0xFF00 + index
+    u64 io_writes[0x80];
+    u64 rom_switches;   // A ROM window remapped by the MBC
+    u64 ram_switches;   // The RAM window remapped (bank, enable or disable)
+} Profile;
+
+static inline ProfRegion profile_region(u16 addr) {
+    if (addr < 0x4000)
+        return PROF_ROM0;
+    if (addr < 0x8000)
+        return PROF_ROMX;
+    if (addr < 0xA000)
+        return PROF_VRAM;
+    if (addr < 0xC000)
+        return PROF_SRAM;
+    if (addr < 0xE000)
+        return PROF_WRAM;
+    if (addr < 0xFE00)
+        return PROF_ECHO;
+    if (addr < 0xFEA0)
+        return PROF_OAM;
+    if (addr < 0xFF00)
+        return PROF_UNUSABLE;
+    if (addr < 0xFF80)
+        return PROF_IO;
+    if (addr < 0xFFFF)
+        return PROF_HRAM;
+    return PROF_IE;
+}
+
+static inline void profile_access(u64 *regions, u64 *io, u16 addr) {
+    ProfRegion region = profile_region(addr);
+    regions[region]++;
+    if (region == PROF_IO)
+        io[addr & 0x7F]++;
+}
+
+#ifdef BAREDMG_PROFILE
+#define PROFILE_OP(gb, op) ((gb)->profile.ops[op]++)
+#define PROFILE_CB(gb, op) ((gb)->profile.cb_ops[op]++)
+#define PROFILE_READ(gb, addr) profile_access((gb)->profile.reads, (gb)->profile.io_reads, addr)
+#define PROFILE_WRITE(gb, addr) profile_access((gb)->profile.writes, (gb)->profile.io_writes, addr)
+#define PROFILE_COUNT(gb, counter) ((gb)->profile.counter++)
+#else
+#define PROFILE_OP(gb, op) ((void)0)
+#define PROFILE_CB(gb, op) ((void)0)
+#define PROFILE_READ(gb, addr) ((void)0)
+#define PROFILE_WRITE(gb, addr) ((void)0)
+#define PROFILE_COUNT(gb, counter) ((void)0)
+#endif
+
+// ---------------------------------------------
+// Profile Functions
+// ---------------------------------------------
+
+// Add src's counters to dst (e.g. several runs into one report)
+void profile_add(Profile *dst, const Profile *src);
+
+// Write the counters as one JSON object; zero counts are left out of the
+// per-opcode & per-register tables. Returns 0, or -1 on a write error.
+int  profile_write_json(const Profile *p, FILE *f);
+
+// Same, to a new file at `path`. Returns 0, or -1 if it can't be written.
+int  profile_save_json(const Profile *p, const char *path);
+
+#endif // PROFILE_H
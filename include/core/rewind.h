@@ -0,0 +1,87 @@
+// include/core/rewind.h
+#ifndef REWIND_H
+#define REWIND_H
+
+#include <core/utils.h>
+#include <stddef.h>
+
+struct GameBoy;
+
+// ---------------------------------------------
+// Rewind Ring
+// ---------------------------------------------
+// History of save states (gb_save_state) taken every `interval` frames.
+// Only the newest state is kept whole; older ones are stored as compressed
+// XOR deltas in a ring of fixed size that drops the oldest when full.
+// Everything is allocated by rewind_init(), within `memory` bytes.
+
+#define REWIND_DEFAULT_MEMORY (8u << 20)
+
+typedef struct {
+    size_t memory;   // Cap on all rewind memory in bytes (0: REWIND_DEFAULT_MEMORY)
+    u32    interval; // Frames between captures (0: every frame)
+} RewindConfig;
+
+typedef struct {
+    u32    states;     // Steps rewind_step() can take
+    u64    frames;     // Frames of history that covers
+    size_t state_size; // Bytes of one raw state
+    size_t memory;     // Bytes allocated (<= RewindConfig.memory)
+    size_t stored;     // Bytes of compressed deltas in the ring
+    double ratio;      // Raw size of the stored states / stored
+    double capture_ns; // Average host time rewind_frame() took per frame
+} RewindStats;
+
+typedef struct {
+    u32 offset; // In Rewind.ring
+    u32 size;
+} RewindEntry;
+
+typedef struct {
+    u8          *block; // Single allocation holding everything below
+    size_t       memory;
+    size_t       state_size;
+    u32          interval;
+
+    u8          *state; // Newest capture, whole
+    u8          *next;  // Capture in progress
+    u8          *delta; // Encoded delta before it goes into the ring
+    bool         have_state;
+    u32          since; // Frames run since `state` was captured
+
+    u8          *ring;
+    u32          ring_size;
+    u32          head; // End of the newest entry
+    RewindEntry *entries;
+    u32          entry_cap;
+    u32          first; // Oldest entry
+    u32          count;
+    size_t       stored;
+
+    u64          frames_seen;
+    u64          capture_ns;
+} Rewind;
+
+// ---------------------------------------------
+// Rewind Functions
+// ---------------------------------------------
+
+// Size the ring for `gb`'s current ROM. Returns false if `memory` can't hold
+// the working buffers for that state size (or allocation fails).
+bool rewind_init(Rewind *r, const struct GameBoy *gb, const RewindConfig *cfg);
+void rewind_free(Rewind *r);
+
+// Forget the history (e.g. after loading a different state)
+void rewind_reset(Rewind *r);
+
+// Call once after every frame: captures every `interval` frames.
+// After loading another ROM, rewind_init() again.
+void rewind_frame(Rewind *r, const struct GameBoy *gb);
+
+// Go one step back: to the newest capture if frames ran since it was taken,
+// else to the capture before it. Returns false when there's nothing left.
+bool rewind_step(Rewind *r, struct GameBoy *gb);
+
+void rewind_stats(const Rewind *r, RewindStats *stats);
+
+#endif // REWIND_H
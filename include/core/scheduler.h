@@ -0,0 +1,61 @@
+// include/core/scheduler.h
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <core/utils.h>
+
+struct GameBoy;
+
+// ---------------------------------------------
+// Event Kinds
+// ---------------------------------------------
+// Every component keeps at most one pending event: its next interesting edge.
+// Events with the same timestamp run in this order.
+typedef enum {
+    SCHED_PPU,     // VBlank start / STAT interrupt edge (ppu.c)
+    SCHED_TIMER,   // TIMA overflow (timer.c)
+    SCHED_SERIAL,  // Serial transfer complete (serial.c)
+    SCHED_RUN_END, // End of the current cpu_run() slice
+    SCHED_COUNT,
+} SchedEvent;
+
+#define SCHED_NEVER UINT64_MAX
+
+// ---------------------------------------------
+// Scheduler
+// ---------------------------------------------
+// A sorted array of (absolute cycle, event) pairs, earliest first. With one
+// slot per event kind it never holds more than SCHED_COUNT entries, so
+// insertion is a short shift & the earliest deadline is always entries[0].
+typedef struct {
+    u64 when;  // Absolute cycle (gb->cycles) the event is due at
+    u8  event; // SchedEvent
+} SchedEntry;
+
+typedef struct {
+    SchedEntry entries[SCHED_COUNT];
+    u8         count;
+    u64        next; // entries[0].when, or SCHED_NEVER (the CPU runs until this)
+} Scheduler;
+
+// ---------------------------------------------
+// Scheduler Functions
+// ---------------------------------------------
+
+// Remove all events
+void sched_init(Scheduler *sched);
+
+// Schedule (or move) `event` to the absolute cycle `when`
+void sched_add(Scheduler *sched, SchedEvent event, u64 when);
+
+// Remove `event` if it is pending
+void sched_cancel(Scheduler *sched, SchedEvent event);
+
+// Cycle `event` is due at, or SCHED_NEVER
+u64  sched_when(const Scheduler *sched, SchedEvent event);
+
+// Run every event due at or before gb->cycles, in timestamp order.
+// Returns true if SCHED_RUN_END was among them.
+bool sched_dispatch(struct GameBoy *gb);
+
+#endif // SCHEDULER_H
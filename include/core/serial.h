@@ -0,0 +1,39 @@
+// include/core/serial.h
+#ifndef SERIAL_H
+#define SERIAL_H
+
+#include <core/utils.h>
+
+struct GameBoy;
+
+// ---------------------------------------------
+// Serial Port
+// https://gbdev.io/pandocs/Serial_Data_Transfer_(Link_Cable).html
+// ---------------------------------------------
+// No link partner is emulated: a transfer on the internal clock shifts in
+// 0xFF & completes after 8 bits at 8192 Hz, one scheduler event per byte.
+#define SC_START BIT(7) // Transfer requested / in progress
+#define SC_CLOCK BIT(0) // 1 = internal clock
+
+#define SERIAL_CYCLES_PER_BYTE (8 * 512)
+
+typedef struct {
+    u8 sb; // Serial data (0xFF01)
+    u8 sc; // Serial control (0xFF02), SC_START | SC_CLOCK bits only
+} Serial;
+
+// ---------------------------------------------
+// Serial Functions
+// ---------------------------------------------
+
+// Idle port, no transfer pending
+void serial_reset(struct GameBoy *gb);
+
+// Register access (0xFF01 - 0xFF02)
+u8   serial_read(struct GameBoy *gb, u16 addr);
+void serial_write(struct GameBoy *gb, u16 addr, u8 value);
+
+// SCHED_SERIAL handler: the current byte has been shifted out
+void serial_event(struct GameBoy *gb, u64 when);
+
+#endif // SERIAL_H
@@ -0,0 +1,42 @@
+// include/core/timer.h
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <core/utils.h>
+
+struct GameBoy;
+
+// ---------------------------------------------
+// Timer & Divider
+// https://gbdev.io/pandocs/Timer_and_Divider_Registers.html
+// ---------------------------------------------
+// DIV is the top byte of a 16-bit counter that runs at the CPU clock; TIMA
+// counts falling edges of one of its bits (selected by TAC). Neither is
+// ticked: DIV is derived from gb->cycles when read, TIMA is caught up on
+// register access & a scheduler event fires at the exact overflow cycle.
+#define TAC_ENABLE BIT(2) // TIMA counts while set
+#define TAC_CLOCK 0x03    // Input clock select
+
+typedef struct {
+    u64 div_base; // gb->cycles at which the 16-bit counter was zero
+    u64 synced;   // gb->cycles TIMA was last brought up to date at
+    u8  tima;     // Timer counter (0xFF05)
+    u8  tma;      // Timer modulo (0xFF06)
+    u8  tac;      // Timer control (0xFF07), low 3 bits
+} Timer;
+
+// ---------------------------------------------
+// Timer Functions
+// ---------------------------------------------
+
+// Set the DMG post-boot-ROM state (DIV = 0xAB, timer stopped)
+void timer_reset(struct GameBoy *gb);
+
+// Register access (0xFF04 - 0xFF07)
+u8   timer_read(struct GameBoy *gb, u16 addr);
+void timer_write(struct GameBoy *gb, u16 addr, u8 value);
+
+// SCHED_TIMER handler: TIMA overflowed
+void timer_event(struct GameBoy *gb, u64 when);
+
+#endif // TIMER_H
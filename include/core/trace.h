@@ -0,0 +1,157 @@
+// include/core/trace.h
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <core/utils.h>
+#include <core/cpu.h>
+#include <gbemu.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+// ---------------------------------------------
+// Execution Trace
+// ---------------------------------------------
+// While gb->trace is set, the interpreter appends one fixed-size record per
+// instruction (state before it runs) to a ring buffer; a writer thread
+// drains the ring to a file. The emulation thread only ever stores into the
+// ring & bumps an index; it waits only when the writer falls a whole ring
+// behind. The JIT is bypassed while tracing.
+//
+// File: TraceFileHeader, then TraceRecords as they are in memory (host
+// byte order, little-endian on everything we run on). baredmg-trace turns
+// it into text.
+#define TRACE_MAGIC "BDMGTRC"
+#define TRACE_VERSION 1
+#define TRACE_RING_RECORDS (1u << 16) // 2 MB
+
+#define TRACE_IME BIT(0)      // Interrupts enabled
+#define TRACE_HALT_BUG BIT(1) // Opcode byte read twice after HALT (pc not advanced)
+
+// Registers in CPU order (a - l, sp, pc): recorded with one copy
+typedef struct {
+    u64 cycles; // gb->cycles when the instruction was fetched
+    u8  a, f, b, c, d, e, h, l;
+    u16 sp;
+    u16 pc;
+    u16 bank;   // ROM bank behind pc (0 outside ROM)
+    u8  mem[4]; // Bytes at pc: the instruction, then what follows it
+    u8  length; // Instruction length (1 - 3)
+    u8  flags;  // TRACE_*
+    u8  reserved[4];
+} TraceRecord;
+
+#define TRACE_REGS_SIZE 12 // a through pc, in both CPU & TraceRecord
+
+// trace_insn() copies them in one go: both structs must lay them out alike
+#define TRACE_REG_AT(reg)                                                                          \
+    (offsetof(CPU, reg) - offsetof(CPU, a) == offsetof(TraceRecord, reg) - offsetof(TraceRecord, a))
+__extension__ _Static_assert(TRACE_REG_AT(f) && TRACE_REG_AT(b) && TRACE_REG_AT(c) &&
+                                 TRACE_REG_AT(d) && TRACE_REG_AT(e) && TRACE_REG_AT(h) &&
+                                 TRACE_REG_AT(l) && TRACE_REG_AT(sp) && TRACE_REG_AT(pc),
+                             "TraceRecord registers must be laid out like CPU's");
+__extension__ _Static_assert(offsetof(TraceRecord, pc) + sizeof(u16) - offsetof(TraceRecord, a) ==
+                                 TRACE_REGS_SIZE,
+                             "TRACE_REGS_SIZE must span a through pc");
+
+typedef struct {
+    char magic[8]; // TRACE_MAGIC, NUL-padded
+    u32  version;
+    u32  record_size;
+} TraceFileHeader;
+
+typedef struct Tracer {
+    // Emulation thread
+    TraceRecord *ring;
+    u32          mask;   // Ring records - 1
+    u32          head;   // Records appended (published with release)
+    u32          limit;  // Slow path (trace_wait) when head gets here
+    u64          stalls; // Times the emulation thread waited for the writer
+
+    // Writer thread (its own cache line)
+    u8           pad[64];
+    u32          tail;   // Records written out (published with release)
+    u32          quit;
+    bool         failed; // A write failed: the rest of the trace is dropped
+    FILE        *file;
+} Tracer;
+
+// Trace every instruction from now on into a new file at `path`
+bool trace_start(GameBoy *gb, const char *path);
+
+// Write out what is left & close the file. False if any of it couldn't be
+// written. Nothing happens if no trace is running.
+bool trace_stop(GameBoy *gb);
+
+// Every batch of records: wake the writer thread & wait until the next batch
+// fits in the ring (emulation thread only)
+void trace_wait(Tracer *t);
+
+// ---------------------------------------------
+// Recording (the interpreter, at each fetch)
+// ---------------------------------------------
+
+// Memory the trace shows after the instruction: what the page table has, or
+// HRAM (OAM DMA routines run there), never a register read with side effects
+static inline u8 trace_peek(const GameBoy *gb, u16 addr) {
+    const u8 *page = gb->read_map[addr >> 8];
+    if (page)
+        return page[addr & 0xFF];
+    if (addr >= 0xFF80 && addr < 0xFFFF)
+        return gb->hram[addr - 0xFF80];
+    return 0xFF;
+}
+
+static inline u16 trace_bank(const GameBoy *gb, u16 pc) {
+    if (pc < 0x4000)
+        return (u16)(gb->cart.mbc.rom0_offset >> 14);
+    if (pc < 0x8000)
+        return (u16)(gb->cart.mbc.rom1_offset >> 14);
+    return 0;
+}
+
+// Record the instruction at cpu->pc: opcode `op` with operands `imm`
+static inline void trace_insn(GameBoy *gb, u8 op, u16 imm, u8 flags) {
+    Tracer    *t   = gb->trace;
+    const CPU *cpu = &gb->cpu;
+    u16        pc  = cpu->pc;
+
+    if (t->head == t->limit)
+        trace_wait(t);
+
+    TraceRecord *r    = &t->ring[t->head & t->mask];
+    const u8    *page = gb->read_map[pc >> 8];
+    u8           n    = cpu_op_length[op];
+
+    r->cycles = gb->cycles;
+    memcpy(&r->a, &cpu->a, TRACE_REGS_SIZE);
+    r->bank   = trace_bank(gb, pc);
+    r->length = n;
+    r->flags  = flags | (cpu->ime ? TRACE_IME : 0);
+
+    // Usually all four bytes are on the page the code runs from
+    if (page && (pc & 0xFF) <= 0xFC && !flags) {
+        memcpy(r->mem, page + (pc & 0xFF), 4);
+    }
+    else {
+        r->mem[0] = op;
+        r->mem[1] = n > 1 ? GET_LOW_BYTE(imm) : trace_peek(gb, (u16)(pc + 1));
+        r->mem[2] = n > 2 ? GET_HIGH_BYTE(imm) : trace_peek(gb, (u16)(pc + 2));
+        r->mem[3] = trace_peek(gb, (u16)(pc + 3));
+    }
+
+    __atomic_store_n(&t->head, t->head + 1, __ATOMIC_RELEASE);
+}
+
+// ---------------------------------------------
+// Decoding
+// ---------------------------------------------
+typedef enum {
+    TRACE_TEXT,   // Cycle, bank:pc, bytes, registers, flags by name
+    TRACE_DOCTOR, // Gameboy Doctor: "A:01 F:B0 B:00 ... SP:FFFE PC:0100 PCMEM:00,C3,13,02"
+} TraceFormat;
+
+// One record as a line of text (no newline). Returns what snprintf does.
+int trace_format(const TraceRecord *r, TraceFormat fmt, char *buf, size_t size);
+
+#endif // TRACE_H
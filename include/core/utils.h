@@ -4,6 +4,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 // ---------------------------------------------
 // Type Definitions
@@ -54,22 +55,59 @@ typedef int64_t  i64;
 #define GET_LOW_BYTE(val) ((u8)((val) & 0xFF))
 
 // ---------------------------------------------
-// Complex Utility Functions
+// Carry Checks & Sign Extension (inline: used per instruction)
 // ---------------------------------------------
-u16  swap_bytes(u16 val);              // Swap endianness
-bool check_half_carry_add(u8 a, u8 b); // Check if half-carry occurred (bit 3->4)
-bool check_carry_add(u8 a, u8 b);      // Check if carry occurred (bit 7->8)
-bool check_half_carry_sub(u8 a, u8 b); // Half-carry for subtraction
-bool check_carry_sub(u8 a, u8 b);      // Carry for subtraction
 
-// 16-bit carry checks (for 16-bit arithmetic)
-bool check_half_carry_add_u16(u16 a, u16 b); // Half-carry bit 11->12
-bool check_carry_add_u16(u16 a, u16 b);      // Carry bit 15->16
+// Check if half-carry occurred (bit 3->4)
+static inline bool check_half_carry_add(u8 a, u8 b) {
+    return ((a & 0x0F) + (b & 0x0F)) > 0x0F;
+}
+
+// Check if carry occurred (bit 7->8)
+static inline bool check_carry_add(u8 a, u8 b) {
+    return (u16)a + (u16)b > 0xFF;
+}
+
+// Half-carry for subtraction (borrow from bit 4)
+static inline bool check_half_carry_sub(u8 a, u8 b) {
+    return (a & 0x0F) < (b & 0x0F);
+}
+
+// Carry for subtraction (borrow)
+static inline bool check_carry_sub(u8 a, u8 b) {
+    return a < b;
+}
+
+// 16-bit half-carry (bit 11->12)
+static inline bool check_half_carry_add_u16(u16 a, u16 b) {
+    return ((a & 0x0FFF) + (b & 0x0FFF)) > 0x0FFF;
+}
+
+// 16-bit carry (bit 15->16)
+static inline bool check_carry_add_u16(u16 a, u16 b) {
+    return ((u32)a + (u32)b) > 0xFFFF;
+}
+
+// Extend 8-bit signed to 16-bit (for relative jumps)
+static inline i16 sign_extend_i8(u8 val) {
+    return (val & 0x80) ? (i16)(val | 0xFF00) : (i16)val;
+}
+
+// ---------------------------------------------
+// Complex Utility Functions
+// ---------------------------------------------
+u16  swap_bytes(u16 val); // Swap endianness
 
-// Binary Coded Decimal (BCD) adjustment for DAA instruction
+// Binary Coded Decimal (BCD) adjustment for DAA instruction (the interpreter
+// uses the generated table in <core/alu_tables.h>)
 u8   adjust_bcd(u8 value, bool subtract, bool carry, bool half_carry);
 
-// Sign extension (for relative jumps)
-i16  sign_extend_i8(u8 val); // Extend 8 bit signed to 16-bit
+// ---------------------------------------------
+// Checksums (ROM identity)
+// ---------------------------------------------
+#define SHA1_SIZE 20
+
+u32  compute_crc32(const void *data, size_t size);                 // CRC-32 (zlib, PNG, .zip)
+void compute_sha1(const void *data, size_t size, u8 out[SHA1_SIZE]); // SHA-1 digest
 
 #endif
@@ -0,0 +1,72 @@
+// include/frontend/frontend.h
+#ifndef FRONTEND_H
+#define FRONTEND_H
+
+#include <gbemu.h>
+
+// ---------------------------------------------
+// Frame Exchange
+// ---------------------------------------------
+// Triple buffer between the emulation thread (producer, one frame per
+// gb_run_frame) & the render thread (consumer, one look per display
+// refresh). Of the three slots the producer owns one (back), the consumer
+// one (front) & the third (middle) is traded by an atomic exchange of its
+// index. Pixels are never copied between slots and neither side waits: the
+// producer always has a slot to draw into, the consumer always holds a
+// whole frame, the newest published or the one it already had.
+#define FRAME_SLOTS 3
+#define FRAME_FRESH BIT(7) // Flag in `middle`: published, not picked up yet
+
+typedef struct {
+    u32 pixels[SCREEN_HEIGHT * SCREEN_WIDTH]; // ARGB8888, row by row
+    u64 serial;                               // 1 for the first frame published, 0: none yet
+} FrameSlot;
+
+typedef struct {
+    FrameSlot slot[FRAME_SLOTS];
+
+    // Separate cache lines: each side writes only its own index & counter
+    u8  pad[64];
+    u32 middle; // Slot index | FRAME_FRESH (shared, only ever exchanged)
+    u8  middle_pad[60];
+    u32 back;      // Producer's slot
+    u64 published; // Frames published
+    u8  back_pad[48];
+    u32 front;   // Consumer's slot
+    u64 skipped; // Frames published over before the consumer saw them
+    u8  front_pad[48];
+} FrameExchange;
+
+// Three blank slots, nothing published
+void             frame_exchange_init(FrameExchange *fx);
+
+// Producer: the slot to draw the next frame into (the same one until published)
+FrameSlot       *frame_exchange_back(FrameExchange *fx);
+
+// Producer: hand the back slot over & take the middle one as the new back
+void             frame_exchange_publish(FrameExchange *fx);
+
+// Consumer: pick up the newest published frame if there is one, & return
+// the slot to show. It stays untouched until the next call.
+const FrameSlot *frame_exchange_acquire(FrameExchange *fx);
+
+// ---------------------------------------------
+// SDL Frontend (sdl_frontend.c, SDL2 builds only)
+// ---------------------------------------------
+// The emulation loop runs on its own thread, paced to the Game Boy's frame
+// rate, & publishes frames through a FrameExchange. The calling thread owns
+// the window: it polls input, hands the held keys over with an atomic
+// store & presents the newest frame. A vsync wait or a stalled window
+// manager only delays presenting; a slow emulated frame only repeats the
+// last whole one on screen.
+typedef struct {
+    int  scale; // Window size in multiples of 160x144 (<= 0: 4)
+    bool vsync; // Present in step with the display
+    bool audio; // Open an audio device & synthesize sound (else register-only APU)
+} FrontendOptions;
+
+// Run a loaded gb in a window until it is closed. Returns 0, or -1 if SDL,
+// the window or the emulation thread couldn't be started.
+int sdl_frontend_run(GameBoy *gb, const FrontendOptions *opt);
+
+#endif // FRONTEND_H
@@ -0,0 +1,42 @@
+// include/frontend/headless.h
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+#include <gbemu.h>
+#include <stddef.h>
+
+// ---------------------------------------------
+// Multi-Instance Runner ("farm")
+// ---------------------------------------------
+// Runs many independent GameBoy instances on a work-stealing thread pool.
+// Each job is run start to finish by one worker, and instances share
+// nothing, so the result of every job is the same for any thread count.
+
+typedef struct {
+    GameBoy *gb;     // Loaded instance (gb_load_rom / gb_load_rom_buffer)
+    u64      frames; // Frames to run (gb_run_frame), or
+    u64      cycles; // cycles to run when frames == 0 (gb_run_cycles)
+} FarmJob;
+
+typedef struct {
+    int  threads; // Worker threads, <= 0: one per online CPU
+    bool pin;     // Pin worker i to CPU i % CPUs (Linux only, ignored elsewhere)
+} FarmOptions;
+
+typedef struct {
+    int threads; // Workers actually started
+    u64 steals;  // Successful steals (each takes half a victim's queue)
+} FarmStats;
+
+// Run every job. Returns 0, or -1 if no worker thread could be started.
+// `stats` may be NULL.
+int farm_run(FarmJob *jobs, size_t count, const FarmOptions *opt, FarmStats *stats);
+
+// Run one job on the calling thread
+void farm_run_job(FarmJob *job);
+
+// FNV-1a digest of an instance's visible state (CPU, memory, last frame,
+// cycle count), for comparing runs
+u64 farm_digest(const GameBoy *gb);
+
+#endif // HEADLESS_H
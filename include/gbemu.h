@@ -2,16 +2,37 @@
 #ifndef GBEMU_H
 #define GBEMU_H
 
+#include <core/apu.h>
 #include <core/cartridge.h>
+#include <core/cpu.h>
+#include <core/joypad.h>
+#include <core/ppu.h>
+#include <core/profile.h>
+#include <core/scheduler.h>
+#include <core/serial.h>
+#include <core/timer.h>
 #include <core/utils.h>
 
+// GameBoy runs at ~4.19 MHz, 1 frame @ ~59.7 Hz = 70224 cycles
+#define CPU_CLOCK_HZ 4194304
+#define CYCLES_PER_FRAME 70224
+
+// Frames between battery save flushes by default (~1 s)
+#define GB_SAVE_INTERVAL 60
+
 // ---------------------------------------------
 // Main GameBoy Struct
 // ---------------------------------------------
 typedef struct GameBoy {
     // Components will be added as they are implemented.
-    // TODO: CPU
+    CPU       cpu;
     Cartridge cart;
+    Ppu       ppu;
+    Apu       apu;
+    Timer     timer;
+    Serial    serial;
+    Joypad    joypad;
+    Scheduler sched;
 
     // Memory
     // https://gbdev.io/pandocs/Memory_Map.html#memory-map
@@ -22,10 +43,47 @@ typedef struct GameBoy {
 
     // I/O Registers
     u8        ie_register; // Interrupt Enable Register (0xFFFF)
+    u8        if_register; // Interrupt Flag Register (0xFF0F)
+
+    // Memory map: one entry per 256-byte page (see bus.c)
+    // Each entry points at the host memory backing the page, or is NULL when
+    // accesses must go through the slow path (I/O, OAM, MBC control, etc.)
+    u8       *read_map[0x100];
+    u8       *write_map[0x100];
+    u8       *write_base[0x100]; // Backing memory of each page, even while it is watched
+    u8        page_watch[0x100]; // MMU_WATCH_* flags (bus.h)
+
+    // Optional decode cache (cpu_decode.c), off by default. Set decode_enabled
+    // to switch it on; the records behind each page (NULL = not cached) are
+    // filled alongside read_map once the cache exists (first fetch).
+    bool                   decode_enabled;
+    DecodedOp             *decode_map[0x100];
+    struct CpuDecodeCache *decode;
+    CpuDecodeStats         decode_stats;
 
     // System state
     u64       cycles;
     bool      running;
+
+    // Battery save flushing (savefile.c): every save_interval frames run by
+    // gb_run_frame (0: GB_SAVE_INTERVAL) & on unload
+    u32       save_interval;
+    u32       save_frames;
+
+    // Optional x86-64 block JIT (cpu_jit.c), off by default.
+    // Set jit_enabled to switch it on; state is allocated on first use. If
+    // that fails, jit_failed is set & jit_enabled cleared: no more attempts.
+    bool           jit_enabled;
+    bool           jit_failed;
+    struct CpuJit *jit;
+
+    // Instruction trace being written (trace.h), NULL = not tracing
+    struct Tracer *trace;
+
+#ifdef BAREDMG_PROFILE
+    // Guest opcode, memory region & bank switch counters (profile.h)
+    Profile        profile;
+#endif
 } GameBoy;
 
 // ---------------------------------------------
@@ -33,8 +91,41 @@ typedef struct GameBoy {
 // ---------------------------------------------
 void gb_init(GameBoy *gb);
 void gb_load_rom(GameBoy *gb, const char *path);
+bool gb_load_rom_buffer(GameBoy *gb, const u8 *data, size_t size);
+bool gb_load_rom_image(GameBoy *gb, RomImage *image);
+void gb_unload(GameBoy *gb);
 void gb_step(GameBoy *gb);
 void gb_run_frame(GameBoy *gb);
+void gb_run_cycles(GameBoy *gb, u64 cycles);
+
+// Write the battery RAM changed since the last flush to the save file now
+void gb_flush_save(GameBoy *gb);
+
+// ---------------------------------------------
+// Save States (savestate.c)
+// ---------------------------------------------
+// A state is a self-describing binary blob (header, version, tagged
+// sections), the same in memory & on disk. It holds everything but the
+// ROM, which it names by hash: it only loads into a machine running the
+// same ROM. Neither call allocates, so taking one every frame is cheap.
+#define GB_STATE_VERSION 1
+
+typedef enum {
+    GB_STATE_OK          = 0,
+    GB_STATE_BAD_MAGIC   = -1, // Not a BareDMG save state
+    GB_STATE_BAD_VERSION = -2, // Format version this build can't read
+    GB_STATE_WRONG_ROM   = -3, // Taken with a different ROM
+    GB_STATE_CORRUPT     = -4, // Truncated or malformed
+} GbStateResult;
+
+// Bytes gb_save_state() needs for this machine (fixed once a ROM is loaded)
+size_t gb_state_size(const GameBoy *gb);
+
+// Write a state to buf. Returns the bytes written, 0 if `size` is too small.
+size_t gb_save_state(const GameBoy *gb, void *buf, size_t size);
+
+// Restore a state (GbStateResult). On failure the machine is left untouched.
+int    gb_load_state(GameBoy *gb, const void *buf, size_t size);
 
 // ---------------------------------------------
 // I/O Handlers (called by MMU)
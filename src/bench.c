@@ -0,0 +1,356 @@
+// src/bench.c
+// baredmg-bench: headless throughput of the core on real ROMs
+#include <gbemu.h>
+#include <core/trace.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+Each ROM is loaded fresh for every repetition, run for a warm-up, then
+timed frame by frame with gb_run_frame(). Input comes from a fixed script
+(bench_script) so every run of a ROM executes the same guest code, whatever
+the host. Frame times of all repetitions are pooled for the percentiles;
+rates are over the total timed run.
+*/
+
+#define MAX_ROMS 64
+#define PROFILE_DEFAULT_PATH "baredmg-profile.json"
+
+#ifdef BAREDMG_PROFILE
+// Every timed frame of every ROM (profiling builds)
+static Profile bench_profile;
+#endif
+
+// Held keys for `frames` frames, then the next step; the script loops.
+// Start & A get through most title screens & menus, the d-pad moves about.
+typedef struct {
+    u16 frames;
+    u8  buttons;
+} BenchStep;
+
+static const BenchStep bench_script[] = {
+    {60, 0},
+    {6, JOYPAD_START},
+    {30, 0},
+    {6, JOYPAD_A},
+    {30, 0},
+    {6, JOYPAD_START},
+    {20, 0},
+    {40, JOYPAD_RIGHT},
+    {10, JOYPAD_RIGHT | JOYPAD_A},
+    {30, JOYPAD_LEFT},
+    {6, JOYPAD_B},
+    {20, JOYPAD_UP},
+    {20, JOYPAD_DOWN},
+    {6, JOYPAD_A},
+};
+
+#define BENCH_SCRIPT_STEPS (sizeof(bench_script) / sizeof(bench_script[0]))
+
+typedef struct {
+    u64 frames; // Timed frames, all repetitions
+    u64 cycles;
+    u64 instructions;
+    u64 idle_cycles; // CPU in HALT/STOP (skipped to the next event)
+    u64 idle_skips;  // Times it skipped
+    u64 ns;          // Total timed host time
+    u64 p50_ns;      // Frame time percentiles
+    u64 p99_ns;
+    u64 best_ns;     // Fastest repetition
+} BenchResult;
+
+typedef struct {
+    u64         frames;
+    u64         warmup;
+    int         reps;
+    bool        jit;
+    bool        decode; // Interpreter fetches through the decode cache
+    bool        ppu;
+    bool        apu;
+    bool        json;
+    const char *trace; // Record the timed frames to this file (NULL: no trace)
+} BenchOptions;
+
+// Print the user Instructions
+static void print_usage(const char *program_name) {
+    printf("Usage: %s [options] <rom> [<rom> ...]\n", program_name);
+    printf("\n");
+    printf("Options:\n");
+    printf("  -f <frames>      Timed frames per repetition (default: 3000)\n");
+    printf("  -w <frames>      Warm-up frames before timing (default: 300)\n");
+    printf("  -r <reps>        Repetitions, each from a fresh power-on (default: 5)\n");
+    printf("  --jit            Run the CPU through the x86-64 block JIT\n");
+    printf("  --decode-cache   Fetch instructions through the decode cache\n");
+    printf("  --no-ppu         Don't draw (LCD timing & interrupts stay)\n");
+    printf("  --no-apu         No sound synthesis (APU registers stay)\n");
+    printf("  --json           Print the results as JSON\n");
+    printf("  --trace <file>   Record the timed instructions (each rep overwrites it)\n");
+#ifdef BAREDMG_PROFILE
+    printf("  --profile <file> Where to write the guest profile of the timed frames\n");
+    printf("                   (default: " PROFILE_DEFAULT_PATH ")\n");
+#endif
+}
+
+static u64 now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ull + (u64)ts.tv_nsec;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    u64 x = *(const u64 *)a, y = *(const u64 *)b;
+    return (x > y) - (x < y);
+}
+
+// Keys the script holds at frame `frame`
+static u8 bench_buttons(u64 frame) {
+    static u64 period = 0;
+    if (!period)
+        for (size_t i = 0; i < BENCH_SCRIPT_STEPS; i++)
+            period += bench_script[i].frames;
+
+    u64 at = frame % period;
+    for (size_t i = 0; i < BENCH_SCRIPT_STEPS; i++) {
+        if (at < bench_script[i].frames)
+            return bench_script[i].buttons;
+        at -= bench_script[i].frames;
+    }
+    return 0;
+}
+
+// Run one ROM `reps` times; false if it doesn't load
+static bool bench_rom(RomImage *image, const BenchOptions *opt, BenchResult *res) {
+    GameBoy *gb    = malloc(sizeof(GameBoy));
+    u64     *times = malloc(opt->frames * (size_t)opt->reps * sizeof(u64));
+
+    memset(res, 0, sizeof(*res));
+    if (!gb || !times) {
+        free(gb);
+        free(times);
+        return false;
+    }
+
+    for (int rep = 0; rep < opt->reps; rep++) {
+        gb_init(gb);
+        gb->jit_enabled    = opt->jit;
+        gb->decode_enabled = opt->decode;
+        ppu_set_drawing(gb, opt->ppu);
+        apu_set_mode(gb, opt->apu ? APU_MODE_FULL : APU_MODE_REGISTERS);
+        if (!gb_load_rom_image(gb, image)) {
+            free(gb);
+            free(times);
+            return false;
+        }
+
+        u64 frame = 0;
+        for (; frame < opt->warmup; frame++) {
+            joypad_set_buttons(gb, bench_buttons(frame));
+            gb_run_frame(gb);
+        }
+
+#ifdef BAREDMG_PROFILE
+        memset(&gb->profile, 0, sizeof(gb->profile)); // Count only the timed frames
+#endif
+        if (opt->trace && !trace_start(gb, opt->trace)) {
+            gb_unload(gb);
+            free(gb);
+            free(times);
+            return false;
+        }
+        u64 cycles       = gb->cycles;
+        u64 instructions = gb->cpu.instructions;
+        u64 idle_cycles  = gb->cpu.idle_cycles;
+        u64 idle_skips   = gb->cpu.idle_skips;
+        u64 start        = now_ns();
+        u64 *rep_times   = times + (size_t)rep * opt->frames;
+
+        for (u64 i = 0; i < opt->frames; i++, frame++) {
+            u64 t = now_ns();
+            joypad_set_buttons(gb, bench_buttons(frame));
+            gb_run_frame(gb);
+            rep_times[i] = now_ns() - t;
+        }
+
+        u64 ns             = now_ns() - start;
+        if (!trace_stop(gb))
+            fprintf(stderr, "Failed to write the trace: %s\n", opt->trace);
+        res->frames       += opt->frames;
+        res->cycles       += gb->cycles - cycles;
+        res->instructions += gb->cpu.instructions - instructions;
+        res->idle_cycles  += gb->cpu.idle_cycles - idle_cycles;
+        res->idle_skips   += gb->cpu.idle_skips - idle_skips;
+        res->ns           += ns;
+        if (!res->best_ns || ns < res->best_ns)
+            res->best_ns = ns;
+#ifdef BAREDMG_PROFILE
+        profile_add(&bench_profile, &gb->profile);
+#endif
+        gb_unload(gb);
+    }
+
+    qsort(times, res->frames, sizeof(u64), cmp_u64);
+    res->p50_ns = times[res->frames / 2];
+    res->p99_ns = times[res->frames * 99 / 100];
+
+    free(times);
+    free(gb);
+    return true;
+}
+
+// ---------------------------------------------
+// Output
+// ---------------------------------------------
+
+static double per_s(u64 count, u64 ns) {
+    return ns ? (double)count * 1e9 / (double)ns : 0.0;
+}
+
+static double percent(u64 part, u64 whole) {
+    return whole ? (double)part * 100.0 / (double)whole : 0.0;
+}
+
+static double per_frame(u64 count, const BenchResult *res) {
+    return res->frames ? (double)count / (double)res->frames : 0.0;
+}
+
+static void print_human(const char *path, const BenchOptions *opt, const BenchResult *res) {
+    double fps = per_s(res->frames, res->ns);
+
+    printf("%s\n", path);
+    printf("  %10.1f frames/s  (%.1fx real time, best rep %.1f frames/s)\n", fps,
+           fps * CYCLES_PER_FRAME / CPU_CLOCK_HZ, per_s(opt->frames, res->best_ns));
+    printf("  %10.2f emulated MHz\n", per_s(res->cycles, res->ns) / 1e6);
+    printf("  %10.2f M guest instructions/s\n", per_s(res->instructions, res->ns) / 1e6);
+    printf("  %10llu ns/frame p50, %llu ns p99\n", (unsigned long long)res->p50_ns,
+           (unsigned long long)res->p99_ns);
+    printf("  %10.1f%% idle (HALT/STOP), %.1f skips & %.0f idle cycles per frame\n",
+           percent(res->idle_cycles, res->cycles), per_frame(res->idle_skips, res),
+           per_frame(res->idle_cycles, res));
+}
+
+static void print_json(const char *path, const BenchResult *res, bool first) {
+    // Paths are printed as given, with quotes & backslashes escaped
+    printf("%s\n    {\"rom\": \"", first ? "" : ",");
+    for (const char *c = path; *c; c++) {
+        if (*c == '"' || *c == '\\')
+            putchar('\\');
+        putchar(*c);
+    }
+    printf("\", \"frames\": %llu, \"cycles\": %llu, \"instructions\": %llu, \"ns\": %llu,\n",
+           (unsigned long long)res->frames, (unsigned long long)res->cycles,
+           (unsigned long long)res->instructions, (unsigned long long)res->ns);
+    printf("     \"fps\": %.2f, \"emulated_mhz\": %.4f, \"instructions_per_s\": %.0f,\n",
+           per_s(res->frames, res->ns), per_s(res->cycles, res->ns) / 1e6,
+           per_s(res->instructions, res->ns));
+    printf("     \"idle_cycles\": %llu, \"idle_skips\": %llu, \"idle_percent\": %.2f, "
+           "\"idle_skips_per_frame\": %.2f,\n",
+           (unsigned long long)res->idle_cycles, (unsigned long long)res->idle_skips,
+           percent(res->idle_cycles, res->cycles), per_frame(res->idle_skips, res));
+    printf("     \"frame_ns_p50\": %llu, \"frame_ns_p99\": %llu}", (unsigned long long)res->p50_ns,
+           (unsigned long long)res->p99_ns);
+}
+
+int main(int argc, char *argv[]) {
+    const char  *paths[MAX_ROMS];
+    const char  *profile_path = PROFILE_DEFAULT_PATH;
+    int          rom_count    = 0;
+    BenchOptions opt          = {3000, 300, 5, false, false, true, true, false, NULL};
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg     = argv[i];
+        bool        has_val = i + 1 < argc;
+
+        if (strcmp(arg, "-f") == 0 && has_val)
+            opt.frames = strtoull(argv[++i], NULL, 0);
+        else if (strcmp(arg, "-w") == 0 && has_val)
+            opt.warmup = strtoull(argv[++i], NULL, 0);
+        else if (strcmp(arg, "-r") == 0 && has_val)
+            opt.reps = (int)strtol(argv[++i], NULL, 0);
+        else if (strcmp(arg, "--jit") == 0)
+            opt.jit = cpu_jit_available();
+        else if (strcmp(arg, "--decode-cache") == 0)
+            opt.decode = true;
+        else if (strcmp(arg, "--no-ppu") == 0)
+            opt.ppu = false;
+        else if (strcmp(arg, "--no-apu") == 0)
+            opt.apu = false;
+        else if (strcmp(arg, "--json") == 0)
+            opt.json = true;
+        else if (strcmp(arg, "--trace") == 0 && has_val)
+            opt.trace = argv[++i];
+#ifdef BAREDMG_PROFILE
+        else if (strcmp(arg, "--profile") == 0 && has_val)
+            profile_path = argv[++i];
+#endif
+        else if (arg[0] == '-' || rom_count == MAX_ROMS) {
+            print_usage(argv[0]);
+            return -2;
+        }
+        else
+            paths[rom_count++] = arg;
+    }
+
+    if (rom_count == 0) {
+        fprintf(stderr, "Error: No ROM file specified\n\n");
+        print_usage(argv[0]);
+        return -2;
+    }
+
+    if (opt.frames == 0 || opt.reps <= 0) {
+        fprintf(stderr, "Error: Need at least 1 timed frame & 1 repetition (-f %llu, -r %d)\n\n",
+                (unsigned long long)opt.frames, opt.reps);
+        print_usage(argv[0]);
+        return -2;
+    }
+
+    if (opt.json)
+        printf("{\"frames\": %llu, \"warmup\": %llu, \"reps\": %d, \"jit\": %s, "
+               "\"decode_cache\": %s, \"ppu\": %s, \"apu\": %s,\n  \"results\": [",
+               (unsigned long long)opt.frames, (unsigned long long)opt.warmup, opt.reps,
+               opt.jit ? "true" : "false", opt.decode ? "true" : "false",
+               opt.ppu ? "true" : "false", opt.apu ? "true" : "false");
+    else
+        printf("%llu frames x %d reps after %llu warm-up frames (jit %s, decode cache %s, ppu %s, "
+               "apu %s)\n\n",
+               (unsigned long long)opt.frames, opt.reps, (unsigned long long)opt.warmup,
+               opt.jit ? "on" : "off", opt.decode ? "on" : "off", opt.ppu ? "on" : "off",
+               opt.apu ? "on" : "off");
+
+    int failed = 0;
+    for (int r = 0; r < rom_count; r++) {
+        RomImage   *image;
+        BenchResult res;
+
+        // Loaded from the image: no save file is read or written
+        if (rom_store_open(paths[r], &image) != 0) {
+            fprintf(stderr, "Failed to read ROM: %s\n", paths[r]);
+            failed++;
+            continue;
+        }
+        bool ok = bench_rom(image, &opt, &res);
+        rom_store_release(image);
+        if (!ok) {
+            fprintf(stderr, "Failed to run ROM: %s\n", paths[r]);
+            failed++;
+            continue;
+        }
+
+        if (opt.json)
+            print_json(paths[r], &res, r - failed == 0);
+        else
+            print_human(paths[r], &opt, &res);
+    }
+
+    if (opt.json)
+        printf("\n  ]}\n");
+
+#ifdef BAREDMG_PROFILE
+    if (profile_save_json(&bench_profile, profile_path) != 0)
+        fprintf(stderr, "Failed to write the profile: %s\n", profile_path);
+#else
+    (void)profile_path;
+#endif
+    return failed ? -3 : 0;
+}
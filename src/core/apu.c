@@ -0,0 +1,773 @@
+// src/core/apu.c
+#include <core/apu.h>
+#include <gbemu.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+Band-limited APU
+
+Nothing here runs per cycle. Each channel keeps the cycle of its next
+waveform step (ApuChannel.next), and apu_sync() brings all four up to the
+current cycle in jumps from one step to the next, running the frame
+sequencer (length, sweep, envelope) at its own steps in between. A sync
+happens on every APU register write, on NR52 reads & at the end of each
+gb_run_frame(); a 440 Hz square costs 3520 steps a second, not 4 million
+ticks. A channel that can't be heard (volume 0) skips its steps
+arithmetically.
+
+Output: a step only matters when the channel's level changes. Each change
+is added to the blip buffer as an amplitude delta at its exact cycle,
+spread over APU_BLIP_TAPS samples by a band-limited step kernel (windowed
+sinc, APU_BLIP_PHASES sub-sample positions). At the end of the frame the
+buffer is integrated into samples at the output rate, high-passed like the
+hardware's output capacitor & handed to the audio ring. No resampling pass,
+no aliasing from square edges, & the cost scales with edges, not cycles.
+
+The ring (AudioRing) is a single-producer/single-consumer queue: the
+emulation thread writes once per frame, the audio callback reads. Both
+sides only load the other's index (acquire) & store their own (release),
+so the callback never locks, waits or allocates; when the ring runs dry it
+plays silence.
+
+Register mode (APU_MODE_REGISTERS) keeps only what the CPU can observe:
+the registers, NR52's status bits & the frame sequencer state behind them
+(length timers, envelope volumes, sweep). Waveform steps, levels, the blip
+buffer & the ring are left alone, and the end of a frame doesn't sync:
+the frame sequencer catches up on the next register access, with its
+steps at the same cycles as in full mode.
+
+Simplifications: no "zombie" envelope writes, wave RAM reads while channel
+3 plays return the written byte, & a silent noise channel doesn't advance
+its LFSR.
+*/
+
+// Register indexes (addr - APU_REG_FIRST); channel c's NRc0 is at c * 5
+enum {
+    NR10 = 0x00,
+    NR11 = 0x01,
+    NR12 = 0x02,
+    NR13 = 0x03,
+    NR14 = 0x04,
+    NR21 = 0x06,
+    NR30 = 0x0A,
+    NR31 = 0x0B,
+    NR32 = 0x0C,
+    NR41 = 0x10,
+    NR43 = 0x12,
+    NR50 = 0x14,
+    NR51 = 0x15,
+    NR52 = 0x16,
+    WAVE = 0x20,
+};
+
+#define NRX4_TRIGGER BIT(7)
+#define NRX4_LENGTH BIT(6)
+
+#define APU_NO_STEP UINT64_MAX // ApuChannel.next of a channel that isn't clocked
+
+// Longest stretch the blip buffer takes between two ends (samples fit at any rate)
+#define APU_BLIP_MAX_CYCLES CYCLES_PER_FRAME
+#define APU_OUTPUT_SCALE 64.0f // Mix units (4 channels x 15 x volume 8) to i16
+
+// Bits that read back as 1 (write-only & unused bits), NR10 - NR52
+static const u8 apu_read_mask[WAVE] = {
+    0x80, 0x3F, 0x00, 0xFF, 0xBF, // NR10 - NR14
+    0xFF, 0x3F, 0x00, 0xFF, 0xBF, // NR20 - NR24
+    0x7F, 0xFF, 0x9F, 0xFF, 0xBF, // NR30 - NR34
+    0xFF, 0xFF, 0x00, 0x00, 0xBF, // NR40 - NR44
+    0x00, 0x00, 0x70,             // NR50 - NR52
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+// Pulse waveforms: 12.5%, 25%, 50% & 75% duty, one bit per duty step
+static const u8 apu_duty[4] = {0x01, 0x81, 0x87, 0x7E};
+
+// ---------------------------------------------
+// Audio Ring
+// ---------------------------------------------
+
+bool audio_ring_init(AudioRing *ring, u32 frames) {
+    u32 capacity = 1;
+    while (capacity < frames)
+        capacity <<= 1;
+
+    memset(ring, 0, sizeof(*ring));
+    ring->data = calloc(capacity, 2 * sizeof(i16));
+    if (!ring->data)
+        return false;
+    ring->capacity = capacity;
+    return true;
+}
+
+void audio_ring_free(AudioRing *ring) {
+    free(ring->data);
+    memset(ring, 0, sizeof(*ring));
+}
+
+u32 audio_ring_write(AudioRing *ring, const i16 *samples, u32 frames) {
+    u32 head = ring->head;
+    u32 tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    u32 room = ring->capacity - (head - tail);
+    u32 n    = frames < room ? frames : room;
+
+    // Up to the end of the buffer, then from the start
+    u32 at    = head & (ring->capacity - 1);
+    u32 first = ring->capacity - at < n ? ring->capacity - at : n;
+    memcpy(ring->data + 2 * at, samples, first * 2 * sizeof(i16));
+    memcpy(ring->data, samples + 2 * first, (n - first) * 2 * sizeof(i16));
+
+    ring->dropped += frames - n;
+    __atomic_store_n(&ring->head, head + n, __ATOMIC_RELEASE);
+    return n;
+}
+
+u32 audio_ring_read(AudioRing *ring, i16 *out, u32 frames) {
+    u32 tail  = ring->tail;
+    u32 head  = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    u32 avail = head - tail;
+    u32 n     = frames < avail ? frames : avail;
+
+    u32 at    = tail & (ring->capacity - 1);
+    u32 first = ring->capacity - at < n ? ring->capacity - at : n;
+    memcpy(out, ring->data + 2 * at, first * 2 * sizeof(i16));
+    memcpy(out + 2 * first, ring->data, (n - first) * 2 * sizeof(i16));
+    memset(out + 2 * n, 0, (frames - n) * 2 * sizeof(i16));
+
+    ring->silence += frames - n;
+    __atomic_store_n(&ring->tail, tail + n, __ATOMIC_RELEASE);
+    return n;
+}
+
+u32 audio_ring_available(AudioRing *ring) {
+    u32 tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - tail;
+}
+
+// ---------------------------------------------
+// Blip Buffer
+// ---------------------------------------------
+
+// Band-limited impulse per sub-sample phase, each summing to 1: a delta
+// added with it integrates to a clean step. Shared by every instance.
+static float          blip_kernel[APU_BLIP_PHASES][APU_BLIP_TAPS];
+static pthread_once_t blip_kernel_once = PTHREAD_ONCE_INIT;
+
+static void blip_init_kernel(void) {
+    const double pi     = 3.14159265358979323846;
+    const double cutoff = 0.45; // Of the output rate, just under Nyquist
+
+    for (int phase = 0; phase < APU_BLIP_PHASES; phase++) {
+        double taps[APU_BLIP_TAPS];
+        double sum = 0;
+
+        for (int i = 0; i < APU_BLIP_TAPS; i++) {
+            // Distance from the step, in samples (-TAPS / 2, TAPS / 2]
+            double x    = i - APU_BLIP_TAPS / 2 + 1 - (double)phase / APU_BLIP_PHASES;
+            double sinc = x == 0 ? 2 * cutoff : sin(2 * pi * cutoff * x) / (pi * x);
+            double win  = 0.42 + 0.5 * cos(2 * pi * x / APU_BLIP_TAPS) +
+                         0.08 * cos(4 * pi * x / APU_BLIP_TAPS); // Blackman
+            taps[i]     = sinc * win;
+            sum        += taps[i];
+        }
+        for (int i = 0; i < APU_BLIP_TAPS; i++)
+            blip_kernel[phase][i] = (float)(taps[i] / sum);
+    }
+}
+
+// Add an amplitude step of (left, right) at cycle t
+static void blip_add(Apu *apu, u64 t, float left, float right) {
+    u64          pos = apu->blip_frac + (t - apu->blip_start) * apu->blip_step;
+    const float *k   = blip_kernel[(pos >> (32 - APU_BLIP_PHASE_BITS)) & (APU_BLIP_PHASES - 1)];
+    float       *l   = apu->blip[0] + (pos >> 32);
+    float       *r   = apu->blip[1] + (pos >> 32);
+
+    for (int i = 0; i < APU_BLIP_TAPS; i++) {
+        l[i] += left * k[i];
+        r[i] += right * k[i];
+    }
+}
+
+// Turn everything before cycle `end` into samples & send them to the ring
+static void blip_end(Apu *apu, u64 end) {
+    u64 pos   = apu->blip_frac + (end - apu->blip_start) * apu->blip_step;
+    u32 count = (u32)(pos >> 32);
+    i16 out[APU_BLIP_SIZE * 2];
+
+    for (u32 i = 0; i < count; i++) {
+        for (int side = 0; side < 2; side++) {
+            apu->blip_sum[side] += apu->blip[side][i];
+
+            // The output capacitor slowly takes on the DC level
+            float y              = apu->blip_sum[side] - apu->blip_cap[side];
+            apu->blip_cap[side]  = apu->blip_sum[side] - y * apu->blip_charge;
+
+            float s = y * APU_OUTPUT_SCALE;
+            out[i * 2 + side] = (i16)(s > 32767.0f ? 32767 : s < -32768.0f ? -32768 : s);
+        }
+    }
+
+    // The kernel tails of the last steps carry over
+    for (int side = 0; side < 2; side++) {
+        memmove(apu->blip[side], apu->blip[side] + count, APU_BLIP_TAPS * sizeof(float));
+        memset(apu->blip[side] + APU_BLIP_TAPS, 0, count * sizeof(float));
+    }
+
+    apu->blip_start  = end;
+    apu->blip_frac   = (u32)pos;
+    apu->samples    += count;
+    if (apu->ring && count)
+        audio_ring_write(apu->ring, out, count);
+}
+
+// ---------------------------------------------
+// Channels
+// ---------------------------------------------
+
+// Output level of one side (0 left, 1 right) for the current channel outputs
+static float apu_mix(const Apu *apu, int side) {
+    u8  nr50   = apu->regs[NR50];
+    u8  nr51   = apu->regs[NR51];
+    u8  volume = (side ? nr50 : nr50 >> 4) & 7;
+    int sum    = 0;
+
+    for (int c = 0; c < 4; c++)
+        if (CHECK_BIT(nr51, side ? c : 4 + c))
+            sum += apu->ch[c].out;
+    return (float)(sum * (volume + 1));
+}
+
+// Digital output (0 - 15) of channel c at its current step
+static u8 apu_level(const Apu *apu, int c) {
+    const ApuChannel *ch = &apu->ch[c];
+
+    if (!ch->enabled)
+        return 0;
+
+    switch (c) {
+        case 0:
+        case 1:
+            return CHECK_BIT(apu_duty[apu->regs[c * 5 + 1] >> 6], ch->pos) ? ch->volume : 0;
+        case 2: {
+            u8 byte  = apu->regs[WAVE + ch->pos / 2];
+            u8 level = (ch->pos & 1) ? (byte & 0x0F) : (byte >> 4);
+            u8 shift = (apu->regs[NR32] >> 5) & 3; // 0: mute, 1: 100%, 2: 50%, 3: 25%
+            return shift ? level >> (shift - 1) : 0;
+        }
+        default:
+            return (ch->lfsr & 1) ? 0 : ch->volume;
+    }
+}
+
+// Change channel c's output at cycle t
+static void apu_output(Apu *apu, int c, u64 t, u8 out) {
+    ApuChannel *ch = &apu->ch[c];
+    if (out == ch->out || apu->mode != APU_MODE_FULL)
+        return;
+
+    int delta = out - ch->out;
+    u8  nr50  = apu->regs[NR50];
+    u8  nr51  = apu->regs[NR51];
+    ch->out   = out;
+
+    float left  = CHECK_BIT(nr51, 4 + c) ? (float)(delta * (((nr50 >> 4) & 7) + 1)) : 0;
+    float right = CHECK_BIT(nr51, c) ? (float)(delta * ((nr50 & 7) + 1)) : 0;
+    if (left != 0 || right != 0)
+        blip_add(apu, t, left, right);
+}
+
+static void apu_refresh(Apu *apu, int c, u64 t) {
+    apu_output(apu, c, t, apu_level(apu, c));
+}
+
+static void apu_disable(Apu *apu, int c, u64 t) {
+    apu->ch[c].enabled = false;
+    apu_output(apu, c, t, 0);
+}
+
+// Cycles between two waveform steps of channel c (0: not clocked)
+static u32 apu_step_cycles(const Apu *apu, int c) {
+    switch (c) {
+        case 0:
+        case 1:
+            return (2048 - apu->ch[c].period) * 4;
+        case 2:
+            return (2048 - apu->ch[c].period) * 2;
+        default: {
+            u8 nr43    = apu->regs[NR43];
+            u8 shift   = nr43 >> 4;
+            u8 divider = nr43 & 7;
+            if (shift >= 14)
+                return 0;
+            return (u32)(divider ? divider * 16 : 8) << shift;
+        }
+    }
+}
+
+// Whether channel c's steps can change what it outputs
+static bool apu_audible(const Apu *apu, int c) {
+    if (c == 2)
+        return (apu->regs[NR32] & 0x60) != 0;
+    return apu->ch[c].volume != 0;
+}
+
+// Run channel c's waveform steps up to cycle `until`
+static void apu_run_channel(Apu *apu, int c, u64 until) {
+    ApuChannel *ch = &apu->ch[c];
+
+    if (!ch->enabled || ch->next > until)
+        return;
+
+    u32 period = apu_step_cycles(apu, c);
+    if (!period) {
+        ch->next = APU_NO_STEP;
+        return;
+    }
+
+    // Nothing to hear: skip to the last step (the noise LFSR stays put)
+    if (!apu_audible(apu, c)) {
+        u64 steps  = (until - ch->next) / period + 1;
+        ch->pos    = (u8)((ch->pos + steps) & (c == 2 ? 31 : 7));
+        ch->next  += steps * period;
+        return;
+    }
+
+    for (; ch->next <= until; ch->next += period) {
+        if (c == 3) {
+            u16 bit  = (ch->lfsr ^ (ch->lfsr >> 1)) & 1;
+            ch->lfsr = (u16)((ch->lfsr >> 1) | (bit << 14));
+            if (apu->regs[NR43] & 0x08) // 7-bit mode
+                ch->lfsr = (u16)((ch->lfsr & ~0x40) | (bit << 6));
+        } else {
+            ch->pos = (ch->pos + 1) & (c == 2 ? 31 : 7);
+        }
+        apu_refresh(apu, c, ch->next);
+    }
+}
+
+// Run the channels up to cycle `until`, ending blip frames on the way if needed
+static void apu_run(Apu *apu, u64 until) {
+    if (until <= apu->synced)
+        return;
+    if (apu->mode != APU_MODE_FULL) {
+        apu->synced = until; // Nothing between frame sequencer steps to see
+        return;
+    }
+
+    while (until - apu->blip_start > APU_BLIP_MAX_CYCLES) {
+        u64 mid = apu->blip_start + APU_BLIP_MAX_CYCLES;
+        for (int c = 0; c < 4; c++)
+            apu_run_channel(apu, c, mid);
+        blip_end(apu, mid);
+    }
+
+    for (int c = 0; c < 4; c++)
+        apu_run_channel(apu, c, until);
+    apu->synced = until;
+}
+
+// ---------------------------------------------
+// Frame Sequencer
+// ---------------------------------------------
+
+static void apu_clock_length(Apu *apu, int c, u64 t) {
+    ApuChannel *ch = &apu->ch[c];
+
+    if ((apu->regs[c * 5 + 4] & NRX4_LENGTH) && ch->length && --ch->length == 0)
+        apu_disable(apu, c, t);
+}
+
+static void apu_clock_envelope(Apu *apu, int c, u64 t) {
+    ApuChannel *ch   = &apu->ch[c];
+    u8          nrx2 = apu->regs[c * 5 + 2];
+    u8          pace = nrx2 & 7;
+
+    if (!ch->enabled || !pace)
+        return;
+    if (ch->env_timer > 1) {
+        ch->env_timer--;
+        return;
+    }
+
+    ch->env_timer = pace;
+    if ((nrx2 & 0x08) && ch->volume < 15)
+        ch->volume++;
+    else if (!(nrx2 & 0x08) && ch->volume > 0)
+        ch->volume--;
+    apu_refresh(apu, c, t);
+}
+
+// Next sweep period; past 2047 channel 1 stops
+static u16 apu_sweep_calc(Apu *apu, u64 t) {
+    u8  nr10   = apu->regs[NR10];
+    u16 delta  = apu->sweep_shadow >> (nr10 & 7);
+    u16 period = apu->sweep_shadow + delta;
+
+    if (nr10 & 0x08) {
+        period             = apu->sweep_shadow - delta;
+        apu->sweep_negated = true;
+    }
+    if (period > 2047)
+        apu_disable(apu, 0, t);
+    return period;
+}
+
+static void apu_clock_sweep(Apu *apu, u64 t) {
+    u8 nr10 = apu->regs[NR10];
+    u8 pace = (nr10 >> 4) & 7;
+
+    if (apu->sweep_timer > 1) {
+        apu->sweep_timer--;
+        return;
+    }
+
+    apu->sweep_timer = pace ? pace : 8;
+    if (!apu->sweep_on || !pace || !apu->ch[0].enabled)
+        return;
+
+    u16 period = apu_sweep_calc(apu, t);
+    if (period <= 2047 && (nr10 & 7)) {
+        apu->sweep_shadow = period;
+        apu->ch[0].period = period;
+        apu->regs[NR13]   = (u8)period;
+        apu->regs[NR14]   = (u8)((apu->regs[NR14] & ~7) | (period >> 8));
+        apu_sweep_calc(apu, t); // Checked again with the new period
+    }
+}
+
+// Frame sequencer step at cycle t: length 256 Hz, sweep 128 Hz, envelope 64 Hz
+static void apu_frame_step(Apu *apu, u64 t) {
+    u8 step      = apu->fs_step;
+    apu->fs_step = (step + 1) & 7;
+
+    if (!(apu->regs[NR52] & NR52_POWER))
+        return;
+
+    if (!(step & 1))
+        for (int c = 0; c < 4; c++)
+            apu_clock_length(apu, c, t);
+    if (step == 2 || step == 6)
+        apu_clock_sweep(apu, t);
+    if (step == 7) {
+        apu_clock_envelope(apu, 0, t);
+        apu_clock_envelope(apu, 1, t);
+        apu_clock_envelope(apu, 3, t);
+    }
+}
+
+// ---------------------------------------------
+// Sync & Output
+// ---------------------------------------------
+
+void apu_sync(GameBoy *gb) {
+    Apu *apu = &gb->apu;
+    u64  now = gb->cycles;
+
+    while (apu->fs_next <= now) {
+        apu_run(apu, apu->fs_next);
+        apu_frame_step(apu, apu->fs_next);
+        apu->fs_next += APU_FRAME_SEQ_CYCLES;
+    }
+    apu_run(apu, now);
+}
+
+void apu_end_frame(GameBoy *gb) {
+    if (gb->apu.mode != APU_MODE_FULL)
+        return; // No samples; registers catch up when read
+    apu_sync(gb);
+    blip_end(&gb->apu, gb->apu.synced);
+}
+
+void apu_div_reset(GameBoy *gb) {
+    Apu *apu = &gb->apu;
+
+    apu_sync(gb);
+    if (CHECK_BIT(gb->cycles - gb->timer.div_base, 12))
+        apu_frame_step(apu, gb->cycles);
+    apu->fs_next = gb->cycles + APU_FRAME_SEQ_CYCLES;
+}
+
+void apu_restart_output(GameBoy *gb) {
+    Apu *apu = &gb->apu;
+
+    pthread_once(&blip_kernel_once, blip_init_kernel);
+
+    // Levels & steps weren't kept up in register mode (or came from one)
+    for (int c = 0; c < 4; c++) {
+        ApuChannel *ch = &apu->ch[c];
+        if (ch->enabled && ch->next <= apu->synced) {
+            u32 period = apu_step_cycles(apu, c);
+            ch->next   = period ? apu->synced + period : APU_NO_STEP;
+        }
+        ch->out = apu_level(apu, c);
+    }
+
+    apu->blip_step   = ((u64)apu->sample_rate << 32) / CPU_CLOCK_HZ;
+    apu->blip_charge = (float)pow(0.999958, (double)CPU_CLOCK_HZ / apu->sample_rate);
+    apu->blip_start  = apu->synced;
+    apu->blip_frac   = 0;
+    memset(apu->blip, 0, sizeof(apu->blip));
+
+    // Pick up at the current level, with the capacitor already charged to it
+    for (int side = 0; side < 2; side++) {
+        apu->blip_sum[side] = apu_mix(apu, side);
+        apu->blip_cap[side] = apu->blip_sum[side];
+    }
+}
+
+void apu_set_mode(GameBoy *gb, ApuMode mode) {
+    Apu *apu = &gb->apu;
+
+    if (mode == apu->mode)
+        return;
+
+    if (gb->running) {
+        apu_end_frame(gb); // Whatever was synthesized goes out
+        apu_sync(gb);
+    }
+    apu->mode = mode;
+    if (mode == APU_MODE_FULL)
+        apu_restart_output(gb);
+}
+
+void apu_set_output(GameBoy *gb, u32 sample_rate, AudioRing *ring) {
+    Apu *apu = &gb->apu;
+
+    // What was synthesized so far goes out at the old rate
+    if (gb->running)
+        apu_end_frame(gb);
+
+    if (!sample_rate)
+        sample_rate = APU_SAMPLE_RATE;
+    apu->sample_rate = sample_rate < APU_MAX_SAMPLE_RATE ? sample_rate : APU_MAX_SAMPLE_RATE;
+    apu->ring        = ring;
+    apu_restart_output(gb);
+}
+
+void apu_reset(GameBoy *gb) {
+    // Registers as the boot ROM leaves them (it just played channel 1)
+    static const u8 post_boot[NR52 + 1] = {
+        0x80, 0xBF, 0xF3, 0xFF, 0xBF, // NR10 - NR14
+        0xFF, 0x3F, 0x00, 0xFF, 0xBF, // NR20 - NR24
+        0x7F, 0xFF, 0x9F, 0xFF, 0xBF, // NR30 - NR34
+        0xFF, 0xFF, 0x00, 0x00, 0xBF, // NR40 - NR44
+        0x77, 0xF3, 0xF1,             // NR50 - NR52
+    };
+    Apu *apu = &gb->apu;
+
+    memset(apu->regs, 0, sizeof(apu->regs));
+    memcpy(apu->regs, post_boot, sizeof(post_boot));
+    memset(apu->ch, 0, sizeof(apu->ch));
+
+    for (int c = 0; c < 4; c++) {
+        apu->ch[c].lfsr = 0x7FFF;
+        apu->ch[c].next = APU_NO_STEP;
+    }
+    for (int c = 0; c < 3; c++)
+        apu->ch[c].period = 0x7FF;
+
+    // Channel 1 is still on, its envelope down to 0
+    apu->ch[0].enabled = true;
+    apu->ch[0].dac     = true;
+    apu->ch[0].length  = 64 - (post_boot[NR11] & 0x3F);
+    apu->ch[0].next    = gb->cycles + apu_step_cycles(apu, 0);
+
+    apu->sweep_timer   = 8;
+    apu->sweep_on      = false;
+    apu->sweep_negated = false;
+    apu->sweep_shadow  = 0x7FF;
+
+    // Steps fall on DIV bit 12 edges
+    u64 counter  = gb->cycles - gb->timer.div_base;
+    apu->synced  = gb->cycles;
+    apu->fs_next = gb->cycles + APU_FRAME_SEQ_CYCLES - counter % APU_FRAME_SEQ_CYCLES;
+    apu->fs_step = 0;
+    apu->samples = 0;
+
+    if (!apu->sample_rate)
+        apu->sample_rate = APU_SAMPLE_RATE;
+    apu_restart_output(gb);
+}
+
+// ---------------------------------------------
+// Registers
+// ---------------------------------------------
+
+static void apu_trigger(Apu *apu, int c, u64 t) {
+    ApuChannel *ch   = &apu->ch[c];
+    u8          nrx4 = apu->regs[c * 5 + 4];
+
+    ch->enabled = ch->dac;
+
+    // An empty length timer restarts full (one less if the step that just
+    // passed was a length step: it counts the next one as well)
+    if (!ch->length) {
+        ch->length = c == 2 ? 256 : 64;
+        if ((nrx4 & NRX4_LENGTH) && (apu->fs_step & 1))
+            ch->length--;
+    }
+
+    u32 period = apu_step_cycles(apu, c);
+    ch->next   = period ? t + period : APU_NO_STEP;
+
+    if (c == 2) {
+        ch->pos = 0;
+    } else {
+        ch->volume    = apu->regs[c * 5 + 2] >> 4;
+        ch->env_timer = apu->regs[c * 5 + 2] & 7;
+    }
+    if (c == 3)
+        ch->lfsr = 0x7FFF;
+
+    if (c == 0) {
+        u8 nr10            = apu->regs[NR10];
+        u8 pace            = (nr10 >> 4) & 7;
+        apu->sweep_shadow  = ch->period;
+        apu->sweep_timer   = pace ? pace : 8;
+        apu->sweep_on      = pace || (nr10 & 7);
+        apu->sweep_negated = false;
+        if (nr10 & 7)
+            apu_sweep_calc(apu, t);
+    }
+}
+
+// NRx1 length bits (writable on DMG even while the APU is off)
+static void apu_write_length(Apu *apu, int c, u8 value) {
+    apu->ch[c].length = c == 2 ? 256 - value : 64 - (value & 0x3F);
+}
+
+static void apu_power(Apu *apu, bool on, u64 t) {
+    bool was_on = apu->regs[NR52] & NR52_POWER;
+
+    if (was_on && !on) {
+        // Everything but wave RAM & the length timers is cleared
+        for (int c = 0; c < 4; c++) {
+            apu_disable(apu, c, t);
+            apu->ch[c].dac    = false;
+            apu->ch[c].volume = 0;
+            apu->ch[c].pos    = 0;
+            if (c < 3)
+                apu->ch[c].period = 0;
+        }
+        memset(apu->regs, 0, NR52 + 1);
+        apu->sweep_on      = false;
+        apu->sweep_negated = false;
+    } else if (!was_on && on) {
+        apu->regs[NR52] = NR52_POWER;
+        apu->fs_step    = 0;
+    }
+}
+
+u8 apu_read(GameBoy *gb, u16 addr) {
+    Apu *apu = &gb->apu;
+    u16  reg = addr - APU_REG_FIRST;
+
+    if (reg >= APU_REG_COUNT)
+        return 0xFF;
+
+    if (reg == NR52) {
+        // Channels stop on their own (length, sweep): catch up first
+        apu_sync(gb);
+        u8 value = (apu->regs[NR52] & NR52_POWER) | apu_read_mask[NR52];
+        for (int c = 0; c < 4; c++)
+            if (apu->ch[c].enabled)
+                value |= BIT(c);
+        return value;
+    }
+
+    if (reg >= WAVE)
+        return apu->regs[reg];
+    return apu->regs[reg] | apu_read_mask[reg];
+}
+
+void apu_write(GameBoy *gb, u16 addr, u8 value) {
+    Apu *apu = &gb->apu;
+    u16  reg = addr - APU_REG_FIRST;
+
+    if (reg >= APU_REG_COUNT)
+        return;
+
+    // Everything up to this cycle ran with the old value
+    apu_sync(gb);
+    u64 t = apu->synced;
+
+    if (reg >= WAVE) {
+        apu->regs[reg] = value;
+        apu_refresh(apu, 2, t);
+        return;
+    }
+    if (reg == NR52) {
+        apu_power(apu, value & NR52_POWER, t);
+        return;
+    }
+    if (!(apu->regs[NR52] & NR52_POWER)) {
+        if (reg == NR11 || reg == NR21 || reg == NR31 || reg == NR41)
+            apu_write_length(apu, reg / 5, value);
+        return;
+    }
+    if (reg == NR50 || reg == NR51) {
+        float left  = apu_mix(apu, 0);
+        float right = apu_mix(apu, 1);
+        apu->regs[reg] = value;
+        if (apu->mode == APU_MODE_FULL)
+            blip_add(apu, t, apu_mix(apu, 0) - left, apu_mix(apu, 1) - right);
+        return;
+    }
+    if (reg > NR52)
+        return; // 0xFF27 - 0xFF2F: nothing there
+
+    int         c    = reg / 5;
+    ApuChannel *ch   = &apu->ch[c];
+    u8          old  = apu->regs[reg];
+    apu->regs[reg]   = value;
+
+    switch (reg % 5) {
+        case 0: // NR10 sweep, NR30 DAC
+            if (c == 0 && apu->sweep_negated && (old & 0x08) && !(value & 0x08))
+                apu_disable(apu, 0, t); // Leaving subtraction after one was used
+            if (c == 2) {
+                ch->dac = value & 0x80;
+                if (!ch->dac)
+                    apu_disable(apu, 2, t);
+            }
+            break;
+
+        case 1: // Length (& duty)
+            apu_write_length(apu, c, value);
+            break;
+
+        case 2: // Envelope & DAC (NR32: output level)
+            if (c != 2) {
+                ch->dac = (value & 0xF8) != 0;
+                if (!ch->dac)
+                    apu_disable(apu, c, t);
+            }
+            break;
+
+        case 3: // Period low (NR43: noise clock)
+            if (c < 3) {
+                ch->period = (u16)((ch->period & 0x700) | value);
+            } else if (ch->enabled && ch->next == APU_NO_STEP) {
+                u32 period = apu_step_cycles(apu, 3);
+                ch->next   = period ? t + period : APU_NO_STEP;
+            }
+            break;
+
+        case 4: // Period high, length enable & trigger
+            if (c < 3)
+                ch->period = (u16)((ch->period & 0xFF) | (value & 7) << 8);
+
+            // Enabling the length timer right after a length step clocks it once
+            if (!(old & NRX4_LENGTH) && (value & NRX4_LENGTH) && (apu->fs_step & 1) &&
+                ch->length && --ch->length == 0 && !(value & NRX4_TRIGGER))
+                apu_disable(apu, c, t);
+
+            if (value & NRX4_TRIGGER)
+                apu_trigger(apu, c, t);
+            break;
+    }
+
+    apu_refresh(apu, c, t);
+}
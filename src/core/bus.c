@@ -1,6 +1,15 @@
 #include <core/utils.h>
+#include <core/apu.h>
+#include <core/bus.h>
+#include <core/cpu.h>
+#include <core/joypad.h>
+#include <core/mbc.h>
+#include <core/ppu.h>
+#include <core/serial.h>
+#include <core/timer.h>
 #include <gbemu.h>
 #include <stdio.h>
+#include <string.h>
 
 /*
 Memory Map:
@@ -21,16 +30,174 @@ https://gbdev.io/pandocs/Memory_Map.html#memory-map
 0xFF00 - 0xFF7F : I/O Registers (hardware control)
 0xFF80 - 0xFFFE : High RAM (HRAM) - 127 bytes
 0xFFFF          : Interrupt Enable Register (IE)
+
+Page Table:
+mmu_read/mmu_write (bus.h) look the page up in gb->read_map/gb->write_map and
+access host memory directly. The table is filled for:
+
+0x00 - 0x3F : ROM window 0  (read only, writes go to the MBC)
+0x40 - 0x7F : ROM window 1  (read only, remapped on bank switch)
+0x80 - 0x9F : VRAM
+0xA0 - 0xBF : External RAM  (the selected bank while enabled, see mbc.c)
+0xC0 - 0xDF : WRAM
+0xE0 - 0xFD : Echo RAM      (same host memory as 0xC0 - 0xDD)
+
+gb->decode_map follows read_map with the decode cache records (cpu_decode.c)
+for the same host memory.
+
+Pages 0xFE (OAM + unusable) and 0xFF (I/O, HRAM, IE) are always NULL and go
+through the slow path below, as does anything a component has unmapped.
+
+Watched pages (MMU_WATCH_*) also take writes through the slow path until the
+first write has been reported to whoever set the watch. Battery RAM pages are
+watched again after each save flush (MMU_WATCH_SAVE), so a game writing SRAM
+every frame leaves the fast path once per page per flush interval.
+
+VRAM & OAM are not locked out during PPU modes 3 & 2/3: the page table
+never changes with the PPU mode. The PPU runs lazily off gb->cycles with a
+fixed-length mode 3 (ppu.c), so unmapping VRAM per mode would cost two
+scheduler events per line & drop writes that real hardware accepts when
+mode 3 ends early. Games that respect the lockout see the same results.
 */
 
-// Read one byte from memory
-u8 mmu_read(GameBoy *gb, u16 addr) {
+// Decode cache records for a page's host memory (none until the cache exists)
+static DecodedOp *mmu_decode_page(GameBoy *gb, const u8 *host) {
+    return (gb->decode && host) ? cpu_decode_records(gb, host) : NULL;
+}
+
+// Point page_count pages starting at first_page at host memory
+void mmu_map_pages(GameBoy *gb, u8 first_page, u16 page_count, u8 *read_base, u8 *write_base) {
+    for (u16 i = 0; i < page_count && first_page + i < MMU_PAGE_COUNT; i++) {
+        u16 page             = first_page + i;
+        gb->read_map[page]   = read_base ? read_base + i * MMU_PAGE_SIZE : NULL;
+        gb->write_base[page] = write_base ? write_base + i * MMU_PAGE_SIZE : NULL;
+        gb->write_map[page]  = gb->page_watch[page] ? NULL : gb->write_base[page];
+        gb->decode_map[page] = mmu_decode_page(gb, gb->read_map[page]);
+    }
+}
+
+// Map a 16 KB ROM window (0x0000 or 0x4000) to the bank starting at rom_offset
+void mmu_map_rom_bank(GameBoy *gb, u16 window, size_t rom_offset) {
+    u8 first_page = window >> MMU_PAGE_SHIFT;
+
+    // Writes to ROM always go to the slow path (MBC registers)
+    for (u16 i = 0; i < 0x4000 / MMU_PAGE_SIZE; i++) {
+        size_t offset = rom_offset + (size_t)i * MMU_PAGE_SIZE;
+        bool   backed = gb->cart.rom && offset + MMU_PAGE_SIZE <= gb->cart.rom_size;
+
+        gb->read_map[first_page + i]   = backed ? gb->cart.rom + offset : NULL;
+        gb->write_map[first_page + i]  = NULL;
+        gb->write_base[first_page + i] = NULL;
+        gb->decode_map[first_page + i] = mmu_decode_page(gb, gb->read_map[first_page + i]);
+    }
+}
+
+// Build the whole page table from the current cartridge & memory state
+void mmu_map_init(GameBoy *gb) {
+    // Start with everything on the slow path & nothing watched
+    memset(gb->page_watch, 0, sizeof(gb->page_watch));
+    mmu_map_pages(gb, 0x00, MMU_PAGE_COUNT, NULL, NULL);
+
+    // ROM windows & cartridge RAM: whatever banks the MBC has selected
+    // (remapped by the MBC on bank switches, mbc.c)
+    mbc_map(gb);
+
+    // VRAM (reads are direct, writes go through the PPU)
+    mmu_map_pages(gb, 0x80, 0x20, gb->vram, gb->vram);
+    for (u16 page = 0x80; page < 0xA0; page++)
+        mmu_watch_page(gb, (u8)page, MMU_WATCH_VRAM);
+
+    // WRAM & its echo (0xE000 - 0xFDFF mirrors 0xC000 - 0xDDFF)
+    mmu_map_pages(gb, 0xC0, 0x20, gb->wram, gb->wram);
+    mmu_map_pages(gb, 0xE0, 0x1E, gb->wram, gb->wram);
+}
+
+// Watch a page & every page aliasing the same host memory
+void mmu_watch_page(GameBoy *gb, u8 page, u8 flags) {
+    const u8 *host = gb->write_base[page];
+    if (!host)
+        return;
+
+    for (u16 p = 0; p < MMU_PAGE_COUNT; p++) {
+        if (gb->write_base[p] == host) {
+            gb->page_watch[p] |= flags;
+            gb->write_map[p] = NULL;
+        }
+    }
+}
+
+// The pages are about to show other memory (RAM bank switch). Their one-shot
+// watches belong to what they show now: drop the code decoded or translated
+// from it (nothing could tell us it changed once it's out of the window).
+void mmu_unwatch_pages(GameBoy *gb, u8 first_page, u16 page_count) {
+    for (u16 i = 0; i < page_count && first_page + i < MMU_PAGE_COUNT; i++) {
+        u16 page  = first_page + i;
+        u8  flags = gb->page_watch[page] & MMU_WATCH_ONCE;
+
+        gb->page_watch[page] &= (u8)~MMU_WATCH_ONCE;
+        if (flags & MMU_WATCH_CODE)
+            cpu_jit_invalidate(gb, gb->write_base[page]);
+        if (flags & MMU_WATCH_DECODE)
+            cpu_decode_invalidate(gb, gb->write_base[page]);
+    }
+}
+
+// Watch every mapped cartridge RAM page that isn't dirty (battery saves only)
+void mmu_watch_save(GameBoy *gb) {
+    const u8 *ram = gb->cart.ram;
+    if (!gb->cart.save_path)
+        return;
+
+    for (u16 page = 0xA0; page < 0xC0; page++) {
+        const u8 *host = gb->write_base[page];
+        if (!host || host < ram || host >= ram + gb->cart.ram_size)
+            continue;
+        if (!(gb->page_watch[page] & MMU_WATCH_SAVE) && !cart_ram_is_dirty(&gb->cart, host - ram))
+            mmu_watch_page(gb, (u8)page, MMU_WATCH_SAVE);
+    }
+}
+
+// First write to a watched page: notify the owners & restore the fast path
+// (unless a permanent watch remains)
+static void mmu_watch_fire(GameBoy *gb, u8 page) {
+    u8  flags = gb->page_watch[page] & MMU_WATCH_ONCE;
+    u8 *host  = gb->write_base[page];
+
+    for (u16 p = 0; p < MMU_PAGE_COUNT; p++) {
+        if (gb->write_base[p] == host) {
+            gb->page_watch[p] &= (u8)~MMU_WATCH_ONCE;
+            gb->write_map[p] = gb->page_watch[p] ? NULL : host;
+        }
+    }
+
+    if (flags & MMU_WATCH_CODE)
+        cpu_jit_invalidate(gb, host);
+    if (flags & MMU_WATCH_DECODE)
+        cpu_decode_invalidate(gb, host);
+    if (flags & MMU_WATCH_SAVE)
+        cart_ram_mark_dirty(&gb->cart, host - gb->cart.ram, MMU_PAGE_SIZE);
+}
+
+// Memory changed behind the bus: same as the first write to it
+void mmu_host_written(GameBoy *gb, const u8 *host) {
+    for (u16 p = 0; p < MMU_PAGE_COUNT; p++) {
+        if (gb->write_base[p] == host && (gb->page_watch[p] & MMU_WATCH_ONCE)) {
+            mmu_watch_fire(gb, (u8)p);
+            return;
+        }
+    }
+}
+
+// Read one byte from memory (slow path)
+u8 mmu_read_slow(GameBoy *gb, u16 addr) {
     // ---------------------------
     // ROM Bank 0 (0x0000 - 0x3FFF) - Fixed
     // ---------------------------
+    // Same banks as the page table shows (it only misses past the end of the ROM)
     if (addr < 0x4000) {
-        if (addr < gb->cart.rom_size)
-            return gb->cart.rom[addr];
+        size_t off = gb->cart.mbc.rom0_offset + addr;
+        if (off < gb->cart.rom_size)
+            return gb->cart.rom[off];
         return 0xFF; // Open bus
     }
 
@@ -38,10 +205,9 @@ u8 mmu_read(GameBoy *gb, u16 addr) {
     // ROM Bank N (0x4000 - 0x7FFF) - Switchable
     // ---------------------------
     if (addr < 0x8000) {
-        // For now, just read from ROM directly
-        // TODO: MBC will handle bank switching
-        if (addr < gb->cart.rom_size)
-            return gb->cart.rom[addr];
+        size_t off = gb->cart.mbc.rom1_offset + (addr - 0x4000);
+        if (off < gb->cart.rom_size)
+            return gb->cart.rom[off];
         return 0xFF;
     }
 
@@ -49,8 +215,6 @@ u8 mmu_read(GameBoy *gb, u16 addr) {
     // VRAM (0x8000 - 0x9FFF) - 8 KB
     // ---------------------------
     if (addr < 0xA000) {
-        // TODO: Implement when the PPU is ready
-        // For now, just return from VRAM array
         return gb->vram[addr - 0x8000];
     }
 
@@ -58,12 +222,8 @@ u8 mmu_read(GameBoy *gb, u16 addr) {
     // External RAM (0xA000 - 0xBFFF) - Cartridge RAM
     // ---------------------------
     if (addr < 0xC000) {
-        // TODO: Implement with MBC (bank switching, enalbe/disable)
-        // For now, direct access if RAM exists
-        u16 ram_addr = addr - 0xA000;
-        if (ram_addr < gb->cart.ram_size)
-            return gb->cart.ram[ram_addr];
-        return 0xFF;
+        // Disabled RAM, the MBC3 clock, MBC2's nibbles, ... (or a mapped bank)
+        return gb->cart.mbc.ram_read(gb, addr);
     }
 
     // ---------------------------
@@ -84,7 +244,6 @@ u8 mmu_read(GameBoy *gb, u16 addr) {
     // OAM (0xFE00 - 0xFE9F) - Sprite Attribute Table
     // ---------------------------
     if (addr < 0xFEA0) {
-        // TODO: Implement when PPU is ready
         return gb->oam[addr - 0xFE00];
     }
 
@@ -121,15 +280,20 @@ u8 mmu_read(GameBoy *gb, u16 addr) {
     return 0xFF; // Open Bus
 }
 
-// Write one Byte to memory
-void mmu_write(GameBoy *gb, u16 addr, u8 value) {
+// Write one Byte to memory (slow path)
+void mmu_write_slow(GameBoy *gb, u16 addr, u8 value) {
+    // ---------------------------
+    // Watched page: report it, then write through the normal routing
+    // ---------------------------
+    if (gb->page_watch[addr >> MMU_PAGE_SHIFT] & MMU_WATCH_ONCE)
+        mmu_watch_fire(gb, addr >> MMU_PAGE_SHIFT);
+
     // ---------------------------
     // ROM (0x0000 - 0x7FFF) - MBC Control
     // ---------------------------
     if (addr < 0x8000) {
-        // TODO: Implement when MBC is ready
-        // Writes to ROM control MBC (bank switching, RAM enable, etc)
-        // Ignore writes to ROM for now
+        // Writes to ROM control the MBC (bank switching, RAM enable, etc)
+        gb->cart.mbc.write(gb, addr, value);
         return;
     }
 
@@ -137,8 +301,7 @@ void mmu_write(GameBoy *gb, u16 addr, u8 value) {
     // VRAM (0x8000 - 0x9FFF) - 8 KB
     // ---------------------------
     if (addr < 0xA000) {
-        // TODO: Check if VRAM is accessible (not during PPU mode 3)
-        gb->vram[addr - 0x8000] = value;
+        ppu_write_vram(gb, addr, value);
         return;
     }
 
@@ -146,11 +309,8 @@ void mmu_write(GameBoy *gb, u16 addr, u8 value) {
     // External RAM (0xA000 - 0xBFFF) - Cartridge RAM
     // ---------------------------
     if (addr < 0xC000) {
-        // TODO: Implement with MBC (check if RAM is enabled)
-        u16 ram_addr = addr - 0xA000;
-        if (ram_addr < gb->cart.ram_size) {
-            gb->cart.ram[ram_addr] = value;
-        }
+        // Disabled RAM, the MBC3 clock, MBC2's nibbles, ... (or a mapped bank)
+        gb->cart.mbc.ram_write(gb, addr, value);
         return;
     }
 
@@ -175,8 +335,7 @@ void mmu_write(GameBoy *gb, u16 addr, u8 value) {
     // OAM (0xFE00 - 0xFE9F) - Sprite Attribute Table
     // ---------------------------
     if (addr < 0xFEA0) {
-        // TODO: Check if OAM is accessible (not during PPU mode 2/3)
-        gb->oam[addr - 0xFE00] = value;
+        ppu_write_oam(gb, addr, value);
         return;
     }
 
@@ -212,32 +371,81 @@ void mmu_write(GameBoy *gb, u16 addr, u8 value) {
     }
 }
 
-// I/O Register handlers (NOTE: stubbed for now)
+// I/O Register handlers: route each register to its component.
+// Unmapped registers read as 0xFF & ignore writes.
 u8 io_read(GameBoy *gb, u16 addr) {
-    // TODO: Implement I/O registers for each component
-    // For now, return 0xFF (open bus)
-    (void)gb;
-    (void)addr;
-
-    // Some registers have default values
     switch (addr) {
         case 0xFF00: // Joypad
-            return 0xCF;
-        case 0xFF40: // LCD Control
-            return 0x91;
-        case 0xFF47: // BG Palette
-            return 0xFC;
+            return joypad_read(gb);
+        case 0xFF01: // Serial
+        case 0xFF02:
+            return serial_read(gb, addr);
+        case 0xFF04: // Timer & divider
+        case 0xFF05:
+        case 0xFF06:
+        case 0xFF07:
+            return timer_read(gb, addr);
+        case 0xFF0F: // Interrupt Flag (upper 3 bits read as 1)
+            return gb->if_register | 0xE0;
+        case 0xFF40: // LCD
+        case 0xFF41:
+        case 0xFF42:
+        case 0xFF43:
+        case 0xFF44:
+        case 0xFF45:
+        case 0xFF46:
+        case 0xFF47:
+        case 0xFF48:
+        case 0xFF49:
+        case 0xFF4A:
+        case 0xFF4B:
+            return ppu_read(gb, addr);
         default:
+            // Sound (0xFF10 - 0xFF26) & wave RAM (0xFF30 - 0xFF3F)
+            if (addr >= APU_REG_FIRST && addr < APU_REG_FIRST + APU_REG_COUNT)
+                return apu_read(gb, addr);
             return 0xFF;
     }
 }
 
 void io_write(GameBoy *gb, u16 addr, u8 value) {
-    // TODO: Implement I/O registers for each component
-    // For now, just ignore writes
-    (void)gb;
-    (void)addr;
-    (void)value;
+    switch (addr) {
+        case 0xFF00: // Joypad
+            joypad_write(gb, value);
+            break;
+        case 0xFF01: // Serial
+        case 0xFF02:
+            serial_write(gb, addr, value);
+            break;
+        case 0xFF04: // Timer & divider
+        case 0xFF05:
+        case 0xFF06:
+        case 0xFF07:
+            timer_write(gb, addr, value);
+            break;
+        case 0xFF0F: // Interrupt Flag
+            gb->if_register = value & 0x1F;
+            break;
+        case 0xFF40: // LCD
+        case 0xFF41:
+        case 0xFF42:
+        case 0xFF43:
+        case 0xFF44:
+        case 0xFF45:
+        case 0xFF46:
+        case 0xFF47:
+        case 0xFF48:
+        case 0xFF49:
+        case 0xFF4A:
+        case 0xFF4B:
+            ppu_write(gb, addr, value);
+            break;
+        default:
+            // Sound (0xFF10 - 0xFF26) & wave RAM (0xFF30 - 0xFF3F)
+            if (addr >= APU_REG_FIRST && addr < APU_REG_FIRST + APU_REG_COUNT)
+                apu_write(gb, addr, value);
+            break;
+    }
 }
 
 // Debug Helper: Dump Memory Region
@@ -11,47 +11,12 @@ return 2; -->  too small
 return 3; -->  malloc ROM failed
 return 4; -->  malloc RAM failed
 return 5; -->  fread failed
+return 6; -->  too large (over 8 MB, the largest ROM a header can describe)
 return -1; --> cart header checksum failed
 */
 
-// Load ROM from disk & parse header
-int cart_load(Cartridge *cart, const char *path) {
-    // Open the ROM file
-    FILE *rom_f = fopen(path, "rb");
-    if (!rom_f) {
-        fprintf(stderr, "Failed to open ROM: %s\n", path);
-        return 1;
-    }
-
-    // Get the file size
-    fseek(rom_f, 0, SEEK_END);
-    cart->rom_size = ftell(rom_f);
-    rewind(rom_f);
-
-    // Actual ROM file size should be greater than 0x0150
-    if (cart->rom_size < 0x0150) {
-        fclose(rom_f);
-        fprintf(stderr, "ROM file too small\n");
-        return 2;
-    }
-
-    // Allocate memory for ROM from heap
-    cart->rom = malloc(cart->rom_size);
-    if (!cart->rom) {
-        fclose(rom_f);
-        fprintf(stderr, "Failed to allocate ROM memory\n");
-        return 3;
-    }
-
-    // Read the ROM data from file into ROM buffer
-    size_t read = fread(cart->rom, 1, cart->rom_size, rom_f);
-    fclose(rom_f);
-
-    if (read != cart->rom_size) {
-        fprintf(stderr, "Failed to read ROM\n");
-        return 5;
-    }
-
+// Parse & verify the header of cart->rom, then allocate cartridge RAM
+static int cart_setup(Cartridge *cart) {
     // Copy raw header (located at 0x100 - 0x14F)
     memcpy(&cart->raw_header, cart->rom + 0x0100, sizeof(RawRomHeader));
 
@@ -64,17 +29,16 @@ int cart_load(Cartridge *cart, const char *path) {
         cart_unload(cart);
         return -1;
     }
-    printf("\nCartridge header checksum: OK\n");
 
-    // Allocate RAM if needed (based on ram_size_code)
-    cart->ram_size = get_ram_size(cart->header.ram_size_code);
+    // Pick the MBC; allocate RAM if needed (based on ram_size_code, or the
+    // MBC's own: MBC2)
+    cart->ram_size = mbc_init(&cart->mbc, cart->header.cart_type, cart->rom_size,
+                              get_ram_size(cart->header.ram_size_code));
     if (cart->ram_size > 0) {
         cart->ram = calloc(1, cart->ram_size);
         if (!cart->ram) {
             fprintf(stderr, "Failed to allocate cartridge RAM\n");
-            free(cart->rom);
-            cart->rom      = NULL;
-            cart->rom_size = 0;
+            cart_unload(cart);
             return 4;
         }
     } else {
@@ -84,12 +48,66 @@ int cart_load(Cartridge *cart, const char *path) {
     return 0;
 }
 
-// Unload the cart: Free the allocated memory for RAM & ROM
+// Load ROM from disk & parse header
+int cart_load(Cartridge *cart, const char *path) {
+    RomImage *image;
+    int       err = rom_store_open(path, &image);
+    if (err)
+        return err;
+
+    err = cart_load_image(cart, image);
+    rom_store_release(image); // The cartridge holds its own reference
+    if (err)
+        return err;
+    printf("\nCartridge header checksum: OK\n");
+
+    // Battery RAM lives in <rom>.sav; without it the game still runs, unsaved
+    if (cart->header.has_battery && cart->ram) {
+        char *save = cart_save_path(path);
+        if (save && cart_attach_save(cart, save) == 0)
+            printf("Save file: %s\n", save);
+        else
+            fprintf(stderr, "Warning: can't open save file %s, progress won't be kept\n",
+                    save ? save : path);
+        free(save);
+    }
+    return 0;
+}
+
+// Load a ROM image from memory (e.g. one file shared by many instances)
+int cart_load_buffer(Cartridge *cart, const u8 *data, size_t size) {
+    RomImage *image;
+    int       err = rom_store_add(data, size, &image);
+    if (err)
+        return err;
+
+    err = cart_load_image(cart, image);
+    rom_store_release(image);
+    return err;
+}
+
+// Cartridge on top of a shared image: only the header is per instance
+int cart_load_image(Cartridge *cart, RomImage *image) {
+    cart->image    = rom_store_ref(image);
+    cart->rom      = image->data;
+    cart->rom_size = image->size;
+    cart->rom_hash = 0;
+    for (int i = 7; i >= 0; i--)
+        cart->rom_hash = cart->rom_hash << 8 | image->sha1[i];
+
+    return cart_setup(cart);
+}
+
+// Unload the cart: Release the ROM, flush the save file, free the RAM
 void cart_unload(Cartridge *cart) {
-    if (cart->rom) {
+    cart_detach_save(cart);
+
+    if (cart->image)
+        rom_store_release(cart->image);
+    else
         free(cart->rom);
-        cart->rom = NULL;
-    }
+    cart->image = NULL;
+    cart->rom   = NULL;
 
     if (cart->ram) {
         free(cart->ram);
@@ -97,7 +115,9 @@ void cart_unload(Cartridge *cart) {
     }
 
     cart->rom_size = 0;
+    cart->rom_hash = 0;
     cart->ram_size = 0;
+    memset(&cart->mbc, 0, sizeof(cart->mbc));
 }
 
 // Parse raw header into usable format
@@ -135,6 +155,9 @@ void parse_header(const RawRomHeader *raw, CartHeader *out) {
 
     // Version
     out->version = raw->version;
+
+    // Battery (save file)
+    out->has_battery = cart_has_battery(raw->type);
 }
 
 // Print cartridge information to stdout
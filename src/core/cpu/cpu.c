@@ -0,0 +1,88 @@
+// src/core/cpu/cpu.c
+#include <core/cpu.h>
+#include <core/bus.h>
+#include <gbemu.h>
+#include <string.h>
+
+// Clear all CPU state
+void cpu_init(CPU *cpu) {
+    memset(cpu, 0, sizeof(CPU));
+}
+
+// Set the registers to the DMG post-boot-ROM values
+// https://gbdev.io/pandocs/Power_Up_Sequence.html#cpu-registers
+void cpu_reset(CPU *cpu) {
+    cpu_init(cpu);
+    cpu->a  = 0x01;
+    cpu->f  = 0xB0; // Z, H, C set (header checksum != 0)
+    cpu->b  = 0x00;
+    cpu->c  = 0x13;
+    cpu->d  = 0x00;
+    cpu->e  = 0xD8;
+    cpu->h  = 0x01;
+    cpu->l  = 0x4D;
+    cpu->sp = 0xFFFE;
+    cpu->pc = 0x0100;
+}
+
+// Request an interrupt (sets the matching IF bit)
+void cpu_request_interrupt(GameBoy *gb, u8 interrupt) {
+    gb->if_register |= interrupt & INT_MASK;
+}
+
+// Push a 16-bit value onto the stack (high byte first, as the hardware does)
+void cpu_push(GameBoy *gb, u16 val) {
+    CPU *cpu = &gb->cpu;
+    mmu_write(gb, --cpu->sp, GET_HIGH_BYTE(val));
+    mmu_write(gb, --cpu->sp, GET_LOW_BYTE(val));
+}
+
+// Pop a 16-bit value off the stack
+u16 cpu_pop(GameBoy *gb) {
+    CPU *cpu = &gb->cpu;
+    u16  val = mmu_read16(gb, cpu->sp);
+    cpu->sp += 2;
+    return val;
+}
+
+// Enter HALT
+// With IME=0 and an interrupt already pending, the CPU does not halt and
+// instead fails to increment PC after the next opcode fetch (the HALT bug).
+// https://gbdev.io/pandocs/halt.html#halt-bug
+void cpu_halt(GameBoy *gb) {
+    CPU *cpu = &gb->cpu;
+
+    if (!cpu->ime && (gb->ie_register & gb->if_register & INT_MASK))
+        cpu->halt_bug = true;
+    else
+        cpu->halted = true;
+}
+
+// Service the highest priority pending interrupt
+// https://gbdev.io/pandocs/Interrupts.html#interrupt-handling
+u32 cpu_service_interrupt(GameBoy *gb) {
+    CPU *cpu     = &gb->cpu;
+    u8   pending = gb->ie_register & gb->if_register & INT_MASK;
+
+    if (!cpu->ime || !pending)
+        return 0;
+
+    // Lowest bit has the highest priority (VBlank first)
+    u8 bit = 0;
+    while (!CHECK_BIT(pending, bit))
+        bit++;
+
+    gb->if_register = CLEAR_BIT(gb->if_register, bit);
+    cpu->ime        = false;
+    cpu->halted     = false;
+    cpu_push(gb, cpu->pc);
+    cpu->pc = 0x0040 + bit * 8;
+
+    // 2 wait states, 2 pushes, 1 jump
+    return 20;
+}
+
+// Execute a single instruction (or interrupt dispatch / halted tick)
+u32 cpu_step(GameBoy *gb) {
+    return cpu_run(gb, 1);
+}
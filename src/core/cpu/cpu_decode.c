@@ -0,0 +1,184 @@
+// src/core/cpu/cpu_decode.c
+#include <core/cpu.h>
+#include <core/bus.h>
+#include <gbemu.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+Decode cache
+
+Every byte of ROM, VRAM, WRAM & cart RAM has a DecodedOp record holding the
+instruction that starts there (opcode, length & immediate operand), so the
+interpreter fetches a whole instruction with one page lookup & one load
+instead of one mmu_read per byte.
+
+Records are found through gb->decode_map, which the page table fills next to
+read_map. ROM records are indexed by ROM offset, so a bank switch only swaps
+decode_map pointers & records survive it. ROM never changes, so once decoded
+a ROM record is valid until the next ROM is loaded.
+
+RAM records are invalidated by writes: the first record decoded on a RAM page
+puts an MMU_WATCH_DECODE watch on it, and the first write to the page after
+that (through mmu_write's slow path) clears all 256 records of the page.
+
+Instructions that straddle two pages are never cached, so a record only
+depends on the page it lives in. Neither is code on the slow-path pages
+(OAM, I/O, HRAM): it is decoded from memory every time.
+
+The cache is off unless gb->decode_enabled is set because of its memory: 4
+bytes per ROM byte per instance (4 MB for a 1 MB ROM, per machine in a farm).
+Speed depends on the code. Against fetching through the page table, with
+baredmg-bench (Release):
+- tight INC A; JR loop: ~8% faster (13.7-14.0k vs 12.6-12.9k frames/s)
+- PUSH/POP/CB loop, stack in WRAM: ~5% slower (11.8k vs 12.4k frames/s)
+Measure with --decode-cache before turning it on.
+*/
+
+typedef struct CpuDecodeCache {
+    const u8  *rom;      // ROM the records below were decoded from
+    size_t     rom_size;
+    DecodedOp *rom_ops;  // One record per ROM byte
+
+    const u8  *sram;     // Cart RAM the records below belong to
+    size_t     sram_size;
+    DecodedOp *sram_ops; // One record per cart RAM byte
+
+    DecodedOp  vram_ops[0x2000];
+    DecodedOp  wram_ops[0x2000];
+} CpuDecodeCache;
+
+// Offset of host inside [base, base + size), or -1
+static ptrdiff_t decode_offset(const u8 *host, const u8 *base, size_t size) {
+    uintptr_t h = (uintptr_t)host;
+    uintptr_t b = (uintptr_t)base;
+
+    if (base && h >= b && h - b < size)
+        return (ptrdiff_t)(h - b);
+    return -1;
+}
+
+// (Re)allocate the records for a ROM or cart RAM buffer if it changed
+static DecodedOp *decode_ensure(DecodedOp **ops, const u8 **owner, size_t *owner_size,
+                                const u8 *mem, size_t size) {
+    if (*ops && *owner == mem && *owner_size == size)
+        return *ops;
+
+    free(*ops);
+    *ops        = calloc(size, sizeof(DecodedOp));
+    *owner      = *ops ? mem : NULL;
+    *owner_size = *ops ? size : 0;
+    return *ops;
+}
+
+// Records backing one 256-byte host page (NULL if the memory is not cached)
+DecodedOp *cpu_decode_records(GameBoy *gb, const u8 *host_page) {
+    CpuDecodeCache *cache = gb->decode;
+    ptrdiff_t       off;
+
+    if (!cache)
+        return NULL;
+
+    if ((off = decode_offset(host_page, gb->wram, sizeof(gb->wram))) >= 0)
+        return cache->wram_ops + off;
+
+    if ((off = decode_offset(host_page, gb->vram, sizeof(gb->vram))) >= 0)
+        return cache->vram_ops + off;
+
+    if ((off = decode_offset(host_page, gb->cart.rom, gb->cart.rom_size)) >= 0) {
+        DecodedOp *ops = decode_ensure(&cache->rom_ops, &cache->rom, &cache->rom_size,
+                                       gb->cart.rom, gb->cart.rom_size);
+        return ops ? ops + off : NULL;
+    }
+
+    if ((off = decode_offset(host_page, gb->cart.ram, gb->cart.ram_size)) >= 0) {
+        DecodedOp *ops = decode_ensure(&cache->sram_ops, &cache->sram, &cache->sram_size,
+                                       gb->cart.ram, gb->cart.ram_size);
+        return ops ? ops + off : NULL;
+    }
+
+    return NULL;
+}
+
+// Create the cache & point decode_map at it for everything already mapped
+static void decode_create(GameBoy *gb) {
+    gb->decode = calloc(1, sizeof(CpuDecodeCache));
+    if (!gb->decode)
+        return;
+
+    for (u16 page = 0; page < MMU_PAGE_COUNT; page++)
+        gb->decode_map[page] = gb->read_map[page] ? cpu_decode_records(gb, gb->read_map[page])
+                                                  : NULL;
+}
+
+// Decode the instruction at pc into its record (or scratch if it has none)
+const DecodedOp *cpu_decode_miss(GameBoy *gb, u16 pc, DecodedOp *scratch) {
+    if (!gb->decode)
+        decode_create(gb);
+
+    u8         page    = pc >> MMU_PAGE_SHIFT;
+    u8         off     = pc & 0xFF;
+    u8         op      = mmu_read(gb, pc);
+    u8         length  = cpu_op_length[op];
+    DecodedOp *records = gb->decode_map[page];
+    DecodedOp *insn    = (records && off + length <= MMU_PAGE_SIZE) ? &records[off] : scratch;
+
+    insn->op     = op;
+    insn->length = length;
+    insn->imm    = 0;
+    if (length == 2)
+        insn->imm = mmu_read(gb, (u16)(pc + 1));
+    else if (length == 3)
+        insn->imm = mmu_read16(gb, (u16)(pc + 1));
+
+    gb->decode_stats.misses++;
+
+    // First record on a RAM page: get told when the page is written
+    if (insn != scratch && gb->write_base[page] && !(gb->page_watch[page] & MMU_WATCH_DECODE))
+        mmu_watch_page(gb, page, MMU_WATCH_DECODE);
+
+    return insn;
+}
+
+// Drop the records of one 256-byte host page
+void cpu_decode_invalidate(GameBoy *gb, const u8 *host_page) {
+    DecodedOp *records = cpu_decode_records(gb, host_page);
+    if (!records)
+        return;
+
+    memset(records, 0, MMU_PAGE_SIZE * sizeof(DecodedOp));
+    gb->decode_stats.invalidations++;
+}
+
+// Drop every record
+void cpu_decode_flush(GameBoy *gb) {
+    CpuDecodeCache *cache = gb->decode;
+    if (!cache)
+        return;
+
+    memset(cache->vram_ops, 0, sizeof(cache->vram_ops));
+    memset(cache->wram_ops, 0, sizeof(cache->wram_ops));
+    if (cache->rom_ops)
+        memset(cache->rom_ops, 0, cache->rom_size * sizeof(DecodedOp));
+    if (cache->sram_ops)
+        memset(cache->sram_ops, 0, cache->sram_size * sizeof(DecodedOp));
+}
+
+// Release the decode cache (the interpreter recreates it on its next miss)
+void cpu_decode_free(GameBoy *gb) {
+    CpuDecodeCache *cache = gb->decode;
+    if (!cache)
+        return;
+
+    free(cache->rom_ops);
+    free(cache->sram_ops);
+    free(cache);
+    gb->decode = NULL;
+    memset(gb->decode_map, 0, sizeof(gb->decode_map));
+}
+
+// Copy the decode cache counters
+void cpu_decode_get_stats(const GameBoy *gb, CpuDecodeStats *out) {
+    *out = gb->decode_stats;
+}
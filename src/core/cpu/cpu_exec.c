@@ -0,0 +1,2620 @@
+// src/core/cpu/cpu_exec.c
+#include <core/cpu.h>
+#include <core/alu_tables.h>
+#include <core/bus.h>
+#include <core/scheduler.h>
+#include <core/trace.h>
+#include <gbemu.h>
+
+/*
+Instruction execution
+
+cpu_run() executes instructions until its cycle budget is used up, so the
+caller pays one function call per time slice instead of one per instruction.
+
+Dispatch uses GCC/Clang labels-as-values: every handler ends by fetching the
+next opcode and jumping straight to its handler through a 256-entry table
+(threaded code), giving the branch predictor one indirect jump per handler
+instead of a single shared one. CB-prefixed opcodes have their own table.
+Compilers without computed goto (or builds with BAREDMG_NO_COMPUTED_GOTO)
+get the same handlers compiled as a plain switch.
+
+Handlers never compute timing: cpu_cycles[op] is added at dispatch and
+TAKEN() tops it up to cpu_cycles_taken[op] for taken conditional branches.
+
+Handlers only compare gb->cycles against gb->sched.next, the earliest
+scheduler deadline. The end of the budget is scheduled as SCHED_RUN_END, so
+component events and the budget are handled by the same slow path at head.
+
+Flags are evaluated lazily (see "Lazy flags"): cpu_run() loads cpu->f into
+the lazy state on entry & writes it back before returning, so nothing
+outside (save states, the JIT, tests) ever sees the difference.
+*/
+
+#if defined(__GNUC__) && !defined(BAREDMG_NO_COMPUTED_GOTO)
+#define CPU_COMPUTED_GOTO 1
+#else
+#define CPU_COMPUTED_GOTO 0
+#endif
+
+#if defined(__GNUC__)
+#define likely(x) __builtin_expect(!!(x), 1)
+#define unlikely(x) __builtin_expect(!!(x), 0)
+#define NOINLINE __attribute__((noinline))
+#else
+#define likely(x) (x)
+#define unlikely(x) (x)
+#define NOINLINE
+#endif
+
+// Build an F value from individual flag conditions
+#define FLAGS(z, n, h, c)                                                                          \
+    (u8)(((z) ? FLAG_Z : 0) | ((n) ? FLAG_N : 0) | ((h) ? FLAG_H : 0) | ((c) ? FLAG_C : 0))
+
+// ---------------------------------------------
+// Lazy flags
+// ---------------------------------------------
+// Flag-setting instructions store their result (& operands, when H depends
+// on them) instead of building F: most flags are overwritten before anything
+// reads them. Z & C come straight from flag_res, which is all a conditional
+// branch needs; N & H are only worked out when the whole of F is read (PUSH
+// AF, DAA, a trace record, leaving cpu_run()).
+typedef enum {
+    LF_ADD,   // ADD, ADC: H from the operands & result
+    LF_SUB,   // SUB, SBC, CP: N, H from the operands & result
+    LF_AND,   // AND, BIT: H
+    LF_LOGIC, // OR, XOR, rotates, shifts, SCF, CCF: neither
+    LF_INC,   // INC r: H if the low nibble wrapped to 0
+    LF_DEC,   // DEC r: N, H if the low nibble wrapped to F
+    LF_KNOWN, // N & H are in flag_x
+} LazyFlagOp;
+
+static inline bool flag_z(const CPU *cpu) {
+    return (u8)cpu->flag_res == 0;
+}
+
+static inline bool flag_c(const CPU *cpu) {
+    return cpu->flag_res & 0x100;
+}
+
+// Load a whole F (POP AF, DAA, entering cpu_run())
+static inline void flags_set(CPU *cpu, u8 f) {
+    cpu->flag_res = (f & FLAG_Z ? 0 : 1) | (f & FLAG_C ? 0x100 : 0);
+    cpu->flag_x   = f & (FLAG_N | FLAG_H);
+    cpu->flag_op  = LF_KNOWN;
+}
+
+static inline u8 flags_get(const CPU *cpu) {
+    u8 f    = FLAGS(flag_z(cpu), 0, 0, flag_c(cpu));
+    u8 half = (cpu->flag_x ^ cpu->flag_y ^ cpu->flag_res) & 0x10; // Carry into bit 4
+
+    switch (cpu->flag_op) {
+        case LF_ADD:
+            return f | (half ? FLAG_H : 0);
+        case LF_SUB:
+            return f | FLAG_N | (half ? FLAG_H : 0);
+        case LF_AND:
+            return f | FLAG_H;
+        case LF_INC:
+            return f | ((cpu->flag_res & 0x0F) == 0x00 ? FLAG_H : 0);
+        case LF_DEC:
+            return f | FLAG_N | ((cpu->flag_res & 0x0F) == 0x0F ? FLAG_H : 0);
+        case LF_KNOWN:
+            return f | cpu->flag_x;
+        default:
+            return f;
+    }
+}
+
+static inline void flags_lazy(CPU *cpu, LazyFlagOp op, u16 res, u8 x, u8 y) {
+    cpu->flag_res = res;
+    cpu->flag_x   = x;
+    cpu->flag_y   = y;
+    cpu->flag_op  = op;
+}
+
+// ---------------------------------------------
+// ALU helpers
+// https://gbdev.io/gb-opcodes/optables/
+// ---------------------------------------------
+
+static inline void alu_add(CPU *cpu, u8 val) {
+    u16 res = cpu->a + val;
+    flags_lazy(cpu, LF_ADD, res, cpu->a, val);
+    cpu->a = (u8)res;
+}
+
+static inline void alu_adc(CPU *cpu, u8 val) {
+    u16 res = cpu->a + val + flag_c(cpu);
+    flags_lazy(cpu, LF_ADD, res, cpu->a, val);
+    cpu->a = (u8)res;
+}
+
+// Subtractions keep the borrow in bit 8 of the 16-bit difference
+static inline void alu_sub(CPU *cpu, u8 val) {
+    u16 res = (u16)(cpu->a - val);
+    flags_lazy(cpu, LF_SUB, res, cpu->a, val);
+    cpu->a = (u8)res;
+}
+
+static inline void alu_sbc(CPU *cpu, u8 val) {
+    u16 res = (u16)(cpu->a - val - flag_c(cpu));
+    flags_lazy(cpu, LF_SUB, res, cpu->a, val);
+    cpu->a = (u8)res;
+}
+
+static inline void alu_and(CPU *cpu, u8 val) {
+    cpu->a &= val;
+    cpu->flag_res = cpu->a;
+    cpu->flag_op  = LF_AND;
+}
+
+static inline void alu_xor(CPU *cpu, u8 val) {
+    cpu->a ^= val;
+    cpu->flag_res = cpu->a;
+    cpu->flag_op  = LF_LOGIC;
+}
+
+static inline void alu_or(CPU *cpu, u8 val) {
+    cpu->a |= val;
+    cpu->flag_res = cpu->a;
+    cpu->flag_op  = LF_LOGIC;
+}
+
+static inline void alu_cp(CPU *cpu, u8 val) {
+    flags_lazy(cpu, LF_SUB, (u16)(cpu->a - val), cpu->a, val);
+}
+
+// INC/DEC r leave the carry flag untouched
+static inline u8 alu_inc(CPU *cpu, u8 val) {
+    u8 res        = val + 1;
+    cpu->flag_res = (cpu->flag_res & 0x100) | res;
+    cpu->flag_op  = LF_INC;
+    return res;
+}
+
+static inline u8 alu_dec(CPU *cpu, u8 val) {
+    u8 res        = val - 1;
+    cpu->flag_res = (cpu->flag_res & 0x100) | res;
+    cpu->flag_op  = LF_DEC;
+    return res;
+}
+
+// ADD HL, rr leaves Z untouched
+static inline void alu_add_hl(CPU *cpu, u16 val) {
+    u16 hl  = cpu_get_hl(cpu);
+    u32 sum = (u32)hl + val;
+
+    cpu->flag_res = (cpu->flag_res & 0xFF) | ((sum >> 8) & 0x100);
+    cpu->flag_x   = (hl ^ val ^ sum) & 0x1000 ? FLAG_H : 0;
+    cpu->flag_op  = LF_KNOWN;
+    cpu_set_hl(cpu, (u16)sum);
+}
+
+// ADD SP, e8 & LD HL, SP + e8: flags come from the unsigned low-byte addition
+static inline u16 alu_add_sp(CPU *cpu, u8 imm) {
+    u8  sp_lo = GET_LOW_BYTE(cpu->sp);
+    u16 sum   = sp_lo + imm;
+
+    cpu->flag_res = (sum & 0x100) | 1; // Never Z
+    cpu->flag_x   = (sp_lo ^ imm ^ sum) & 0x10 ? FLAG_H : 0;
+    cpu->flag_op  = LF_KNOWN;
+    return (u16)(cpu->sp + sign_extend_i8(imm));
+}
+
+// DAA: result & F from the generated table (alu_tables.h)
+static inline void alu_daa(CPU *cpu) {
+    u16 res = alu_daa_table[ALU_DAA_INDEX(cpu->a, flags_get(cpu))];
+    cpu->a  = GET_LOW_BYTE(res);
+    flags_set(cpu, GET_HIGH_BYTE(res));
+}
+
+// ---------------------------------------------
+// CB helpers (rotates, shifts, BIT)
+// ---------------------------------------------
+
+// Rotates & shifts: the table entry (result | carry out << 8) is flag_res
+static inline u8 cb_shift(CPU *cpu, AluShift kind, u8 val) {
+    cpu->flag_res = alu_shift_table[kind][(cpu->flag_res & 0x100) | val];
+    cpu->flag_op  = LF_LOGIC;
+    return (u8)cpu->flag_res;
+}
+
+// BIT keeps C: Z is the tested bit inverted
+static inline void cb_bit(CPU *cpu, u8 bit, u8 val) {
+    cpu->flag_res = (cpu->flag_res & 0x100) | ((val >> bit) & 1);
+    cpu->flag_op  = LF_AND;
+}
+
+// ---------------------------------------------
+// Dispatch
+// ---------------------------------------------
+
+// Opcode & operands at pc straight from its host page (the interpreter's
+// usual fetch, with the decode cache off). All three bytes are loaded at once;
+// handlers only look at as many as the instruction has. Like a decode cache
+// hit this bypasses mmu_read (and its profile counters). False if pc is on a
+// slow-path page or too close to the end of its page.
+static inline bool fetch_direct(GameBoy *gb, u16 pc, u8 *op, u16 *imm) {
+    const u8 *host = gb->read_map[pc >> MMU_PAGE_SHIFT];
+    u8        off  = pc & 0xFF;
+
+    if (unlikely(!host || off >= MMU_PAGE_SIZE - 2))
+        return false;
+    *op  = host[off];
+    *imm = MAKE_U16(host[off + 2], host[off + 1]);
+    return true;
+}
+
+// Opcode & operands at pc through mmu_read (slow-path page or end of a page)
+static NOINLINE const DecodedOp *fetch_slow(GameBoy *gb, u16 pc, DecodedOp *scratch) {
+    scratch->op     = mmu_read(gb, pc);
+    scratch->length = cpu_op_length[scratch->op];
+    scratch->imm    = scratch->length == 3   ? mmu_read16(gb, (u16)(pc + 1))
+                      : scratch->length == 2 ? mmu_read(gb, (u16)(pc + 1))
+                                             : 0;
+    return scratch;
+}
+
+// Pre-decoded instruction at pc (decoded into the cache on a miss)
+static inline const DecodedOp *fetch_decoded(GameBoy *gb, u16 pc, DecodedOp *scratch) {
+    const DecodedOp *records = gb->decode_map[pc >> MMU_PAGE_SHIFT];
+
+    if (likely(records && records[pc & 0xFF].length)) {
+        gb->decode_stats.hits++;
+        return &records[pc & 0xFF];
+    }
+    return cpu_decode_miss(gb, pc, scratch);
+}
+
+// Operands were fetched along with the opcode; handlers still step PC past
+// them with a constant, which keeps PC off the record load's dependency chain
+#define IMM8() (cpu->pc++, (u8)imm)
+#define IMM16() (cpu->pc += 2, imm)
+
+// Conditional branch taken: charge the extra cycles
+#define TAKEN() (gb->cycles += cpu_cycles_taken[op] - cpu_cycles[op])
+
+// Charge an instruction's base cycles
+#define CHARGE()                                                                                   \
+    do {                                                                                           \
+        gb->cycles += cpu_cycles[op];                                                              \
+        cpu->instructions++;                                                                       \
+        PROFILE_OP(gb, op);                                                                        \
+    } while (0)
+
+// Record the instruction about to run if a trace is on (trace.h)
+#define TRACE(flags)                                                                               \
+    do {                                                                                           \
+        if (unlikely(gb->trace != NULL)) {                                                         \
+            cpu->f = flags_get(cpu);                                                               \
+            trace_insn(gb, op, imm, flags);                                                        \
+        }                                                                                          \
+    } while (0)
+
+// Fetch the next instruction (opcode & operands) & charge it
+#define FETCH()                                                                                    \
+    do {                                                                                           \
+        if (unlikely(gb->decode_enabled || !fetch_direct(gb, cpu->pc, &op, &imm))) {               \
+            const DecodedOp *insn = gb->decode_enabled ? fetch_decoded(gb, cpu->pc, &scratch)      \
+                                                       : fetch_slow(gb, cpu->pc, &scratch);        \
+            op                    = insn->op;                                                      \
+            imm                   = insn->imm;                                                     \
+        }                                                                                          \
+        TRACE(0);                                                                                  \
+        cpu->pc++;                                                                                 \
+        CHARGE();                                                                                  \
+    } while (0)
+
+// Something other than the next opcode needs handling
+#define IRQ_READY() (cpu->ime && (gb->ie_register & gb->if_register & INT_MASK))
+
+#if CPU_COMPUTED_GOTO
+
+#define OP(n) op_##n
+#define CB_OP(n) cb_##n
+
+// Fetch & jump to the next handler without going back to the loop head
+#define DISPATCH()                                                                                 \
+    do {                                                                                           \
+        FETCH();                                                                                   \
+        goto *dispatch[op];                                                                        \
+    } while (0)
+
+#define NEXT                                                                                       \
+    do {                                                                                           \
+        if (likely(gb->cycles < gb->sched.next && !IRQ_READY()))                                   \
+            DISPATCH();                                                                            \
+        goto head;                                                                                 \
+    } while (0)
+
+#define SWITCH_BEGIN(table, val) goto *table[val];
+#define SWITCH_END
+
+#define TABLE_ROW(prefix, h)                                                                       \
+    &&prefix##h##0, &&prefix##h##1, &&prefix##h##2, &&prefix##h##3, &&prefix##h##4,                \
+        &&prefix##h##5, &&prefix##h##6, &&prefix##h##7, &&prefix##h##8, &&prefix##h##9,            \
+        &&prefix##h##A, &&prefix##h##B, &&prefix##h##C, &&prefix##h##D, &&prefix##h##E,            \
+        &&prefix##h##F
+
+#define TABLE(prefix)                                                                              \
+    {TABLE_ROW(prefix, 0), TABLE_ROW(prefix, 1), TABLE_ROW(prefix, 2), TABLE_ROW(prefix, 3),       \
+     TABLE_ROW(prefix, 4), TABLE_ROW(prefix, 5), TABLE_ROW(prefix, 6), TABLE_ROW(prefix, 7),       \
+     TABLE_ROW(prefix, 8), TABLE_ROW(prefix, 9), TABLE_ROW(prefix, A), TABLE_ROW(prefix, B),       \
+     TABLE_ROW(prefix, C), TABLE_ROW(prefix, D), TABLE_ROW(prefix, E), TABLE_ROW(prefix, F)}
+
+// Labels-as-values are a GNU extension
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+
+#else
+
+#define OP(n) case n
+#define CB_OP(n) case n
+
+#define NEXT goto head
+
+#define SWITCH_BEGIN(table, val) switch (val) {
+#define SWITCH_END }
+
+#endif
+
+// Run instructions until at least `budget` cycles have elapsed
+u32 cpu_run(GameBoy *gb, u32 budget) {
+    CPU      *cpu   = &gb->cpu;
+    u64       start = gb->cycles;
+    u8        op;
+    u16       imm;
+    DecodedOp scratch; // Record for code the cache (or the direct fetch) can't hold
+
+    // The end of the budget is just another scheduler deadline
+    sched_add(&gb->sched, SCHED_RUN_END, start + budget);
+    flags_set(cpu, cpu->f);
+
+#if CPU_COMPUTED_GOTO
+    static void *const dispatch[256]    = TABLE(op_0x);
+    static void *const cb_dispatch[256] = TABLE(cb_0x);
+#endif
+
+head:
+    // Slow path: due events (incl. the end of the budget), HALT/STOP, interrupts, EI delay
+    if (gb->cycles >= gb->sched.next && sched_dispatch(gb)) {
+        cpu->f = flags_get(cpu);
+        return (u32)(gb->cycles - start);
+    }
+
+    if (unlikely(cpu->halted || cpu->stopped || cpu->locked)) {
+        u8 pending = gb->ie_register & gb->if_register & INT_MASK;
+
+        if (cpu->locked || (cpu->halted && !pending) ||
+            (cpu->stopped && !(pending & INT_JOYPAD))) {
+            // Only an event can wake us up (interrupts are raised from
+            // sched_dispatch): skip straight to the next one, in whole
+            // M-cycles like the steps it replaces. Components catch up
+            // lazily, so the skipped time costs nothing.
+            u64 idle = (gb->sched.next - gb->cycles + 3) & ~(u64)3;
+            gb->cycles       += idle;
+            cpu->idle_cycles += idle;
+            cpu->idle_skips++;
+            goto head;
+        }
+
+        cpu->halted  = false;
+        cpu->stopped = false;
+    }
+
+    if (IRQ_READY()) {
+        gb->cycles += cpu_service_interrupt(gb);
+        goto head;
+    }
+
+    if (unlikely(cpu->ime_pending)) {
+        cpu->ime_pending = false;
+        cpu->ime         = true;
+    }
+
+    if (unlikely(cpu->halt_bug)) {
+        // PC fails to increment past the opcode following HALT, so the
+        // opcode byte is read again as the first operand byte (uncached)
+        cpu->halt_bug = false;
+        op            = mmu_read(gb, cpu->pc);
+        imm           = cpu_op_length[op] == 3 ? mmu_read16(gb, cpu->pc) : mmu_read(gb, cpu->pc);
+        TRACE(TRACE_HALT_BUG);
+        CHARGE();
+    }
+    else {
+        FETCH();
+    }
+
+    SWITCH_BEGIN(dispatch, op)
+
+        OP(0x00): // NOP
+            NEXT;
+
+        OP(0x01): // LD BC, d16
+            cpu_set_bc(cpu, IMM16());
+            NEXT;
+
+        OP(0x02): // LD (BC), A
+            mmu_write(gb, cpu_get_bc(cpu), cpu->a);
+            NEXT;
+
+        OP(0x03): // INC BC
+            cpu_set_bc(cpu, cpu_get_bc(cpu) + 1);
+            NEXT;
+
+        OP(0x04): // INC B
+            cpu->b = alu_inc(cpu, cpu->b);
+            NEXT;
+
+        OP(0x05): // DEC B
+            cpu->b = alu_dec(cpu, cpu->b);
+            NEXT;
+
+        OP(0x06): // LD B, d8
+            cpu->b = IMM8();
+            NEXT;
+
+        OP(0x07): // RLCA
+            cpu->a = cb_shift(cpu, ALU_RLC, cpu->a);
+            cpu->flag_res |= 1; // Never Z
+            NEXT;
+
+        OP(0x08): // LD (a16), SP
+            mmu_write16(gb, IMM16(), cpu->sp);
+            NEXT;
+
+        OP(0x09): // ADD HL, BC
+            alu_add_hl(cpu, cpu_get_bc(cpu));
+            NEXT;
+
+        OP(0x0A): // LD A, (BC)
+            cpu->a = mmu_read(gb, cpu_get_bc(cpu));
+            NEXT;
+
+        OP(0x0B): // DEC BC
+            cpu_set_bc(cpu, cpu_get_bc(cpu) - 1);
+            NEXT;
+
+        OP(0x0C): // INC C
+            cpu->c = alu_inc(cpu, cpu->c);
+            NEXT;
+
+        OP(0x0D): // DEC C
+            cpu->c = alu_dec(cpu, cpu->c);
+            NEXT;
+
+        OP(0x0E): // LD C, d8
+            cpu->c = IMM8();
+            NEXT;
+
+        OP(0x0F): // RRCA
+            cpu->a = cb_shift(cpu, ALU_RRC, cpu->a);
+            cpu->flag_res |= 1; // Never Z
+            NEXT;
+
+        OP(0x10): // STOP (skips a padding byte)
+            (void)IMM8();
+            cpu->stopped = true;
+            goto head;
+
+        OP(0x11): // LD DE, d16
+            cpu_set_de(cpu, IMM16());
+            NEXT;
+
+        OP(0x12): // LD (DE), A
+            mmu_write(gb, cpu_get_de(cpu), cpu->a);
+            NEXT;
+
+        OP(0x13): // INC DE
+            cpu_set_de(cpu, cpu_get_de(cpu) + 1);
+            NEXT;
+
+        OP(0x14): // INC D
+            cpu->d = alu_inc(cpu, cpu->d);
+            NEXT;
+
+        OP(0x15): // DEC D
+            cpu->d = alu_dec(cpu, cpu->d);
+            NEXT;
+
+        OP(0x16): // LD D, d8
+            cpu->d = IMM8();
+            NEXT;
+
+        OP(0x17): // RLA
+            cpu->a = cb_shift(cpu, ALU_RL, cpu->a);
+            cpu->flag_res |= 1; // Never Z
+            NEXT;
+
+        OP(0x18): { // JR r8
+            i8 off = (i8)IMM8();
+            cpu->pc = (u16)(cpu->pc + off);
+            NEXT;
+        }
+
+        OP(0x19): // ADD HL, DE
+            alu_add_hl(cpu, cpu_get_de(cpu));
+            NEXT;
+
+        OP(0x1A): // LD A, (DE)
+            cpu->a = mmu_read(gb, cpu_get_de(cpu));
+            NEXT;
+
+        OP(0x1B): // DEC DE
+            cpu_set_de(cpu, cpu_get_de(cpu) - 1);
+            NEXT;
+
+        OP(0x1C): // INC E
+            cpu->e = alu_inc(cpu, cpu->e);
+            NEXT;
+
+        OP(0x1D): // DEC E
+            cpu->e = alu_dec(cpu, cpu->e);
+            NEXT;
+
+        OP(0x1E): // LD E, d8
+            cpu->e = IMM8();
+            NEXT;
+
+        OP(0x1F): // RRA
+            cpu->a = cb_shift(cpu, ALU_RR, cpu->a);
+            cpu->flag_res |= 1; // Never Z
+            NEXT;
+
+        OP(0x20): { // JR NZ, r8
+            i8 off = (i8)IMM8();
+            if (!flag_z(cpu)) {
+                cpu->pc = (u16)(cpu->pc + off);
+                TAKEN();
+            }
+            NEXT;
+        }
+
+        OP(0x21): // LD HL, d16
+            cpu_set_hl(cpu, IMM16());
+            NEXT;
+
+        OP(0x22): { // LD (HL+), A
+            u16 hl = cpu_get_hl(cpu);
+            mmu_write(gb, hl, cpu->a);
+            cpu_set_hl(cpu, hl + 1);
+            NEXT;
+        }
+
+        OP(0x23): // INC HL
+            cpu_set_hl(cpu, cpu_get_hl(cpu) + 1);
+            NEXT;
+
+        OP(0x24): // INC H
+            cpu->h = alu_inc(cpu, cpu->h);
+            NEXT;
+
+        OP(0x25): // DEC H
+            cpu->h = alu_dec(cpu, cpu->h);
+            NEXT;
+
+        OP(0x26): // LD H, d8
+            cpu->h = IMM8();
+            NEXT;
+
+        OP(0x27): // DAA
+            alu_daa(cpu);
+            NEXT;
+
+        OP(0x28): { // JR Z, r8
+            i8 off = (i8)IMM8();
+            if (flag_z(cpu)) {
+                cpu->pc = (u16)(cpu->pc + off);
+                TAKEN();
+            }
+            NEXT;
+        }
+
+        OP(0x29): // ADD HL, HL
+            alu_add_hl(cpu, cpu_get_hl(cpu));
+            NEXT;
+
+        OP(0x2A): { // LD A, (HL+)
+            u16 hl = cpu_get_hl(cpu);
+            cpu->a = mmu_read(gb, hl);
+            cpu_set_hl(cpu, hl + 1);
+            NEXT;
+        }
+
+        OP(0x2B): // DEC HL
+            cpu_set_hl(cpu, cpu_get_hl(cpu) - 1);
+            NEXT;
+
+        OP(0x2C): // INC L
+            cpu->l = alu_inc(cpu, cpu->l);
+            NEXT;
+
+        OP(0x2D): // DEC L
+            cpu->l = alu_dec(cpu, cpu->l);
+            NEXT;
+
+        OP(0x2E): // LD L, d8
+            cpu->l = IMM8();
+            NEXT;
+
+        OP(0x2F): // CPL
+            cpu->a       = ~cpu->a;
+            cpu->flag_x  = FLAG_N | FLAG_H;
+            cpu->flag_op = LF_KNOWN;
+            NEXT;
+
+        OP(0x30): { // JR NC, r8
+            i8 off = (i8)IMM8();
+            if (!flag_c(cpu)) {
+                cpu->pc = (u16)(cpu->pc + off);
+                TAKEN();
+            }
+            NEXT;
+        }
+
+        OP(0x31): // LD SP, d16
+            cpu->sp = IMM16();
+            NEXT;
+
+        OP(0x32): { // LD (HL-), A
+            u16 hl = cpu_get_hl(cpu);
+            mmu_write(gb, hl, cpu->a);
+            cpu_set_hl(cpu, hl - 1);
+            NEXT;
+        }
+
+        OP(0x33): // INC SP
+            cpu->sp++;
+            NEXT;
+
+        OP(0x34): { // INC (HL)
+            u16 hl = cpu_get_hl(cpu);
+            mmu_write(gb, hl, alu_inc(cpu, mmu_read(gb, hl)));
+            NEXT;
+        }
+
+        OP(0x35): { // DEC (HL)
+            u16 hl = cpu_get_hl(cpu);
+            mmu_write(gb, hl, alu_dec(cpu, mmu_read(gb, hl)));
+            NEXT;
+        }
+
+        OP(0x36): // LD (HL), d8
+            mmu_write(gb, cpu_get_hl(cpu), IMM8());
+            NEXT;
+
+        OP(0x37): // SCF
+            cpu->flag_res |= 0x100;
+            cpu->flag_op = LF_LOGIC;
+            NEXT;
+
+        OP(0x38): { // JR C, r8
+            i8 off = (i8)IMM8();
+            if (flag_c(cpu)) {
+                cpu->pc = (u16)(cpu->pc + off);
+                TAKEN();
+            }
+            NEXT;
+        }
+
+        OP(0x39): // ADD HL, SP
+            alu_add_hl(cpu, cpu->sp);
+            NEXT;
+
+        OP(0x3A): { // LD A, (HL-)
+            u16 hl = cpu_get_hl(cpu);
+            cpu->a = mmu_read(gb, hl);
+            cpu_set_hl(cpu, hl - 1);
+            NEXT;
+        }
+
+        OP(0x3B): // DEC SP
+            cpu->sp--;
+            NEXT;
+
+        OP(0x3C): // INC A
+            cpu->a = alu_inc(cpu, cpu->a);
+            NEXT;
+
+        OP(0x3D): // DEC A
+            cpu->a = alu_dec(cpu, cpu->a);
+            NEXT;
+
+        OP(0x3E): // LD A, d8
+            cpu->a = IMM8();
+            NEXT;
+
+        OP(0x3F): // CCF
+            cpu->flag_res ^= 0x100;
+            cpu->flag_op = LF_LOGIC;
+            NEXT;
+
+        OP(0x40): // LD B, B
+            NEXT;
+
+        OP(0x41): // LD B, C
+            cpu->b = cpu->c;
+            NEXT;
+
+        OP(0x42): // LD B, D
+            cpu->b = cpu->d;
+            NEXT;
+
+        OP(0x43): // LD B, E
+            cpu->b = cpu->e;
+            NEXT;
+
+        OP(0x44): // LD B, H
+            cpu->b = cpu->h;
+            NEXT;
+
+        OP(0x45): // LD B, L
+            cpu->b = cpu->l;
+            NEXT;
+
+        OP(0x46): // LD B, (HL)
+            cpu->b = mmu_read(gb, cpu_get_hl(cpu));
+            NEXT;
+
+        OP(0x47): // LD B, A
+            cpu->b = cpu->a;
+            NEXT;
+
+        OP(0x48): // LD C, B
+            cpu->c = cpu->b;
+            NEXT;
+
+        OP(0x49): // LD C, C
+            NEXT;
+
+        OP(0x4A): // LD C, D
+            cpu->c = cpu->d;
+            NEXT;
+
+        OP(0x4B): // LD C, E
+            cpu->c = cpu->e;
+            NEXT;
+
+        OP(0x4C): // LD C, H
+            cpu->c = cpu->h;
+            NEXT;
+
+        OP(0x4D): // LD C, L
+            cpu->c = cpu->l;
+            NEXT;
+
+        OP(0x4E): // LD C, (HL)
+            cpu->c = mmu_read(gb, cpu_get_hl(cpu));
+            NEXT;
+
+        OP(0x4F): // LD C, A
+            cpu->c = cpu->a;
+            NEXT;
+
+        OP(0x50): // LD D, B
+            cpu->d = cpu->b;
+            NEXT;
+
+        OP(0x51): // LD D, C
+            cpu->d = cpu->c;
+            NEXT;
+
+        OP(0x52): // LD D, D
+            NEXT;
+
+        OP(0x53): // LD D, E
+            cpu->d = cpu->e;
+            NEXT;
+
+        OP(0x54): // LD D, H
+            cpu->d = cpu->h;
+            NEXT;
+
+        OP(0x55): // LD D, L
+            cpu->d = cpu->l;
+            NEXT;
+
+        OP(0x56): // LD D, (HL)
+            cpu->d = mmu_read(gb, cpu_get_hl(cpu));
+            NEXT;
+
+        OP(0x57): // LD D, A
+            cpu->d = cpu->a;
+            NEXT;
+
+        OP(0x58): // LD E, B
+            cpu->e = cpu->b;
+            NEXT;
+
+        OP(0x59): // LD E, C
+            cpu->e = cpu->c;
+            NEXT;
+
+        OP(0x5A): // LD E, D
+            cpu->e = cpu->d;
+            NEXT;
+
+        OP(0x5B): // LD E, E
+            NEXT;
+
+        OP(0x5C): // LD E, H
+            cpu->e = cpu->h;
+            NEXT;
+
+        OP(0x5D): // LD E, L
+            cpu->e = cpu->l;
+            NEXT;
+
+        OP(0x5E): // LD E, (HL)
+            cpu->e = mmu_read(gb, cpu_get_hl(cpu));
+            NEXT;
+
+        OP(0x5F): // LD E, A
+            cpu->e = cpu->a;
+            NEXT;
+
+        OP(0x60): // LD H, B
+            cpu->h = cpu->b;
+            NEXT;
+
+        OP(0x61): // LD H, C
+            cpu->h = cpu->c;
+            NEXT;
+
+        OP(0x62): // LD H, D
+            cpu->h = cpu->d;
+            NEXT;
+
+        OP(0x63): // LD H, E
+            cpu->h = cpu->e;
+            NEXT;
+
+        OP(0x64): // LD H, H
+            NEXT;
+
+        OP(0x65): // LD H, L
+            cpu->h = cpu->l;
+            NEXT;
+
+        OP(0x66): // LD H, (HL)
+            cpu->h = mmu_read(gb, cpu_get_hl(cpu));
+            NEXT;
+
+        OP(0x67): // LD H, A
+            cpu->h = cpu->a;
+            NEXT;
+
+        OP(0x68): // LD L, B
+            cpu->l = cpu->b;
+            NEXT;
+
+        OP(0x69): // LD L, C
+            cpu->l = cpu->c;
+            NEXT;
+
+        OP(0x6A): // LD L, D
+            cpu->l = cpu->d;
+            NEXT;
+
+        OP(0x6B): // LD L, E
+            cpu->l = cpu->e;
+            NEXT;
+
+        OP(0x6C): // LD L, H
+            cpu->l = cpu->h;
+            NEXT;
+
+        OP(0x6D): // LD L, L
+            NEXT;
+
+        OP(0x6E): // LD L, (HL)
+            cpu->l = mmu_read(gb, cpu_get_hl(cpu));
+            NEXT;
+
+        OP(0x6F): // LD L, A
+            cpu->l = cpu->a;
+            NEXT;
+
+        OP(0x70): // LD (HL), B
+            mmu_write(gb, cpu_get_hl(cpu), cpu->b);
+            NEXT;
+
+        OP(0x71): // LD (HL), C
+            mmu_write(gb, cpu_get_hl(cpu), cpu->c);
+            NEXT;
+
+        OP(0x72): // LD (HL), D
+            mmu_write(gb, cpu_get_hl(cpu), cpu->d);
+            NEXT;
+
+        OP(0x73): // LD (HL), E
+            mmu_write(gb, cpu_get_hl(cpu), cpu->e);
+            NEXT;
+
+        OP(0x74): // LD (HL), H
+            mmu_write(gb, cpu_get_hl(cpu), cpu->h);
+            NEXT;
+
+        OP(0x75): // LD (HL), L
+            mmu_write(gb, cpu_get_hl(cpu), cpu->l);
+            NEXT;
+
+        OP(0x76): // HALT
+            cpu_halt(gb);
+            goto head;
+
+        OP(0x77): // LD (HL), A
+            mmu_write(gb, cpu_get_hl(cpu), cpu->a);
+            NEXT;
+
+        OP(0x78): // LD A, B
+            cpu->a = cpu->b;
+            NEXT;
+
+        OP(0x79): // LD A, C
+            cpu->a = cpu->c;
+            NEXT;
+
+        OP(0x7A): // LD A, D
+            cpu->a = cpu->d;
+            NEXT;
+
+        OP(0x7B): // LD A, E
+            cpu->a = cpu->e;
+            NEXT;
+
+        OP(0x7C): // LD A, H
+            cpu->a = cpu->h;
+            NEXT;
+
+        OP(0x7D): // LD A, L
+            cpu->a = cpu->l;
+            NEXT;
+
+        OP(0x7E): // LD A, (HL)
+            cpu->a = mmu_read(gb, cpu_get_hl(cpu));
+            NEXT;
+
+        OP(0x7F): // LD A, A
+            NEXT;
+
+        OP(0x80): // ADD A, B
+            alu_add(cpu, cpu->b);
+            NEXT;
+
+        OP(0x81): // ADD A, C
+            alu_add(cpu, cpu->c);
+            NEXT;
+
+        OP(0x82): // ADD A, D
+            alu_add(cpu, cpu->d);
+            NEXT;
+
+        OP(0x83): // ADD A, E
+            alu_add(cpu, cpu->e);
+            NEXT;
+
+        OP(0x84): // ADD A, H
+            alu_add(cpu, cpu->h);
+            NEXT;
+
+        OP(0x85): // ADD A, L
+            alu_add(cpu, cpu->l);
+            NEXT;
+
+        OP(0x86): // ADD A, (HL)
+            alu_add(cpu, mmu_read(gb, cpu_get_hl(cpu)));
+            NEXT;
+
+        OP(0x87): // ADD A, A
+            alu_add(cpu, cpu->a);
+            NEXT;
+
+        OP(0x88): // ADC A, B
+            alu_adc(cpu, cpu->b);
+            NEXT;
+
+        OP(0x89): // ADC A, C
+            alu_adc(cpu, cpu->c);
+            NEXT;
+
+        OP(0x8A): // ADC A, D
+            alu_adc(cpu, cpu->d);
+            NEXT;
+
+        OP(0x8B): // ADC A, E
+            alu_adc(cpu, cpu->e);
+            NEXT;
+
+        OP(0x8C): // ADC A, H
+            alu_adc(cpu, cpu->h);
+            NEXT;
+
+        OP(0x8D): // ADC A, L
+            alu_adc(cpu, cpu->l);
+            NEXT;
+
+        OP(0x8E): // ADC A, (HL)
+            alu_adc(cpu, mmu_read(gb, cpu_get_hl(cpu)));
+            NEXT;
+
+        OP(0x8F): // ADC A, A
+            alu_adc(cpu, cpu->a);
+            NEXT;
+
+        OP(0x90): // SUB B
+            alu_sub(cpu, cpu->b);
+            NEXT;
+
+        OP(0x91): // SUB C
+            alu_sub(cpu, cpu->c);
+            NEXT;
+
+        OP(0x92): // SUB D
+            alu_sub(cpu, cpu->d);
+            NEXT;
+
+        OP(0x93): // SUB E
+            alu_sub(cpu, cpu->e);
+            NEXT;
+
+        OP(0x94): // SUB H
+            alu_sub(cpu, cpu->h);
+            NEXT;
+
+        OP(0x95): // SUB L
+            alu_sub(cpu, cpu->l);
+            NEXT;
+
+        OP(0x96): // SUB (HL)
+            alu_sub(cpu, mmu_read(gb, cpu_get_hl(cpu)));
+            NEXT;
+
+        OP(0x97): // SUB A
+            alu_sub(cpu, cpu->a);
+            NEXT;
+
+        OP(0x98): // SBC A, B
+            alu_sbc(cpu, cpu->b);
+            NEXT;
+
+        OP(0x99): // SBC A, C
+            alu_sbc(cpu, cpu->c);
+            NEXT;
+
+        OP(0x9A): // SBC A, D
+            alu_sbc(cpu, cpu->d);
+            NEXT;
+
+        OP(0x9B): // SBC A, E
+            alu_sbc(cpu, cpu->e);
+            NEXT;
+
+        OP(0x9C): // SBC A, H
+            alu_sbc(cpu, cpu->h);
+            NEXT;
+
+        OP(0x9D): // SBC A, L
+            alu_sbc(cpu, cpu->l);
+            NEXT;
+
+        OP(0x9E): // SBC A, (HL)
+            alu_sbc(cpu, mmu_read(gb, cpu_get_hl(cpu)));
+            NEXT;
+
+        OP(0x9F): // SBC A, A
+            alu_sbc(cpu, cpu->a);
+            NEXT;
+
+        OP(0xA0): // AND B
+            alu_and(cpu, cpu->b);
+            NEXT;
+
+        OP(0xA1): // AND C
+            alu_and(cpu, cpu->c);
+            NEXT;
+
+        OP(0xA2): // AND D
+            alu_and(cpu, cpu->d);
+            NEXT;
+
+        OP(0xA3): // AND E
+            alu_and(cpu, cpu->e);
+            NEXT;
+
+        OP(0xA4): // AND H
+            alu_and(cpu, cpu->h);
+            NEXT;
+
+        OP(0xA5): // AND L
+            alu_and(cpu, cpu->l);
+            NEXT;
+
+        OP(0xA6): // AND (HL)
+            alu_and(cpu, mmu_read(gb, cpu_get_hl(cpu)));
+            NEXT;
+
+        OP(0xA7): // AND A
+            alu_and(cpu, cpu->a);
+            NEXT;
+
+        OP(0xA8): // XOR B
+            alu_xor(cpu, cpu->b);
+            NEXT;
+
+        OP(0xA9): // XOR C
+            alu_xor(cpu, cpu->c);
+            NEXT;
+
+        OP(0xAA): // XOR D
+            alu_xor(cpu, cpu->d);
+            NEXT;
+
+        OP(0xAB): // XOR E
+            alu_xor(cpu, cpu->e);
+            NEXT;
+
+        OP(0xAC): // XOR H
+            alu_xor(cpu, cpu->h);
+            NEXT;
+
+        OP(0xAD): // XOR L
+            alu_xor(cpu, cpu->l);
+            NEXT;
+
+        OP(0xAE): // XOR (HL)
+            alu_xor(cpu, mmu_read(gb, cpu_get_hl(cpu)));
+            NEXT;
+
+        OP(0xAF): // XOR A
+            alu_xor(cpu, cpu->a);
+            NEXT;
+
+        OP(0xB0): // OR B
+            alu_or(cpu, cpu->b);
+            NEXT;
+
+        OP(0xB1): // OR C
+            alu_or(cpu, cpu->c);
+            NEXT;
+
+        OP(0xB2): // OR D
+            alu_or(cpu, cpu->d);
+            NEXT;
+
+        OP(0xB3): // OR E
+            alu_or(cpu, cpu->e);
+            NEXT;
+
+        OP(0xB4): // OR H
+            alu_or(cpu, cpu->h);
+            NEXT;
+
+        OP(0xB5): // OR L
+            alu_or(cpu, cpu->l);
+            NEXT;
+
+        OP(0xB6): // OR (HL)
+            alu_or(cpu, mmu_read(gb, cpu_get_hl(cpu)));
+            NEXT;
+
+        OP(0xB7): // OR A
+            alu_or(cpu, cpu->a);
+            NEXT;
+
+        OP(0xB8): // CP B
+            alu_cp(cpu, cpu->b);
+            NEXT;
+
+        OP(0xB9): // CP C
+            alu_cp(cpu, cpu->c);
+            NEXT;
+
+        OP(0xBA): // CP D
+            alu_cp(cpu, cpu->d);
+            NEXT;
+
+        OP(0xBB): // CP E
+            alu_cp(cpu, cpu->e);
+            NEXT;
+
+        OP(0xBC): // CP H
+            alu_cp(cpu, cpu->h);
+            NEXT;
+
+        OP(0xBD): // CP L
+            alu_cp(cpu, cpu->l);
+            NEXT;
+
+        OP(0xBE): // CP (HL)
+            alu_cp(cpu, mmu_read(gb, cpu_get_hl(cpu)));
+            NEXT;
+
+        OP(0xBF): // CP A
+            alu_cp(cpu, cpu->a);
+            NEXT;
+
+        OP(0xC0): // RET NZ
+            if (!flag_z(cpu)) {
+                cpu->pc = cpu_pop(gb);
+                TAKEN();
+            }
+            NEXT;
+
+        OP(0xC1): // POP BC
+            cpu_set_bc(cpu, cpu_pop(gb));
+            NEXT;
+
+        OP(0xC2): { // JP NZ, a16
+            u16 target = IMM16();
+            if (!flag_z(cpu)) {
+                cpu->pc = target;
+                TAKEN();
+            }
+            NEXT;
+        }
+
+        OP(0xC3): // JP a16
+            cpu->pc = IMM16();
+            NEXT;
+
+        OP(0xC4): { // CALL NZ, a16
+            u16 target = IMM16();
+            if (!flag_z(cpu)) {
+                cpu_push(gb, cpu->pc);
+                cpu->pc = target;
+                TAKEN();
+            }
+            NEXT;
+        }
+
+        OP(0xC5): // PUSH BC
+            cpu_push(gb, cpu_get_bc(cpu));
+            NEXT;
+
+        OP(0xC6): // ADD A, d8
+            alu_add(cpu, IMM8());
+            NEXT;
+
+        OP(0xC7): // RST 00H
+            cpu_push(gb, cpu->pc);
+            cpu->pc = 0x0000;
+            NEXT;
+
+        OP(0xC8): // RET Z
+            if (flag_z(cpu)) {
+                cpu->pc = cpu_pop(gb);
+                TAKEN();
+            }
+            NEXT;
+
+        OP(0xC9): // RET
+            cpu->pc = cpu_pop(gb);
+            NEXT;
+
+        OP(0xCA): { // JP Z, a16
+            u16 target = IMM16();
+            if (flag_z(cpu)) {
+                cpu->pc = target;
+                TAKEN();
+            }
+            NEXT;
+        }
+
+        OP(0xCC): { // CALL Z, a16
+            u16 target = IMM16();
+            if (flag_z(cpu)) {
+                cpu_push(gb, cpu->pc);
+                cpu->pc = target;
+                TAKEN();
+            }
+            NEXT;
+        }
+
+        OP(0xCD): { // CALL a16
+            u16 target = IMM16();
+            cpu_push(gb, cpu->pc);
+            cpu->pc = target;
+            NEXT;
+        }
+
+        OP(0xCE): // ADC A, d8
+            alu_adc(cpu, IMM8());
+            NEXT;
+
+        OP(0xCF): // RST 08H
+            cpu_push(gb, cpu->pc);
+            cpu->pc = 0x0008;
+            NEXT;
+
+        OP(0xD0): // RET NC
+            if (!flag_c(cpu)) {
+                cpu->pc = cpu_pop(gb);
+                TAKEN();
+            }
+            NEXT;
+
+        OP(0xD1): // POP DE
+            cpu_set_de(cpu, cpu_pop(gb));
+            NEXT;
+
+        OP(0xD2): { // JP NC, a16
+            u16 target = IMM16();
+            if (!flag_c(cpu)) {
+                cpu->pc = target;
+                TAKEN();
+            }
+            NEXT;
+        }
+
+        OP(0xD4): { // CALL NC, a16
+            u16 target = IMM16();
+            if (!flag_c(cpu)) {
+                cpu_push(gb, cpu->pc);
+                cpu->pc = target;
+                TAKEN();
+            }
+            NEXT;
+        }
+
+        OP(0xD5): // PUSH DE
+            cpu_push(gb, cpu_get_de(cpu));
+            NEXT;
+
+        OP(0xD6): // SUB d8
+            alu_sub(cpu, IMM8());
+            NEXT;
+
+        OP(0xD7): // RST 10H
+            cpu_push(gb, cpu->pc);
+            cpu->pc = 0x0010;
+            NEXT;
+
+        OP(0xD8): // RET C
+            if (flag_c(cpu)) {
+                cpu->pc = cpu_pop(gb);
+                TAKEN();
+            }
+            NEXT;
+
+        OP(0xD9): // RETI
+            cpu->pc  = cpu_pop(gb);
+            cpu->ime = true;
+            goto head;
+
+        OP(0xDA): { // JP C, a16
+            u16 target = IMM16();
+            if (flag_c(cpu)) {
+                cpu->pc = target;
+                TAKEN();
+            }
+            NEXT;
+        }
+
+        OP(0xDC): { // CALL C, a16
+            u16 target = IMM16();
+            if (flag_c(cpu)) {
+                cpu_push(gb, cpu->pc);
+                cpu->pc = target;
+                TAKEN();
+            }
+            NEXT;
+        }
+
+        OP(0xDE): // SBC A, d8
+            alu_sbc(cpu, IMM8());
+            NEXT;
+
+        OP(0xDF): // RST 18H
+            cpu_push(gb, cpu->pc);
+            cpu->pc = 0x0018;
+            NEXT;
+
+        OP(0xE0): // LDH (a8), A
+            mmu_write(gb, 0xFF00 | IMM8(), cpu->a);
+            NEXT;
+
+        OP(0xE1): // POP HL
+            cpu_set_hl(cpu, cpu_pop(gb));
+            NEXT;
+
+        OP(0xE2): // LD (C), A
+            mmu_write(gb, 0xFF00 | cpu->c, cpu->a);
+            NEXT;
+
+        OP(0xE5): // PUSH HL
+            cpu_push(gb, cpu_get_hl(cpu));
+            NEXT;
+
+        OP(0xE6): // AND d8
+            alu_and(cpu, IMM8());
+            NEXT;
+
+        OP(0xE7): // RST 20H
+            cpu_push(gb, cpu->pc);
+            cpu->pc = 0x0020;
+            NEXT;
+
+        OP(0xE8): // ADD SP, r8
+            cpu->sp = alu_add_sp(cpu, IMM8());
+            NEXT;
+
+        OP(0xE9): // JP HL
+            cpu->pc = cpu_get_hl(cpu);
+            NEXT;
+
+        OP(0xEA): // LD (a16), A
+            mmu_write(gb, IMM16(), cpu->a);
+            NEXT;
+
+        OP(0xEE): // XOR d8
+            alu_xor(cpu, IMM8());
+            NEXT;
+
+        OP(0xEF): // RST 28H
+            cpu_push(gb, cpu->pc);
+            cpu->pc = 0x0028;
+            NEXT;
+
+        OP(0xF0): // LDH A, (a8)
+            cpu->a = mmu_read(gb, 0xFF00 | IMM8());
+            NEXT;
+
+        OP(0xF1): // POP AF
+            cpu_set_af(cpu, cpu_pop(gb));
+            flags_set(cpu, cpu->f);
+            NEXT;
+
+        OP(0xF2): // LD A, (C)
+            cpu->a = mmu_read(gb, 0xFF00 | cpu->c);
+            NEXT;
+
+        OP(0xF3): // DI
+            cpu->ime         = false;
+            cpu->ime_pending = false;
+            NEXT;
+
+        OP(0xF5): // PUSH AF
+            cpu_push(gb, MAKE_U16(cpu->a, flags_get(cpu)));
+            NEXT;
+
+        OP(0xF6): // OR d8
+            alu_or(cpu, IMM8());
+            NEXT;
+
+        OP(0xF7): // RST 30H
+            cpu_push(gb, cpu->pc);
+            cpu->pc = 0x0030;
+            NEXT;
+
+        OP(0xF8): // LD HL, SP + r8
+            cpu_set_hl(cpu, alu_add_sp(cpu, IMM8()));
+            NEXT;
+
+        OP(0xF9): // LD SP, HL
+            cpu->sp = cpu_get_hl(cpu);
+            NEXT;
+
+        OP(0xFA): // LD A, (a16)
+            cpu->a = mmu_read(gb, IMM16());
+            NEXT;
+
+        OP(0xFB): // EI
+            cpu->ime_pending = true;
+            goto head;
+
+        OP(0xFE): // CP d8
+            alu_cp(cpu, IMM8());
+            NEXT;
+
+        OP(0xFF): // RST 38H
+            cpu_push(gb, cpu->pc);
+            cpu->pc = 0x0038;
+            NEXT;
+
+
+        OP(0xCB): // PREFIX CB
+            op = IMM8();
+            gb->cycles += cpu_cb_cycles[op];
+            PROFILE_CB(gb, op);
+            SWITCH_BEGIN(cb_dispatch, op)
+
+            CB_OP(0x00): // RLC B
+                cpu->b = cb_shift(cpu, ALU_RLC, cpu->b);
+                NEXT;
+
+            CB_OP(0x01): // RLC C
+                cpu->c = cb_shift(cpu, ALU_RLC, cpu->c);
+                NEXT;
+
+            CB_OP(0x02): // RLC D
+                cpu->d = cb_shift(cpu, ALU_RLC, cpu->d);
+                NEXT;
+
+            CB_OP(0x03): // RLC E
+                cpu->e = cb_shift(cpu, ALU_RLC, cpu->e);
+                NEXT;
+
+            CB_OP(0x04): // RLC H
+                cpu->h = cb_shift(cpu, ALU_RLC, cpu->h);
+                NEXT;
+
+            CB_OP(0x05): // RLC L
+                cpu->l = cb_shift(cpu, ALU_RLC, cpu->l);
+                NEXT;
+
+            CB_OP(0x06): { // RLC (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, cb_shift(cpu, ALU_RLC, mmu_read(gb, hl)));
+                NEXT;
+            }
+
+            CB_OP(0x07): // RLC A
+                cpu->a = cb_shift(cpu, ALU_RLC, cpu->a);
+                NEXT;
+
+            CB_OP(0x08): // RRC B
+                cpu->b = cb_shift(cpu, ALU_RRC, cpu->b);
+                NEXT;
+
+            CB_OP(0x09): // RRC C
+                cpu->c = cb_shift(cpu, ALU_RRC, cpu->c);
+                NEXT;
+
+            CB_OP(0x0A): // RRC D
+                cpu->d = cb_shift(cpu, ALU_RRC, cpu->d);
+                NEXT;
+
+            CB_OP(0x0B): // RRC E
+                cpu->e = cb_shift(cpu, ALU_RRC, cpu->e);
+                NEXT;
+
+            CB_OP(0x0C): // RRC H
+                cpu->h = cb_shift(cpu, ALU_RRC, cpu->h);
+                NEXT;
+
+            CB_OP(0x0D): // RRC L
+                cpu->l = cb_shift(cpu, ALU_RRC, cpu->l);
+                NEXT;
+
+            CB_OP(0x0E): { // RRC (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, cb_shift(cpu, ALU_RRC, mmu_read(gb, hl)));
+                NEXT;
+            }
+
+            CB_OP(0x0F): // RRC A
+                cpu->a = cb_shift(cpu, ALU_RRC, cpu->a);
+                NEXT;
+
+            CB_OP(0x10): // RL B
+                cpu->b = cb_shift(cpu, ALU_RL, cpu->b);
+                NEXT;
+
+            CB_OP(0x11): // RL C
+                cpu->c = cb_shift(cpu, ALU_RL, cpu->c);
+                NEXT;
+
+            CB_OP(0x12): // RL D
+                cpu->d = cb_shift(cpu, ALU_RL, cpu->d);
+                NEXT;
+
+            CB_OP(0x13): // RL E
+                cpu->e = cb_shift(cpu, ALU_RL, cpu->e);
+                NEXT;
+
+            CB_OP(0x14): // RL H
+                cpu->h = cb_shift(cpu, ALU_RL, cpu->h);
+                NEXT;
+
+            CB_OP(0x15): // RL L
+                cpu->l = cb_shift(cpu, ALU_RL, cpu->l);
+                NEXT;
+
+            CB_OP(0x16): { // RL (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, cb_shift(cpu, ALU_RL, mmu_read(gb, hl)));
+                NEXT;
+            }
+
+            CB_OP(0x17): // RL A
+                cpu->a = cb_shift(cpu, ALU_RL, cpu->a);
+                NEXT;
+
+            CB_OP(0x18): // RR B
+                cpu->b = cb_shift(cpu, ALU_RR, cpu->b);
+                NEXT;
+
+            CB_OP(0x19): // RR C
+                cpu->c = cb_shift(cpu, ALU_RR, cpu->c);
+                NEXT;
+
+            CB_OP(0x1A): // RR D
+                cpu->d = cb_shift(cpu, ALU_RR, cpu->d);
+                NEXT;
+
+            CB_OP(0x1B): // RR E
+                cpu->e = cb_shift(cpu, ALU_RR, cpu->e);
+                NEXT;
+
+            CB_OP(0x1C): // RR H
+                cpu->h = cb_shift(cpu, ALU_RR, cpu->h);
+                NEXT;
+
+            CB_OP(0x1D): // RR L
+                cpu->l = cb_shift(cpu, ALU_RR, cpu->l);
+                NEXT;
+
+            CB_OP(0x1E): { // RR (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, cb_shift(cpu, ALU_RR, mmu_read(gb, hl)));
+                NEXT;
+            }
+
+            CB_OP(0x1F): // RR A
+                cpu->a = cb_shift(cpu, ALU_RR, cpu->a);
+                NEXT;
+
+            CB_OP(0x20): // SLA B
+                cpu->b = cb_shift(cpu, ALU_SLA, cpu->b);
+                NEXT;
+
+            CB_OP(0x21): // SLA C
+                cpu->c = cb_shift(cpu, ALU_SLA, cpu->c);
+                NEXT;
+
+            CB_OP(0x22): // SLA D
+                cpu->d = cb_shift(cpu, ALU_SLA, cpu->d);
+                NEXT;
+
+            CB_OP(0x23): // SLA E
+                cpu->e = cb_shift(cpu, ALU_SLA, cpu->e);
+                NEXT;
+
+            CB_OP(0x24): // SLA H
+                cpu->h = cb_shift(cpu, ALU_SLA, cpu->h);
+                NEXT;
+
+            CB_OP(0x25): // SLA L
+                cpu->l = cb_shift(cpu, ALU_SLA, cpu->l);
+                NEXT;
+
+            CB_OP(0x26): { // SLA (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, cb_shift(cpu, ALU_SLA, mmu_read(gb, hl)));
+                NEXT;
+            }
+
+            CB_OP(0x27): // SLA A
+                cpu->a = cb_shift(cpu, ALU_SLA, cpu->a);
+                NEXT;
+
+            CB_OP(0x28): // SRA B
+                cpu->b = cb_shift(cpu, ALU_SRA, cpu->b);
+                NEXT;
+
+            CB_OP(0x29): // SRA C
+                cpu->c = cb_shift(cpu, ALU_SRA, cpu->c);
+                NEXT;
+
+            CB_OP(0x2A): // SRA D
+                cpu->d = cb_shift(cpu, ALU_SRA, cpu->d);
+                NEXT;
+
+            CB_OP(0x2B): // SRA E
+                cpu->e = cb_shift(cpu, ALU_SRA, cpu->e);
+                NEXT;
+
+            CB_OP(0x2C): // SRA H
+                cpu->h = cb_shift(cpu, ALU_SRA, cpu->h);
+                NEXT;
+
+            CB_OP(0x2D): // SRA L
+                cpu->l = cb_shift(cpu, ALU_SRA, cpu->l);
+                NEXT;
+
+            CB_OP(0x2E): { // SRA (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, cb_shift(cpu, ALU_SRA, mmu_read(gb, hl)));
+                NEXT;
+            }
+
+            CB_OP(0x2F): // SRA A
+                cpu->a = cb_shift(cpu, ALU_SRA, cpu->a);
+                NEXT;
+
+            CB_OP(0x30): // SWAP B
+                cpu->b = cb_shift(cpu, ALU_SWAP, cpu->b);
+                NEXT;
+
+            CB_OP(0x31): // SWAP C
+                cpu->c = cb_shift(cpu, ALU_SWAP, cpu->c);
+                NEXT;
+
+            CB_OP(0x32): // SWAP D
+                cpu->d = cb_shift(cpu, ALU_SWAP, cpu->d);
+                NEXT;
+
+            CB_OP(0x33): // SWAP E
+                cpu->e = cb_shift(cpu, ALU_SWAP, cpu->e);
+                NEXT;
+
+            CB_OP(0x34): // SWAP H
+                cpu->h = cb_shift(cpu, ALU_SWAP, cpu->h);
+                NEXT;
+
+            CB_OP(0x35): // SWAP L
+                cpu->l = cb_shift(cpu, ALU_SWAP, cpu->l);
+                NEXT;
+
+            CB_OP(0x36): { // SWAP (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, cb_shift(cpu, ALU_SWAP, mmu_read(gb, hl)));
+                NEXT;
+            }
+
+            CB_OP(0x37): // SWAP A
+                cpu->a = cb_shift(cpu, ALU_SWAP, cpu->a);
+                NEXT;
+
+            CB_OP(0x38): // SRL B
+                cpu->b = cb_shift(cpu, ALU_SRL, cpu->b);
+                NEXT;
+
+            CB_OP(0x39): // SRL C
+                cpu->c = cb_shift(cpu, ALU_SRL, cpu->c);
+                NEXT;
+
+            CB_OP(0x3A): // SRL D
+                cpu->d = cb_shift(cpu, ALU_SRL, cpu->d);
+                NEXT;
+
+            CB_OP(0x3B): // SRL E
+                cpu->e = cb_shift(cpu, ALU_SRL, cpu->e);
+                NEXT;
+
+            CB_OP(0x3C): // SRL H
+                cpu->h = cb_shift(cpu, ALU_SRL, cpu->h);
+                NEXT;
+
+            CB_OP(0x3D): // SRL L
+                cpu->l = cb_shift(cpu, ALU_SRL, cpu->l);
+                NEXT;
+
+            CB_OP(0x3E): { // SRL (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, cb_shift(cpu, ALU_SRL, mmu_read(gb, hl)));
+                NEXT;
+            }
+
+            CB_OP(0x3F): // SRL A
+                cpu->a = cb_shift(cpu, ALU_SRL, cpu->a);
+                NEXT;
+
+            CB_OP(0x40): // BIT 0, B
+                cb_bit(cpu, 0, cpu->b);
+                NEXT;
+
+            CB_OP(0x41): // BIT 0, C
+                cb_bit(cpu, 0, cpu->c);
+                NEXT;
+
+            CB_OP(0x42): // BIT 0, D
+                cb_bit(cpu, 0, cpu->d);
+                NEXT;
+
+            CB_OP(0x43): // BIT 0, E
+                cb_bit(cpu, 0, cpu->e);
+                NEXT;
+
+            CB_OP(0x44): // BIT 0, H
+                cb_bit(cpu, 0, cpu->h);
+                NEXT;
+
+            CB_OP(0x45): // BIT 0, L
+                cb_bit(cpu, 0, cpu->l);
+                NEXT;
+
+            CB_OP(0x46): // BIT 0, (HL)
+                cb_bit(cpu, 0, mmu_read(gb, cpu_get_hl(cpu)));
+                NEXT;
+
+            CB_OP(0x47): // BIT 0, A
+                cb_bit(cpu, 0, cpu->a);
+                NEXT;
+
+            CB_OP(0x48): // BIT 1, B
+                cb_bit(cpu, 1, cpu->b);
+                NEXT;
+
+            CB_OP(0x49): // BIT 1, C
+                cb_bit(cpu, 1, cpu->c);
+                NEXT;
+
+            CB_OP(0x4A): // BIT 1, D
+                cb_bit(cpu, 1, cpu->d);
+                NEXT;
+
+            CB_OP(0x4B): // BIT 1, E
+                cb_bit(cpu, 1, cpu->e);
+                NEXT;
+
+            CB_OP(0x4C): // BIT 1, H
+                cb_bit(cpu, 1, cpu->h);
+                NEXT;
+
+            CB_OP(0x4D): // BIT 1, L
+                cb_bit(cpu, 1, cpu->l);
+                NEXT;
+
+            CB_OP(0x4E): // BIT 1, (HL)
+                cb_bit(cpu, 1, mmu_read(gb, cpu_get_hl(cpu)));
+                NEXT;
+
+            CB_OP(0x4F): // BIT 1, A
+                cb_bit(cpu, 1, cpu->a);
+                NEXT;
+
+            CB_OP(0x50): // BIT 2, B
+                cb_bit(cpu, 2, cpu->b);
+                NEXT;
+
+            CB_OP(0x51): // BIT 2, C
+                cb_bit(cpu, 2, cpu->c);
+                NEXT;
+
+            CB_OP(0x52): // BIT 2, D
+                cb_bit(cpu, 2, cpu->d);
+                NEXT;
+
+            CB_OP(0x53): // BIT 2, E
+                cb_bit(cpu, 2, cpu->e);
+                NEXT;
+
+            CB_OP(0x54): // BIT 2, H
+                cb_bit(cpu, 2, cpu->h);
+                NEXT;
+
+            CB_OP(0x55): // BIT 2, L
+                cb_bit(cpu, 2, cpu->l);
+                NEXT;
+
+            CB_OP(0x56): // BIT 2, (HL)
+                cb_bit(cpu, 2, mmu_read(gb, cpu_get_hl(cpu)));
+                NEXT;
+
+            CB_OP(0x57): // BIT 2, A
+                cb_bit(cpu, 2, cpu->a);
+                NEXT;
+
+            CB_OP(0x58): // BIT 3, B
+                cb_bit(cpu, 3, cpu->b);
+                NEXT;
+
+            CB_OP(0x59): // BIT 3, C
+                cb_bit(cpu, 3, cpu->c);
+                NEXT;
+
+            CB_OP(0x5A): // BIT 3, D
+                cb_bit(cpu, 3, cpu->d);
+                NEXT;
+
+            CB_OP(0x5B): // BIT 3, E
+                cb_bit(cpu, 3, cpu->e);
+                NEXT;
+
+            CB_OP(0x5C): // BIT 3, H
+                cb_bit(cpu, 3, cpu->h);
+                NEXT;
+
+            CB_OP(0x5D): // BIT 3, L
+                cb_bit(cpu, 3, cpu->l);
+                NEXT;
+
+            CB_OP(0x5E): // BIT 3, (HL)
+                cb_bit(cpu, 3, mmu_read(gb, cpu_get_hl(cpu)));
+                NEXT;
+
+            CB_OP(0x5F): // BIT 3, A
+                cb_bit(cpu, 3, cpu->a);
+                NEXT;
+
+            CB_OP(0x60): // BIT 4, B
+                cb_bit(cpu, 4, cpu->b);
+                NEXT;
+
+            CB_OP(0x61): // BIT 4, C
+                cb_bit(cpu, 4, cpu->c);
+                NEXT;
+
+            CB_OP(0x62): // BIT 4, D
+                cb_bit(cpu, 4, cpu->d);
+                NEXT;
+
+            CB_OP(0x63): // BIT 4, E
+                cb_bit(cpu, 4, cpu->e);
+                NEXT;
+
+            CB_OP(0x64): // BIT 4, H
+                cb_bit(cpu, 4, cpu->h);
+                NEXT;
+
+            CB_OP(0x65): // BIT 4, L
+                cb_bit(cpu, 4, cpu->l);
+                NEXT;
+
+            CB_OP(0x66): // BIT 4, (HL)
+                cb_bit(cpu, 4, mmu_read(gb, cpu_get_hl(cpu)));
+                NEXT;
+
+            CB_OP(0x67): // BIT 4, A
+                cb_bit(cpu, 4, cpu->a);
+                NEXT;
+
+            CB_OP(0x68): // BIT 5, B
+                cb_bit(cpu, 5, cpu->b);
+                NEXT;
+
+            CB_OP(0x69): // BIT 5, C
+                cb_bit(cpu, 5, cpu->c);
+                NEXT;
+
+            CB_OP(0x6A): // BIT 5, D
+                cb_bit(cpu, 5, cpu->d);
+                NEXT;
+
+            CB_OP(0x6B): // BIT 5, E
+                cb_bit(cpu, 5, cpu->e);
+                NEXT;
+
+            CB_OP(0x6C): // BIT 5, H
+                cb_bit(cpu, 5, cpu->h);
+                NEXT;
+
+            CB_OP(0x6D): // BIT 5, L
+                cb_bit(cpu, 5, cpu->l);
+                NEXT;
+
+            CB_OP(0x6E): // BIT 5, (HL)
+                cb_bit(cpu, 5, mmu_read(gb, cpu_get_hl(cpu)));
+                NEXT;
+
+            CB_OP(0x6F): // BIT 5, A
+                cb_bit(cpu, 5, cpu->a);
+                NEXT;
+
+            CB_OP(0x70): // BIT 6, B
+                cb_bit(cpu, 6, cpu->b);
+                NEXT;
+
+            CB_OP(0x71): // BIT 6, C
+                cb_bit(cpu, 6, cpu->c);
+                NEXT;
+
+            CB_OP(0x72): // BIT 6, D
+                cb_bit(cpu, 6, cpu->d);
+                NEXT;
+
+            CB_OP(0x73): // BIT 6, E
+                cb_bit(cpu, 6, cpu->e);
+                NEXT;
+
+            CB_OP(0x74): // BIT 6, H
+                cb_bit(cpu, 6, cpu->h);
+                NEXT;
+
+            CB_OP(0x75): // BIT 6, L
+                cb_bit(cpu, 6, cpu->l);
+                NEXT;
+
+            CB_OP(0x76): // BIT 6, (HL)
+                cb_bit(cpu, 6, mmu_read(gb, cpu_get_hl(cpu)));
+                NEXT;
+
+            CB_OP(0x77): // BIT 6, A
+                cb_bit(cpu, 6, cpu->a);
+                NEXT;
+
+            CB_OP(0x78): // BIT 7, B
+                cb_bit(cpu, 7, cpu->b);
+                NEXT;
+
+            CB_OP(0x79): // BIT 7, C
+                cb_bit(cpu, 7, cpu->c);
+                NEXT;
+
+            CB_OP(0x7A): // BIT 7, D
+                cb_bit(cpu, 7, cpu->d);
+                NEXT;
+
+            CB_OP(0x7B): // BIT 7, E
+                cb_bit(cpu, 7, cpu->e);
+                NEXT;
+
+            CB_OP(0x7C): // BIT 7, H
+                cb_bit(cpu, 7, cpu->h);
+                NEXT;
+
+            CB_OP(0x7D): // BIT 7, L
+                cb_bit(cpu, 7, cpu->l);
+                NEXT;
+
+            CB_OP(0x7E): // BIT 7, (HL)
+                cb_bit(cpu, 7, mmu_read(gb, cpu_get_hl(cpu)));
+                NEXT;
+
+            CB_OP(0x7F): // BIT 7, A
+                cb_bit(cpu, 7, cpu->a);
+                NEXT;
+
+            CB_OP(0x80): // RES 0, B
+                cpu->b = CLEAR_BIT(cpu->b, 0);
+                NEXT;
+
+            CB_OP(0x81): // RES 0, C
+                cpu->c = CLEAR_BIT(cpu->c, 0);
+                NEXT;
+
+            CB_OP(0x82): // RES 0, D
+                cpu->d = CLEAR_BIT(cpu->d, 0);
+                NEXT;
+
+            CB_OP(0x83): // RES 0, E
+                cpu->e = CLEAR_BIT(cpu->e, 0);
+                NEXT;
+
+            CB_OP(0x84): // RES 0, H
+                cpu->h = CLEAR_BIT(cpu->h, 0);
+                NEXT;
+
+            CB_OP(0x85): // RES 0, L
+                cpu->l = CLEAR_BIT(cpu->l, 0);
+                NEXT;
+
+            CB_OP(0x86): { // RES 0, (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, CLEAR_BIT(mmu_read(gb, hl), 0));
+                NEXT;
+            }
+
+            CB_OP(0x87): // RES 0, A
+                cpu->a = CLEAR_BIT(cpu->a, 0);
+                NEXT;
+
+            CB_OP(0x88): // RES 1, B
+                cpu->b = CLEAR_BIT(cpu->b, 1);
+                NEXT;
+
+            CB_OP(0x89): // RES 1, C
+                cpu->c = CLEAR_BIT(cpu->c, 1);
+                NEXT;
+
+            CB_OP(0x8A): // RES 1, D
+                cpu->d = CLEAR_BIT(cpu->d, 1);
+                NEXT;
+
+            CB_OP(0x8B): // RES 1, E
+                cpu->e = CLEAR_BIT(cpu->e, 1);
+                NEXT;
+
+            CB_OP(0x8C): // RES 1, H
+                cpu->h = CLEAR_BIT(cpu->h, 1);
+                NEXT;
+
+            CB_OP(0x8D): // RES 1, L
+                cpu->l = CLEAR_BIT(cpu->l, 1);
+                NEXT;
+
+            CB_OP(0x8E): { // RES 1, (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, CLEAR_BIT(mmu_read(gb, hl), 1));
+                NEXT;
+            }
+
+            CB_OP(0x8F): // RES 1, A
+                cpu->a = CLEAR_BIT(cpu->a, 1);
+                NEXT;
+
+            CB_OP(0x90): // RES 2, B
+                cpu->b = CLEAR_BIT(cpu->b, 2);
+                NEXT;
+
+            CB_OP(0x91): // RES 2, C
+                cpu->c = CLEAR_BIT(cpu->c, 2);
+                NEXT;
+
+            CB_OP(0x92): // RES 2, D
+                cpu->d = CLEAR_BIT(cpu->d, 2);
+                NEXT;
+
+            CB_OP(0x93): // RES 2, E
+                cpu->e = CLEAR_BIT(cpu->e, 2);
+                NEXT;
+
+            CB_OP(0x94): // RES 2, H
+                cpu->h = CLEAR_BIT(cpu->h, 2);
+                NEXT;
+
+            CB_OP(0x95): // RES 2, L
+                cpu->l = CLEAR_BIT(cpu->l, 2);
+                NEXT;
+
+            CB_OP(0x96): { // RES 2, (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, CLEAR_BIT(mmu_read(gb, hl), 2));
+                NEXT;
+            }
+
+            CB_OP(0x97): // RES 2, A
+                cpu->a = CLEAR_BIT(cpu->a, 2);
+                NEXT;
+
+            CB_OP(0x98): // RES 3, B
+                cpu->b = CLEAR_BIT(cpu->b, 3);
+                NEXT;
+
+            CB_OP(0x99): // RES 3, C
+                cpu->c = CLEAR_BIT(cpu->c, 3);
+                NEXT;
+
+            CB_OP(0x9A): // RES 3, D
+                cpu->d = CLEAR_BIT(cpu->d, 3);
+                NEXT;
+
+            CB_OP(0x9B): // RES 3, E
+                cpu->e = CLEAR_BIT(cpu->e, 3);
+                NEXT;
+
+            CB_OP(0x9C): // RES 3, H
+                cpu->h = CLEAR_BIT(cpu->h, 3);
+                NEXT;
+
+            CB_OP(0x9D): // RES 3, L
+                cpu->l = CLEAR_BIT(cpu->l, 3);
+                NEXT;
+
+            CB_OP(0x9E): { // RES 3, (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, CLEAR_BIT(mmu_read(gb, hl), 3));
+                NEXT;
+            }
+
+            CB_OP(0x9F): // RES 3, A
+                cpu->a = CLEAR_BIT(cpu->a, 3);
+                NEXT;
+
+            CB_OP(0xA0): // RES 4, B
+                cpu->b = CLEAR_BIT(cpu->b, 4);
+                NEXT;
+
+            CB_OP(0xA1): // RES 4, C
+                cpu->c = CLEAR_BIT(cpu->c, 4);
+                NEXT;
+
+            CB_OP(0xA2): // RES 4, D
+                cpu->d = CLEAR_BIT(cpu->d, 4);
+                NEXT;
+
+            CB_OP(0xA3): // RES 4, E
+                cpu->e = CLEAR_BIT(cpu->e, 4);
+                NEXT;
+
+            CB_OP(0xA4): // RES 4, H
+                cpu->h = CLEAR_BIT(cpu->h, 4);
+                NEXT;
+
+            CB_OP(0xA5): // RES 4, L
+                cpu->l = CLEAR_BIT(cpu->l, 4);
+                NEXT;
+
+            CB_OP(0xA6): { // RES 4, (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, CLEAR_BIT(mmu_read(gb, hl), 4));
+                NEXT;
+            }
+
+            CB_OP(0xA7): // RES 4, A
+                cpu->a = CLEAR_BIT(cpu->a, 4);
+                NEXT;
+
+            CB_OP(0xA8): // RES 5, B
+                cpu->b = CLEAR_BIT(cpu->b, 5);
+                NEXT;
+
+            CB_OP(0xA9): // RES 5, C
+                cpu->c = CLEAR_BIT(cpu->c, 5);
+                NEXT;
+
+            CB_OP(0xAA): // RES 5, D
+                cpu->d = CLEAR_BIT(cpu->d, 5);
+                NEXT;
+
+            CB_OP(0xAB): // RES 5, E
+                cpu->e = CLEAR_BIT(cpu->e, 5);
+                NEXT;
+
+            CB_OP(0xAC): // RES 5, H
+                cpu->h = CLEAR_BIT(cpu->h, 5);
+                NEXT;
+
+            CB_OP(0xAD): // RES 5, L
+                cpu->l = CLEAR_BIT(cpu->l, 5);
+                NEXT;
+
+            CB_OP(0xAE): { // RES 5, (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, CLEAR_BIT(mmu_read(gb, hl), 5));
+                NEXT;
+            }
+
+            CB_OP(0xAF): // RES 5, A
+                cpu->a = CLEAR_BIT(cpu->a, 5);
+                NEXT;
+
+            CB_OP(0xB0): // RES 6, B
+                cpu->b = CLEAR_BIT(cpu->b, 6);
+                NEXT;
+
+            CB_OP(0xB1): // RES 6, C
+                cpu->c = CLEAR_BIT(cpu->c, 6);
+                NEXT;
+
+            CB_OP(0xB2): // RES 6, D
+                cpu->d = CLEAR_BIT(cpu->d, 6);
+                NEXT;
+
+            CB_OP(0xB3): // RES 6, E
+                cpu->e = CLEAR_BIT(cpu->e, 6);
+                NEXT;
+
+            CB_OP(0xB4): // RES 6, H
+                cpu->h = CLEAR_BIT(cpu->h, 6);
+                NEXT;
+
+            CB_OP(0xB5): // RES 6, L
+                cpu->l = CLEAR_BIT(cpu->l, 6);
+                NEXT;
+
+            CB_OP(0xB6): { // RES 6, (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, CLEAR_BIT(mmu_read(gb, hl), 6));
+                NEXT;
+            }
+
+            CB_OP(0xB7): // RES 6, A
+                cpu->a = CLEAR_BIT(cpu->a, 6);
+                NEXT;
+
+            CB_OP(0xB8): // RES 7, B
+                cpu->b = CLEAR_BIT(cpu->b, 7);
+                NEXT;
+
+            CB_OP(0xB9): // RES 7, C
+                cpu->c = CLEAR_BIT(cpu->c, 7);
+                NEXT;
+
+            CB_OP(0xBA): // RES 7, D
+                cpu->d = CLEAR_BIT(cpu->d, 7);
+                NEXT;
+
+            CB_OP(0xBB): // RES 7, E
+                cpu->e = CLEAR_BIT(cpu->e, 7);
+                NEXT;
+
+            CB_OP(0xBC): // RES 7, H
+                cpu->h = CLEAR_BIT(cpu->h, 7);
+                NEXT;
+
+            CB_OP(0xBD): // RES 7, L
+                cpu->l = CLEAR_BIT(cpu->l, 7);
+                NEXT;
+
+            CB_OP(0xBE): { // RES 7, (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, CLEAR_BIT(mmu_read(gb, hl), 7));
+                NEXT;
+            }
+
+            CB_OP(0xBF): // RES 7, A
+                cpu->a = CLEAR_BIT(cpu->a, 7);
+                NEXT;
+
+            CB_OP(0xC0): // SET 0, B
+                cpu->b = SET_BIT(cpu->b, 0);
+                NEXT;
+
+            CB_OP(0xC1): // SET 0, C
+                cpu->c = SET_BIT(cpu->c, 0);
+                NEXT;
+
+            CB_OP(0xC2): // SET 0, D
+                cpu->d = SET_BIT(cpu->d, 0);
+                NEXT;
+
+            CB_OP(0xC3): // SET 0, E
+                cpu->e = SET_BIT(cpu->e, 0);
+                NEXT;
+
+            CB_OP(0xC4): // SET 0, H
+                cpu->h = SET_BIT(cpu->h, 0);
+                NEXT;
+
+            CB_OP(0xC5): // SET 0, L
+                cpu->l = SET_BIT(cpu->l, 0);
+                NEXT;
+
+            CB_OP(0xC6): { // SET 0, (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, SET_BIT(mmu_read(gb, hl), 0));
+                NEXT;
+            }
+
+            CB_OP(0xC7): // SET 0, A
+                cpu->a = SET_BIT(cpu->a, 0);
+                NEXT;
+
+            CB_OP(0xC8): // SET 1, B
+                cpu->b = SET_BIT(cpu->b, 1);
+                NEXT;
+
+            CB_OP(0xC9): // SET 1, C
+                cpu->c = SET_BIT(cpu->c, 1);
+                NEXT;
+
+            CB_OP(0xCA): // SET 1, D
+                cpu->d = SET_BIT(cpu->d, 1);
+                NEXT;
+
+            CB_OP(0xCB): // SET 1, E
+                cpu->e = SET_BIT(cpu->e, 1);
+                NEXT;
+
+            CB_OP(0xCC): // SET 1, H
+                cpu->h = SET_BIT(cpu->h, 1);
+                NEXT;
+
+            CB_OP(0xCD): // SET 1, L
+                cpu->l = SET_BIT(cpu->l, 1);
+                NEXT;
+
+            CB_OP(0xCE): { // SET 1, (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, SET_BIT(mmu_read(gb, hl), 1));
+                NEXT;
+            }
+
+            CB_OP(0xCF): // SET 1, A
+                cpu->a = SET_BIT(cpu->a, 1);
+                NEXT;
+
+            CB_OP(0xD0): // SET 2, B
+                cpu->b = SET_BIT(cpu->b, 2);
+                NEXT;
+
+            CB_OP(0xD1): // SET 2, C
+                cpu->c = SET_BIT(cpu->c, 2);
+                NEXT;
+
+            CB_OP(0xD2): // SET 2, D
+                cpu->d = SET_BIT(cpu->d, 2);
+                NEXT;
+
+            CB_OP(0xD3): // SET 2, E
+                cpu->e = SET_BIT(cpu->e, 2);
+                NEXT;
+
+            CB_OP(0xD4): // SET 2, H
+                cpu->h = SET_BIT(cpu->h, 2);
+                NEXT;
+
+            CB_OP(0xD5): // SET 2, L
+                cpu->l = SET_BIT(cpu->l, 2);
+                NEXT;
+
+            CB_OP(0xD6): { // SET 2, (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, SET_BIT(mmu_read(gb, hl), 2));
+                NEXT;
+            }
+
+            CB_OP(0xD7): // SET 2, A
+                cpu->a = SET_BIT(cpu->a, 2);
+                NEXT;
+
+            CB_OP(0xD8): // SET 3, B
+                cpu->b = SET_BIT(cpu->b, 3);
+                NEXT;
+
+            CB_OP(0xD9): // SET 3, C
+                cpu->c = SET_BIT(cpu->c, 3);
+                NEXT;
+
+            CB_OP(0xDA): // SET 3, D
+                cpu->d = SET_BIT(cpu->d, 3);
+                NEXT;
+
+            CB_OP(0xDB): // SET 3, E
+                cpu->e = SET_BIT(cpu->e, 3);
+                NEXT;
+
+            CB_OP(0xDC): // SET 3, H
+                cpu->h = SET_BIT(cpu->h, 3);
+                NEXT;
+
+            CB_OP(0xDD): // SET 3, L
+                cpu->l = SET_BIT(cpu->l, 3);
+                NEXT;
+
+            CB_OP(0xDE): { // SET 3, (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, SET_BIT(mmu_read(gb, hl), 3));
+                NEXT;
+            }
+
+            CB_OP(0xDF): // SET 3, A
+                cpu->a = SET_BIT(cpu->a, 3);
+                NEXT;
+
+            CB_OP(0xE0): // SET 4, B
+                cpu->b = SET_BIT(cpu->b, 4);
+                NEXT;
+
+            CB_OP(0xE1): // SET 4, C
+                cpu->c = SET_BIT(cpu->c, 4);
+                NEXT;
+
+            CB_OP(0xE2): // SET 4, D
+                cpu->d = SET_BIT(cpu->d, 4);
+                NEXT;
+
+            CB_OP(0xE3): // SET 4, E
+                cpu->e = SET_BIT(cpu->e, 4);
+                NEXT;
+
+            CB_OP(0xE4): // SET 4, H
+                cpu->h = SET_BIT(cpu->h, 4);
+                NEXT;
+
+            CB_OP(0xE5): // SET 4, L
+                cpu->l = SET_BIT(cpu->l, 4);
+                NEXT;
+
+            CB_OP(0xE6): { // SET 4, (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, SET_BIT(mmu_read(gb, hl), 4));
+                NEXT;
+            }
+
+            CB_OP(0xE7): // SET 4, A
+                cpu->a = SET_BIT(cpu->a, 4);
+                NEXT;
+
+            CB_OP(0xE8): // SET 5, B
+                cpu->b = SET_BIT(cpu->b, 5);
+                NEXT;
+
+            CB_OP(0xE9): // SET 5, C
+                cpu->c = SET_BIT(cpu->c, 5);
+                NEXT;
+
+            CB_OP(0xEA): // SET 5, D
+                cpu->d = SET_BIT(cpu->d, 5);
+                NEXT;
+
+            CB_OP(0xEB): // SET 5, E
+                cpu->e = SET_BIT(cpu->e, 5);
+                NEXT;
+
+            CB_OP(0xEC): // SET 5, H
+                cpu->h = SET_BIT(cpu->h, 5);
+                NEXT;
+
+            CB_OP(0xED): // SET 5, L
+                cpu->l = SET_BIT(cpu->l, 5);
+                NEXT;
+
+            CB_OP(0xEE): { // SET 5, (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, SET_BIT(mmu_read(gb, hl), 5));
+                NEXT;
+            }
+
+            CB_OP(0xEF): // SET 5, A
+                cpu->a = SET_BIT(cpu->a, 5);
+                NEXT;
+
+            CB_OP(0xF0): // SET 6, B
+                cpu->b = SET_BIT(cpu->b, 6);
+                NEXT;
+
+            CB_OP(0xF1): // SET 6, C
+                cpu->c = SET_BIT(cpu->c, 6);
+                NEXT;
+
+            CB_OP(0xF2): // SET 6, D
+                cpu->d = SET_BIT(cpu->d, 6);
+                NEXT;
+
+            CB_OP(0xF3): // SET 6, E
+                cpu->e = SET_BIT(cpu->e, 6);
+                NEXT;
+
+            CB_OP(0xF4): // SET 6, H
+                cpu->h = SET_BIT(cpu->h, 6);
+                NEXT;
+
+            CB_OP(0xF5): // SET 6, L
+                cpu->l = SET_BIT(cpu->l, 6);
+                NEXT;
+
+            CB_OP(0xF6): { // SET 6, (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, SET_BIT(mmu_read(gb, hl), 6));
+                NEXT;
+            }
+
+            CB_OP(0xF7): // SET 6, A
+                cpu->a = SET_BIT(cpu->a, 6);
+                NEXT;
+
+            CB_OP(0xF8): // SET 7, B
+                cpu->b = SET_BIT(cpu->b, 7);
+                NEXT;
+
+            CB_OP(0xF9): // SET 7, C
+                cpu->c = SET_BIT(cpu->c, 7);
+                NEXT;
+
+            CB_OP(0xFA): // SET 7, D
+                cpu->d = SET_BIT(cpu->d, 7);
+                NEXT;
+
+            CB_OP(0xFB): // SET 7, E
+                cpu->e = SET_BIT(cpu->e, 7);
+                NEXT;
+
+            CB_OP(0xFC): // SET 7, H
+                cpu->h = SET_BIT(cpu->h, 7);
+                NEXT;
+
+            CB_OP(0xFD): // SET 7, L
+                cpu->l = SET_BIT(cpu->l, 7);
+                NEXT;
+
+            CB_OP(0xFE): { // SET 7, (HL)
+                u16 hl = cpu_get_hl(cpu);
+                mmu_write(gb, hl, SET_BIT(mmu_read(gb, hl), 7));
+                NEXT;
+            }
+
+            CB_OP(0xFF): // SET 7, A
+                cpu->a = SET_BIT(cpu->a, 7);
+                NEXT;
+
+
+            SWITCH_END
+
+        // Illegal opcodes hang the CPU
+        OP(0xD3):
+        OP(0xDB):
+        OP(0xDD):
+        OP(0xE3):
+        OP(0xE4):
+        OP(0xEB):
+        OP(0xEC):
+        OP(0xED):
+        OP(0xF4):
+        OP(0xFC):
+        OP(0xFD):
+            cpu->locked = true;
+            goto head;
+
+    SWITCH_END
+
+    goto head;
+}
+
+#if CPU_COMPUTED_GOTO
+#pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,1274 @@
+// src/core/cpu/cpu_jit.c
+#define _GNU_SOURCE // memfd_create
+#include <core/cpu.h>
+#include <core/alu_tables.h>
+#include <core/bus.h>
+#include <core/scheduler.h>
+#include <gbemu.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+Block JIT (x86-64, System V ABI)
+
+A block is a run of guest instructions inside one 256-byte page, ending at
+the first control transfer (JP/JR/CALL/RET/RST/RETI), HALT, STOP or EI. It is
+translated into a host function `void block(GameBoy *gb)` that works directly
+on the CPU struct in memory (RBX holds gb for the whole block):
+
+- Loads, INC/DEC, 8-bit ALU ops, CPL/SCF/CCF, RES/SET on registers & all
+  branches are emitted as native code. Half-carry comes straight from the
+  host AF flag via LAHF.
+- Memory accesses call jit_read/jit_write, which use the page table.
+- PUSH/POP, the other CB ops, DAA & the 16-bit arithmetic call one small C
+  helper each (jit_push, jit_cb, ...), never the interpreter loop.
+- HALT, STOP, EI & illegal opcodes only set the CPU state & end the block;
+  the run loop hands that state (and interrupts) to the interpreter.
+
+Translated code must stay cycle-for-cycle identical to the interpreter so the
+two can be run in lockstep. That gives three rules:
+1. Cycles are charged per instruction before its memory accesses, exactly
+   like the interpreter's dispatch.
+2. A block is only entered if it cannot cross the end of the cycle budget.
+3. A block leaves right after any write that takes the slow path (I/O, MBC,
+   watched code pages, ...): only such a write can make an interrupt ready
+   or change the code being run.
+
+Blocks are keyed by the host address of their first byte, which already
+encodes the ROM bank (or RAM location) behind the guest PC. RAM pages that
+hold translated code are watched through the page table (MMU_WATCH_CODE):
+the first write to one drops all blocks translated from it.
+
+HRAM & OAM sit on the slow-path pages 0xFE/0xFF, so code there (like the
+usual OAM DMA routine) is always interpreted.
+
+No page is ever writable & executable at once (hardened kernels refuse RWX
+memory). The code buffer is a shared memory object mapped twice: blocks are
+emitted through a read/write view & run from a read/execute one, so
+translating costs no system calls.
+*/
+
+// Profiling builds count every opcode in the interpreter: no translated code
+#if defined(__x86_64__) && (defined(__unix__) || defined(__APPLE__)) && !defined(BAREDMG_PROFILE)
+#define JIT_SUPPORTED 1
+#include <cpuid.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#define JIT_SUPPORTED 0
+#endif
+
+#define JIT_CODE_SIZE (1u << 20)     // Host code buffer per instance
+#define JIT_MAX_BLOCKS 8192          // Translated blocks per instance
+#define JIT_TABLE_SIZE 16384         // Hash table slots (power of two)
+#define JIT_MAX_INSNS 64             // Guest instructions per block
+#define JIT_MAX_BLOCK_BYTES 8192     // Worst-case host code for one block
+#define JIT_MAX_INSN_BYTES 128       // Worst-case host code for one instruction
+
+typedef void (*JitFn)(GameBoy *gb);
+
+typedef struct {
+    const u8 *src;        // Host address of the first guest byte (the key)
+    JitFn     fn;         // Translated code
+    u32       max_cycles; // Cycles used if the final branch is taken
+} JitBlock;
+
+typedef struct CpuJit {
+    u8         *code;      // Code buffer, read/write view (blocks are emitted here)
+    u8         *exec;      // The same memory, read/execute view (blocks run from here)
+    size_t      code_used; // Bytes of `code` in use
+    JitBlock    blocks[JIT_MAX_BLOCKS];
+    u32         block_count;
+    u32         table[JIT_TABLE_SIZE]; // Block index + 1, 0 = empty slot
+    CpuJitStats stats;
+} CpuJit;
+
+// Copy the JIT counters (all zero if the JIT never ran)
+void cpu_jit_get_stats(const GameBoy *gb, CpuJitStats *out) {
+    if (gb->jit)
+        *out = gb->jit->stats;
+    else
+        memset(out, 0, sizeof(*out));
+}
+
+#if JIT_SUPPORTED
+
+// ---------------------------------------------
+// Host code emitter
+// ---------------------------------------------
+
+// Host registers (low 3 bits of the encoding)
+enum { X_EAX = 0, X_ECX = 1, X_EDX = 2, X_EBX = 3, X_AH = 4, X_ESI = 6, X_EDI = 7 };
+
+typedef struct {
+    u8 *p; // Next byte to write
+} Emitter;
+
+// Offsets of guest state relative to RBX (= gb)
+#define GB_OFF(field) ((i32)offsetof(GameBoy, field))
+#define CPU_OFF(field) ((i32)(offsetof(GameBoy, cpu) + offsetof(CPU, field)))
+
+static void e8(Emitter *e, u8 b) {
+    *e->p++ = b;
+}
+
+static void e16(Emitter *e, u16 v) {
+    memcpy(e->p, &v, 2);
+    e->p += 2;
+}
+
+static void e32(Emitter *e, u32 v) {
+    memcpy(e->p, &v, 4);
+    e->p += 4;
+}
+
+static void e64(Emitter *e, u64 v) {
+    memcpy(e->p, &v, 8);
+    e->p += 8;
+}
+
+// ModRM + disp32 for a [rbx + disp] memory operand
+static void e_mem(Emitter *e, u8 reg, i32 disp) {
+    e8(e, 0x80 | (reg << 3) | X_EBX);
+    e32(e, (u32)disp);
+}
+
+// mov r8, [rbx + off]
+static void x_load8(Emitter *e, u8 reg, i32 off) {
+    e8(e, 0x8A);
+    e_mem(e, reg, off);
+}
+
+// mov [rbx + off], r8
+static void x_store8(Emitter *e, u8 reg, i32 off) {
+    e8(e, 0x88);
+    e_mem(e, reg, off);
+}
+
+// movzx r32, byte [rbx + off]
+static void x_load8_zx(Emitter *e, u8 reg, i32 off) {
+    e8(e, 0x0F);
+    e8(e, 0xB6);
+    e_mem(e, reg, off);
+}
+
+// mov byte [rbx + off], imm8
+static void x_store8_imm(Emitter *e, i32 off, u8 imm) {
+    e8(e, 0xC6);
+    e_mem(e, 0, off);
+    e8(e, imm);
+}
+
+// mov word [rbx + off], imm16
+static void x_store16_imm(Emitter *e, i32 off, u16 imm) {
+    e8(e, 0x66);
+    e8(e, 0xC7);
+    e_mem(e, 0, off);
+    e16(e, imm);
+}
+
+// Guest register pairs are stored high byte first: load as a word & swap.
+// movzx r32, word [rbx + hi]; rol r16, 8
+static void x_load_pair(Emitter *e, u8 reg, i32 hi_off) {
+    e8(e, 0x0F);
+    e8(e, 0xB7);
+    e_mem(e, reg, hi_off);
+    e8(e, 0x66);
+    e8(e, 0xC1);
+    e8(e, 0xC0 | reg);
+    e8(e, 0x08);
+}
+
+// rol ax, 8; mov [rbx + hi], ax
+static void x_store_pair_eax(Emitter *e, i32 hi_off) {
+    e8(e, 0x66);
+    e8(e, 0xC1);
+    e8(e, 0xC0);
+    e8(e, 0x08);
+    e8(e, 0x66);
+    e8(e, 0x89);
+    e_mem(e, X_EAX, hi_off);
+}
+
+// Charge an instruction: add qword [cycles], n; inc qword [instructions]
+static void x_charge(Emitter *e, u8 cycles) {
+    e8(e, 0x48);
+    e8(e, 0x83);
+    e_mem(e, 0, GB_OFF(cycles));
+    e8(e, cycles);
+    e8(e, 0x48);
+    e8(e, 0xFF);
+    e_mem(e, 0, CPU_OFF(instructions));
+}
+
+// Extra cycles for a taken branch
+static void x_add_cycles(Emitter *e, u8 cycles) {
+    e8(e, 0x48);
+    e8(e, 0x83);
+    e_mem(e, 0, GB_OFF(cycles));
+    e8(e, cycles);
+}
+
+static void x_set_pc(Emitter *e, u16 pc) {
+    x_store16_imm(e, CPU_OFF(pc), pc);
+}
+
+// mov rdi, rbx; mov rax, fn; call rax
+static void x_call(Emitter *e, u64 fn) {
+    e8(e, 0x48);
+    e8(e, 0x89);
+    e8(e, 0xDF);
+    e8(e, 0x48);
+    e8(e, 0xB8);
+    e64(e, fn);
+    e8(e, 0xFF);
+    e8(e, 0xD0);
+}
+
+// mov esi/edx, imm32
+static void x_mov_imm(Emitter *e, u8 reg, u32 imm) {
+    e8(e, 0xB8 | reg);
+    e32(e, imm);
+}
+
+// pop rbx; ret
+static void x_exit(Emitter *e) {
+    e8(e, 0x5B);
+    e8(e, 0xC3);
+}
+
+// test eax, eax; jz +2; pop rbx; ret
+static void x_exit_if_eax(Emitter *e) {
+    e8(e, 0x85);
+    e8(e, 0xC0);
+    e8(e, 0x74);
+    e8(e, 0x02);
+    x_exit(e);
+}
+
+// Build F from AH after LAHF (ZF bit 6 -> Z, AF bit 4 -> H, CF bit 0 -> C).
+// INC/DEC keep the guest carry instead of taking the host one.
+static void x_flags_from_ah(Emitter *e, u8 n_flag, bool keep_carry) {
+    static const u8 movzx_ecx_ah[] = {0x0F, 0xB6, 0xCC};
+    static const u8 lea_edx_2ecx[] = {0x8D, 0x14, 0x09};
+    static const u8 and_edx_a0[]   = {0x81, 0xE2, 0xA0, 0x00, 0x00, 0x00};
+    static const u8 shl_ecx_4[]    = {0xC1, 0xE1, 0x04};
+
+    memcpy(e->p, movzx_ecx_ah, 3);
+    e->p += 3;
+    memcpy(e->p, lea_edx_2ecx, 3);
+    e->p += 3;
+    memcpy(e->p, and_edx_a0, 6);
+    e->p += 6;
+
+    if (keep_carry) {
+        x_load8_zx(e, X_ECX, CPU_OFF(f));
+    }
+    else {
+        memcpy(e->p, shl_ecx_4, 3);
+        e->p += 3;
+    }
+
+    e8(e, 0x83); // and ecx, 0x10
+    e8(e, 0xE1);
+    e8(e, 0x10);
+    e8(e, 0x09); // or edx, ecx
+    e8(e, 0xCA);
+
+    if (n_flag) {
+        e8(e, 0x83); // or edx, imm8
+        e8(e, 0xCA);
+        e8(e, n_flag);
+    }
+
+    x_store8(e, X_EDX, CPU_OFF(f));
+}
+
+// ---------------------------------------------
+// Helpers called from translated code
+// ---------------------------------------------
+
+static u8 jit_read(GameBoy *gb, u32 addr) {
+    return mmu_read(gb, (u16)addr);
+}
+
+// Returns 1 if the write took the slow path and the block must stop
+static u32 jit_write(GameBoy *gb, u32 addr, u32 value) {
+    u8 *page = gb->write_map[(addr >> MMU_PAGE_SHIFT) & 0xFF];
+    if (page) {
+        page[addr & 0xFF] = (u8)value;
+        return 0;
+    }
+
+    mmu_write_slow(gb, (u16)addr, (u8)value);
+    return 1;
+}
+
+// CALL & RST (PC already points at the return address)
+static void jit_call(GameBoy *gb, u32 target) {
+    cpu_push(gb, gb->cpu.pc);
+    gb->cpu.pc = (u16)target;
+}
+
+static void jit_ret(GameBoy *gb) {
+    gb->cpu.pc = cpu_pop(gb);
+}
+
+// PUSH rr, high byte first like cpu_push(); returns 1 if a write took the slow path
+static u32 jit_push(GameBoy *gb, u32 value) {
+    CPU *cpu  = &gb->cpu;
+    u32  slow = jit_write(gb, --cpu->sp, value >> 8);
+    return slow | jit_write(gb, --cpu->sp, value & 0xFF);
+}
+
+// POP rr (0 = BC, 1 = DE, 2 = HL, 3 = AF)
+static void jit_pop(GameBoy *gb, u32 pair) {
+    CPU *cpu = &gb->cpu;
+    u16  val = cpu_pop(gb);
+
+    switch (pair) {
+        case 0:
+            cpu_set_bc(cpu, val);
+            break;
+        case 1:
+            cpu_set_de(cpu, val);
+            break;
+        case 2:
+            cpu_set_hl(cpu, val);
+            break;
+        default:
+            cpu_set_af(cpu, val);
+            break;
+    }
+}
+
+// CB rotates, shifts, SWAP & BIT on any operand, RES/SET on (HL).
+// RLCA/RRCA/RLA/RRA share the encoding of the CB op on A.
+// Returns 1 if the (HL) write took the slow path.
+static u32 jit_cb(GameBoy *gb, u32 cb) {
+    CPU *cpu     = &gb->cpu;
+    u8  *regs[8] = {&cpu->b, &cpu->c, &cpu->d, &cpu->e, &cpu->h, &cpu->l, NULL, &cpu->a};
+    u8  *reg     = regs[cb & 7];
+    u16  hl      = cpu_get_hl(cpu);
+    u8   y       = (cb >> 3) & 7;
+    u8   val     = reg ? *reg : mmu_read(gb, hl);
+
+    switch (cb >> 6) {
+        case 0: {
+            // The table entry is result | carry out << 8
+            u16 res = alu_shift_table[y][((cpu->f & FLAG_C) << 4) | val];
+            val     = (u8)res;
+            cpu->f  = (val ? 0 : FLAG_Z) | (res & 0x100 ? FLAG_C : 0);
+            break;
+        }
+        case 1:
+            cpu->f = (cpu->f & FLAG_C) | FLAG_H | (val & BIT(y) ? 0 : FLAG_Z);
+            return 0;
+        case 2:
+            val &= (u8)~BIT(y);
+            break;
+        default:
+            val |= (u8)BIT(y);
+            break;
+    }
+
+    if (reg) {
+        *reg = val;
+        return 0;
+    }
+    return jit_write(gb, hl, val);
+}
+
+// INC (HL) / DEC (HL) (carry untouched); returns 1 if the write took the slow path
+static u32 jit_inc_hl(GameBoy *gb, u32 dec) {
+    CPU *cpu = &gb->cpu;
+    u16  hl  = cpu_get_hl(cpu);
+    u8   val = (u8)(mmu_read(gb, hl) + (dec ? -1 : 1));
+    bool h   = (val & 0x0F) == (dec ? 0x0F : 0x00);
+
+    cpu->f = (cpu->f & FLAG_C) | (val ? 0 : FLAG_Z) | (dec ? FLAG_N : 0) | (h ? FLAG_H : 0);
+    return jit_write(gb, hl, val);
+}
+
+// ADD HL, rr leaves Z untouched
+static void jit_add_hl(GameBoy *gb, u32 val) {
+    CPU *cpu = &gb->cpu;
+    u32  hl  = cpu_get_hl(cpu);
+    u32  sum = hl + val;
+
+    cpu->f = (cpu->f & FLAG_Z) | ((hl ^ val ^ sum) & 0x1000 ? FLAG_H : 0) |
+             (sum & 0x10000 ? FLAG_C : 0);
+    cpu_set_hl(cpu, (u16)sum);
+}
+
+// ADD SP, e8 & LD HL, SP + e8: sets the flags & returns SP + e8
+static u32 jit_add_sp(GameBoy *gb, u32 imm) {
+    CPU *cpu   = &gb->cpu;
+    u8   sp_lo = GET_LOW_BYTE(cpu->sp);
+    u16  sum   = sp_lo + (u8)imm;
+
+    cpu->f = ((sp_lo ^ imm ^ sum) & 0x10 ? FLAG_H : 0) | (sum & 0x100 ? FLAG_C : 0);
+    return (u16)(cpu->sp + sign_extend_i8((u8)imm));
+}
+
+// DAA: result & F from the generated table
+static void jit_daa(GameBoy *gb) {
+    CPU *cpu = &gb->cpu;
+    u16  res = alu_daa_table[ALU_DAA_INDEX(cpu->a, cpu->f)];
+
+    cpu->a = GET_LOW_BYTE(res);
+    cpu->f = GET_HIGH_BYTE(res);
+}
+
+// LD (a16), SP (low byte first); returns 1 if a write took the slow path
+static u32 jit_store_sp(GameBoy *gb, u32 addr) {
+    u32 slow = jit_write(gb, addr, GET_LOW_BYTE(gb->cpu.sp));
+    return slow | jit_write(gb, (u16)(addr + 1), GET_HIGH_BYTE(gb->cpu.sp));
+}
+
+#define FN(f) ((u64)(uintptr_t)(f))
+
+// ---------------------------------------------
+// Instruction translation
+// ---------------------------------------------
+
+// Offsets of the 8-bit register operands (B, C, D, E, H, L, (HL), A)
+static i32 reg_off(u8 idx) {
+    switch (idx) {
+        case 0:
+            return CPU_OFF(b);
+        case 1:
+            return CPU_OFF(c);
+        case 2:
+            return CPU_OFF(d);
+        case 3:
+            return CPU_OFF(e);
+        case 4:
+            return CPU_OFF(h);
+        case 5:
+            return CPU_OFF(l);
+        default:
+            return CPU_OFF(a);
+    }
+}
+
+// High-byte offsets of BC, DE, HL (SP is a native u16)
+static i32 pair_off(u8 idx) {
+    return idx == 0 ? CPU_OFF(b) : idx == 1 ? CPU_OFF(d) : CPU_OFF(h);
+}
+
+// 8-bit ALU op on AL with the operand either in [rbx + off] or in DL
+static void x_alu(Emitter *e, u8 alu, bool operand_in_dl, i32 off) {
+    // r8, r/m8 forms: ADD ADC SUB SBC AND XOR OR CP
+    static const u8 op_mem[8] = {0x02, 0x12, 0x2A, 0x1A, 0x22, 0x32, 0x0A, 0x3A};
+    // r/m8, r8 forms
+    static const u8 op_reg[8] = {0x00, 0x10, 0x28, 0x18, 0x20, 0x30, 0x08, 0x38};
+
+    x_load8(e, X_EAX, CPU_OFF(a));
+
+    // ADC/SBC: guest carry into the host CF (bt ecx, 4)
+    if (alu == 1 || alu == 3) {
+        x_load8_zx(e, X_ECX, CPU_OFF(f));
+        e8(e, 0x0F);
+        e8(e, 0xBA);
+        e8(e, 0xE1);
+        e8(e, 0x04);
+    }
+
+    if (operand_in_dl) {
+        e8(e, op_reg[alu]);
+        e8(e, 0xD0); // al, dl
+    }
+    else {
+        e8(e, op_mem[alu]);
+        e_mem(e, X_EAX, off);
+    }
+
+    if (alu >= 4 && alu <= 6) {
+        // AND/XOR/OR: Z from the result, H set for AND, N & C clear
+        x_store8(e, X_EAX, CPU_OFF(a));
+        e8(e, 0x84); // test al, al
+        e8(e, 0xC0);
+        e8(e, 0x0F); // setz cl
+        e8(e, 0x94);
+        e8(e, 0xC1);
+        e8(e, 0xC0); // shl cl, 7
+        e8(e, 0xE1);
+        e8(e, 0x07);
+        if (alu == 4) {
+            e8(e, 0x80); // or cl, 0x20
+            e8(e, 0xC9);
+            e8(e, 0x20);
+        }
+        x_store8(e, X_ECX, CPU_OFF(f));
+        return;
+    }
+
+    e8(e, 0x9F); // lahf
+    if (alu != 7)
+        x_store8(e, X_EAX, CPU_OFF(a));
+    x_flags_from_ah(e, alu >= 2 ? FLAG_N : 0, false);
+}
+
+// Conditional branch prologue: test the flag & jump over the taken path.
+// Returns the address of the rel8 to patch once the taken path is emitted.
+static u8 *x_branch_if_not(Emitter *e, u8 cond) {
+    u8 mask     = (cond < 2) ? FLAG_Z : FLAG_C;
+    bool if_set = cond & 1; // Z & C branch when the flag is set
+
+    e8(e, 0xF6); // test byte [rbx + f], mask
+    e_mem(e, 0, CPU_OFF(f));
+    e8(e, mask);
+    e8(e, if_set ? 0x74 : 0x75); // skip taken path if the condition fails
+    e8(e, 0x00);
+    return e->p - 1;
+}
+
+static void x_patch_rel8(Emitter *e, u8 *rel) {
+    *rel = (u8)(e->p - (rel + 1));
+}
+
+// Emit one instruction; returns true if it ends the block
+static bool jit_emit_insn(Emitter *e, u16 pc, const u8 *code, u32 *max_cycles) {
+    u8  op   = code[0];
+    u8  len  = cpu_op_length[op];
+    u16 next = (u16)(pc + len);
+    u8  x    = op >> 6;
+    u8  y    = (op >> 3) & 7;
+    u8  z    = op & 7;
+    u8  imm8 = len > 1 ? code[1] : 0;
+    u16 imm  = len > 2 ? MAKE_U16(code[2], code[1]) : imm8;
+    u8  base = cpu_cycles[op];
+    u8  more = cpu_cycles_taken[op] - base;
+
+    *max_cycles += (op == 0xCB) ? cpu_cb_cycles[imm8] : cpu_cycles_taken[op];
+
+    // ----- Control flow -----
+    if (op == 0x18 || op == 0xC3 || (x == 0 && z == 0 && y >= 4) ||
+        (x == 3 && z == 2 && y < 4)) {
+        // JR e8 / JP a16 / JR cc / JP cc
+        u16 target = (x == 0) ? (u16)(next + (i8)imm8) : imm;
+        x_charge(e, base);
+
+        if (op == 0x18 || op == 0xC3) {
+            x_set_pc(e, target);
+            x_exit(e);
+            return true;
+        }
+
+        u8 *skip = x_branch_if_not(e, x == 0 ? y - 4 : y);
+        x_set_pc(e, target);
+        x_add_cycles(e, more);
+        x_exit(e);
+        x_patch_rel8(e, skip);
+        x_set_pc(e, next);
+        x_exit(e);
+        return true;
+    }
+
+    if (op == 0xCD || (x == 3 && z == 4 && y < 4)) {
+        // CALL a16 / CALL cc
+        x_charge(e, base);
+        x_set_pc(e, next);
+
+        u8 *skip = NULL;
+        if (op != 0xCD)
+            skip = x_branch_if_not(e, y);
+
+        x_mov_imm(e, X_ESI, imm);
+        x_call(e, FN(jit_call));
+        if (skip) {
+            x_add_cycles(e, more);
+            x_exit(e);
+            x_patch_rel8(e, skip);
+        }
+        x_exit(e);
+        return true;
+    }
+
+    if (op == 0xC9 || (x == 3 && z == 0 && y < 4)) {
+        // RET / RET cc
+        x_charge(e, base);
+        x_set_pc(e, next);
+
+        u8 *skip = NULL;
+        if (op != 0xC9)
+            skip = x_branch_if_not(e, y);
+
+        x_call(e, FN(jit_ret));
+        if (skip) {
+            x_add_cycles(e, more);
+            x_exit(e);
+            x_patch_rel8(e, skip);
+        }
+        x_exit(e);
+        return true;
+    }
+
+    if (x == 3 && z == 7) {
+        // RST n
+        x_charge(e, base);
+        x_set_pc(e, next);
+        x_mov_imm(e, X_ESI, y * 8);
+        x_call(e, FN(jit_call));
+        x_exit(e);
+        return true;
+    }
+
+    if (op == 0xE9) {
+        // JP HL
+        x_charge(e, base);
+        x_load_pair(e, X_EAX, CPU_OFF(h));
+        e8(e, 0x66);
+        e8(e, 0x89);
+        e_mem(e, X_EAX, CPU_OFF(pc));
+        x_exit(e);
+        return true;
+    }
+
+    if (op == 0xD9) {
+        // RETI: IME is set at once, unlike EI
+        x_charge(e, base);
+        x_call(e, FN(jit_ret));
+        x_store8_imm(e, CPU_OFF(ime), 1);
+        x_exit(e);
+        return true;
+    }
+
+    // HALT, STOP, EI & illegal opcodes end the block: the run loop hands the
+    // state they leave behind to the interpreter
+    if (op == 0x10 || op == 0x76 || op == 0xFB || op == 0xD3 || op == 0xDB || op == 0xDD ||
+        op == 0xE3 || op == 0xE4 || op == 0xEB || op == 0xEC || op == 0xED || op == 0xF4 ||
+        op == 0xFC || op == 0xFD) {
+        x_charge(e, base);
+        x_set_pc(e, next);
+        if (op == 0x76)
+            x_call(e, FN(cpu_halt));
+        else if (op == 0x10)
+            x_store8_imm(e, CPU_OFF(stopped), 1);
+        else if (op == 0xFB)
+            x_store8_imm(e, CPU_OFF(ime_pending), 1);
+        else
+            x_store8_imm(e, CPU_OFF(locked), 1);
+        x_exit(e);
+        return true;
+    }
+
+    // ----- 8-bit loads -----
+    if (x == 1) {
+        // LD r, r' / LD r, (HL) / LD (HL), r
+        x_charge(e, base);
+        if (y == 6) {
+            x_set_pc(e, next);
+            x_load_pair(e, X_ESI, CPU_OFF(h));
+            x_load8_zx(e, X_EDX, reg_off(z));
+            x_call(e, FN(jit_write));
+            x_exit_if_eax(e);
+        }
+        else if (z == 6) {
+            x_load_pair(e, X_ESI, CPU_OFF(h));
+            x_call(e, FN(jit_read));
+            x_store8(e, X_EAX, reg_off(y));
+        }
+        else if (y != z) {
+            x_load8(e, X_EAX, reg_off(z));
+            x_store8(e, X_EAX, reg_off(y));
+        }
+        return false;
+    }
+
+    if (x == 0 && z == 6) {
+        // LD r, d8 / LD (HL), d8
+        x_charge(e, base);
+        if (y == 6) {
+            x_set_pc(e, next);
+            x_load_pair(e, X_ESI, CPU_OFF(h));
+            x_mov_imm(e, X_EDX, imm8);
+            x_call(e, FN(jit_write));
+            x_exit_if_eax(e);
+        }
+        else {
+            x_store8_imm(e, reg_off(y), imm8);
+        }
+        return false;
+    }
+
+    if (x == 0 && z == 2) {
+        // LD (BC)/(DE)/(HL+)/(HL-), A & LD A, (BC)/(DE)/(HL+)/(HL-)
+        u8 p     = y >> 1;
+        bool ld_a = y & 1;
+        x_charge(e, base);
+        if (!ld_a)
+            x_set_pc(e, next);
+
+        x_load_pair(e, X_ESI, pair_off(p < 2 ? p : 2));
+        if (p >= 2) {
+            // lea eax, [rsi +/- 1]; store HL before the access so an early exit stays consistent
+            e8(e, 0x8D);
+            e8(e, 0x46);
+            e8(e, p == 2 ? 0x01 : 0xFF);
+            x_store_pair_eax(e, CPU_OFF(h));
+        }
+
+        if (ld_a) {
+            x_call(e, FN(jit_read));
+            x_store8(e, X_EAX, CPU_OFF(a));
+        }
+        else {
+            x_load8_zx(e, X_EDX, CPU_OFF(a));
+            x_call(e, FN(jit_write));
+            x_exit_if_eax(e);
+        }
+        return false;
+    }
+
+    if (op == 0xE0 || op == 0xF0 || op == 0xE2 || op == 0xF2 || op == 0xEA || op == 0xFA) {
+        // LDH (a8), A / LDH A, (a8) / LD (C), A / LD A, (C) / LD (a16), A / LD A, (a16)
+        bool store = (op & 0x10) == 0;
+        x_charge(e, base);
+        if (store)
+            x_set_pc(e, next);
+
+        if (op == 0xE2 || op == 0xF2) {
+            // (C): movzx esi, byte [c]; or esi, 0xFF00
+            x_load8_zx(e, X_ESI, CPU_OFF(c));
+            e8(e, 0x81);
+            e8(e, 0xCE);
+            e32(e, 0xFF00);
+        }
+        else {
+            x_mov_imm(e, X_ESI, (op == 0xE0 || op == 0xF0) ? 0xFF00u | imm8 : imm);
+        }
+
+        if (store) {
+            x_load8_zx(e, X_EDX, CPU_OFF(a));
+            x_call(e, FN(jit_write));
+            x_exit_if_eax(e);
+        }
+        else {
+            x_call(e, FN(jit_read));
+            x_store8(e, X_EAX, CPU_OFF(a));
+        }
+        return false;
+    }
+
+    // ----- 16-bit loads & arithmetic -----
+    if (x == 0 && z == 1 && !(y & 1)) {
+        // LD rr, d16
+        u8 p = y >> 1;
+        x_charge(e, base);
+        if (p == 3) {
+            x_store16_imm(e, CPU_OFF(sp), imm);
+        }
+        else {
+            x_store8_imm(e, pair_off(p), GET_HIGH_BYTE(imm));
+            x_store8_imm(e, pair_off(p) + 1, GET_LOW_BYTE(imm));
+        }
+        return false;
+    }
+
+    if (x == 0 && z == 3) {
+        // INC rr / DEC rr
+        u8   p   = y >> 1;
+        bool dec = y & 1;
+        x_charge(e, base);
+        if (p == 3) {
+            e8(e, 0x66); // inc/dec word [rbx + sp]
+            e8(e, 0xFF);
+            e_mem(e, dec ? 1 : 0, CPU_OFF(sp));
+        }
+        else {
+            x_load_pair(e, X_EAX, pair_off(p));
+            e8(e, 0xFF); // inc/dec eax
+            e8(e, dec ? 0xC8 : 0xC0);
+            x_store_pair_eax(e, pair_off(p));
+        }
+        return false;
+    }
+
+    // ----- 8-bit arithmetic -----
+    if (x == 0 && (z == 4 || z == 5) && y != 6) {
+        // INC r / DEC r (carry untouched)
+        bool dec = z == 5;
+        x_charge(e, base);
+        x_load8(e, X_EAX, reg_off(y));
+        e8(e, 0xFE);
+        e8(e, dec ? 0xC8 : 0xC0);
+        e8(e, 0x9F); // lahf
+        x_store8(e, X_EAX, reg_off(y));
+        x_flags_from_ah(e, dec ? FLAG_N : 0, true);
+        return false;
+    }
+
+    if (x == 2 || (x == 3 && z == 6)) {
+        // ALU A, r / ALU A, (HL) / ALU A, d8
+        x_charge(e, base);
+        if (x == 2 && z == 6) {
+            x_load_pair(e, X_ESI, CPU_OFF(h));
+            x_call(e, FN(jit_read));
+            e8(e, 0x88); // mov dl, al
+            e8(e, 0xC2);
+            x_alu(e, y, true, 0);
+        }
+        else if (x == 3) {
+            x_mov_imm(e, X_EDX, imm8);
+            x_alu(e, y, true, 0);
+        }
+        else {
+            x_alu(e, y, false, reg_off(z));
+        }
+        return false;
+    }
+
+    if (op == 0x2F || op == 0x37 || op == 0x3F) {
+        x_charge(e, base);
+        if (op == 0x2F) {
+            // CPL: not byte [a]; or byte [f], N|H
+            e8(e, 0xF6);
+            e_mem(e, 2, CPU_OFF(a));
+            e8(e, 0x80);
+            e_mem(e, 1, CPU_OFF(f));
+            e8(e, FLAG_N | FLAG_H);
+        }
+        else {
+            // SCF: F = (F & Z) | C;  CCF: F = (F & (Z | C)) ^ C
+            x_load8(e, X_EAX, CPU_OFF(f));
+            e8(e, 0x24); // and al, imm8
+            e8(e, op == 0x37 ? FLAG_Z : (FLAG_Z | FLAG_C));
+            e8(e, op == 0x37 ? 0x0C : 0x34); // or/xor al, C
+            e8(e, FLAG_C);
+            x_store8(e, X_EAX, CPU_OFF(f));
+        }
+        return false;
+    }
+
+    // ----- Stack -----
+    if (x == 3 && (z == 1 || z == 5)) {
+        // POP rr / PUSH rr (odd y: RET/RETI/JP HL/CALL & illegal ones are handled above)
+        u8 p = y >> 1;
+        x_charge(e, base);
+        if (op == 0xF9) {
+            // LD SP, HL
+            x_load_pair(e, X_EAX, CPU_OFF(h));
+            e8(e, 0x66);
+            e8(e, 0x89);
+            e_mem(e, X_EAX, CPU_OFF(sp));
+        }
+        else if (z == 1) {
+            x_mov_imm(e, X_ESI, p);
+            x_call(e, FN(jit_pop));
+        }
+        else {
+            x_set_pc(e, next);
+            x_load_pair(e, X_ESI, p == 3 ? CPU_OFF(a) : pair_off(p));
+            x_call(e, FN(jit_push));
+            x_exit_if_eax(e);
+        }
+        return false;
+    }
+
+    if (op == 0xE8 || op == 0xF8) {
+        // ADD SP, e8 / LD HL, SP + e8
+        x_charge(e, base);
+        x_mov_imm(e, X_ESI, imm8);
+        x_call(e, FN(jit_add_sp));
+        if (op == 0xF8) {
+            x_store_pair_eax(e, CPU_OFF(h));
+        }
+        else {
+            e8(e, 0x66); // mov [rbx + sp], ax
+            e8(e, 0x89);
+            e_mem(e, X_EAX, CPU_OFF(sp));
+        }
+        return false;
+    }
+
+    if (op == 0x08) {
+        // LD (a16), SP
+        x_charge(e, base);
+        x_set_pc(e, next);
+        x_mov_imm(e, X_ESI, imm);
+        x_call(e, FN(jit_store_sp));
+        x_exit_if_eax(e);
+        return false;
+    }
+
+    // ----- CB ops & the A rotates -----
+    if (op == 0xCB) {
+        u8 cy = (imm8 >> 3) & 7;
+        u8 cz = imm8 & 7;
+        x_charge(e, cpu_cb_cycles[imm8]);
+
+        if (imm8 >= 0x80 && cz != 6) {
+            // RES/SET n, r: and/or byte [rbx + r], imm8
+            e8(e, 0x80);
+            e_mem(e, imm8 < 0xC0 ? 4 : 1, reg_off(cz));
+            e8(e, imm8 < 0xC0 ? (u8)~BIT(cy) : (u8)BIT(cy));
+            return false;
+        }
+
+        // Everything but BIT writes (HL) back
+        bool writes = cz == 6 && (imm8 < 0x40 || imm8 >= 0x80);
+        if (writes)
+            x_set_pc(e, next);
+        x_mov_imm(e, X_ESI, imm8);
+        x_call(e, FN(jit_cb));
+        if (writes)
+            x_exit_if_eax(e);
+        return false;
+    }
+
+    if (op == 0x07 || op == 0x0F || op == 0x17 || op == 0x1F) {
+        // RLCA/RRCA/RLA/RRA: the CB op on A, but Z is always clear
+        x_charge(e, base);
+        x_mov_imm(e, X_ESI, op);
+        x_call(e, FN(jit_cb));
+        e8(e, 0x80); // and byte [rbx + f], ~Z
+        e_mem(e, 4, CPU_OFF(f));
+        e8(e, (u8)~FLAG_Z);
+        return false;
+    }
+
+    // ----- The rest -----
+    if (x == 0 && z == 1) {
+        // ADD HL, rr (odd y; LD rr, d16 is handled above)
+        u8 p = y >> 1;
+        x_charge(e, base);
+        if (p == 3) {
+            e8(e, 0x0F); // movzx esi, word [rbx + sp]
+            e8(e, 0xB7);
+            e_mem(e, X_ESI, CPU_OFF(sp));
+        }
+        else {
+            x_load_pair(e, X_ESI, pair_off(p));
+        }
+        x_call(e, FN(jit_add_hl));
+        return false;
+    }
+
+    if (op == 0x34 || op == 0x35) {
+        // INC (HL) / DEC (HL)
+        x_charge(e, base);
+        x_set_pc(e, next);
+        x_mov_imm(e, X_ESI, op == 0x35);
+        x_call(e, FN(jit_inc_hl));
+        x_exit_if_eax(e);
+        return false;
+    }
+
+    if (op == 0x27) {
+        // DAA
+        x_charge(e, base);
+        x_call(e, FN(jit_daa));
+        return false;
+    }
+
+    if (op == 0xF3) {
+        // DI: EI always ends its block, so there is no pending EI to cancel
+        x_charge(e, base);
+        x_store8_imm(e, CPU_OFF(ime), 0);
+        return false;
+    }
+
+    // NOP (the only opcode left)
+    x_charge(e, base);
+    return false;
+}
+
+// ---------------------------------------------
+// Block cache
+// ---------------------------------------------
+
+static u32 jit_hash(const u8 *src) {
+    return (u32)(((u64)(uintptr_t)src * 0x9E3779B97F4A7C15ull) >> 40) & (JIT_TABLE_SIZE - 1);
+}
+
+static void jit_table_insert(CpuJit *jit, u32 index) {
+    u32 slot = jit_hash(jit->blocks[index].src);
+    while (jit->table[slot])
+        slot = (slot + 1) & (JIT_TABLE_SIZE - 1);
+    jit->table[slot] = index + 1;
+}
+
+static JitBlock *jit_lookup(CpuJit *jit, const u8 *src) {
+    u32 slot = jit_hash(src);
+
+    while (jit->table[slot]) {
+        JitBlock *blk = &jit->blocks[jit->table[slot] - 1];
+        if (blk->src == src)
+            return blk;
+        slot = (slot + 1) & (JIT_TABLE_SIZE - 1);
+    }
+    return NULL;
+}
+
+static void jit_reset(CpuJit *jit) {
+    jit->code_used   = 0;
+    jit->block_count = 0;
+    memset(jit->table, 0, sizeof(jit->table));
+}
+
+// LAHF/SAHF in 64-bit mode is missing on the very first x86-64 CPUs
+static bool jit_host_ok(void) {
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx))
+        return false;
+    return ecx & 1;
+}
+
+// Anonymous shared memory object to back the two views of the code buffer
+static int jit_code_fd(void) {
+#if defined(__linux__)
+    return memfd_create("baredmg-jit", MFD_CLOEXEC);
+#else
+    // Unlinked right away; the stack address keeps concurrent threads apart
+    char name[64];
+    snprintf(name, sizeof(name), "/baredmg-jit-%ld-%p", (long)getpid(), (void *)name);
+
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0)
+        shm_unlink(name);
+    return fd;
+#endif
+}
+
+static CpuJit *jit_create(void) {
+    if (!jit_host_ok())
+        return NULL;
+
+    CpuJit *jit = calloc(1, sizeof(CpuJit));
+    int     fd  = jit ? jit_code_fd() : -1;
+    if (fd < 0) {
+        free(jit);
+        return NULL;
+    }
+
+    void *rw = MAP_FAILED, *rx = MAP_FAILED;
+    if (ftruncate(fd, JIT_CODE_SIZE) == 0) {
+        rw = mmap(NULL, JIT_CODE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        rx = mmap(NULL, JIT_CODE_SIZE, PROT_READ | PROT_EXEC, MAP_SHARED, fd, 0);
+    }
+    close(fd); // The mappings keep the memory
+
+    if (rw == MAP_FAILED || rx == MAP_FAILED) {
+        if (rw != MAP_FAILED)
+            munmap(rw, JIT_CODE_SIZE);
+        if (rx != MAP_FAILED)
+            munmap(rx, JIT_CODE_SIZE);
+        free(jit);
+        return NULL;
+    }
+
+    jit->code = rw;
+    jit->exec = rx;
+    return jit;
+}
+
+// Translate the block starting at pc; NULL if it can't be translated
+static JitBlock *jit_compile(GameBoy *gb, CpuJit *jit, u16 pc) {
+    u8 *page = gb->read_map[pc >> MMU_PAGE_SHIFT];
+    if (!page)
+        return NULL;
+
+    if (jit->block_count == JIT_MAX_BLOCKS ||
+        JIT_CODE_SIZE - jit->code_used < JIT_MAX_BLOCK_BYTES) {
+        jit_reset(jit);
+        jit->stats.flushes++;
+    }
+
+    Emitter e     = {jit->code + jit->code_used};
+    u8     *start = e.p;
+    u32     max   = 0;
+    u16     cur   = pc;
+    u32     count = 0;
+    bool    ended = false;
+
+    e8(&e, 0x53); // push rbx
+    e8(&e, 0x48); // mov rbx, rdi
+    e8(&e, 0x89);
+    e8(&e, 0xFB);
+
+    while (!ended && count < JIT_MAX_INSNS) {
+        u16 off = cur & 0xFF;
+        u8  len = cpu_op_length[page[off]];
+
+        // Blocks never leave their page: the next page may map elsewhere
+        if ((cur >> MMU_PAGE_SHIFT) != (pc >> MMU_PAGE_SHIFT) || off + len > MMU_PAGE_SIZE)
+            break;
+
+        ended = jit_emit_insn(&e, cur, page + off, &max);
+        cur   = (u16)(cur + len);
+        count++;
+    }
+
+    if (count == 0)
+        return NULL;
+
+    if (!ended) {
+        x_set_pc(&e, cur);
+        x_exit(&e);
+    }
+
+    jit->code_used += (size_t)(e.p - start);
+
+    JitBlock *blk   = &jit->blocks[jit->block_count];
+    blk->src        = page + (pc & 0xFF);
+    blk->max_cycles = max;
+    u8 *entry       = jit->exec + (start - jit->code);
+    memcpy(&blk->fn, &entry, sizeof(blk->fn));
+    jit_table_insert(jit, jit->block_count++);
+    jit->stats.blocks_compiled++;
+
+    // Code in RAM: get told about the first write to it
+    if (gb->write_base[pc >> MMU_PAGE_SHIFT])
+        mmu_watch_page(gb, pc >> MMU_PAGE_SHIFT, MMU_WATCH_CODE);
+
+    return blk;
+}
+
+bool cpu_jit_available(void) {
+    return jit_host_ok();
+}
+
+// Run with translated blocks where possible (same contract as cpu_run)
+u32 cpu_jit_run(GameBoy *gb, u32 budget) {
+    if (!gb->jit) {
+        // Set up on first use. If the host refuses (no executable memory,
+        // ...) that is recorded once & the interpreter takes over for good.
+        if (!gb->jit_failed)
+            gb->jit = jit_create();
+        if (!gb->jit) {
+            gb->jit_failed  = true;
+            gb->jit_enabled = false;
+            return cpu_run(gb, budget);
+        }
+    }
+
+    CpuJit *jit   = gb->jit;
+    CPU    *cpu   = &gb->cpu;
+    u64     start = gb->cycles;
+    u64     end   = start + budget;
+
+    while (gb->cycles < end) {
+        // Nothing can wake the CPU before the next event: let the interpreter
+        // skip ahead to it (or the end) in one step
+        u8   pending = gb->ie_register & gb->if_register & INT_MASK;
+        bool idle    = cpu->locked || (cpu->halted && !pending) ||
+                    (cpu->stopped && !(pending & INT_JOYPAD));
+        if (idle && gb->sched.next > gb->cycles) {
+            u64 until = gb->sched.next < end ? gb->sched.next : end;
+            cpu_run(gb, (u32)(until - gb->cycles));
+            continue;
+        }
+
+        // Interrupts, HALT, STOP & the EI delay are the interpreter's business
+        if (cpu->halted || cpu->stopped || cpu->locked || cpu->ime_pending || cpu->halt_bug ||
+            (cpu->ime && (gb->ie_register & gb->if_register & INT_MASK))) {
+            cpu_step(gb);
+            continue;
+        }
+
+        const u8 *page = gb->read_map[cpu->pc >> MMU_PAGE_SHIFT];
+        JitBlock *blk  = NULL;
+
+        if (page) {
+            blk = jit_lookup(jit, page + (cpu->pc & 0xFF));
+            if (!blk)
+                blk = jit_compile(gb, jit, cpu->pc);
+        }
+
+        // Only enter a block that can't run past the budget or the next event
+        if (blk && gb->cycles + blk->max_cycles <= end &&
+            gb->cycles + blk->max_cycles <= gb->sched.next) {
+            jit->stats.blocks_executed++;
+            blk->fn(gb);
+        }
+        else {
+            // No block (HRAM code) or too close to the next event: interpret up to it
+            u64 until  = gb->sched.next < end ? gb->sched.next : end;
+            u64 before = cpu->instructions;
+            cpu_run(gb, until > gb->cycles ? (u32)(until - gb->cycles) : 1);
+            jit->stats.interp_steps += cpu->instructions - before;
+        }
+    }
+
+    // Like cpu_run(), leave no event overdue
+    if (gb->cycles >= gb->sched.next)
+        sched_dispatch(gb);
+
+    return (u32)(gb->cycles - start);
+}
+
+// Drop all blocks translated from one host page
+void cpu_jit_invalidate(GameBoy *gb, const u8 *host_page) {
+    CpuJit *jit = gb->jit;
+    if (!jit || !host_page)
+        return;
+
+    u32 kept = 0;
+    for (u32 i = 0; i < jit->block_count; i++) {
+        const u8 *src = jit->blocks[i].src;
+        if (src >= host_page && src < host_page + MMU_PAGE_SIZE)
+            jit->stats.invalidations++;
+        else
+            jit->blocks[kept++] = jit->blocks[i];
+    }
+
+    // Rebuild the hash table for the surviving blocks
+    // (their code stays in the buffer until the next flush)
+    jit->block_count = kept;
+    memset(jit->table, 0, sizeof(jit->table));
+    for (u32 i = 0; i < kept; i++)
+        jit_table_insert(jit, i);
+}
+
+void cpu_jit_flush(GameBoy *gb) {
+    if (gb->jit) {
+        jit_reset(gb->jit);
+        gb->jit->stats.flushes++;
+    }
+}
+
+void cpu_jit_free(GameBoy *gb) {
+    if (!gb->jit)
+        return;
+
+    munmap(gb->jit->code, JIT_CODE_SIZE);
+    munmap(gb->jit->exec, JIT_CODE_SIZE);
+    free(gb->jit);
+    gb->jit = NULL;
+}
+
+#else // !JIT_SUPPORTED
+
+// No JIT on this host: everything runs in the interpreter
+
+bool cpu_jit_available(void) {
+    return false;
+}
+
+// No JIT in this build: recorded like a failed setup
+u32 cpu_jit_run(GameBoy *gb, u32 budget) {
+    gb->jit_failed  = true;
+    gb->jit_enabled = false;
+    return cpu_run(gb, budget);
+}
+
+void cpu_jit_invalidate(GameBoy *gb, const u8 *host_page) {
+    (void)gb;
+    (void)host_page;
+}
+
+void cpu_jit_flush(GameBoy *gb) {
+    (void)gb;
+}
+
+void cpu_jit_free(GameBoy *gb) {
+    (void)gb;
+}
+
+#endif
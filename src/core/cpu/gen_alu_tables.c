@@ -0,0 +1,155 @@
+// src/core/cpu/gen_alu_tables.c
+// Build-time generator for <core/alu_tables.h> (run by src/core/CMakeLists.txt)
+#include <core/cpu.h>
+#include <stdio.h>
+
+/*
+ALU lookup tables
+
+DAA & the CB rotates/shifts are short chains of data-dependent branches;
+indexed by their inputs they become a single load each. The tables are
+written out here as static const arrays in a header, so cpu_exec.c can
+inline them & the compiler sees constant data, not a call into utils.c.
+
+The values come from the instruction definitions below, written
+independently of utils.c; test_utils.c checks every entry against
+adjust_bcd() and the shift definitions.
+
+Nothing is generated for ADD/ADC/SUB/SBC/CP: with lazy flags (cpu_exec.c)
+those store their operands and never build F at the instruction, and an
+operand-indexed table (64K entries per op) would only push the decode cache
+& page tables out of the data cache.
+*/
+
+#define PER_LINE 8
+
+// DAA: A & N/H/C in, MAKE_U16(F, A) out
+static u16 daa(u8 a, u8 f) {
+    bool n     = f & FLAG_N;
+    bool h     = f & FLAG_H;
+    bool carry = f & FLAG_C;
+    u8   adj   = 0;
+
+    if (h || (!n && (a & 0x0F) > 0x09))
+        adj |= 0x06;
+    if (carry || (!n && a > 0x99)) {
+        adj |= 0x60;
+        carry = true;
+    }
+
+    u8 res = n ? (u8)(a - adj) : (u8)(a + adj);
+    u8 out = (res == 0 ? FLAG_Z : 0) | (n ? FLAG_N : 0) | (carry ? FLAG_C : 0);
+    return MAKE_U16(out, res);
+}
+
+// Rotate/shift `kind` (CB order) of val with carry in: result | carry out << 8
+static u16 shift(int kind, u8 val, bool carry) {
+    u8   res;
+    bool out;
+
+    switch (kind) {
+        case 0: // RLC
+            res = (u8)(val << 1) | (val >> 7);
+            out = val & 0x80;
+            break;
+        case 1: // RRC
+            res = (u8)(val >> 1) | (u8)(val << 7);
+            out = val & 0x01;
+            break;
+        case 2: // RL
+            res = (u8)(val << 1) | carry;
+            out = val & 0x80;
+            break;
+        case 3: // RR
+            res = (val >> 1) | (carry ? 0x80 : 0);
+            out = val & 0x01;
+            break;
+        case 4: // SLA
+            res = (u8)(val << 1);
+            out = val & 0x80;
+            break;
+        case 5: // SRA
+            res = (val >> 1) | (val & 0x80);
+            out = val & 0x01;
+            break;
+        case 6: // SWAP
+            res = (u8)(val << 4) | (val >> 4);
+            out = false;
+            break;
+        default: // SRL
+            res = val >> 1;
+            out = val & 0x01;
+            break;
+    }
+    return res | (out ? 0x100 : 0);
+}
+
+static void put_entry(FILE *f, int i, u16 val) {
+    if (i % PER_LINE == 0)
+        fputs("    ", f);
+    fprintf(f, "0x%04X,", val);
+    fputs(i % PER_LINE == PER_LINE - 1 ? "\n" : " ", f);
+}
+
+static void write_header(FILE *f) {
+    fputs("// core/alu_tables.h\n"
+          "// Generated by gen_alu_tables (src/core/cpu/gen_alu_tables.c): do not edit\n"
+          "#ifndef ALU_TABLES_H\n"
+          "#define ALU_TABLES_H\n"
+          "\n"
+          "#include <core/cpu.h>\n"
+          "\n"
+          "// DAA: index ALU_DAA_INDEX(A, F), only N/H/C of F count. Entry: MAKE_U16(F, A)\n"
+          "#define ALU_DAA_INDEX(a, f) ((((f) & (FLAG_N | FLAG_H | FLAG_C)) << 4) | (a))\n"
+          "\n"
+          "static const u16 alu_daa_table[0x800] = {\n",
+          f);
+    for (int i = 0; i < 0x800; i++)
+        put_entry(f, i, daa((u8)i, (u8)((i >> 4) & 0x70)));
+    fputs("};\n"
+          "\n"
+          "// Rotates & shifts, rows in CB opcode order (CB op >> 3 for 0x00 - 0x3F).\n"
+          "// Index: carry in << 8 | value. Entry: result | carry out << 8.\n"
+          "typedef enum {\n"
+          "    ALU_RLC,\n"
+          "    ALU_RRC,\n"
+          "    ALU_RL,\n"
+          "    ALU_RR,\n"
+          "    ALU_SLA,\n"
+          "    ALU_SRA,\n"
+          "    ALU_SWAP,\n"
+          "    ALU_SRL,\n"
+          "} AluShift;\n"
+          "\n"
+          "static const u16 alu_shift_table[8][0x200] = {\n",
+          f);
+    for (int kind = 0; kind < 8; kind++) {
+        fputs("  {\n", f);
+        for (int i = 0; i < 0x200; i++)
+            put_entry(f, i, shift(kind, (u8)i, i >> 8));
+        fputs("  },\n", f);
+    }
+    fputs("};\n"
+          "\n"
+          "#endif // ALU_TABLES_H\n",
+          f);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <alu_tables.h>\n", argv[0]);
+        return 1;
+    }
+
+    FILE *f = fopen(argv[1], "w");
+    if (!f) {
+        fprintf(stderr, "Failed to open %s\n", argv[1]);
+        return 1;
+    }
+    write_header(f);
+    if (fclose(f) != 0) {
+        fprintf(stderr, "Failed to write %s\n", argv[1]);
+        return 1;
+    }
+    return 0;
+}
@@ -1,13 +1,34 @@
 // src/core/gbemu.c
 #include <gbemu.h>
 #include <core/bus.h>
+#include <core/trace.h>
 #include <string.h>
 #include <stdio.h>
 
 // Initialize the GameBoy instance
 void gb_init(GameBoy *gb) {
     memset(gb, 0, sizeof(GameBoy));
-    // TODO: cpu_init(&gb->cpu, gb)
+    gb->ppu.pix = pixel_kernels_best(); // VRAM writes may come before ppu_reset()
+    sched_init(&gb->sched);
+    mmu_map_init(gb);
+    cpu_init(&gb->cpu);
+}
+
+// Post-boot-ROM state for the cartridge that was just loaded
+static void gb_power_on(GameBoy *gb) {
+    // Cartridge memory moved: rebuild the page table & drop decoded/translated code
+    mmu_map_init(gb);
+    cpu_decode_flush(gb);
+    cpu_jit_flush(gb);
+
+    cpu_reset(&gb->cpu);
+    sched_init(&gb->sched);
+    ppu_reset(gb);
+    timer_reset(gb);
+    apu_reset(gb); // Frame sequencer follows DIV
+    serial_reset(gb);
+    joypad_reset(gb);
+    gb->running = true;
 }
 
 // Load a cartridge into GameBoy
@@ -24,8 +45,29 @@ void gb_load_rom(GameBoy *gb, const char *path) {
     cart_print_header(&gb->cart.header);
     printf("\n");
 
-    // TODO: cpu_reset(&gb->cpu);
-    gb->running = true;
+    gb_power_on(gb);
+}
+
+// Load a cartridge from a ROM image in memory, quietly (for batch runs)
+bool gb_load_rom_buffer(GameBoy *gb, const u8 *data, size_t size) {
+    if (cart_load_buffer(&gb->cart, data, size) != 0) {
+        gb->running = false;
+        return false;
+    }
+
+    gb_power_on(gb);
+    return true;
+}
+
+// Load a cartridge on top of a shared ROM image (rom_store_open), quietly
+bool gb_load_rom_image(GameBoy *gb, RomImage *image) {
+    if (cart_load_image(&gb->cart, image) != 0) {
+        gb->running = false;
+        return false;
+    }
+
+    gb_power_on(gb);
+    return true;
 }
 
 // Exeucte a single CPU instruction step
@@ -33,9 +75,24 @@ void gb_step(GameBoy *gb) {
     if (!gb->running)
         return;
 
-    u8 cycles = 0;
-    // TODO: u8 cycles = cpu_step(&gb->cpu);
-    gb->cycles += cycles;
+    // cpu_step advances gb->cycles itself
+    cpu_step(gb);
+}
+
+// Run the CPU (and through the scheduler everything else) until cycle `end`
+static void gb_run_until(GameBoy *gb, u64 end) {
+    while (gb->cycles < end) {
+        u32 budget = end - gb->cycles > UINT32_MAX ? UINT32_MAX : (u32)(end - gb->cycles);
+        if (gb->jit_enabled && !gb->trace) // Translated blocks aren't traced
+            cpu_jit_run(gb, budget);
+        else
+            cpu_run(gb, budget);
+    }
+
+    // Catch the picture up for whoever looks at it next, & hand the sound
+    // synthesized meanwhile to the audio ring
+    ppu_sync(gb);
+    apu_end_frame(gb);
 }
 
 // Run the emulator for the duration of one video frame
@@ -43,14 +100,38 @@ void gb_run_frame(GameBoy *gb) {
     if (!gb->running)
         return;
 
-    // GameBoy runs at ~4.19 MHz
-    // 1 frame @ 60 Hz = 70224 cycles
-    u32 frame_cycles = 0;
+    // The CPU runs the whole frame budget in one call; PPU, timer, serial etc.
+    // are driven from inside it by the scheduler (scheduler.c), not ticked here.
+    // Frames end on absolute cycle boundaries so instruction overshoot doesn't drift.
+    gb_run_until(gb, (gb->cycles / CYCLES_PER_FRAME + 1) * CYCLES_PER_FRAME);
 
-    while (frame_cycles < 70224) {
-        u8 cycles = 0;
-        // TODO: u8 cycles = cpu_step(&gb->cpu);
-        frame_cycles += cycles;
-        gb->cycles += cycles;
-    }
+    // Battery RAM goes to the disk in batches, not per write
+    u32 interval = gb->save_interval ? gb->save_interval : GB_SAVE_INTERVAL;
+    if (gb->cart.save_path && ++gb->save_frames >= interval)
+        gb_flush_save(gb);
+}
+
+// Run the emulator for (at least) `cycles` clock cycles
+void gb_run_cycles(GameBoy *gb, u64 cycles) {
+    if (!gb->running)
+        return;
+
+    gb_run_until(gb, gb->cycles + cycles);
+}
+
+// Write the dirty battery RAM pages & watch them again
+void gb_flush_save(GameBoy *gb) {
+    gb->save_frames = 0;
+    if (cart_save_flush(&gb->cart))
+        mmu_watch_save(gb);
+}
+
+// Release everything gb_load_rom & the CPU backends allocated
+void gb_unload(GameBoy *gb) {
+    trace_stop(gb);
+    cpu_jit_free(gb);
+    cpu_decode_free(gb);
+    cart_unload(&gb->cart); // Flushes the save file
+    gb->save_frames = 0;
+    gb->running     = false;
 }
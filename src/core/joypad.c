@@ -0,0 +1,41 @@
+// src/core/joypad.c
+#include <core/joypad.h>
+#include <core/cpu.h>
+#include <gbemu.h>
+
+// P1 bits 0 - 3: the selected rows ANDed, 0 = pressed
+static u8 joypad_lines(const Joypad *joypad) {
+    u8 pressed = 0;
+    if (!(joypad->select & P1_SELECT_DPAD))
+        pressed |= joypad->buttons & 0x0F;
+    if (!(joypad->select & P1_SELECT_BUTTONS))
+        pressed |= joypad->buttons >> 4;
+    return (u8)~pressed & 0x0F;
+}
+
+// Any line going high to low requests the interrupt
+static void joypad_update(GameBoy *gb, u8 before) {
+    if (before & ~joypad_lines(&gb->joypad))
+        cpu_request_interrupt(gb, INT_JOYPAD);
+}
+
+void joypad_reset(GameBoy *gb) {
+    gb->joypad.select  = P1_SELECT_DPAD | P1_SELECT_BUTTONS;
+    gb->joypad.buttons = 0;
+}
+
+void joypad_set_buttons(GameBoy *gb, u8 buttons) {
+    u8 before          = joypad_lines(&gb->joypad);
+    gb->joypad.buttons = buttons;
+    joypad_update(gb, before);
+}
+
+u8 joypad_read(GameBoy *gb) {
+    return 0xC0 | gb->joypad.select | joypad_lines(&gb->joypad);
+}
+
+void joypad_write(GameBoy *gb, u8 value) {
+    u8 before         = joypad_lines(&gb->joypad);
+    gb->joypad.select = value & (P1_SELECT_DPAD | P1_SELECT_BUTTONS);
+    joypad_update(gb, before);
+}
@@ -0,0 +1,441 @@
+// src/core/mbc.c
+#include <core/mbc.h>
+#include <core/bus.h>
+#include <gbemu.h>
+#include <string.h>
+
+/*
+Memory Bank Controllers
+
+Each controller has its own register write handler. A write only stores the
+register; when the value actually changed, the controller's update works out
+the banks (bank 0 -> 1, upper bits, masks) & compares them with what the page
+table shows. Only a bank that moved is remapped: a ROM window is 64 page
+table entries, the RAM window 32. Reads of banked ROM & RAM are page table
+hits like on a ROM-only cart; nothing on the read path knows there is an MBC.
+
+The RAM window is only mapped while RAM is enabled & a RAM bank is selected.
+Otherwise 0xA000 - 0xBFFF goes through the slow path to the controller's RAM
+handlers (open bus, the MBC3 clock). MBC2's built-in RAM is 4 bits wide &
+mirrored, so it always takes the slow path; it holds the low nibbles & reads
+back with the upper four bits set.
+
+Before the RAM window shows another bank, code decoded or translated from the
+old one is dropped: its watches are on the window's pages, which the next
+bank takes over (see mmu_unwatch_pages).
+*/
+
+#define ROM_BANK_SIZE 0x4000
+#define RAM_BANK_SIZE 0x2000
+
+// ---------------------------------------------
+// Banks -> Page Table
+// ---------------------------------------------
+
+// banks rounded up to a power of two, minus one
+static u32 mbc_mask(size_t size, size_t bank_size) {
+    size_t banks = (size + bank_size - 1) / bank_size;
+    u32    n     = 1;
+    while (n < banks)
+        n <<= 1;
+    return n - 1;
+}
+
+static void mbc_map_ram(GameBoy *gb) {
+    const Mbc *mbc   = &gb->cart.mbc;
+    u16        pages = 0;
+
+    if (mbc->ram_on && mbc->ram_offset < gb->cart.ram_size) {
+        size_t left = gb->cart.ram_size - mbc->ram_offset;
+        pages       = left >= RAM_BANK_SIZE ? 0x20 : (u16)(left / MMU_PAGE_SIZE);
+    }
+
+    mmu_unwatch_pages(gb, 0xA0, 0x20);
+    mmu_map_pages(gb, 0xA0, 0x20, NULL, NULL);
+    if (pages) {
+        u8 *bank = gb->cart.ram + mbc->ram_offset;
+        mmu_map_pages(gb, 0xA0, pages, bank, bank);
+        mmu_watch_save(gb);
+    }
+}
+
+// Show these ROM banks, remapping the windows that changed
+static void mbc_set_rom(GameBoy *gb, size_t rom0, size_t rom1) {
+    Mbc *mbc = &gb->cart.mbc;
+
+    if (rom0 != mbc->rom0_offset) {
+        mbc->rom0_offset = rom0;
+        mmu_map_rom_bank(gb, 0x0000, rom0);
+        PROFILE_COUNT(gb, rom_switches);
+    }
+    if (rom1 != mbc->rom1_offset) {
+        mbc->rom1_offset = rom1;
+        mmu_map_rom_bank(gb, 0x4000, rom1);
+        PROFILE_COUNT(gb, rom_switches);
+    }
+}
+
+// Show this RAM bank (or none), remapping if it changed
+static void mbc_set_ram(GameBoy *gb, bool on, size_t offset) {
+    Mbc *mbc = &gb->cart.mbc;
+
+    on = on && gb->cart.ram_size > 0;
+    if (on == mbc->ram_on && offset == mbc->ram_offset)
+        return;
+
+    mbc->ram_on     = on;
+    mbc->ram_offset = offset;
+    mbc_map_ram(gb);
+    PROFILE_COUNT(gb, ram_switches);
+}
+
+// Store a register. False if it already held the value: nothing to redo.
+static bool set_u8(u8 *reg, u8 value) {
+    bool changed = *reg != value;
+    *reg         = value;
+    return changed;
+}
+
+static bool set_u16(u16 *reg, u16 value) {
+    bool changed = *reg != value;
+    *reg         = value;
+    return changed;
+}
+
+static bool set_enable(bool *reg, u8 value) {
+    bool on      = (value & 0x0F) == 0x0A;
+    bool changed = *reg != on;
+    *reg         = on;
+    return changed;
+}
+
+// ---------------------------------------------
+// Cartridge RAM (slow path)
+// ---------------------------------------------
+
+// The mapped bank, or open bus when there is none
+static u8 mbc_ram_read(GameBoy *gb, u16 addr) {
+    const Mbc *mbc = &gb->cart.mbc;
+    size_t     off = mbc->ram_offset + (addr - 0xA000);
+
+    return (mbc->ram_on && off < gb->cart.ram_size) ? gb->cart.ram[off] : 0xFF;
+}
+
+static void mbc_ram_write(GameBoy *gb, u16 addr, u8 value) {
+    const Mbc *mbc = &gb->cart.mbc;
+    size_t     off = mbc->ram_offset + (addr - 0xA000);
+
+    if (mbc->ram_on && off < gb->cart.ram_size) {
+        gb->cart.ram[off] = value;
+        cart_ram_mark_dirty(&gb->cart, off, 1);
+    }
+}
+
+// ---------------------------------------------
+// No MBC (ROM only, ROM + RAM)
+// ---------------------------------------------
+
+static void none_write(GameBoy *gb, u16 addr, u8 value) {
+    (void)gb;
+    (void)addr;
+    (void)value;
+}
+
+static void none_update(GameBoy *gb) {
+    mbc_set_rom(gb, 0, ROM_BANK_SIZE);
+    mbc_set_ram(gb, true, 0);
+}
+
+// ---------------------------------------------
+// MBC1: 5-bit ROM bank + 2 bits shared by ROM (upper) & RAM bank
+// ---------------------------------------------
+
+static void mbc1_update(GameBoy *gb) {
+    Mbc *mbc  = &gb->cart.mbc;
+    u32  low  = mbc->rom_bank ? mbc->rom_bank : 1;
+    u32  bank = ((u32)mbc->bank_hi << 5 | low) & mbc->rom_mask;
+
+    // Mode 1: the upper bits also bank 0x0000 - 0x3FFF & select the RAM bank
+    u32 bank0 = mbc->mode ? ((u32)mbc->bank_hi << 5) & mbc->rom_mask : 0;
+    u32 ram   = mbc->mode ? mbc->bank_hi & mbc->ram_mask : 0;
+
+    mbc_set_rom(gb, (size_t)bank0 * ROM_BANK_SIZE, (size_t)bank * ROM_BANK_SIZE);
+    mbc_set_ram(gb, mbc->ram_enable, (size_t)ram * RAM_BANK_SIZE);
+}
+
+static void mbc1_write(GameBoy *gb, u16 addr, u8 value) {
+    Mbc *mbc = &gb->cart.mbc;
+    bool changed;
+
+    switch (addr >> 13) {
+        case 0: // 0x0000 - 0x1FFF: RAM enable
+            changed = set_enable(&mbc->ram_enable, value);
+            break;
+        case 1: // 0x2000 - 0x3FFF: ROM bank
+            changed = set_u16(&mbc->rom_bank, value & 0x1F);
+            break;
+        case 2: // 0x4000 - 0x5FFF: RAM bank / upper ROM bank bits
+            changed = set_u8(&mbc->bank_hi, value & 0x03);
+            break;
+        default: // 0x6000 - 0x7FFF: Banking mode
+            changed = set_u8(&mbc->mode, value & 0x01);
+            break;
+    }
+
+    if (changed)
+        mbc1_update(gb);
+}
+
+// ---------------------------------------------
+// MBC2: 4-bit ROM bank, 512 x 4 bits of RAM
+// ---------------------------------------------
+
+static void mbc2_update(GameBoy *gb) {
+    Mbc *mbc  = &gb->cart.mbc;
+    u32  bank = (mbc->rom_bank ? mbc->rom_bank : 1) & mbc->rom_mask;
+
+    mbc_set_rom(gb, 0, (size_t)bank * ROM_BANK_SIZE);
+}
+
+static void mbc2_write(GameBoy *gb, u16 addr, u8 value) {
+    Mbc *mbc = &gb->cart.mbc;
+
+    // Only 0x0000 - 0x3FFF; address bit 8 picks the register
+    if (addr >= 0x4000)
+        return;
+    if (addr & 0x0100) {
+        if (set_u16(&mbc->rom_bank, value & 0x0F))
+            mbc2_update(gb);
+    } else {
+        set_enable(&mbc->ram_enable, value);
+    }
+}
+
+static u8 mbc2_ram_read(GameBoy *gb, u16 addr) {
+    if (!gb->cart.mbc.ram_enable)
+        return 0xFF;
+    return gb->cart.ram[addr & (MBC2_RAM_SIZE - 1)] | 0xF0;
+}
+
+static void mbc2_ram_write(GameBoy *gb, u16 addr, u8 value) {
+    if (!gb->cart.mbc.ram_enable)
+        return;
+
+    u16 off           = addr & (MBC2_RAM_SIZE - 1);
+    gb->cart.ram[off] = value & 0x0F;
+    cart_ram_mark_dirty(&gb->cart, off, 1);
+}
+
+// ---------------------------------------------
+// MBC3: 7-bit ROM bank, 4 RAM banks or a clock register
+// ---------------------------------------------
+
+// Count the clock up to now (whole seconds of emulated time)
+static void rtc_sync(GameBoy *gb) {
+    Mbc *mbc = &gb->cart.mbc;
+
+    if ((mbc->rtc[4] & 0x40) || gb->cycles < mbc->rtc_synced) {
+        mbc->rtc_synced = gb->cycles; // Halted: time doesn't count
+        return;
+    }
+
+    u64 seconds = (gb->cycles - mbc->rtc_synced) / CPU_CLOCK_HZ;
+    if (!seconds)
+        return;
+    mbc->rtc_synced += seconds * CPU_CLOCK_HZ;
+
+    u64 t = seconds + mbc->rtc[0];
+    mbc->rtc[0] = (u8)(t % 60);
+    t = t / 60 + mbc->rtc[1];
+    mbc->rtc[1] = (u8)(t % 60);
+    t = t / 60 + mbc->rtc[2];
+    mbc->rtc[2] = (u8)(t % 24);
+    t = t / 24 + (mbc->rtc[3] | (u32)(mbc->rtc[4] & 0x01) << 8);
+
+    // 9-bit day counter; bit 7 of DH latches the overflow
+    if (t > 0x1FF)
+        mbc->rtc[4] |= 0x80;
+    mbc->rtc[3] = (u8)t;
+    mbc->rtc[4] = (u8)((mbc->rtc[4] & 0xFE) | ((t >> 8) & 0x01));
+}
+
+static bool rtc_selected(const Mbc *mbc) {
+    return mbc->has_rtc && mbc->bank_hi >= 0x08 && mbc->bank_hi <= 0x0C;
+}
+
+static void mbc3_update(GameBoy *gb) {
+    Mbc *mbc  = &gb->cart.mbc;
+    u32  bank = (mbc->rom_bank ? mbc->rom_bank : 1) & mbc->rom_mask;
+
+    mbc_set_rom(gb, 0, (size_t)bank * ROM_BANK_SIZE);
+    mbc_set_ram(gb, mbc->ram_enable && mbc->bank_hi < 0x04,
+                (size_t)(mbc->bank_hi & mbc->ram_mask) * RAM_BANK_SIZE);
+}
+
+static void mbc3_write(GameBoy *gb, u16 addr, u8 value) {
+    Mbc *mbc = &gb->cart.mbc;
+    bool changed;
+
+    switch (addr >> 13) {
+        case 0: // 0x0000 - 0x1FFF: RAM & clock enable
+            changed = set_enable(&mbc->ram_enable, value);
+            break;
+        case 1: // 0x2000 - 0x3FFF: ROM bank
+            changed = set_u16(&mbc->rom_bank, value & 0x7F);
+            break;
+        case 2: // 0x4000 - 0x5FFF: RAM bank (0x00 - 0x03) or clock register (0x08 - 0x0C)
+            changed = set_u8(&mbc->bank_hi, value & 0x0F);
+            break;
+        default: // 0x6000 - 0x7FFF: Writing 0x00 then 0x01 latches the clock
+            if (mbc->has_rtc && mbc->rtc_latch == 0x00 && value == 0x01) {
+                rtc_sync(gb);
+                memcpy(mbc->rtc_latched, mbc->rtc, sizeof(mbc->rtc));
+            }
+            mbc->rtc_latch = value;
+            return;
+    }
+
+    if (changed)
+        mbc3_update(gb);
+}
+
+static u8 mbc3_ram_read(GameBoy *gb, u16 addr) {
+    const Mbc *mbc = &gb->cart.mbc;
+
+    if (rtc_selected(mbc))
+        return mbc->ram_enable ? mbc->rtc_latched[mbc->bank_hi - 0x08] : 0xFF;
+    return mbc_ram_read(gb, addr);
+}
+
+static void mbc3_ram_write(GameBoy *gb, u16 addr, u8 value) {
+    static const u8 rtc_bits[5] = {0x3F, 0x3F, 0x1F, 0xFF, 0xC1};
+    Mbc            *mbc         = &gb->cart.mbc;
+
+    if (!rtc_selected(mbc)) {
+        mbc_ram_write(gb, addr, value);
+        return;
+    }
+    if (!mbc->ram_enable)
+        return;
+
+    u8 reg = mbc->bank_hi - 0x08;
+    rtc_sync(gb);
+    mbc->rtc[reg] = value & rtc_bits[reg];
+    if (reg == 0)
+        mbc->rtc_synced = gb->cycles; // Writing seconds restarts the second
+}
+
+// ---------------------------------------------
+// MBC5: 9-bit ROM bank (bank 0 allowed), 16 RAM banks
+// ---------------------------------------------
+
+static void mbc5_update(GameBoy *gb) {
+    Mbc *mbc  = &gb->cart.mbc;
+    u32  bank = mbc->rom_bank & mbc->rom_mask;
+
+    // Rumble carts use bit 3 for the motor; their RAM is small enough that
+    // ram_mask drops it
+    mbc_set_rom(gb, 0, (size_t)bank * ROM_BANK_SIZE);
+    mbc_set_ram(gb, mbc->ram_enable, (size_t)(mbc->bank_hi & mbc->ram_mask) * RAM_BANK_SIZE);
+}
+
+static void mbc5_write(GameBoy *gb, u16 addr, u8 value) {
+    Mbc *mbc = &gb->cart.mbc;
+    bool changed;
+
+    if (addr < 0x2000) // RAM enable
+        changed = set_enable(&mbc->ram_enable, value);
+    else if (addr < 0x3000) // ROM bank, low 8 bits
+        changed = set_u16(&mbc->rom_bank, (mbc->rom_bank & 0x100) | value);
+    else if (addr < 0x4000) // ROM bank, bit 8
+        changed = set_u16(&mbc->rom_bank, (u16)((mbc->rom_bank & 0xFF) | (value & 0x01) << 8));
+    else if (addr < 0x6000) // RAM bank
+        changed = set_u8(&mbc->bank_hi, value & 0x0F);
+    else
+        return;
+
+    if (changed)
+        mbc5_update(gb);
+}
+
+// ---------------------------------------------
+// MBC Functions
+// ---------------------------------------------
+
+static const struct {
+    MbcWriteFn  write;
+    MbcUpdateFn update;
+    MbcReadFn   ram_read;
+    MbcWriteFn  ram_write;
+} mbc_handlers[] = {
+    [MBC_NONE] = {none_write, none_update, mbc_ram_read, mbc_ram_write},
+    [MBC_1]    = {mbc1_write, mbc1_update, mbc_ram_read, mbc_ram_write},
+    [MBC_2]    = {mbc2_write, mbc2_update, mbc2_ram_read, mbc2_ram_write},
+    [MBC_3]    = {mbc3_write, mbc3_update, mbc3_ram_read, mbc3_ram_write},
+    [MBC_5]    = {mbc5_write, mbc5_update, mbc_ram_read, mbc_ram_write},
+};
+
+size_t mbc_init(Mbc *mbc, u8 cart_type, size_t rom_size, size_t ram_size) {
+    memset(mbc, 0, sizeof(*mbc));
+
+    switch (cart_type) {
+        case 0x01: // MBC1
+        case 0x02: // MBC1+RAM
+        case 0x03: // MBC1+RAM+BATTERY
+            mbc->type = MBC_1;
+            break;
+        case 0x05: // MBC2
+        case 0x06: // MBC2+BATTERY
+            mbc->type = MBC_2;
+            ram_size  = MBC2_RAM_SIZE;
+            break;
+        case 0x0F: // MBC3+TIMER+BATTERY
+        case 0x10: // MBC3+TIMER+RAM+BATTERY
+            mbc->has_rtc = true;
+            mbc->type    = MBC_3;
+            break;
+        case 0x11: // MBC3
+        case 0x12: // MBC3+RAM
+        case 0x13: // MBC3+RAM+BATTERY
+            mbc->type = MBC_3;
+            break;
+        case 0x19: // MBC5
+        case 0x1A: // MBC5+RAM
+        case 0x1B: // MBC5+RAM+BATTERY
+        case 0x1C: // MBC5+RUMBLE
+        case 0x1D: // MBC5+RUMBLE+RAM
+        case 0x1E: // MBC5+RUMBLE+RAM+BATTERY
+            mbc->type = MBC_5;
+            break;
+        default:
+            mbc->type = MBC_NONE;
+            break;
+    }
+
+    mbc->write     = mbc_handlers[mbc->type].write;
+    mbc->update    = mbc_handlers[mbc->type].update;
+    mbc->ram_read  = mbc_handlers[mbc->type].ram_read;
+    mbc->ram_write = mbc_handlers[mbc->type].ram_write;
+    mbc->rom_mask  = mbc_mask(rom_size < 2 * ROM_BANK_SIZE ? 2 * ROM_BANK_SIZE : rom_size,
+                              ROM_BANK_SIZE);
+    mbc->ram_mask  = mbc_mask(ram_size, RAM_BANK_SIZE);
+
+    // Power-on banks: ROM 0 & 1, RAM off (MBC5 starts with bank 1 selected)
+    mbc->rom_bank    = mbc->type == MBC_5 ? 1 : 0;
+    mbc->rom1_offset = ROM_BANK_SIZE;
+    return ram_size;
+}
+
+void mbc_map(GameBoy *gb) {
+    Mbc *mbc = &gb->cart.mbc;
+
+    // Cartridges put together by hand (tests) behave as ROM only
+    if (!mbc->update)
+        mbc_init(mbc, 0x00, gb->cart.rom_size, gb->cart.ram_size);
+
+    // Bring the banks in line with the registers, then map all three windows
+    mbc->update(gb);
+    mmu_map_rom_bank(gb, 0x0000, mbc->rom0_offset);
+    mmu_map_rom_bank(gb, 0x4000, mbc->rom1_offset);
+    mbc_map_ram(gb);
+}
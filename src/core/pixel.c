@@ -0,0 +1,229 @@
+// src/core/pixel.c
+#include <core/pixel.h>
+#include <string.h>
+
+/*
+Pixel kernels
+
+Scalar versions are the reference. On x86-64 (GCC/Clang) there are also
+SSE2 (always present there) & AVX2 versions, the latter compiled with a
+per-function target attribute so the rest of the build needs no -mavx2.
+Which one runs is picked with CPUID when a PPU is reset, never at build time.
+
+decode: every plane byte is broadcast to the 8 lanes of its row, ANDed with
+{0x80, 0x40, ..., 0x01} (reversed for X-flip) & compared to it, giving 0xFF
+for every set bit. Low plane lanes keep bit 0 of that & high plane lanes
+bit 1. SSE2 lacks byte shuffles, so the broadcast is a chain of unpacks
+(2 rows per 16 bytes); AVX2 does it with one PSHUFB (4 rows per 32 bytes).
+
+palette: SSE2 selects between the four shades with bit masks of the color;
+AVX2 uses the 4 shades as a PSHUFB table.
+*/
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(BAREDMG_NO_SIMD)
+#define PIXEL_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#else
+#define PIXEL_X86 0
+#endif
+
+// ---------------------------------------------
+// Scalar (reference)
+// ---------------------------------------------
+
+static void pixel_decode_scalar(u8 *dst, const u8 *planes, size_t rows, bool xflip) {
+    for (size_t r = 0; r < rows; r++, planes += 2, dst += 8) {
+        u8 lo = planes[0];
+        u8 hi = planes[1];
+
+        for (int i = 0; i < 8; i++) {
+            int bit = xflip ? i : 7 - i;
+            dst[i]  = (u8)((((hi >> bit) & 1) << 1) | ((lo >> bit) & 1));
+        }
+    }
+}
+
+static void pixel_palette_scalar(u8 *dst, const u8 *src, u8 palette, size_t n) {
+    u8 shades[4] = {(u8)(palette & 3), (u8)((palette >> 2) & 3), (u8)((palette >> 4) & 3),
+                    (u8)(palette >> 6)};
+
+    for (size_t i = 0; i < n; i++)
+        dst[i] = shades[src[i] & 3];
+}
+
+#if PIXEL_X86
+
+// ---------------------------------------------
+// SSE2
+// ---------------------------------------------
+
+// Decode the two rows packed in `planes` (lo0, hi0, lo1, hi1 from the low byte up)
+static inline __m128i pixel_decode2_sse2(u32 planes, __m128i bits) {
+    __m128i v  = _mm_cvtsi32_si128((int)planes);
+    v          = _mm_unpacklo_epi8(v, v);  // lo0 lo0 hi0 hi0 lo1 lo1 hi1 hi1
+    v          = _mm_unpacklo_epi16(v, v); // lo0 x4, hi0 x4, lo1 x4, hi1 x4
+    __m128i r0 = _mm_unpacklo_epi32(v, v); // lo0 x8, hi0 x8
+    __m128i r1 = _mm_unpackhi_epi32(v, v); // lo1 x8, hi1 x8
+    __m128i lo = _mm_unpacklo_epi64(r0, r1);
+    __m128i hi = _mm_unpackhi_epi64(r0, r1);
+
+    lo = _mm_cmpeq_epi8(_mm_and_si128(lo, bits), bits);
+    hi = _mm_cmpeq_epi8(_mm_and_si128(hi, bits), bits);
+    return _mm_or_si128(_mm_and_si128(lo, _mm_set1_epi8(1)), _mm_and_si128(hi, _mm_set1_epi8(2)));
+}
+
+static inline __m128i pixel_bits_sse2(bool xflip) {
+    return xflip ? _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128)
+                 : _mm_setr_epi8(-128, 64, 32, 16, 8, 4, 2, 1, -128, 64, 32, 16, 8, 4, 2, 1);
+}
+
+static void pixel_decode_sse2(u8 *dst, const u8 *planes, size_t rows, bool xflip) {
+    __m128i bits = pixel_bits_sse2(xflip);
+    u32     word;
+
+    for (; rows >= 2; rows -= 2, planes += 4, dst += 16) {
+        memcpy(&word, planes, 4);
+        _mm_storeu_si128((__m128i *)dst, pixel_decode2_sse2(word, bits));
+    }
+
+    if (rows)
+        _mm_storel_epi64((__m128i *)dst, pixel_decode2_sse2(planes[0] | (u32)planes[1] << 8, bits));
+}
+
+// Per-byte select: mask ? a : b
+static inline __m128i pixel_select_sse2(__m128i mask, __m128i a, __m128i b) {
+    return _mm_xor_si128(b, _mm_and_si128(mask, _mm_xor_si128(a, b)));
+}
+
+static void pixel_palette_sse2(u8 *dst, const u8 *src, u8 palette, size_t n) {
+    __m128i one = _mm_set1_epi8(1);
+    __m128i two = _mm_set1_epi8(2);
+    __m128i s0  = _mm_set1_epi8((char)(palette & 3));
+    __m128i s1  = _mm_set1_epi8((char)((palette >> 2) & 3));
+    __m128i s2  = _mm_set1_epi8((char)((palette >> 4) & 3));
+    __m128i s3  = _mm_set1_epi8((char)((palette >> 6) & 3));
+    size_t  i   = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i c  = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i b0 = _mm_cmpeq_epi8(_mm_and_si128(c, one), one);
+        __m128i b1 = _mm_cmpeq_epi8(_mm_and_si128(c, two), two);
+        __m128i lo = pixel_select_sse2(b0, s1, s0);
+        __m128i hi = pixel_select_sse2(b0, s3, s2);
+
+        _mm_storeu_si128((__m128i *)(dst + i), pixel_select_sse2(b1, hi, lo));
+    }
+
+    pixel_palette_scalar(dst + i, src + i, palette, n - i);
+}
+
+// ---------------------------------------------
+// AVX2
+// ---------------------------------------------
+
+#define PIXEL_AVX2_FN __attribute__((target("avx2")))
+
+PIXEL_AVX2_FN
+static void pixel_decode_avx2(u8 *dst, const u8 *planes, size_t rows, bool xflip) {
+    // Lane bytes of row r: lo at 2r, hi at 2r + 1 (PSHUFB stays within 128-bit halves)
+    const __m256i lo_idx = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 2, 2, 2, 2, 2, 2, 2, 2,
+                                            4, 4, 4, 4, 4, 4, 4, 4, 6, 6, 6, 6, 6, 6, 6, 6);
+    const __m256i hi_idx = _mm256_add_epi8(lo_idx, _mm256_set1_epi8(1));
+    const __m256i one    = _mm256_set1_epi8(1);
+    const __m256i two    = _mm256_set1_epi8(2);
+    __m128i       bits   = pixel_bits_sse2(xflip);
+    __m256i       bits2  = _mm256_broadcastsi128_si256(bits);
+    u64           word;
+
+    for (; rows >= 4; rows -= 4, planes += 8, dst += 32) {
+        memcpy(&word, planes, 8);
+        __m256i v  = _mm256_set1_epi64x((long long)word);
+        __m256i lo = _mm256_shuffle_epi8(v, lo_idx);
+        __m256i hi = _mm256_shuffle_epi8(v, hi_idx);
+
+        lo = _mm256_cmpeq_epi8(_mm256_and_si256(lo, bits2), bits2);
+        hi = _mm256_cmpeq_epi8(_mm256_and_si256(hi, bits2), bits2);
+        _mm256_storeu_si256((__m256i *)dst,
+                            _mm256_or_si256(_mm256_and_si256(lo, one), _mm256_and_si256(hi, two)));
+    }
+
+    _mm256_zeroupper(); // The tail runs legacy SSE code: avoid the AVX transition penalty
+    pixel_decode_sse2(dst, planes, rows, xflip);
+}
+
+PIXEL_AVX2_FN
+static void pixel_palette_avx2(u8 *dst, const u8 *src, u8 palette, size_t n) {
+    // The 4 shades repeated in every dword: PSHUFB with a color picks its shade
+    u32     packed = (palette & 3u) | ((palette >> 2) & 3u) << 8 | ((palette >> 4) & 3u) << 16 |
+                     ((palette >> 6) & 3u) << 24;
+    __m256i lut    = _mm256_set1_epi32((int)packed);
+    size_t  i      = 0;
+
+    for (; i + 32 <= n; i += 32) {
+        __m256i c = _mm256_loadu_si256((const __m256i *)(src + i));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_shuffle_epi8(lut, c));
+    }
+
+    if (i + 16 <= n) {
+        __m128i c = _mm_loadu_si128((const __m128i *)(src + i));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_shuffle_epi8(_mm256_castsi256_si128(lut), c));
+        i += 16;
+    }
+
+    _mm256_zeroupper();
+    pixel_palette_scalar(dst + i, src + i, palette, n - i);
+}
+
+// AVX2 needs the CPU flag & the OS saving YMM state (OSXSAVE + XCR0 bits 1-2)
+static bool pixel_host_avx2(void) {
+    unsigned int eax, ebx, ecx, edx, xcr0_lo, xcr0_hi;
+
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return false;
+    if (!(ecx & (1u << 27)) || !(ecx & (1u << 28))) // OSXSAVE, AVX
+        return false;
+
+    __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    (void)xcr0_hi;
+    if ((xcr0_lo & 6) != 6)
+        return false;
+
+    if (__get_cpuid_max(0, NULL) < 7)
+        return false;
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return ebx & (1u << 5);
+}
+
+#endif // PIXEL_X86
+
+// ---------------------------------------------
+// Dispatch
+// ---------------------------------------------
+
+static const PixelKernels pixel_table[PIXEL_ISA_COUNT] = {
+    [PIXEL_SCALAR] = {"scalar", pixel_decode_scalar, pixel_palette_scalar},
+#if PIXEL_X86
+    [PIXEL_SSE2] = {"sse2", pixel_decode_sse2, pixel_palette_sse2},
+    [PIXEL_AVX2] = {"avx2", pixel_decode_avx2, pixel_palette_avx2},
+#endif
+};
+
+const PixelKernels *pixel_kernels(PixelIsa isa) {
+    if (isa >= PIXEL_ISA_COUNT || !pixel_table[isa].decode)
+        return NULL;
+#if PIXEL_X86
+    if (isa == PIXEL_AVX2 && !pixel_host_avx2())
+        return NULL;
+#endif
+    return &pixel_table[isa];
+}
+
+const PixelKernels *pixel_kernels_best(void) {
+    for (int isa = PIXEL_ISA_COUNT - 1; isa > PIXEL_SCALAR; isa--) {
+        const PixelKernels *k = pixel_kernels((PixelIsa)isa);
+        if (k)
+            return k;
+    }
+    return &pixel_table[PIXEL_SCALAR];
+}
@@ -0,0 +1,569 @@
+// src/core/ppu.c
+#include <core/ppu.h>
+#include <core/bus.h>
+#include <core/cpu.h>
+#include <core/scheduler.h>
+#include <gbemu.h>
+#include <string.h>
+
+/*
+Lazy catch-up PPU
+
+While the LCD is on, the PPU's position is a pure function of time: frame_base
+is the cycle line 0 started at, so (gb->cycles - frame_base) % PPU_FRAME_CYCLES
+gives the line & dot. Nothing is ticked per instruction.
+
+Pixels are produced by ppu_sync(), which draws everything between `synced`
+and the current cycle, scanline by scanline. Pixel x of a line is output at
+dot PPU_OAM_CYCLES + x, so a sync that stops in the middle of mode 3 leaves
+the line half drawn & the rest is drawn with whatever the registers hold by
+the next sync. That is what makes mid-scanline writes work: every write that
+can change the picture (VRAM, OAM, LCDC, scroll, palettes, window) syncs up
+to the write cycle before it lands.
+
+Pixels never come from the 2bpp planes directly: tile data writes keep
+ppu->tiles (& the X-flipped copy) decoded, so fetching a tile row is a copy.
+Decoding & the BGP mapping of each span run on the SIMD kernels of pixel.c.
+
+ppu_sync() runs when something observes or changes PPU state:
+- reads of STAT & LY,
+- writes to VRAM (its pages are watched with MMU_WATCH_VRAM), OAM & the
+  registers above,
+- scheduler events & the end of gb_run_frame(),
+- ppu_framebuffer().
+
+Interrupts can't wait for an observer, so they are scheduler events: one
+SCHED_PPU event is kept pending at the next VBlank start or the next rising
+edge of the STAT interrupt line, whichever comes first. With no STAT sources
+selected that is a single event per frame.
+
+With drawing off (ppu_set_drawing) the sync still walks the lines, so LY,
+STAT & the interrupts are unchanged, but draws nothing & tile data writes
+aren't decoded; the tiles are decoded again when drawing comes back.
+
+Simplifications: mode 3 always takes PPU_DRAW_CYCLES, VRAM & OAM stay
+accessible in every mode (no lockout in the page table, see bus.c) & OAM
+DMA copies all 160 bytes at once.
+*/
+
+#define PPU_DRAW_START PPU_OAM_CYCLES                       // Dot pixel 0 is output at
+#define PPU_HBLANK_START (PPU_OAM_CYCLES + PPU_DRAW_CYCLES) // Dot mode 0 starts at
+
+typedef struct {
+    u8  ly;
+    u16 dot;
+} PpuPos;
+
+// ---------------------------------------------
+// Timing
+// ---------------------------------------------
+
+// Line & dot at cycle t (LCD on, t >= frame_base)
+static PpuPos ppu_pos(const Ppu *ppu, u64 t) {
+    u32 pos = (u32)((t - ppu->frame_base) % PPU_FRAME_CYCLES);
+    return (PpuPos){(u8)(pos / PPU_LINE_CYCLES), (u16)(pos % PPU_LINE_CYCLES)};
+}
+
+static PpuMode ppu_mode(PpuPos p) {
+    if (p.ly >= SCREEN_HEIGHT)
+        return PPU_MODE_VBLANK;
+    if (p.dot < PPU_DRAW_START)
+        return PPU_MODE_OAM;
+    if (p.dot < PPU_HBLANK_START)
+        return PPU_MODE_DRAW;
+    return PPU_MODE_HBLANK;
+}
+
+// STAT interrupt line: any selected source is active
+static bool ppu_stat_line(const Ppu *ppu, PpuPos p) {
+    PpuMode mode = ppu_mode(p);
+
+    return ((ppu->stat & STAT_HBLANK_INT) && mode == PPU_MODE_HBLANK) ||
+           ((ppu->stat & STAT_VBLANK_INT) && mode == PPU_MODE_VBLANK) ||
+           ((ppu->stat & STAT_OAM_INT) && mode == PPU_MODE_OAM) ||
+           ((ppu->stat & STAT_LYC_INT) && p.ly == ppu->lyc);
+}
+
+// STAT interrupt line at the current cycle
+static bool ppu_stat_line_now(const GameBoy *gb) {
+    const Ppu *ppu = &gb->ppu;
+    return (ppu->lcdc & LCDC_ENABLE) && ppu_stat_line(ppu, ppu_pos(ppu, gb->cycles));
+}
+
+// Keep one SCHED_PPU event at the first VBlank start or STAT rising edge after `from`
+static void ppu_schedule(GameBoy *gb, u64 from) {
+    Ppu *ppu = &gb->ppu;
+
+    if (!(ppu->lcdc & LCDC_ENABLE)) {
+        sched_cancel(&gb->sched, SCHED_PPU);
+        return;
+    }
+
+    PpuPos p      = ppu_pos(ppu, from);
+    u32    pos    = p.ly * PPU_LINE_CYCLES + p.dot;
+    u32    to_vbl = (SCREEN_HEIGHT * PPU_LINE_CYCLES + PPU_FRAME_CYCLES - pos) % PPU_FRAME_CYCLES;
+    u64    vblank = from + (to_vbl ? to_vbl : PPU_FRAME_CYCLES);
+    u64    t      = vblank;
+
+    // Walk the mode edges (at most 3 per line) until the STAT line rises
+    if (ppu->stat & STAT_INT_MASK) {
+        bool line = ppu_stat_line(ppu, p);
+
+        for (t = from; t < vblank;) {
+            u16 next = PPU_LINE_CYCLES;
+            if (p.ly < SCREEN_HEIGHT && p.dot < PPU_DRAW_START)
+                next = PPU_DRAW_START;
+            else if (p.ly < SCREEN_HEIGHT && p.dot < PPU_HBLANK_START)
+                next = PPU_HBLANK_START;
+
+            t += next - p.dot;
+            p.dot = next;
+            if (p.dot == PPU_LINE_CYCLES) {
+                p.dot = 0;
+                p.ly  = (p.ly + 1) % PPU_LINES;
+            }
+
+            bool now = ppu_stat_line(ppu, p);
+            if (now && !line)
+                break;
+            line = now;
+        }
+    }
+
+    sched_add(&gb->sched, SCHED_PPU, t < vblank ? t : vblank);
+}
+
+// ---------------------------------------------
+// Rendering
+// ---------------------------------------------
+
+// Shade of a 2-bit color through a palette register
+static inline u8 ppu_shade(u8 palette, u8 color) {
+    return (palette >> (color * 2)) & 0x03;
+}
+
+// Decode the tile row holding VRAM offset `offset` (< 0x1800)
+static void ppu_decode_row(GameBoy *gb, u16 offset) {
+    Ppu      *ppu    = &gb->ppu;
+    u16       tile   = offset / 16;
+    u8        row    = (offset % 16) / 2;
+    const u8 *planes = &gb->vram[offset & ~1];
+
+    ppu->pix->decode(ppu->tiles[tile][row], planes, 1, false);
+#ifndef BAREDMG_NO_TILE_XFLIP
+    ppu->pix->decode(ppu->tiles_xflip[tile][row], planes, 1, true);
+#endif
+}
+
+// Tile number of a BG/window map entry, addressed as LCDC.4 selects
+static inline u16 ppu_bg_tile(const Ppu *ppu, u8 index) {
+    return (ppu->lcdc & LCDC_TILE_DATA) ? index : (u16)(256 + (i8)index);
+}
+
+// Mirrored sprite row: from the X-flip cache, or built in `buf` without one
+static inline const u8 *ppu_xflip_row(const Ppu *ppu, u16 tile, u8 row, u8 *buf) {
+#ifndef BAREDMG_NO_TILE_XFLIP
+    (void)buf;
+    return ppu->tiles_xflip[tile][row];
+#else
+    for (int i = 0; i < 8; i++)
+        buf[i] = ppu->tiles[tile][row][7 - i];
+    return buf;
+#endif
+}
+
+// Copy `n` BG/window colors of one map row, starting at pixel column `mx`
+static void ppu_fetch_map(const Ppu *ppu, u8 *dst, const u8 *map, u8 mx, u8 row, int n) {
+    // Partial first tile (fine scroll)
+    if ((mx & 7) && n > 0) {
+        int run = 8 - (mx & 7) < n ? 8 - (mx & 7) : n;
+        memcpy(dst, ppu->tiles[ppu_bg_tile(ppu, map[mx / 8])][row] + (mx & 7), (size_t)run);
+        dst += run;
+        mx  = (u8)(mx + run);
+        n   -= run;
+    }
+
+    // Whole tiles: fixed-size copies
+    for (; n >= 8; n -= 8, dst += 8, mx = (u8)(mx + 8))
+        memcpy(dst, ppu->tiles[ppu_bg_tile(ppu, map[mx / 8])][row], 8);
+
+    if (n > 0)
+        memcpy(dst, ppu->tiles[ppu_bg_tile(ppu, map[mx / 8])][row], (size_t)n);
+}
+
+// Pick the sprites of line ly, lowest X first (ties: lowest OAM index first)
+static void ppu_select_objs(GameBoy *gb) {
+    Ppu *ppu    = &gb->ppu;
+    int  height = (ppu->lcdc & LCDC_OBJ_SIZE) ? 16 : 8;
+
+    ppu->obj_count = 0;
+    for (u8 i = 0; i < OBJ_COUNT && ppu->obj_count < OBJ_PER_LINE; i++) {
+        int y = gb->oam[i * 4] - 16;
+        if (ppu->ly < y || ppu->ly >= y + height)
+            continue;
+
+        u8 pos = ppu->obj_count++;
+        while (pos > 0 && gb->oam[ppu->obj[pos - 1] * 4 + 1] > gb->oam[i * 4 + 1]) {
+            ppu->obj[pos] = ppu->obj[pos - 1];
+            pos--;
+        }
+        ppu->obj[pos] = i;
+    }
+}
+
+// Output pixels [x0, x1) of line ly with the current registers
+static void ppu_draw_span(GameBoy *gb, int x0, int x1) {
+    Ppu *ppu = &gb->ppu;
+    u8  *out = ppu->frame[ppu->back][ppu->ly];
+    u8   bg[SCREEN_WIDTH];  // BG/window color before the palette (for sprite priority)
+    u8   obj[SCREEN_WIDTH]; // Winning sprite pixel: color | OBJ_PALETTE | OBJ_PRIORITY
+
+    // ---------------------------
+    // Background & window (LCDC.0 off blanks both)
+    // ---------------------------
+    if (ppu->lcdc & LCDC_BG_ENABLE) {
+        int win_x  = ppu->wx - 7;
+        int bg_end = x1;
+
+        if ((ppu->lcdc & LCDC_WIN_ENABLE) && ppu->window_y && win_x < x1)
+            bg_end = win_x > x0 ? win_x : x0;
+
+        u8        y   = (u8)(ppu->ly + ppu->scy);
+        const u8 *map = &gb->vram[((ppu->lcdc & LCDC_BG_MAP) ? 0x1C00 : 0x1800) + (y / 8) * 32];
+
+        ppu_fetch_map(ppu, bg + x0, map, (u8)(x0 + ppu->scx), y % 8, bg_end - x0);
+
+        if (bg_end < x1) {
+            u8 wy = ppu->window_line;
+            map   = &gb->vram[((ppu->lcdc & LCDC_WIN_MAP) ? 0x1C00 : 0x1800) + (wy / 8) * 32];
+
+            ppu_fetch_map(ppu, bg + bg_end, map, (u8)(bg_end - win_x), wy % 8, x1 - bg_end);
+            ppu->window_drawn = true;
+        }
+    }
+    else {
+        memset(bg + x0, 0, (size_t)(x1 - x0));
+    }
+
+    // ---------------------------
+    // Sprites: lowest priority first, so the winner is written last
+    // ---------------------------
+    if ((ppu->lcdc & LCDC_OBJ_ENABLE) && ppu->obj_count) {
+        memset(obj + x0, 0, (size_t)(x1 - x0));
+
+        int height = (ppu->lcdc & LCDC_OBJ_SIZE) ? 16 : 8;
+
+        for (int i = ppu->obj_count - 1; i >= 0; i--) {
+            const u8 *o    = &gb->oam[ppu->obj[i] * 4];
+            int       sx   = o[1] - 8;
+            u8        attr = o[3];
+            u8        tile = height == 16 ? (o[2] & 0xFE) : o[2];
+            int       row  = ppu->ly - (o[0] - 16);
+
+            if (attr & OBJ_YFLIP)
+                row = height - 1 - row;
+
+            TileRow   flipped;
+            const u8 *px    = ppu->tiles[tile + row / 8][row % 8];
+            int       start = sx > x0 ? sx : x0;
+            int       end   = sx + 8 < x1 ? sx + 8 : x1;
+
+            if (attr & OBJ_XFLIP)
+                px = ppu_xflip_row(ppu, tile + row / 8, row % 8, flipped);
+
+            for (int x = start; x < end; x++) {
+                u8 color = px[x - sx];
+                if (color)
+                    obj[x] = color | (attr & (OBJ_PALETTE | OBJ_PRIORITY));
+            }
+        }
+    }
+
+    // ---------------------------
+    // Map BG through BGP, then put the sprites that win over it on top
+    // ---------------------------
+    ppu->pix->palette(out + x0, bg + x0, ppu->bgp, (size_t)(x1 - x0));
+
+    if (!(ppu->lcdc & LCDC_OBJ_ENABLE) || !ppu->obj_count)
+        return;
+
+    for (int x = x0; x < x1; x++) {
+        u8 o = obj[x];
+
+        if ((o & 0x03) && !((o & OBJ_PRIORITY) && bg[x]))
+            out[x] = ppu_shade((o & OBJ_PALETTE) ? ppu->obp1 : ppu->obp0, o & 0x03);
+    }
+}
+
+// Draw line ly up to the pixel due at `dot`
+static void ppu_draw_line(GameBoy *gb, u16 dot) {
+    Ppu *ppu    = &gb->ppu;
+    int  target = dot > PPU_DRAW_START ? dot - PPU_DRAW_START : 0;
+
+    if (target > SCREEN_WIDTH)
+        target = SCREEN_WIDTH;
+    if (target <= ppu->drawn)
+        return;
+
+    // First pixel of the line: OAM scan & window Y check
+    if (ppu->drawn == 0) {
+        ppu_select_objs(gb);
+        if (ppu->ly == ppu->wy)
+            ppu->window_y = true;
+    }
+
+    ppu_draw_span(gb, ppu->drawn, target);
+    ppu->drawn = (u8)target;
+}
+
+// Move on to the next line (the current one is complete)
+static void ppu_next_line(Ppu *ppu) {
+    if (ppu->window_drawn)
+        ppu->window_line++;
+
+    ppu->window_drawn = false;
+    ppu->drawn        = 0;
+    ppu->ly++;
+
+    // VBlank: the back buffer holds a whole frame now
+    if (ppu->ly == SCREEN_HEIGHT) {
+        ppu->back ^= 1;
+        ppu->frames++;
+    }
+
+    if (ppu->ly == PPU_LINES) {
+        ppu->ly          = 0;
+        ppu->window_line = 0;
+        ppu->window_y    = false;
+    }
+}
+
+// Draw everything up to gb->cycles
+void ppu_sync(GameBoy *gb) {
+    Ppu *ppu = &gb->ppu;
+    u64  now = gb->cycles;
+
+    if (now <= ppu->synced)
+        return;
+
+    if (!(ppu->lcdc & LCDC_ENABLE)) {
+        ppu->synced = now;
+        return;
+    }
+
+    PpuPos p = ppu_pos(ppu, ppu->synced);
+    u64    t = ppu->synced;
+
+    while (t < now) {
+        u64 left = PPU_LINE_CYCLES - p.dot;
+        u16 to   = now - t < left ? (u16)(p.dot + (now - t)) : PPU_LINE_CYCLES;
+
+        if (ppu->ly < SCREEN_HEIGHT && !ppu->no_draw)
+            ppu_draw_line(gb, to);
+
+        t += to - p.dot;
+        if (to == PPU_LINE_CYCLES) {
+            ppu_next_line(ppu);
+            p.dot = 0;
+        }
+        else {
+            p.dot = to;
+        }
+    }
+
+    ppu->synced = now;
+}
+
+void ppu_set_drawing(GameBoy *gb, bool on) {
+    ppu_sync(gb);
+    if (on && gb->ppu.no_draw)
+        ppu_refresh_tiles(gb); // VRAM writes weren't decoded meanwhile
+    gb->ppu.no_draw = !on;
+}
+
+// ---------------------------------------------
+// Registers & Memory
+// ---------------------------------------------
+
+// Set the DMG post-boot-ROM state
+void ppu_reset(GameBoy *gb) {
+    Ppu *ppu     = &gb->ppu;
+    bool no_draw = ppu->no_draw;
+
+    memset(ppu, 0, sizeof(*ppu));
+    ppu->no_draw    = no_draw;
+    ppu->pix        = pixel_kernels_best();
+    ppu->lcdc       = 0x91;
+    ppu->bgp        = 0xFC;
+    ppu->obp0       = 0xFF;
+    ppu->obp1       = 0xFF;
+    ppu->frame_base = gb->cycles;
+    ppu->synced     = gb->cycles;
+    ppu_refresh_tiles(gb);
+    ppu_schedule(gb, gb->cycles);
+}
+
+// LCDC write: switching the LCD on restarts the frame at line 0
+static void ppu_write_lcdc(GameBoy *gb, u8 value) {
+    Ppu *ppu = &gb->ppu;
+
+    if ((value ^ ppu->lcdc) & LCDC_ENABLE) {
+        ppu->ly           = 0;
+        ppu->drawn        = 0;
+        ppu->window_line  = 0;
+        ppu->window_y     = false;
+        ppu->window_drawn = false;
+
+        if (value & LCDC_ENABLE)
+            ppu->frame_base = gb->cycles;
+        else
+            memset(ppu->frame[ppu->back ^ 1], 0, sizeof(ppu->frame[0])); // Blank screen
+    }
+
+    ppu->lcdc = value;
+}
+
+// OAM DMA: copy 160 bytes from (value << 8) at once
+static void ppu_dma(GameBoy *gb, u8 value) {
+    u16 src = (u16)(value << 8);
+
+    gb->ppu.dma = value;
+    for (u16 i = 0; i < sizeof(gb->oam); i++)
+        gb->oam[i] = mmu_read(gb, (u16)(src + i));
+}
+
+u8 ppu_read(GameBoy *gb, u16 addr) {
+    Ppu *ppu = &gb->ppu;
+
+    switch (addr) {
+        case 0xFF40: // LCDC
+            return ppu->lcdc;
+        case 0xFF41: { // STAT (bit 7 reads as 1)
+            ppu_sync(gb);
+            u8 stat = 0x80 | ppu->stat | (ppu->ly == ppu->lyc ? STAT_LYC_EQUAL : 0);
+            if (ppu->lcdc & LCDC_ENABLE)
+                stat |= ppu_mode(ppu_pos(ppu, gb->cycles));
+            return stat;
+        }
+        case 0xFF42: // SCY
+            return ppu->scy;
+        case 0xFF43: // SCX
+            return ppu->scx;
+        case 0xFF44: // LY
+            ppu_sync(gb);
+            return ppu->ly;
+        case 0xFF45: // LYC
+            return ppu->lyc;
+        case 0xFF46: // DMA
+            return ppu->dma;
+        case 0xFF47: // BGP
+            return ppu->bgp;
+        case 0xFF48: // OBP0
+            return ppu->obp0;
+        case 0xFF49: // OBP1
+            return ppu->obp1;
+        case 0xFF4A: // WY
+            return ppu->wy;
+        case 0xFF4B: // WX
+            return ppu->wx;
+        default:
+            return 0xFF;
+    }
+}
+
+void ppu_write(GameBoy *gb, u16 addr, u8 value) {
+    Ppu *ppu       = &gb->ppu;
+    bool stat_line = ppu_stat_line_now(gb);
+
+    // Everything before this write is drawn with the old value
+    ppu_sync(gb);
+
+    switch (addr) {
+        case 0xFF40: // LCDC
+            ppu_write_lcdc(gb, value);
+            break;
+        case 0xFF41: // STAT (only the interrupt selects are writable)
+            ppu->stat = value & STAT_INT_MASK;
+            break;
+        case 0xFF42: // SCY
+            ppu->scy = value;
+            return;
+        case 0xFF43: // SCX
+            ppu->scx = value;
+            return;
+        case 0xFF45: // LYC
+            ppu->lyc = value;
+            break;
+        case 0xFF46: // DMA
+            ppu_dma(gb, value);
+            return;
+        case 0xFF47: // BGP
+            ppu->bgp = value;
+            return;
+        case 0xFF48: // OBP0
+            ppu->obp0 = value;
+            return;
+        case 0xFF49: // OBP1
+            ppu->obp1 = value;
+            return;
+        case 0xFF4A: // WY
+            ppu->wy = value;
+            return;
+        case 0xFF4B: // WX
+            ppu->wx = value;
+            return;
+        default: // LY is read only
+            return;
+    }
+
+    // LCDC, STAT & LYC move the interrupt edges (& may raise the line right now)
+    if (!stat_line && ppu_stat_line_now(gb))
+        cpu_request_interrupt(gb, INT_STAT);
+    ppu_schedule(gb, gb->cycles);
+}
+
+void ppu_write_vram(GameBoy *gb, u16 addr, u8 value) {
+    ppu_sync(gb);
+    gb->vram[addr - 0x8000] = value;
+
+    if (addr < 0x9800 && !gb->ppu.no_draw)
+        ppu_decode_row(gb, addr - 0x8000);
+}
+
+void ppu_refresh_tiles(GameBoy *gb) {
+    Ppu *ppu = &gb->ppu;
+
+    // Tiles & their rows are laid out like the 2bpp data: one call decodes all
+    ppu->pix->decode(ppu->tiles[0][0], gb->vram, TILE_COUNT * 8, false);
+#ifndef BAREDMG_NO_TILE_XFLIP
+    ppu->pix->decode(ppu->tiles_xflip[0][0], gb->vram, TILE_COUNT * 8, true);
+#endif
+}
+
+void ppu_write_oam(GameBoy *gb, u16 addr, u8 value) {
+    ppu_sync(gb);
+    gb->oam[addr - 0xFE00] = value;
+}
+
+// Last completed frame
+const u8 *ppu_framebuffer(GameBoy *gb) {
+    ppu_sync(gb);
+    return &gb->ppu.frame[gb->ppu.back ^ 1][0][0];
+}
+
+// SCHED_PPU handler
+void ppu_event(GameBoy *gb, u64 when) {
+    Ppu   *ppu = &gb->ppu;
+    PpuPos p   = ppu_pos(ppu, when);
+
+    ppu_sync(gb);
+
+    if (p.ly == SCREEN_HEIGHT && p.dot == 0)
+        cpu_request_interrupt(gb, INT_VBLANK);
+
+    if (when > ppu->frame_base && ppu_stat_line(ppu, p) &&
+        !ppu_stat_line(ppu, ppu_pos(ppu, when - 1)))
+        cpu_request_interrupt(gb, INT_STAT);
+
+    ppu_schedule(gb, when);
+}
@@ -0,0 +1,86 @@
+// src/core/profile.c
+#include <core/profile.h>
+
+/*
+Guest profile report
+
+The counters themselves are bumped inline by the PROFILE_* macros (bus.h,
+cpu_exec.c, mbc.c); this file only merges & prints them. The JSON is flat
+enough to load straight into a script: opcode & register tables are objects
+keyed by hex ("0x3E", "0xFF44") holding only what was actually seen.
+*/
+
+static const char *const region_names[PROF_REGION_COUNT] = {
+    "rom0", "romx", "vram", "sram", "wram", "echo", "oam", "unusable", "io", "hram", "ie",
+};
+
+void profile_add(Profile *dst, const Profile *src) {
+    for (int i = 0; i < 256; i++) {
+        dst->ops[i]    += src->ops[i];
+        dst->cb_ops[i] += src->cb_ops[i];
+    }
+    for (int i = 0; i < PROF_REGION_COUNT; i++) {
+        dst->reads[i]  += src->reads[i];
+        dst->writes[i] += src->writes[i];
+    }
+    for (int i = 0; i < 0x80; i++) {
+        dst->io_reads[i]  += src->io_reads[i];
+        dst->io_writes[i] += src->io_writes[i];
+    }
+    dst->rom_switches += src->rom_switches;
+    dst->ram_switches += src->ram_switches;
+}
+
+// {"<fmt % (base + i)>": count, ...} over the non-zero counts
+static void write_table(FILE *f, const char *name, const u64 *counts, int n, unsigned base,
+                        const char *key_fmt) {
+    bool first = true;
+
+    fprintf(f, "  \"%s\": {", name);
+    for (int i = 0; i < n; i++) {
+        if (!counts[i])
+            continue;
+        fprintf(f, "%s\n    \"", first ? "" : ",");
+        fprintf(f, key_fmt, base + (unsigned)i);
+        fprintf(f, "\": %llu", (unsigned long long)counts[i]);
+        first = false;
+    }
+    fprintf(f, "%s},\n", first ? "" : "\n  ");
+}
+
+static void write_regions(FILE *f, const char *name, const u64 *counts) {
+    fprintf(f, "  \"%s\": {", name);
+    for (int i = 0; i < PROF_REGION_COUNT; i++)
+        fprintf(f, "%s\"%s\": %llu", i ? ", " : "", region_names[i],
+                (unsigned long long)counts[i]);
+    fprintf(f, "},\n");
+}
+
+int profile_write_json(const Profile *p, FILE *f) {
+    u64 instructions = 0;
+    for (int i = 0; i < 256; i++)
+        instructions += p->ops[i];
+
+    fprintf(f, "{\n  \"instructions\": %llu,\n", (unsigned long long)instructions);
+    write_table(f, "ops", p->ops, 256, 0, "0x%02X");
+    write_table(f, "cb_ops", p->cb_ops, 256, 0, "0x%02X");
+    write_regions(f, "reads", p->reads);
+    write_regions(f, "writes", p->writes);
+    write_table(f, "io_reads", p->io_reads, 0x80, 0xFF00, "0x%04X");
+    write_table(f, "io_writes", p->io_writes, 0x80, 0xFF00, "0x%04X");
+    fprintf(f, "  \"mbc\": {\"rom_switches\": %llu, \"ram_switches\": %llu}\n}\n",
+            (unsigned long long)p->rom_switches, (unsigned long long)p->ram_switches);
+
+    return ferror(f) ? -1 : 0;
+}
+
+int profile_save_json(const Profile *p, const char *path) {
+    FILE *f = fopen(path, "w");
+    if (!f)
+        return -1;
+
+    int ret = profile_write_json(p, f);
+    if (fclose(f) != 0)
+        ret = -1;
+    return ret;
+}
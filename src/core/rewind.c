@@ -0,0 +1,302 @@
+// src/core/rewind.c
+#include <core/rewind.h>
+#include <gbemu.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+Rewind ring
+
+Only the newest capture (`state`) is kept whole. Capturing a new one stores
+state XOR new, compressed, as the newest ring entry & makes the new state
+current; stepping back XORs the newest entry into `state` & loads it. XOR
+works both ways, so no older state is ever rebuilt from the oldest one and
+dropping the oldest entry only shortens the history.
+
+Consecutive states differ in a few places (a frame buffer, some WRAM
+variables, a couple of VRAM tiles), so a delta is mostly zeros. It is
+coded as runs:
+
+    varint skip, varint length, `length` XORed bytes    (repeated)
+
+Both equal & changed stretches are scanned 8 bytes at a time; a changed
+run only ends at 8 equal bytes, so every run after the first saves more
+than its two varints cost: a delta never exceeds the state size + 16. Stepping back
+touches only the changed bytes, then costs one gb_load_state().
+
+The ring is a byte buffer; entries are written contiguously at `head` and
+wrap to offset 0 when they don't fit before the end. The oldest entries are
+dropped until the new one doesn't overlap live data. An index (`entries`)
+keeps each entry's place, as a ring of its own.
+*/
+
+#define DELTA_SLACK 16
+#define RING_BYTES_PER_ENTRY 256 // Index slot per this many ring bytes
+
+#define ALIGN8(x) (((x) + 7) & ~(size_t)7)
+
+static u64 rewind_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000u + (u64)ts.tv_nsec;
+}
+
+// ---------------------------------------------
+// Delta Coding
+// ---------------------------------------------
+
+static size_t put_varint(u8 *out, size_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (u8)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (u8)v;
+    return n;
+}
+
+static const u8 *get_varint(const u8 *p, size_t *v) {
+    size_t value = 0;
+    int    shift = 0;
+    while (*p & 0x80) {
+        value |= (size_t)(*p++ & 0x7F) << shift;
+        shift += 7;
+    }
+    *v = value | (size_t)*p++ << shift;
+    return p;
+}
+
+static inline bool words_equal(const u8 *a, const u8 *b) {
+    u64 x, y;
+    memcpy(&x, a, 8);
+    memcpy(&y, b, 8);
+    return x == y;
+}
+
+// Runs of a XOR b into out, returns the encoded size
+static size_t delta_encode(u8 *out, const u8 *a, const u8 *b, size_t n) {
+    size_t len = 0;
+    size_t i   = 0;
+
+    while (i < n) {
+        size_t start = i;
+        while (i + 8 <= n && words_equal(a + i, b + i))
+            i += 8;
+        while (i < n && a[i] == b[i])
+            i++;
+        if (i == n)
+            break; // Trailing equal bytes need no run
+
+        // Changed run: up to the next 8 equal bytes found 8 at a time, then
+        // back over the equal bytes just before them
+        size_t first = i;
+        while (i + 8 <= n && !words_equal(a + i, b + i))
+            i += 8;
+        if (i + 8 > n)
+            i = n;
+        while (a[i - 1] == b[i - 1])
+            i--;
+
+        len += put_varint(out + len, first - start);
+        len += put_varint(out + len, i - first);
+        for (size_t k = first; k < i; k++)
+            out[len++] = a[k] ^ b[k];
+    }
+    return len;
+}
+
+// XOR an encoded delta into dst
+static void delta_apply(u8 *dst, const u8 *p, size_t size) {
+    const u8 *end = p + size;
+
+    while (p < end) {
+        size_t skip, len;
+        p = get_varint(p, &skip);
+        p = get_varint(p, &len);
+        dst += skip;
+        for (size_t k = 0; k < len; k++)
+            dst[k] ^= p[k];
+        dst += len;
+        p   += len;
+    }
+}
+
+// ---------------------------------------------
+// Ring
+// ---------------------------------------------
+
+static RewindEntry *entry_at(Rewind *r, u32 i) {
+    return &r->entries[(r->first + i) % r->entry_cap];
+}
+
+static void drop_oldest(Rewind *r) {
+    r->stored -= r->entries[r->first].size;
+    r->first   = (r->first + 1) % r->entry_cap;
+    r->count--;
+    if (r->count == 0)
+        r->head = 0;
+}
+
+// Store r->delta as the newest entry. False if it can't fit even in an empty ring.
+static bool ring_push(Rewind *r, u32 size) {
+    u32 at;
+
+    if (size > r->ring_size)
+        return false;
+    if (r->count == r->entry_cap)
+        drop_oldest(r);
+
+    for (;;) {
+        if (r->count == 0) {
+            at = 0;
+            break;
+        }
+
+        u32 oldest = entry_at(r, 0)->offset;
+        if (oldest < r->head) {
+            // Live data is [oldest, head): room after it, or before it
+            if (r->head + size <= r->ring_size) {
+                at = r->head;
+                break;
+            }
+            if (size <= oldest) {
+                at = 0;
+                break;
+            }
+        } else if (r->head + size <= oldest) {
+            // Wrapped: the gap is [head, oldest)
+            at = r->head;
+            break;
+        }
+        drop_oldest(r);
+    }
+
+    memcpy(r->ring + at, r->delta, size);
+    *entry_at(r, r->count) = (RewindEntry){at, size};
+    r->count++;
+    r->head    = at + size;
+    r->stored += size;
+    return true;
+}
+
+// ---------------------------------------------
+// Rewind Functions
+// ---------------------------------------------
+
+bool rewind_init(Rewind *r, const GameBoy *gb, const RewindConfig *cfg) {
+    memset(r, 0, sizeof(*r));
+
+    r->memory     = cfg && cfg->memory ? cfg->memory : REWIND_DEFAULT_MEMORY;
+    r->interval   = cfg && cfg->interval ? cfg->interval : 1;
+    r->state_size = gb_state_size(gb);
+
+    // Working buffers first, the rest is split between index & ring
+    size_t state_buf = ALIGN8(r->state_size);
+    size_t delta_buf = ALIGN8(r->state_size + DELTA_SLACK);
+    size_t fixed     = 2 * state_buf + delta_buf;
+    if (r->memory < fixed + RING_BYTES_PER_ENTRY + sizeof(RewindEntry))
+        return false;
+
+    size_t rest   = r->memory - fixed;
+    r->entry_cap  = (u32)(rest / (RING_BYTES_PER_ENTRY + sizeof(RewindEntry)));
+    size_t ring   = rest - r->entry_cap * sizeof(RewindEntry);
+    r->ring_size  = ring > UINT32_MAX ? UINT32_MAX : (u32)ring;
+
+    r->block = malloc(r->memory);
+    if (!r->block)
+        return false;
+
+    r->state   = r->block;
+    r->next    = r->state + state_buf;
+    r->delta   = r->next + state_buf;
+    r->entries = (RewindEntry *)(r->delta + delta_buf);
+    r->ring    = (u8 *)(r->entries + r->entry_cap);
+    return true;
+}
+
+void rewind_free(Rewind *r) {
+    free(r->block);
+    memset(r, 0, sizeof(*r));
+}
+
+void rewind_reset(Rewind *r) {
+    r->have_state = false;
+    r->since      = 0;
+    r->first      = 0;
+    r->count      = 0;
+    r->head       = 0;
+    r->stored     = 0;
+}
+
+void rewind_frame(Rewind *r, const GameBoy *gb) {
+    r->frames_seen++;
+    if (r->have_state && ++r->since < r->interval)
+        return;
+
+    u64 start = rewind_now_ns();
+
+    if (gb_state_size(gb) != r->state_size) {
+        rewind_reset(r);
+        return;
+    }
+
+    if (!r->have_state) {
+        gb_save_state(gb, r->state, r->state_size);
+        r->have_state = true;
+    } else {
+        gb_save_state(gb, r->next, r->state_size);
+
+        size_t size = delta_encode(r->delta, r->state, r->next, r->state_size);
+        if (!ring_push(r, (u32)size)) {
+            // Bigger than the whole ring: the history can't reach past this state
+            r->first  = 0;
+            r->count  = 0;
+            r->head   = 0;
+            r->stored = 0;
+        }
+
+        u8 *newest = r->next;
+        r->next    = r->state;
+        r->state   = newest;
+    }
+    r->since = 0;
+
+    r->capture_ns += rewind_now_ns() - start;
+}
+
+bool rewind_step(Rewind *r, GameBoy *gb) {
+    if (!r->have_state)
+        return false;
+
+    if (r->since == 0) {
+        if (r->count == 0)
+            return false;
+
+        RewindEntry *e = entry_at(r, r->count - 1);
+        delta_apply(r->state, r->ring + e->offset, e->size);
+        r->stored -= e->size;
+        r->count--;
+        if (r->count) {
+            e       = entry_at(r, r->count - 1);
+            r->head = e->offset + e->size;
+        } else {
+            r->head = 0;
+        }
+    }
+    r->since = 0;
+
+    return gb_load_state(gb, r->state, r->state_size) == GB_STATE_OK;
+}
+
+void rewind_stats(const Rewind *r, RewindStats *stats) {
+    u32 steps = r->count + (r->have_state && r->since > 0);
+
+    stats->states     = steps;
+    stats->frames     = (u64)r->count * r->interval + r->since;
+    stats->state_size = r->state_size;
+    stats->memory     = r->block ? r->memory : 0;
+    stats->stored     = r->stored;
+    stats->ratio      = r->stored ? (double)r->count * r->state_size / r->stored : 0.0;
+    stats->capture_ns = r->frames_seen ? (double)r->capture_ns / r->frames_seen : 0.0;
+}
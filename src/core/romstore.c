@@ -0,0 +1,339 @@
+// src/core/romstore.c
+#include <core/cartridge.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ROM store
+
+One image per distinct ROM in the process, shared read-only by every
+cartridge running it:
+
+- Files: regular files are mapped (PROT_READ, MAP_PRIVATE) so other
+  processes running the same file share the page cache too; pipes &
+  devices are read into a single heap copy. An image remembers the file it
+  came from (device, inode, size, mtime), so opening that file again finds
+  it without reading a byte. Only the first open hashes.
+- Buffers: looked up by CRC-32 & size, then compared byte for byte; only
+  new content is copied & gets a SHA-1.
+
+Images are named by CRC-32 + SHA-1 (files with the same content at two
+paths end up as one image). Each holds a reference count; the last
+rom_store_release() unmaps or frees it.
+
+The list & counts are guarded by one mutex. Hashing, mapping & reading
+happen outside it, so a miss looks the content up again before inserting:
+two threads opening the same new ROM keep the first image & drop the other.
+*/
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(BAREDMG_NO_MMAP)
+#define STORE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define STORE_MMAP 0
+#endif
+
+static pthread_mutex_t store_lock = PTHREAD_MUTEX_INITIALIZER;
+static RomImage       *store_images;
+
+// ---------------------------------------------
+// Reading & Mapping
+// ---------------------------------------------
+
+// Give back an image's memory (not the struct)
+static void store_drop_data(u8 *data, size_t size, bool mapped) {
+#if STORE_MMAP
+    if (mapped) {
+        munmap(data, size);
+        return;
+    }
+#endif
+    (void)size;
+    (void)mapped;
+    free(data);
+}
+
+// Read a whole stream into the heap. Works on pipes too (no size up front),
+// so the size is capped at the largest ROM a header can describe.
+static int store_read_stream(FILE *rom_f, u8 **data, size_t *size_out) {
+    size_t max  = get_rom_size(0x08);
+    size_t cap  = 0x8000;
+    size_t size = 0;
+    size_t read;
+
+    u8 *rom = malloc(cap);
+    if (!rom) {
+        fprintf(stderr, "Failed to allocate ROM memory\n");
+        return 3;
+    }
+
+    while ((read = fread(rom + size, 1, cap - size, rom_f)) > 0) {
+        size += read;
+        if (size < cap)
+            continue;
+        if (size > max)
+            break;
+
+        u8 *grown = realloc(rom, cap * 2);
+        if (!grown) {
+            free(rom);
+            fprintf(stderr, "Failed to allocate ROM memory\n");
+            return 3;
+        }
+        rom  = grown;
+        cap *= 2;
+    }
+
+    if (size > max) {
+        free(rom);
+        fprintf(stderr, "ROM file too large\n");
+        return 6;
+    }
+
+    if (ferror(rom_f)) {
+        free(rom);
+        fprintf(stderr, "Failed to read ROM\n");
+        return 5;
+    }
+
+    // Actual ROM file size should be greater than 0x0150
+    if (size < 0x0150) {
+        free(rom);
+        fprintf(stderr, "ROM file too small\n");
+        return 2;
+    }
+
+    *data     = rom;
+    *size_out = size;
+    return 0;
+}
+
+// ---------------------------------------------
+// Lookup (store_lock held)
+// ---------------------------------------------
+
+#if STORE_MMAP
+static RomImage *store_find_file(const RomImage *key) {
+    for (RomImage *img = store_images; img; img = img->next) {
+        if (img->from_file && img->file_dev == key->file_dev && img->file_ino == key->file_ino &&
+            img->file_mtime_ns == key->file_mtime_ns && img->size == key->size)
+            return img;
+    }
+    return NULL;
+}
+#endif
+
+// By name (CRC-32, SHA-1 & size), or by CRC-32 & size + content when `sha1` is NULL
+static RomImage *store_find_content(const u8 *data, size_t size, u32 crc32, const u8 *sha1) {
+    for (RomImage *img = store_images; img; img = img->next) {
+        if (img->crc32 != crc32 || img->size != size)
+            continue;
+        if (sha1 ? memcmp(img->sha1, sha1, SHA1_SIZE) == 0 : memcmp(img->data, data, size) == 0)
+            return img;
+    }
+    return NULL;
+}
+
+// Insert `fresh` (refs = 1) unless the same content got in first; returns
+// the referenced image & frees whichever lost
+static RomImage *store_insert(RomImage *fresh) {
+    pthread_mutex_lock(&store_lock);
+
+    RomImage *img = store_find_content(fresh->data, fresh->size, fresh->crc32, fresh->sha1);
+    if (img) {
+        img->refs++;
+        if (!img->from_file && fresh->from_file) {
+            // Remember the file anyway, so it isn't hashed on the next open
+            img->from_file     = true;
+            img->file_dev      = fresh->file_dev;
+            img->file_ino      = fresh->file_ino;
+            img->file_mtime_ns = fresh->file_mtime_ns;
+        }
+    } else {
+        img          = fresh;
+        img->refs    = 1;
+        img->next    = store_images;
+        store_images = img;
+    }
+
+    pthread_mutex_unlock(&store_lock);
+
+    if (img != fresh) {
+        store_drop_data(fresh->data, fresh->size, fresh->mapped);
+        free(fresh);
+    }
+    return img;
+}
+
+static void store_hash(RomImage *img) {
+    img->crc32 = compute_crc32(img->data, img->size);
+    compute_sha1(img->data, img->size, img->sha1);
+}
+
+// ---------------------------------------------
+// ROM Store Functions
+// ---------------------------------------------
+
+int rom_store_open(const char *path, RomImage **out) {
+    RomImage *fresh = calloc(1, sizeof(RomImage));
+    if (!fresh) {
+        fprintf(stderr, "Failed to allocate ROM memory\n");
+        return 3;
+    }
+
+#if STORE_MMAP
+    // One open() for both paths: a pipe can't be opened a second time
+    int         fd = open(path, O_RDONLY);
+    struct stat st;
+
+    if (fd >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size >= 0x0150) {
+        // Same cap as a stream: never map, hash or decode a file no header can describe
+        if ((u64)st.st_size > get_rom_size(0x08)) {
+            close(fd);
+            free(fresh);
+            fprintf(stderr, "ROM file too large\n");
+            return 6;
+        }
+
+        fresh->from_file     = true;
+        fresh->file_dev      = (u64)st.st_dev;
+        fresh->file_ino      = (u64)st.st_ino;
+        fresh->size          = (size_t)st.st_size;
+#ifdef __linux__
+        fresh->file_mtime_ns = (i64)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#else
+        fresh->file_mtime_ns = (i64)st.st_mtime * 1000000000;
+#endif
+
+        // Seen this file before: nothing to read
+        pthread_mutex_lock(&store_lock);
+        RomImage *img = store_find_file(fresh);
+        if (img)
+            img->refs++;
+        pthread_mutex_unlock(&store_lock);
+
+        if (img) {
+            close(fd);
+            free(fresh);
+            *out = img;
+            return 0;
+        }
+
+        void *map = mmap(NULL, fresh->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            madvise(map, fresh->size, MADV_WILLNEED); // Hashing reads it all next
+            close(fd); // The mapping keeps its own reference to the file
+            fresh->data   = map;
+            fresh->mapped = true;
+        }
+    }
+
+    FILE *rom_f = NULL;
+    if (!fresh->data && fd >= 0 && !(rom_f = fdopen(fd, "rb")))
+        close(fd);
+#else
+    FILE *rom_f = fopen(path, "rb");
+#endif
+
+    if (!fresh->data) {
+        if (!rom_f) {
+            fprintf(stderr, "Failed to open ROM: %s\n", path);
+            free(fresh);
+            return 1;
+        }
+
+        int err = store_read_stream(rom_f, &fresh->data, &fresh->size);
+        fclose(rom_f);
+        if (err) {
+            free(fresh);
+            return err;
+        }
+    }
+
+    store_hash(fresh);
+    *out = store_insert(fresh);
+    return 0;
+}
+
+int rom_store_add(const u8 *data, size_t size, RomImage **out) {
+    if (size < 0x0150) {
+        fprintf(stderr, "ROM image too small\n");
+        return 2;
+    }
+
+    // Known content: just another reference
+    u32 crc32 = compute_crc32(data, size);
+
+    pthread_mutex_lock(&store_lock);
+    RomImage *img = store_find_content(data, size, crc32, NULL);
+    if (img)
+        img->refs++;
+    pthread_mutex_unlock(&store_lock);
+
+    if (img) {
+        *out = img;
+        return 0;
+    }
+
+    RomImage *fresh = calloc(1, sizeof(RomImage));
+    u8       *copy  = malloc(size);
+    if (!fresh || !copy) {
+        free(fresh);
+        free(copy);
+        fprintf(stderr, "Failed to allocate ROM memory\n");
+        return 3;
+    }
+
+    memcpy(copy, data, size);
+    fresh->data  = copy;
+    fresh->size  = size;
+    fresh->crc32 = crc32;
+    compute_sha1(copy, size, fresh->sha1);
+
+    *out = store_insert(fresh);
+    return 0;
+}
+
+RomImage *rom_store_ref(RomImage *image) {
+    pthread_mutex_lock(&store_lock);
+    image->refs++;
+    pthread_mutex_unlock(&store_lock);
+    return image;
+}
+
+void rom_store_release(RomImage *image) {
+    if (!image)
+        return;
+
+    pthread_mutex_lock(&store_lock);
+    bool last = --image->refs == 0;
+    if (last) {
+        RomImage **link = &store_images;
+        while (*link != image)
+            link = &(*link)->next;
+        *link = image->next;
+    }
+    pthread_mutex_unlock(&store_lock);
+
+    if (last) {
+        store_drop_data(image->data, image->size, image->mapped);
+        free(image);
+    }
+}
+
+void rom_store_stats(RomStoreStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+
+    pthread_mutex_lock(&store_lock);
+    for (const RomImage *img = store_images; img; img = img->next) {
+        stats->images++;
+        stats->refs  += img->refs;
+        stats->bytes += img->size;
+    }
+    pthread_mutex_unlock(&store_lock);
+}
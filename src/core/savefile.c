@@ -0,0 +1,240 @@
+// src/core/savefile.c
+#include <core/cartridge.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+Battery saves
+
+Cartridges with a battery keep their external RAM in a .sav file next to
+the ROM. The file is mapped shared (MAP_SHARED) & becomes cart->ram itself:
+every write the game makes lands in the page cache right away, so even a
+crash of the emulator loses nothing. What is left to batch is getting those
+pages to the disk.
+
+Writes are tracked per 256-byte page in cart->ram_dirty (the bus sets the
+bits, see MMU_WATCH_SAVE in bus.h: only the first write to a page after a
+flush leaves the fast path). cart_save_flush() then issues one msync over
+the span of dirty pages, at most once per flush interval & on unload; the
+kernel writes back only the host pages that changed. A game writing SRAM
+every frame costs one syscall per interval, and losing power loses at most
+one interval.
+
+Without mmap the file is read into the heap copy once & the dirty runs are
+written back with stdio at each flush instead.
+*/
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(BAREDMG_NO_MMAP)
+#define SAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define SAVE_MMAP 0
+#endif
+
+#define DIRTY_WORD(page) ((page) / 64)
+#define DIRTY_BIT(page) ((u64)1 << ((page) % 64))
+
+// ---------------------------------------------
+// Save File
+// ---------------------------------------------
+
+bool cart_has_battery(u8 cart_type) {
+    switch (cart_type) {
+        case 0x03: // MBC1+RAM+BATTERY
+        case 0x06: // MBC2+BATTERY
+        case 0x09: // ROM+RAM+BATTERY
+        case 0x0D: // MMM01+RAM+BATTERY
+        case 0x0F: // MBC3+TIMER+BATTERY
+        case 0x10: // MBC3+TIMER+RAM+BATTERY
+        case 0x13: // MBC3+RAM+BATTERY
+        case 0x1B: // MBC5+RAM+BATTERY
+        case 0x1E: // MBC5+RUMBLE+RAM+BATTERY
+        case 0x22: // MBC7+SENSOR+RUMBLE+RAM+BATTERY
+        case 0xFF: // HuC1+RAM+BATTERY
+            return true;
+        default:
+            return false;
+    }
+}
+
+char *cart_save_path(const char *rom_path) {
+    const char *slash = strrchr(rom_path, '/');
+    const char *base  = slash ? slash + 1 : rom_path;
+    const char *dot   = strrchr(base, '.');
+    size_t      stem  = dot && dot != base ? (size_t)(dot - rom_path) : strlen(rom_path);
+
+    char *path = malloc(stem + sizeof(".sav"));
+    if (path) {
+        memcpy(path, rom_path, stem);
+        memcpy(path + stem, ".sav", sizeof(".sav"));
+    }
+    return path;
+}
+
+#if SAVE_MMAP
+// Replace the heap RAM with a shared mapping of the file
+static int save_map(Cartridge *cart, const char *path) {
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+        return 1;
+
+    // Short (or new) files grow with zeros; anything past ram_size (e.g. an
+    // RTC footer written by another emulator) is left alone
+    struct stat st;
+    if (fstat(fd, &st) != 0 ||
+        ((size_t)st.st_size < cart->ram_size && ftruncate(fd, (off_t)cart->ram_size) != 0)) {
+        close(fd);
+        return 1;
+    }
+
+    void *map = mmap(NULL, cart->ram_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps its own reference to the file
+    if (map == MAP_FAILED)
+        return 4;
+
+    free(cart->ram);
+    cart->ram        = map;
+    cart->ram_mapped = true;
+    return 0;
+}
+#else
+// Read what the file has into the heap RAM, creating it if missing
+static int save_read(Cartridge *cart, const char *path) {
+    FILE *f      = fopen(path, "rb");
+    bool  exists = f != NULL;
+    if (exists) {
+        size_t n = fread(cart->ram, 1, cart->ram_size, f);
+        fclose(f);
+        if (n == cart->ram_size)
+            return 0;
+    }
+
+    // Missing or short: write it out whole once
+    f = fopen(path, exists ? "r+b" : "wb");
+    if (!f)
+        return 1;
+    bool ok = fwrite(cart->ram, 1, cart->ram_size, f) == cart->ram_size;
+    return (fclose(f) == 0 && ok) ? 0 : 1;
+}
+#endif
+
+int cart_attach_save(Cartridge *cart, const char *path) {
+    if (!cart->ram || cart->save_path)
+        return 4;
+
+    size_t len  = strlen(path) + 1;
+    char  *copy = malloc(len);
+    if (!copy)
+        return 4;
+    memcpy(copy, path, len);
+
+#if SAVE_MMAP
+    int err = save_map(cart, path);
+#else
+    int err = save_read(cart, path);
+#endif
+    if (err) {
+        free(copy);
+        return err;
+    }
+
+    cart->save_path = copy;
+    memset(cart->ram_dirty, 0, sizeof(cart->ram_dirty));
+    return 0;
+}
+
+void cart_ram_mark_dirty(Cartridge *cart, size_t offset, size_t size) {
+    if (!size || offset >= cart->ram_size)
+        return;
+    if (size > cart->ram_size - offset)
+        size = cart->ram_size - offset;
+
+    size_t last = (offset + size - 1) / CART_RAM_PAGE_SIZE;
+    for (size_t page = offset / CART_RAM_PAGE_SIZE; page <= last; page++)
+        cart->ram_dirty[DIRTY_WORD(page)] |= DIRTY_BIT(page);
+}
+
+bool cart_ram_is_dirty(const Cartridge *cart, size_t offset) {
+    size_t page = offset / CART_RAM_PAGE_SIZE;
+    return (cart->ram_dirty[DIRTY_WORD(page)] & DIRTY_BIT(page)) != 0;
+}
+
+u32 cart_save_flush(Cartridge *cart) {
+    size_t pages = (cart->ram_size + CART_RAM_PAGE_SIZE - 1) / CART_RAM_PAGE_SIZE;
+    size_t first = pages, last = 0;
+    u32    count = 0;
+
+    if (!cart->save_path)
+        return 0;
+
+    for (size_t page = 0; page < pages; page++) {
+        if (cart_ram_is_dirty(cart, page * CART_RAM_PAGE_SIZE)) {
+            first = page < first ? page : first;
+            last  = page;
+            count++;
+        }
+    }
+    if (!count)
+        return 0;
+
+#if SAVE_MMAP
+    // One msync over the dirty span, from the host page holding the first one
+    size_t host  = (size_t)sysconf(_SC_PAGESIZE);
+    size_t start = first * CART_RAM_PAGE_SIZE / host * host;
+    size_t end   = (last + 1) * CART_RAM_PAGE_SIZE;
+    if (end > cart->ram_size)
+        end = cart->ram_size;
+    if (msync(cart->ram + start, end - start, MS_SYNC) != 0)
+        return 0; // Stays dirty, the next flush tries again
+#else
+    // Each run of dirty pages with one write, all through one open. Any
+    // failure leaves every page dirty, so the next flush writes them again.
+    FILE *f  = fopen(cart->save_path, "r+b");
+    bool  ok = true;
+    if (!f)
+        return 0;
+    for (size_t page = first; ok && page <= last; page++) {
+        if (!cart_ram_is_dirty(cart, page * CART_RAM_PAGE_SIZE))
+            continue;
+
+        size_t run = page;
+        while (run + 1 <= last && cart_ram_is_dirty(cart, (run + 1) * CART_RAM_PAGE_SIZE))
+            run++;
+
+        size_t start = page * CART_RAM_PAGE_SIZE;
+        size_t end   = (run + 1) * CART_RAM_PAGE_SIZE;
+        if (end > cart->ram_size)
+            end = cart->ram_size;
+        ok   = fseek(f, (long)start, SEEK_SET) == 0 &&
+               fwrite(cart->ram + start, 1, end - start, f) == end - start;
+        page = run;
+    }
+    if (fclose(f) != 0 || !ok)
+        return 0;
+#endif
+
+    memset(cart->ram_dirty, 0, sizeof(cart->ram_dirty));
+    cart->save_flushes++;
+    return count;
+}
+
+void cart_detach_save(Cartridge *cart) {
+    if (!cart->save_path)
+        return;
+
+    cart_save_flush(cart);
+#if SAVE_MMAP
+    if (cart->ram_mapped) {
+        munmap(cart->ram, cart->ram_size);
+        cart->ram = NULL;
+    }
+#endif
+    cart->ram_mapped = false;
+
+    free(cart->save_path);
+    cart->save_path = NULL;
+}
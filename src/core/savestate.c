@@ -0,0 +1,616 @@
+// src/core/savestate.c
+#include <gbemu.h>
+#include <core/bus.h>
+#include <string.h>
+
+/*
+Save states
+
+Layout (all integers little-endian), identical in memory & on disk:
+
+    header   magic "BDMGSAVE", u32 version, u32 total size, u64 ROM hash,
+             u32 section count, u32 reserved
+    section  u32 tag, u32 payload size, payload    (repeated)
+
+Sections hold components field by field, never raw structs, so padding,
+host pointers & build options (e.g. BAREDMG_NO_TILE_XFLIP) don't leak into
+the format. Anything derived is rebuilt on load: decoded tiles, the page
+table's watches, the decode cache & JIT blocks. The ROM itself isn't stored;
+the header names it by Cartridge.rom_hash & a state only loads into a
+machine running that ROM.
+
+Compatibility: loaders skip sections with tags they don't know, so new
+sections can be added without a version bump. Changing a known section's
+payload bumps GB_STATE_VERSION; older versions stay loadable by keeping
+their readers.
+
+Cost: the bulk of a state is VRAM/WRAM/cart RAM & the two PPU frame buffers,
+each a single memcpy on save. Loading compares RAM 256 bytes at a time &
+only copies (and invalidates decoded/translated code for) pages that
+differ, so going back a few frames touches little.
+
+gb_load_state() validates the whole buffer before changing anything: a
+rejected state leaves the machine as it was.
+*/
+
+#define STATE_MAGIC "BDMGSAVE"
+#define STATE_HEADER_SIZE 32
+#define STATE_SECTION_HEADER 8
+
+#define STATE_TAG(a, b, c, d) ((u32)(a) | (u32)(b) << 8 | (u32)(c) << 16 | (u32)(d) << 24)
+
+enum {
+    TAG_SYS  = STATE_TAG('S', 'Y', 'S', ' '),
+    TAG_CPU  = STATE_TAG('C', 'P', 'U', ' '),
+    TAG_MEM  = STATE_TAG('M', 'E', 'M', ' '),
+    TAG_PPU  = STATE_TAG('P', 'P', 'U', ' '),
+    TAG_TIMR = STATE_TAG('T', 'I', 'M', 'R'),
+    TAG_SERL = STATE_TAG('S', 'E', 'R', 'L'),
+    TAG_SCHD = STATE_TAG('S', 'C', 'H', 'D'),
+    TAG_APU  = STATE_TAG('A', 'P', 'U', ' '), // Optional: states from before it reset the APU
+    TAG_MBC  = STATE_TAG('M', 'B', 'C', ' '), // Optional: states from before it keep the banks
+    TAG_JOYP = STATE_TAG('J', 'O', 'Y', 'P'), // Optional: states from before it release the keys
+    TAG_CRAM = STATE_TAG('C', 'R', 'A', 'M'), // Only with cartridge RAM
+};
+
+// Sections this version writes (& requires, but for APU, MBC & JOYP), in file order
+static const u32 state_tags[] = {TAG_SYS,  TAG_CPU, TAG_MEM, TAG_PPU,  TAG_TIMR, TAG_SERL,
+                                 TAG_SCHD, TAG_APU, TAG_MBC, TAG_JOYP, TAG_CRAM};
+
+#define STATE_TAG_COUNT (sizeof(state_tags) / sizeof(state_tags[0]))
+
+// Payload sizes of the fixed-size sections
+#define SYS_SIZE 8
+#define CPU_SIZE (8 + 2 + 2 + 6 + 8)
+#define MEM_SIZE (0x2000 + 0x2000 + 0xA0 + 0x7F + 2)
+#define PPU_REGS_SIZE 11
+#define PPU_FRAMES_SIZE (2 * SCREEN_HEIGHT * SCREEN_WIDTH)
+#define PPU_SIZE (PPU_REGS_SIZE + 8 + 8 + 5 + 1 + OBJ_PER_LINE + 1 + 8 + PPU_FRAMES_SIZE)
+#define TIMR_SIZE (8 + 8 + 3)
+#define SERL_SIZE 2
+#define SCHD_SIZE (SCHED_RUN_END * 8)
+#define APU_CHANNEL_SIZE (1 + 1 + 2 + 1 + 1 + 2 + 1 + 2 + 1 + 8)
+#define APU_SIZE (APU_REG_COUNT + 4 * APU_CHANNEL_SIZE + 1 + 1 + 1 + 2 + 8 + 8 + 1)
+#define MBC_SIZE (1 + 1 + 2 + 1 + 1 + 5 + 5 + 1 + 8)
+#define JOYP_SIZE 2
+
+// ---------------------------------------------
+// Writer & Reader
+// ---------------------------------------------
+
+typedef struct {
+    u8 *p;
+} StateWriter;
+
+typedef struct {
+    const u8 *p;
+} StateReader;
+
+static void put8(StateWriter *w, u8 v) {
+    *w->p++ = v;
+}
+
+static void put16(StateWriter *w, u16 v) {
+    put8(w, (u8)v);
+    put8(w, (u8)(v >> 8));
+}
+
+static void put32(StateWriter *w, u32 v) {
+    put16(w, (u16)v);
+    put16(w, (u16)(v >> 16));
+}
+
+static void put64(StateWriter *w, u64 v) {
+    put32(w, (u32)v);
+    put32(w, (u32)(v >> 32));
+}
+
+static void put_mem(StateWriter *w, const void *src, size_t size) {
+    memcpy(w->p, src, size);
+    w->p += size;
+}
+
+static void put_section(StateWriter *w, u32 tag, u32 size) {
+    put32(w, tag);
+    put32(w, size);
+}
+
+static u8 get8(StateReader *r) {
+    return *r->p++;
+}
+
+static u16 get16(StateReader *r) {
+    u16 lo = get8(r);
+    return (u16)(lo | get8(r) << 8);
+}
+
+static u32 get32(StateReader *r) {
+    u32 lo = get16(r);
+    return lo | (u32)get16(r) << 16;
+}
+
+static u64 get64(StateReader *r) {
+    u64 lo = get32(r);
+    return lo | (u64)get32(r) << 32;
+}
+
+static void get_mem(StateReader *r, void *dst, size_t size) {
+    memcpy(dst, r->p, size);
+    r->p += size;
+}
+
+// Copy a RAM region back page by page, notifying the bus of the pages that
+// changed. Returns true if anything did.
+static bool get_ram(StateReader *r, GameBoy *gb, u8 *dst, size_t size) {
+    bool changed = false;
+
+    for (size_t off = 0; off < size; off += MMU_PAGE_SIZE) {
+        size_t n = size - off < MMU_PAGE_SIZE ? size - off : MMU_PAGE_SIZE;
+
+        if (memcmp(dst + off, r->p + off, n) != 0) {
+            memcpy(dst + off, r->p + off, n);
+            mmu_host_written(gb, dst + off);
+            changed = true;
+        }
+    }
+    r->p += size;
+    return changed;
+}
+
+// ---------------------------------------------
+// Sections
+// ---------------------------------------------
+
+size_t gb_state_size(const GameBoy *gb) {
+    size_t size = STATE_HEADER_SIZE;
+
+    size += STATE_SECTION_HEADER + SYS_SIZE;
+    size += STATE_SECTION_HEADER + CPU_SIZE;
+    size += STATE_SECTION_HEADER + MEM_SIZE;
+    size += STATE_SECTION_HEADER + PPU_SIZE;
+    size += STATE_SECTION_HEADER + TIMR_SIZE;
+    size += STATE_SECTION_HEADER + SERL_SIZE;
+    size += STATE_SECTION_HEADER + SCHD_SIZE;
+    size += STATE_SECTION_HEADER + APU_SIZE;
+    size += STATE_SECTION_HEADER + MBC_SIZE;
+    size += STATE_SECTION_HEADER + JOYP_SIZE;
+    if (gb->cart.ram_size)
+        size += STATE_SECTION_HEADER + gb->cart.ram_size;
+    return size;
+}
+
+static void save_cpu(StateWriter *w, const CPU *cpu) {
+    put_section(w, TAG_CPU, CPU_SIZE);
+    put8(w, cpu->a);
+    put8(w, cpu->f);
+    put8(w, cpu->b);
+    put8(w, cpu->c);
+    put8(w, cpu->d);
+    put8(w, cpu->e);
+    put8(w, cpu->h);
+    put8(w, cpu->l);
+    put16(w, cpu->sp);
+    put16(w, cpu->pc);
+    put8(w, cpu->ime);
+    put8(w, cpu->ime_pending);
+    put8(w, cpu->halted);
+    put8(w, cpu->halt_bug);
+    put8(w, cpu->stopped);
+    put8(w, cpu->locked);
+    put64(w, cpu->instructions);
+}
+
+static void load_cpu(StateReader *r, CPU *cpu) {
+    cpu->a            = get8(r);
+    cpu->f            = get8(r);
+    cpu->b            = get8(r);
+    cpu->c            = get8(r);
+    cpu->d            = get8(r);
+    cpu->e            = get8(r);
+    cpu->h            = get8(r);
+    cpu->l            = get8(r);
+    cpu->sp           = get16(r);
+    cpu->pc           = get16(r);
+    cpu->ime          = get8(r);
+    cpu->ime_pending  = get8(r);
+    cpu->halted       = get8(r);
+    cpu->halt_bug     = get8(r);
+    cpu->stopped      = get8(r);
+    cpu->locked       = get8(r);
+    cpu->instructions = get64(r);
+}
+
+// Registers & channel state; the output (blip buffer) restarts on load
+static void save_apu(StateWriter *w, const Apu *apu) {
+    put_section(w, TAG_APU, APU_SIZE);
+    put_mem(w, apu->regs, APU_REG_COUNT);
+    for (int c = 0; c < 4; c++) {
+        const ApuChannel *ch = &apu->ch[c];
+        put8(w, ch->enabled);
+        put8(w, ch->dac);
+        put16(w, ch->length);
+        put8(w, ch->volume);
+        put8(w, ch->env_timer);
+        put16(w, ch->period);
+        put8(w, ch->pos);
+        put16(w, ch->lfsr);
+        put8(w, ch->out);
+        put64(w, ch->next);
+    }
+    put8(w, apu->sweep_timer);
+    put8(w, apu->sweep_on);
+    put8(w, apu->sweep_negated);
+    put16(w, apu->sweep_shadow);
+    put64(w, apu->synced);
+    put64(w, apu->fs_next);
+    put8(w, apu->fs_step);
+}
+
+static void load_apu(StateReader *r, Apu *apu) {
+    get_mem(r, apu->regs, APU_REG_COUNT);
+    for (int c = 0; c < 4; c++) {
+        ApuChannel *ch = &apu->ch[c];
+        ch->enabled    = get8(r) != 0;
+        ch->dac        = get8(r) != 0;
+        ch->length     = get16(r);
+        ch->volume     = get8(r) & 0x0F;
+        ch->env_timer  = get8(r);
+        ch->period     = get16(r) & 0x7FF;
+        ch->pos        = get8(r) & 31;
+        ch->lfsr       = get16(r);
+        ch->out        = get8(r) & 0x0F;
+        ch->next       = get64(r);
+    }
+    apu->sweep_timer   = get8(r);
+    apu->sweep_on      = get8(r) != 0;
+    apu->sweep_negated = get8(r) != 0;
+    apu->sweep_shadow  = get16(r);
+    apu->synced        = get64(r);
+    apu->fs_next       = get64(r);
+    apu->fs_step       = get8(r) & 7;
+}
+
+// Registers only: the banks they select are remapped on load
+static void save_mbc(StateWriter *w, const Mbc *mbc) {
+    put_section(w, TAG_MBC, MBC_SIZE);
+    put8(w, (u8)mbc->type);
+    put8(w, mbc->ram_enable);
+    put16(w, mbc->rom_bank);
+    put8(w, mbc->bank_hi);
+    put8(w, mbc->mode);
+    put_mem(w, mbc->rtc, sizeof(mbc->rtc));
+    put_mem(w, mbc->rtc_latched, sizeof(mbc->rtc_latched));
+    put8(w, mbc->rtc_latch);
+    put64(w, mbc->rtc_synced);
+}
+
+static void load_mbc(StateReader *r, Mbc *mbc) {
+    get8(r); // Type, checked by state_validate()
+    mbc->ram_enable = get8(r) != 0;
+    mbc->rom_bank   = get16(r);
+    mbc->bank_hi    = get8(r);
+    mbc->mode       = get8(r);
+    get_mem(r, mbc->rtc, sizeof(mbc->rtc));
+    get_mem(r, mbc->rtc_latched, sizeof(mbc->rtc_latched));
+    mbc->rtc_latch  = get8(r);
+    mbc->rtc_synced = get64(r);
+}
+
+static void save_ppu(StateWriter *w, const Ppu *ppu) {
+    put_section(w, TAG_PPU, PPU_SIZE);
+    put8(w, ppu->lcdc);
+    put8(w, ppu->stat);
+    put8(w, ppu->scy);
+    put8(w, ppu->scx);
+    put8(w, ppu->lyc);
+    put8(w, ppu->dma);
+    put8(w, ppu->bgp);
+    put8(w, ppu->obp0);
+    put8(w, ppu->obp1);
+    put8(w, ppu->wy);
+    put8(w, ppu->wx);
+    put64(w, ppu->frame_base);
+    put64(w, ppu->synced);
+    put8(w, ppu->ly);
+    put8(w, ppu->drawn);
+    put8(w, ppu->window_line);
+    put8(w, ppu->window_y);
+    put8(w, ppu->window_drawn);
+    put8(w, ppu->obj_count);
+    put_mem(w, ppu->obj, OBJ_PER_LINE);
+    put8(w, ppu->back);
+    put64(w, ppu->frames);
+    put_mem(w, ppu->frame, PPU_FRAMES_SIZE);
+}
+
+static void load_ppu(StateReader *r, Ppu *ppu) {
+    ppu->lcdc         = get8(r);
+    ppu->stat         = get8(r);
+    ppu->scy          = get8(r);
+    ppu->scx          = get8(r);
+    ppu->lyc          = get8(r);
+    ppu->dma          = get8(r);
+    ppu->bgp          = get8(r);
+    ppu->obp0         = get8(r);
+    ppu->obp1         = get8(r);
+    ppu->wy           = get8(r);
+    ppu->wx           = get8(r);
+    ppu->frame_base   = get64(r);
+    ppu->synced       = get64(r);
+    ppu->ly           = get8(r);
+    ppu->drawn        = get8(r);
+    ppu->window_line  = get8(r);
+    ppu->window_y     = get8(r);
+    ppu->window_drawn = get8(r);
+    ppu->obj_count    = get8(r);
+    get_mem(r, ppu->obj, OBJ_PER_LINE);
+    if (ppu->obj_count > OBJ_PER_LINE)
+        ppu->obj_count = OBJ_PER_LINE;
+    for (int i = 0; i < OBJ_PER_LINE; i++)
+        ppu->obj[i] %= OBJ_COUNT; // Indexes OAM
+    ppu->back         = get8(r) & 1;
+    ppu->frames       = get64(r);
+    get_mem(r, ppu->frame, PPU_FRAMES_SIZE);
+}
+
+// ---------------------------------------------
+// Save
+// ---------------------------------------------
+
+size_t gb_save_state(const GameBoy *gb, void *buf, size_t size) {
+    size_t total = gb_state_size(gb);
+    if (!buf || size < total)
+        return 0;
+
+    StateWriter w        = {buf};
+    u32         sections = gb->cart.ram_size ? STATE_TAG_COUNT : STATE_TAG_COUNT - 1;
+
+    // Header
+    put_mem(&w, STATE_MAGIC, 8);
+    put32(&w, GB_STATE_VERSION);
+    put32(&w, (u32)total);
+    put64(&w, gb->cart.rom_hash);
+    put32(&w, sections);
+    put32(&w, 0);
+
+    put_section(&w, TAG_SYS, SYS_SIZE);
+    put64(&w, gb->cycles);
+
+    save_cpu(&w, &gb->cpu);
+
+    put_section(&w, TAG_MEM, MEM_SIZE);
+    put_mem(&w, gb->vram, sizeof(gb->vram));
+    put_mem(&w, gb->wram, sizeof(gb->wram));
+    put_mem(&w, gb->oam, sizeof(gb->oam));
+    put_mem(&w, gb->hram, sizeof(gb->hram));
+    put8(&w, gb->ie_register);
+    put8(&w, gb->if_register);
+
+    save_ppu(&w, &gb->ppu);
+
+    put_section(&w, TAG_TIMR, TIMR_SIZE);
+    put64(&w, gb->timer.div_base);
+    put64(&w, gb->timer.synced);
+    put8(&w, gb->timer.tima);
+    put8(&w, gb->timer.tma);
+    put8(&w, gb->timer.tac);
+
+    put_section(&w, TAG_SERL, SERL_SIZE);
+    put8(&w, gb->serial.sb);
+    put8(&w, gb->serial.sc);
+
+    // When each event is due (SCHED_NEVER: not pending), in SchedEvent order.
+    // The end of a cpu_run() slice isn't machine state.
+    put_section(&w, TAG_SCHD, SCHD_SIZE);
+    for (int e = 0; e < SCHED_RUN_END; e++)
+        put64(&w, sched_when(&gb->sched, (SchedEvent)e));
+
+    save_apu(&w, &gb->apu);
+    save_mbc(&w, &gb->cart.mbc);
+
+    put_section(&w, TAG_JOYP, JOYP_SIZE);
+    put8(&w, gb->joypad.select);
+    put8(&w, gb->joypad.buttons);
+
+    if (gb->cart.ram_size) {
+        put_section(&w, TAG_CRAM, (u32)gb->cart.ram_size);
+        put_mem(&w, gb->cart.ram, gb->cart.ram_size);
+    }
+
+    return total;
+}
+
+// ---------------------------------------------
+// Load
+// ---------------------------------------------
+
+// Payload size a known section must have (0: unknown tag, skipped)
+static size_t state_expected(const GameBoy *gb, u32 tag) {
+    switch (tag) {
+        case TAG_SYS:
+            return SYS_SIZE;
+        case TAG_CPU:
+            return CPU_SIZE;
+        case TAG_MEM:
+            return MEM_SIZE;
+        case TAG_PPU:
+            return PPU_SIZE;
+        case TAG_TIMR:
+            return TIMR_SIZE;
+        case TAG_SERL:
+            return SERL_SIZE;
+        case TAG_SCHD:
+            return SCHD_SIZE;
+        case TAG_APU:
+            return APU_SIZE;
+        case TAG_MBC:
+            return MBC_SIZE;
+        case TAG_JOYP:
+            return JOYP_SIZE;
+        case TAG_CRAM:
+            return gb->cart.ram_size;
+        default:
+            return 0;
+    }
+}
+
+// Walk the sections without touching gb: every known one well-formed, the
+// required ones present
+static int state_validate(const GameBoy *gb, const u8 *data, size_t size, u32 sections) {
+    const u8 *p     = data + STATE_HEADER_SIZE;
+    const u8 *end   = data + size;
+    u32       found = 0;
+
+    for (u32 i = 0; i < sections; i++) {
+        if ((size_t)(end - p) < STATE_SECTION_HEADER)
+            return GB_STATE_CORRUPT;
+
+        StateReader r   = {p};
+        u32         tag = get32(&r);
+        u32         len = get32(&r);
+
+        if ((size_t)(end - r.p) < len)
+            return GB_STATE_CORRUPT;
+
+        size_t expected = state_expected(gb, tag);
+        if (expected && expected != len)
+            return GB_STATE_CORRUPT;
+        if (tag == TAG_MBC && *r.p != (u8)gb->cart.mbc.type)
+            return GB_STATE_CORRUPT; // Same ROM hash, other controller: not ours
+
+        for (u32 t = 0; t < STATE_TAG_COUNT; t++)
+            if (state_tags[t] == tag)
+                found |= BIT(t);
+        p = r.p + len;
+    }
+
+    u32 required = 0;
+    for (u32 t = 0; t < STATE_TAG_COUNT; t++) {
+        u32 tag = state_tags[t];
+        if (tag != TAG_APU && tag != TAG_MBC && tag != TAG_JOYP &&
+            (tag != TAG_CRAM || gb->cart.ram_size)) // No CRAM section
+            required |= BIT(t);
+    }
+    return (found & required) == required ? GB_STATE_OK : GB_STATE_CORRUPT;
+}
+
+int gb_load_state(GameBoy *gb, const void *buf, size_t size) {
+    const u8   *data = buf;
+    StateReader r    = {data};
+
+    if (!buf || size < STATE_HEADER_SIZE)
+        return GB_STATE_CORRUPT;
+    if (memcmp(data, STATE_MAGIC, 8) != 0)
+        return GB_STATE_BAD_MAGIC;
+
+    r.p += 8;
+    u32 version  = get32(&r);
+    u32 total    = get32(&r);
+    u64 rom_hash = get64(&r);
+    u32 sections = get32(&r);
+
+    if (version != GB_STATE_VERSION)
+        return GB_STATE_BAD_VERSION;
+    if (total > size || total < STATE_HEADER_SIZE)
+        return GB_STATE_CORRUPT;
+    if (rom_hash != gb->cart.rom_hash)
+        return GB_STATE_WRONG_ROM;
+
+    int err = state_validate(gb, data, total, sections);
+    if (err != GB_STATE_OK)
+        return err;
+
+    // Everything checks out: apply
+    bool tiles_changed = false;
+    bool apu_loaded    = false;
+    bool joyp_loaded   = false;
+
+    r.p = data + STATE_HEADER_SIZE;
+    for (u32 i = 0; i < sections; i++) {
+        u32       tag  = get32(&r);
+        u32       len  = get32(&r);
+        const u8 *next = r.p + len;
+
+        switch (tag) {
+            case TAG_SYS:
+                gb->cycles = get64(&r);
+                break;
+
+            case TAG_CPU:
+                load_cpu(&r, &gb->cpu);
+                break;
+
+            case TAG_MEM:
+                tiles_changed = get_ram(&r, gb, gb->vram, sizeof(gb->vram));
+                get_ram(&r, gb, gb->wram, sizeof(gb->wram));
+                get_mem(&r, gb->oam, sizeof(gb->oam));
+                get_mem(&r, gb->hram, sizeof(gb->hram));
+                gb->ie_register = get8(&r);
+                gb->if_register = get8(&r);
+                break;
+
+            case TAG_PPU:
+                load_ppu(&r, &gb->ppu);
+                break;
+
+            case TAG_TIMR:
+                gb->timer.div_base = get64(&r);
+                gb->timer.synced   = get64(&r);
+                gb->timer.tima     = get8(&r);
+                gb->timer.tma      = get8(&r);
+                gb->timer.tac      = get8(&r);
+                break;
+
+            case TAG_SERL:
+                gb->serial.sb = get8(&r);
+                gb->serial.sc = get8(&r);
+                break;
+
+            case TAG_SCHD:
+                sched_init(&gb->sched);
+                for (int e = 0; e < SCHED_RUN_END; e++) {
+                    u64 when = get64(&r);
+                    if (when != SCHED_NEVER)
+                        sched_add(&gb->sched, (SchedEvent)e, when);
+                }
+                break;
+
+            case TAG_APU:
+                load_apu(&r, &gb->apu);
+                apu_loaded = true;
+                break;
+
+            case TAG_MBC:
+                load_mbc(&r, &gb->cart.mbc);
+                mbc_map(gb);
+                break;
+
+            case TAG_JOYP:
+                gb->joypad.select  = get8(&r) & (P1_SELECT_DPAD | P1_SELECT_BUTTONS);
+                gb->joypad.buttons = get8(&r);
+                joyp_loaded        = true;
+                break;
+
+            case TAG_CRAM:
+                // Battery RAM takes the state's contents: save them too
+                if (get_ram(&r, gb, gb->cart.ram, gb->cart.ram_size))
+                    cart_ram_mark_dirty(&gb->cart, 0, gb->cart.ram_size);
+                break;
+        }
+        r.p = next;
+    }
+
+    // Derived state: decoded tiles follow VRAM
+    if (tiles_changed)
+        ppu_refresh_tiles(gb);
+
+    // Sound picks up from the loaded channels (states without them: power-on)
+    if (apu_loaded)
+        apu_restart_output(gb);
+    else
+        apu_reset(gb);
+    if (!joyp_loaded)
+        joypad_reset(gb);
+
+    return GB_STATE_OK;
+}
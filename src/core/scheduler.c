@@ -0,0 +1,97 @@
+// src/core/scheduler.c
+#include <core/scheduler.h>
+#include <core/ppu.h>
+#include <core/serial.h>
+#include <core/timer.h>
+#include <gbemu.h>
+
+/*
+Event scheduler
+
+Instead of ticking every component after every instruction, each component
+schedules the absolute cycle of its next visible edge (TIMA overflow, end of
+a serial transfer, VBlank, ...). The CPU compares gb->cycles against a single
+deadline, sched.next, and only drops into sched_dispatch() once it passes it.
+Components bring their own state up to date lazily whenever the CPU reads or
+writes one of their registers, so between events they cost nothing.
+
+cpu_run() schedules SCHED_RUN_END at the end of its budget, which makes the
+budget just another deadline for the interpreter's dispatch loop.
+*/
+
+void sched_init(Scheduler *sched) {
+    sched->count = 0;
+    sched->next  = SCHED_NEVER;
+}
+
+void sched_cancel(Scheduler *sched, SchedEvent event) {
+    for (u8 i = 0; i < sched->count; i++) {
+        if (sched->entries[i].event != event)
+            continue;
+
+        for (u8 j = i + 1; j < sched->count; j++)
+            sched->entries[j - 1] = sched->entries[j];
+        sched->count--;
+        break;
+    }
+
+    sched->next = sched->count ? sched->entries[0].when : SCHED_NEVER;
+}
+
+void sched_add(Scheduler *sched, SchedEvent event, u64 when) {
+    sched_cancel(sched, event);
+
+    // Insert after every entry due earlier (or at the same cycle with a lower kind)
+    u8 pos = sched->count;
+    while (pos > 0) {
+        const SchedEntry *prev = &sched->entries[pos - 1];
+        if (prev->when < when || (prev->when == when && prev->event < event))
+            break;
+        sched->entries[pos] = *prev;
+        pos--;
+    }
+
+    sched->entries[pos].when  = when;
+    sched->entries[pos].event = (u8)event;
+    sched->count++;
+    sched->next = sched->entries[0].when;
+}
+
+u64 sched_when(const Scheduler *sched, SchedEvent event) {
+    for (u8 i = 0; i < sched->count; i++) {
+        if (sched->entries[i].event == event)
+            return sched->entries[i].when;
+    }
+    return SCHED_NEVER;
+}
+
+bool sched_dispatch(GameBoy *gb) {
+    Scheduler *sched   = &gb->sched;
+    bool       run_end = false;
+
+    while (sched->count && sched->entries[0].when <= gb->cycles) {
+        SchedEntry entry = sched->entries[0];
+
+        // Pop first: the handler may schedule the same event again
+        sched_cancel(sched, (SchedEvent)entry.event);
+
+        switch (entry.event) {
+            case SCHED_PPU:
+                ppu_event(gb, entry.when);
+                break;
+            case SCHED_TIMER:
+                timer_event(gb, entry.when);
+                break;
+            case SCHED_SERIAL:
+                serial_event(gb, entry.when);
+                break;
+            case SCHED_RUN_END:
+                run_end = true;
+                break;
+            default:
+                break;
+        }
+    }
+
+    return run_end;
+}
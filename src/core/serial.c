@@ -0,0 +1,50 @@
+// src/core/serial.c
+#include <core/serial.h>
+#include <core/cpu.h>
+#include <core/scheduler.h>
+#include <gbemu.h>
+
+void serial_reset(GameBoy *gb) {
+    gb->serial.sb = 0x00;
+    gb->serial.sc = 0x00;
+    sched_cancel(&gb->sched, SCHED_SERIAL);
+}
+
+u8 serial_read(GameBoy *gb, u16 addr) {
+    switch (addr) {
+        case 0xFF01: // SB
+            return gb->serial.sb;
+        case 0xFF02: // SC (unused bits read as 1)
+            return gb->serial.sc | 0x7E;
+        default:
+            return 0xFF;
+    }
+}
+
+void serial_write(GameBoy *gb, u16 addr, u8 value) {
+    switch (addr) {
+        case 0xFF01: // SB
+            gb->serial.sb = value;
+            break;
+        case 0xFF02: // SC
+            gb->serial.sc = value & (SC_START | SC_CLOCK);
+
+            // Only the internal clock ever finishes a transfer without a partner
+            if ((gb->serial.sc & (SC_START | SC_CLOCK)) == (SC_START | SC_CLOCK))
+                sched_add(&gb->sched, SCHED_SERIAL, gb->cycles + SERIAL_CYCLES_PER_BYTE);
+            else
+                sched_cancel(&gb->sched, SCHED_SERIAL);
+            break;
+        default:
+            break;
+    }
+}
+
+// SCHED_SERIAL handler
+void serial_event(GameBoy *gb, u64 when) {
+    (void)when;
+
+    gb->serial.sb = 0xFF; // Nothing connected: the line idles high
+    gb->serial.sc &= (u8)~SC_START;
+    cpu_request_interrupt(gb, INT_SERIAL);
+}
@@ -0,0 +1,134 @@
+// src/core/timer.c
+#include <core/timer.h>
+#include <core/apu.h>
+#include <core/cpu.h>
+#include <core/scheduler.h>
+#include <gbemu.h>
+
+// TIMA increments every 2^shift cycles: 4096, 262144, 65536 & 16384 Hz
+static const u8 tac_shift[4] = {10, 4, 6, 8};
+
+// Value of the 16-bit divider counter (unwrapped) at cycle t
+static u64 timer_counter(const GameBoy *gb, u64 t) {
+    return t - gb->timer.div_base;
+}
+
+// Advance TIMA by `ticks`, reloading from TMA & requesting the interrupt on overflow
+static void timer_advance(GameBoy *gb, u64 ticks) {
+    Timer *timer = &gb->timer;
+
+    while (ticks) {
+        u32 to_overflow = 0x100 - timer->tima;
+        if (ticks < to_overflow) {
+            timer->tima += (u8)ticks;
+            return;
+        }
+
+        ticks -= to_overflow;
+        timer->tima = timer->tma;
+        cpu_request_interrupt(gb, INT_TIMER);
+    }
+}
+
+// Bring TIMA up to date with gb->cycles
+static void timer_sync(GameBoy *gb) {
+    Timer *timer = &gb->timer;
+    u64    now   = gb->cycles;
+
+    if (now <= timer->synced)
+        return;
+
+    if (timer->tac & TAC_ENABLE) {
+        u8 shift = tac_shift[timer->tac & TAC_CLOCK];
+        timer_advance(gb, (timer_counter(gb, now) >> shift) -
+                              (timer_counter(gb, timer->synced) >> shift));
+    }
+
+    timer->synced = now;
+}
+
+// Schedule the next TIMA overflow (or nothing while the timer is stopped)
+static void timer_schedule(GameBoy *gb) {
+    Timer *timer = &gb->timer;
+
+    if (!(timer->tac & TAC_ENABLE)) {
+        sched_cancel(&gb->sched, SCHED_TIMER);
+        return;
+    }
+
+    u8  shift    = tac_shift[timer->tac & TAC_CLOCK];
+    u64 counter  = timer_counter(gb, timer->synced);
+    u64 overflow = ((counter >> shift) + (0x100 - timer->tima)) << shift;
+
+    sched_add(&gb->sched, SCHED_TIMER, timer->synced + (overflow - counter));
+}
+
+// Set the DMG post-boot-ROM state
+void timer_reset(GameBoy *gb) {
+    Timer *timer = &gb->timer;
+
+    timer->div_base = gb->cycles - 0xABCC; // DIV reads 0xAB after the boot ROM
+    timer->synced   = gb->cycles;
+    timer->tima     = 0x00;
+    timer->tma      = 0x00;
+    timer->tac      = 0x00;
+    sched_cancel(&gb->sched, SCHED_TIMER);
+}
+
+u8 timer_read(GameBoy *gb, u16 addr) {
+    Timer *timer = &gb->timer;
+
+    switch (addr) {
+        case 0xFF04: // DIV
+            return (u8)(timer_counter(gb, gb->cycles) >> 8);
+        case 0xFF05: // TIMA
+            timer_sync(gb);
+            return timer->tima;
+        case 0xFF06: // TMA
+            return timer->tma;
+        case 0xFF07: // TAC (upper 5 bits read as 1)
+            return timer->tac | 0xF8;
+        default:
+            return 0xFF;
+    }
+}
+
+void timer_write(GameBoy *gb, u16 addr, u8 value) {
+    Timer *timer = &gb->timer;
+
+    timer_sync(gb);
+
+    switch (addr) {
+        case 0xFF04: { // DIV: any write resets the whole counter
+            // The selected counter bit falling from 1 to 0 still clocks TIMA
+            u8 shift = tac_shift[timer->tac & TAC_CLOCK];
+            if ((timer->tac & TAC_ENABLE) && CHECK_BIT(timer_counter(gb, gb->cycles), shift - 1))
+                timer_advance(gb, 1);
+            apu_div_reset(gb); // The frame sequencer runs off DIV too
+            timer->div_base = gb->cycles;
+            break;
+        }
+        case 0xFF05: // TIMA
+            timer->tima = value;
+            break;
+        case 0xFF06: // TMA
+            timer->tma = value;
+            break;
+        case 0xFF07: // TAC
+            timer->tac = value & (TAC_ENABLE | TAC_CLOCK);
+            break;
+        default:
+            return;
+    }
+
+    timer_schedule(gb);
+}
+
+// SCHED_TIMER handler
+void timer_event(GameBoy *gb, u64 when) {
+    (void)when;
+
+    // Catching up to now performs the overflow (& any ticks since)
+    timer_sync(gb);
+    timer_schedule(gb);
+}
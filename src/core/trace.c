@@ -0,0 +1,195 @@
+// src/core/trace.c
+#include <core/trace.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*
+Instruction trace
+
+The ring is single-producer, single-consumer: the emulation thread owns
+head & limit, the writer thread owns tail. The producer stores a record,
+then publishes head with release; the writer acquires head, fwrite()s every
+record between tail & head in at most two runs (the ring wraps) & releases
+tail. The producer looks at tail only when it reaches limit, so in the
+common case recording is a few stores & no shared reads.
+
+limit also comes every TRACE_KICK records: the producer then wakes the
+writer (one mutex & condvar signal per batch, not per record) & makes sure
+the next batch fits, yielding to the writer until it does. An idle writer
+also wakes up every TRACE_IDLE_NS for whatever trickled in, so a slow or
+paused game still reaches the disk. The producer only waits when the disk
+can't keep up. On a write error the writer keeps draining but drops the
+records, so emulation never blocks on a dead file; trace_stop() reports it.
+
+Stopping: the producer sets quit after its last record. The writer reads
+quit before head, so once it sees quit with an empty ring, everything has
+been written.
+*/
+
+#define TRACE_KICK (TRACE_RING_RECORDS / 4)
+#define TRACE_IDLE_NS 10000000 // 10 ms
+
+typedef struct {
+    Tracer          t; // First: gb->trace points here
+    pthread_t       thread;
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;
+} TraceWriter;
+
+static void trace_wake(TraceWriter *w) {
+    pthread_mutex_lock(&w->lock);
+    pthread_cond_signal(&w->wake);
+    pthread_mutex_unlock(&w->lock);
+}
+
+// Nothing to write: wait for a kick, the idle timeout or quit
+static void trace_idle(TraceWriter *w, u32 head) {
+    struct timespec until;
+    clock_gettime(CLOCK_REALTIME, &until);
+    until.tv_nsec += TRACE_IDLE_NS;
+    if (until.tv_nsec >= 1000000000) {
+        until.tv_sec++;
+        until.tv_nsec -= 1000000000;
+    }
+
+    // Checked under the lock the producer signals with: no lost wake-up
+    pthread_mutex_lock(&w->lock);
+    if (!__atomic_load_n(&w->t.quit, __ATOMIC_ACQUIRE) &&
+        __atomic_load_n(&w->t.head, __ATOMIC_ACQUIRE) == head)
+        pthread_cond_timedwait(&w->wake, &w->lock, &until);
+    pthread_mutex_unlock(&w->lock);
+}
+
+// Write `count` records from the ring starting at `from`
+static void trace_write(Tracer *t, u32 from, u32 count) {
+    u32 at    = from & t->mask;
+    u32 first = t->mask + 1 - at < count ? t->mask + 1 - at : count;
+
+    if (t->failed)
+        return;
+    if (fwrite(t->ring + at, sizeof(TraceRecord), first, t->file) != first ||
+        fwrite(t->ring, sizeof(TraceRecord), count - first, t->file) != count - first)
+        t->failed = true;
+}
+
+static void *trace_thread(void *arg) {
+    TraceWriter *w = arg;
+    Tracer      *t = &w->t;
+
+    for (;;) {
+        u32 quit = __atomic_load_n(&t->quit, __ATOMIC_ACQUIRE);
+        u32 head = __atomic_load_n(&t->head, __ATOMIC_ACQUIRE);
+        u32 tail = t->tail;
+
+        if (head == tail) {
+            if (quit)
+                break;
+            trace_idle(w, head);
+            continue;
+        }
+
+        trace_write(t, tail, head - tail);
+        __atomic_store_n(&t->tail, head, __ATOMIC_RELEASE);
+    }
+    return NULL;
+}
+
+void trace_wait(Tracer *t) {
+    trace_wake((TraceWriter *)t);
+
+    // Room for the next batch
+    for (;;) {
+        u32 tail = __atomic_load_n(&t->tail, __ATOMIC_ACQUIRE);
+        if (t->head + TRACE_KICK - tail <= t->mask + 1) {
+            t->limit = t->head + TRACE_KICK;
+            return;
+        }
+        t->stalls++;
+        sched_yield();
+    }
+}
+
+bool trace_start(GameBoy *gb, const char *path) {
+    TraceFileHeader header = {TRACE_MAGIC, TRACE_VERSION, sizeof(TraceRecord)};
+    TraceWriter    *w      = calloc(1, sizeof(TraceWriter));
+
+    if (!w)
+        return false;
+    trace_stop(gb);
+
+    Tracer *t = &w->t;
+    t->ring   = malloc(TRACE_RING_RECORDS * sizeof(TraceRecord));
+    t->file   = fopen(path, "wb");
+    t->mask   = TRACE_RING_RECORDS - 1;
+    t->limit  = TRACE_KICK;
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->wake, NULL);
+
+    if (!t->ring || !t->file || fwrite(&header, sizeof(header), 1, t->file) != 1 ||
+        pthread_create(&w->thread, NULL, trace_thread, w) != 0) {
+        if (t->file)
+            fclose(t->file);
+        pthread_cond_destroy(&w->wake);
+        pthread_mutex_destroy(&w->lock);
+        free(t->ring);
+        free(w);
+        return false;
+    }
+
+    gb->trace = t;
+    return true;
+}
+
+bool trace_stop(GameBoy *gb) {
+    TraceWriter *w = (TraceWriter *)gb->trace;
+    if (!w)
+        return true;
+
+    gb->trace = NULL;
+    __atomic_store_n(&w->t.quit, 1, __ATOMIC_RELEASE);
+    trace_wake(w);
+    pthread_join(w->thread, NULL);
+    pthread_cond_destroy(&w->wake);
+    pthread_mutex_destroy(&w->lock);
+
+    bool ok = !w->t.failed;
+    if (fclose(w->t.file) != 0)
+        ok = false;
+    free(w->t.ring);
+    free(w);
+    return ok;
+}
+
+// ---------------------------------------------
+// Decoding
+// ---------------------------------------------
+
+int trace_format(const TraceRecord *r, TraceFormat fmt, char *buf, size_t size) {
+    if (fmt == TRACE_DOCTOR)
+        return snprintf(buf, size,
+                        "A:%02X F:%02X B:%02X C:%02X D:%02X E:%02X H:%02X L:%02X SP:%04X PC:%04X "
+                        "PCMEM:%02X,%02X,%02X,%02X",
+                        r->a, r->f, r->b, r->c, r->d, r->e, r->h, r->l, r->sp, r->pc, r->mem[0],
+                        r->mem[1], r->mem[2], r->mem[3]);
+
+    // Instruction bytes, padded to three
+    static const char hex[] = "0123456789ABCDEF";
+    char              bytes[9];
+    memset(bytes, ' ', 8);
+    bytes[8] = '\0';
+    for (int i = 0; i < r->length && i < 3; i++) {
+        bytes[3 * i]     = hex[r->mem[i] >> 4];
+        bytes[3 * i + 1] = hex[r->mem[i] & 0x0F];
+    }
+
+    return snprintf(buf, size,
+                    "%12llu %02X:%04X  %s A:%02X F:%c%c%c%c BC:%04X DE:%04X HL:%04X SP:%04X%s%s",
+                    (unsigned long long)r->cycles, r->bank, r->pc, bytes, r->a,
+                    r->f & FLAG_Z ? 'Z' : '-', r->f & FLAG_N ? 'N' : '-',
+                    r->f & FLAG_H ? 'H' : '-', r->f & FLAG_C ? 'C' : '-', MAKE_U16(r->b, r->c),
+                    MAKE_U16(r->d, r->e), MAKE_U16(r->h, r->l), r->sp,
+                    r->flags & TRACE_IME ? " IME" : "", r->flags & TRACE_HALT_BUG ? " HALTBUG" : "");
+}
@@ -1,42 +1,143 @@
 // src/core/utils.c
 #include <core/utils.h>
+#include <pthread.h>
+#include <string.h>
 
 // Swap endianness
 u16 swap_bytes(u16 val) {
     return (val << 8) | (val >> 8);
 }
 
-// Check if half-carry occurred (bit 3->4)
-bool check_half_carry_add(u8 a, u8 b) {
-    return ((a & 0x0F) + (b & 0x0F)) > 0x0F;
-}
+// BCD adjustment after an addition/subtraction (DAA)
+// https://gbdev.io/pandocs/CPU_Instruction_Set.html (DAA)
+u8 adjust_bcd(u8 value, bool subtract, bool carry, bool half_carry) {
+    u8 correction = 0;
 
-// Check if carry occurred (bit 7->8)
-bool check_carry_add(u8 a, u8 b) {
-    return (u16)a + (u16)b > 0xFF;
-}
+    if (half_carry || (!subtract && (value & 0x0F) > 0x09))
+        correction |= 0x06;
+
+    if (carry || (!subtract && value > 0x99))
+        correction |= 0x60;
 
-// Check if half-carry for subtraction occurred
-bool check_half_carry_sub(u8 a, u8 b) {
-    return (a & 0x0F) < (b & 0x0F);
+    return subtract ? (u8)(value - correction) : (u8)(value + correction);
 }
 
-// Check if carry for subtraction occurred
-bool check_carry_sub(u8 a, u8 b) {
-    return a < b;
+// ---------------------------------------------
+// CRC-32
+// ---------------------------------------------
+// Reflected polynomial 0xEDB88320, slicing by 8: eight tables let the loop
+// fold 8 bytes per step instead of 1. Tables are built once, on first use.
+
+static u32            crc32_table[8][256];
+static pthread_once_t crc32_once = PTHREAD_ONCE_INIT;
+
+static void crc32_init(void) {
+    for (u32 i = 0; i < 256; i++) {
+        u32 crc = i;
+        for (int k = 0; k < 8; k++)
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        crc32_table[0][i] = crc;
+    }
+    for (u32 i = 0; i < 256; i++) {
+        for (int t = 1; t < 8; t++) {
+            u32 prev          = crc32_table[t - 1][i];
+            crc32_table[t][i] = (prev >> 8) ^ crc32_table[0][prev & 0xFF];
+        }
+    }
 }
 
-// 16-bit versions to check if half-carry occurred (bit 11->12)
-bool check_half_carry_add_u16(u16 a, u16 b) {
-    return ((a & 0x0FFF) + (b & 0x0FFF)) > 0x0FFF;
+u32 compute_crc32(const void *data, size_t size) {
+    const u8 *p   = data;
+    u32       crc = 0xFFFFFFFFu;
+
+    pthread_once(&crc32_once, crc32_init);
+
+    for (; size >= 8; size -= 8, p += 8) {
+        u32 lo = crc ^ ((u32)p[0] | (u32)p[1] << 8 | (u32)p[2] << 16 | (u32)p[3] << 24);
+        crc    = crc32_table[7][lo & 0xFF] ^ crc32_table[6][(lo >> 8) & 0xFF] ^
+              crc32_table[5][(lo >> 16) & 0xFF] ^ crc32_table[4][lo >> 24] ^
+              crc32_table[3][p[4]] ^ crc32_table[2][p[5]] ^ crc32_table[1][p[6]] ^
+              crc32_table[0][p[7]];
+    }
+    for (; size; size--, p++)
+        crc = (crc >> 8) ^ crc32_table[0][(crc ^ *p) & 0xFF];
+
+    return ~crc;
 }
 
-// 16-bit version to check if carry occurred
-bool check_carry_add_u16(u16 a, u16 b) {
-    return ((u32)a + (u32)b) > 0xFFFF;
+// ---------------------------------------------
+// SHA-1
+// ---------------------------------------------
+// FIPS 180-4. Only used to name ROM images, once per distinct ROM.
+
+#define ROL32(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+
+static void sha1_block(u32 h[5], const u8 *block) {
+    u32 w[80];
+    for (int i = 0; i < 16; i++)
+        w[i] = (u32)block[i * 4] << 24 | (u32)block[i * 4 + 1] << 16 |
+               (u32)block[i * 4 + 2] << 8 | (u32)block[i * 4 + 3];
+    for (int i = 16; i < 80; i++)
+        w[i] = ROL32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+    u32 a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+        u32 f, k;
+        if (i < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999;
+        } else if (i < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1;
+        } else if (i < 60) {
+            f = (b & c) | (b & d) | (c & d);
+            k = 0x8F1BBCDC;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6;
+        }
+
+        u32 t = ROL32(a, 5) + f + e + k + w[i];
+        e     = d;
+        d     = c;
+        c     = ROL32(b, 30);
+        b     = a;
+        a     = t;
+    }
+
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
 }
 
-// Extend 8-bit signed to 16-bit
-i16 sign_extend_i8(u8 val) {
-    return (val & 0x80) ? (i16)(val | 0xFF00) : (i16)val;
+void compute_sha1(const void *data, size_t size, u8 out[SHA1_SIZE]) {
+    const u8 *p    = data;
+    u32       h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    u8        tail[128] = {0};
+    size_t    rest      = size % 64;
+
+    for (size_t i = 0; i + 64 <= size; i += 64)
+        sha1_block(h, p + i);
+
+    // Last partial block, 0x80, zeros & the bit length (one or two blocks)
+    if (rest)
+        memcpy(tail, p + size - rest, rest);
+    tail[rest]       = 0x80;
+    size_t tail_size = rest < 56 ? 64 : 128;
+    u64    bits      = (u64)size * 8;
+    for (int i = 0; i < 8; i++)
+        tail[tail_size - 1 - i] = (u8)(bits >> (i * 8));
+
+    sha1_block(h, tail);
+    if (tail_size == 128)
+        sha1_block(h, tail + 64);
+
+    for (int i = 0; i < 5; i++) {
+        out[i * 4]     = (u8)(h[i] >> 24);
+        out[i * 4 + 1] = (u8)(h[i] >> 16);
+        out[i * 4 + 2] = (u8)(h[i] >> 8);
+        out[i * 4 + 3] = (u8)h[i];
+    }
 }
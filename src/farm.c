@@ -0,0 +1,146 @@
+// src/farm.c
+// baredmg-farm: run many headless instances in parallel (see frontend/headless.h)
+#include <frontend/headless.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_ROMS 256
+
+typedef struct {
+    const char *path;
+    RomImage   *image; // Store reference: every instance of the ROM shares it
+} FarmRom;
+
+// Print the user Instructions
+static void print_usage(const char *program_name) {
+    printf("Usage: %s [options] <rom> [<rom> ...]\n", program_name);
+    printf("\n");
+    printf("Options:\n");
+    printf("  -n <count>       Instances, ROMs assigned round-robin (default: one per ROM)\n");
+    printf("  -t <threads>     Worker threads (default: one per online CPU)\n");
+    printf("  -f <frames>      Frames to run per instance (default: 600)\n");
+    printf("  -c <cycles>      Run a cycle budget instead of frames\n");
+    printf("  --pin            Pin each worker thread to its own CPU\n");
+    printf("  --jit            Run the CPUs through the x86-64 block JIT\n");
+    printf("  --audio          Synthesize audio (default: APU registers only)\n");
+    printf("\n");
+    printf("Prints one line per instance (index, ROM, cycles, state digest) in index\n");
+    printf("order; the output doesn't depend on the thread count.\n");
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[]) {
+    FarmRom     roms[MAX_ROMS];
+    int         rom_count = 0;
+    long        instances = 0;
+    FarmOptions opt       = {0};
+    u64         frames    = 600;
+    u64         cycles    = 0;
+    bool        jit       = false;
+    bool        audio     = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg     = argv[i];
+        bool        has_val = i + 1 < argc;
+
+        if (strcmp(arg, "-n") == 0 && has_val)
+            instances = strtol(argv[++i], NULL, 0);
+        else if (strcmp(arg, "-t") == 0 && has_val)
+            opt.threads = (int)strtol(argv[++i], NULL, 0);
+        else if (strcmp(arg, "-f") == 0 && has_val)
+            frames = strtoull(argv[++i], NULL, 0);
+        else if (strcmp(arg, "-c") == 0 && has_val)
+            cycles = strtoull(argv[++i], NULL, 0);
+        else if (strcmp(arg, "--pin") == 0)
+            opt.pin = true;
+        else if (strcmp(arg, "--jit") == 0)
+            jit = cpu_jit_available();
+        else if (strcmp(arg, "--audio") == 0)
+            audio = true;
+        else if (arg[0] == '-' || rom_count == MAX_ROMS) {
+            print_usage(argv[0]);
+            return -2;
+        }
+        else
+            roms[rom_count++].path = arg;
+    }
+
+    if (rom_count == 0) {
+        fprintf(stderr, "Error: No ROM file specified\n\n");
+        print_usage(argv[0]);
+        return -2;
+    }
+    if (instances <= 0)
+        instances = rom_count;
+    if (cycles)
+        frames = 0;
+
+    // Each ROM file is read (mapped) & hashed once; instances only parse its header
+    for (int r = 0; r < rom_count; r++) {
+        if (rom_store_open(roms[r].path, &roms[r].image) != 0) {
+            fprintf(stderr, "Failed to read ROM: %s\n", roms[r].path);
+            return -3;
+        }
+    }
+
+    GameBoy **gbs  = calloc((size_t)instances, sizeof(GameBoy *));
+    FarmJob  *jobs = calloc((size_t)instances, sizeof(FarmJob));
+    if (!gbs || !jobs) {
+        fprintf(stderr, "Out of memory\n");
+        return -4;
+    }
+
+    for (long i = 0; i < instances; i++) {
+        const FarmRom *rom = &roms[i % rom_count];
+
+        gbs[i] = malloc(sizeof(GameBoy));
+        if (!gbs[i]) {
+            fprintf(stderr, "Out of memory\n");
+            return -4;
+        }
+        gb_init(gbs[i]);
+        gbs[i]->jit_enabled = jit;
+        // Nobody listens: keep what games read back, skip the samples
+        apu_set_mode(gbs[i], audio ? APU_MODE_FULL : APU_MODE_REGISTERS);
+        if (!gb_load_rom_image(gbs[i], rom->image)) {
+            fprintf(stderr, "Failed to load ROM: %s\n", rom->path);
+            return -3;
+        }
+        jobs[i] = (FarmJob){gbs[i], frames, cycles};
+    }
+
+    FarmStats stats;
+    double    start = now_s();
+    if (farm_run(jobs, (size_t)instances, &opt, &stats) != 0) {
+        fprintf(stderr, "Failed to start the thread pool\n");
+        return -5;
+    }
+    double elapsed = now_s() - start;
+
+    // Results in instance order, whoever ran them
+    u64 total = 0;
+    for (long i = 0; i < instances; i++) {
+        printf("%6ld  %-32s %12llu  %016llx\n", i, roms[i % rom_count].path,
+               (unsigned long long)gbs[i]->cycles, (unsigned long long)farm_digest(gbs[i]));
+        total += gbs[i]->cycles;
+        gb_unload(gbs[i]);
+        free(gbs[i]);
+    }
+
+    fprintf(stderr, "%ld instances, %d threads, %llu steals: %.3f s, %.1fx real time\n",
+            instances, stats.threads, (unsigned long long)stats.steals, elapsed,
+            (double)total / elapsed / CPU_CLOCK_HZ);
+
+    for (int r = 0; r < rom_count; r++)
+        rom_store_release(roms[r].image);
+    free(jobs);
+    free(gbs);
+    return 0;
+}
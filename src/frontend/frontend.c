@@ -0,0 +1,51 @@
+// src/frontend/frontend.c
+#include <frontend/frontend.h>
+#include <string.h>
+
+/*
+Frame exchange (triple buffer)
+
+Slot ownership moves only through `middle`. Publishing swaps the back slot
+in with FRAME_FRESH set; acquiring swaps the front slot in (flag clear) if
+the flag was set. Each slot index is always held by exactly one of back,
+front & middle, so the slot a side draws into or reads from can't be
+touched by the other side until it gives it away.
+
+Ordering: the exchanges are acq_rel. The producer's release publishes the
+pixels it drew; the consumer's acquire sees them, & its own release hands
+the old front back before the producer (acquire) draws over it.
+*/
+
+void frame_exchange_init(FrameExchange *fx) {
+    memset(fx, 0, sizeof(*fx));
+    fx->back   = 0;
+    fx->middle = 1;
+    fx->front  = 2;
+}
+
+FrameSlot *frame_exchange_back(FrameExchange *fx) {
+    return &fx->slot[fx->back];
+}
+
+void frame_exchange_publish(FrameExchange *fx) {
+    fx->slot[fx->back].serial = ++fx->published;
+
+    u32 old  = __atomic_exchange_n(&fx->middle, fx->back | FRAME_FRESH, __ATOMIC_ACQ_REL);
+    fx->back = old & ~FRAME_FRESH;
+}
+
+const FrameSlot *frame_exchange_acquire(FrameExchange *fx) {
+    // Nothing new: keep the frame we have (no write to the shared line)
+    if (!(__atomic_load_n(&fx->middle, __ATOMIC_RELAXED) & FRAME_FRESH))
+        return &fx->slot[fx->front];
+
+    u64 shown = fx->slot[fx->front].serial;
+    u32 fresh = __atomic_exchange_n(&fx->middle, fx->front, __ATOMIC_ACQ_REL);
+    fx->front = fresh & ~FRAME_FRESH;
+
+    // Frames published between the one we had & this one were never shown
+    u64 serial = fx->slot[fx->front].serial;
+    if (serial > shown + 1)
+        fx->skipped += serial - shown - 1;
+    return &fx->slot[fx->front];
+}
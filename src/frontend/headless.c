@@ -0,0 +1,269 @@
+// src/frontend/headless.c
+#ifdef __linux__
+#define _GNU_SOURCE // pthread_setaffinity_np
+#endif
+
+#include <frontend/headless.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*
+Multi-instance runner
+
+Jobs (one GameBoy each) are split into one contiguous shard per worker.
+A shard is a [next, end) range of job indices packed into one 64-bit word
+so both ends can be moved with a single compare-and-swap:
+
+- the owner takes jobs from the front (next + 1),
+- an idle worker steals the back half of another shard (end - k) & makes
+  it its own shard.
+
+Jobs are never added once the run starts, so a worker that finds every
+shard empty is done. A job is run from start to finish by whoever took it;
+instances share nothing but read-only ROM images (romstore.c), so output
+does not depend on the thread count or on who ran what.
+
+Shards sit on their own cache lines: owners update theirs on every job.
+*/
+
+#define FARM_MAX_THREADS 256
+#define FARM_CACHE_LINE 64
+
+typedef struct {
+    u64 range; // next in the low 32 bits, end in the high 32 bits
+    u8  pad[FARM_CACHE_LINE - sizeof(u64)];
+} FarmShard;
+
+typedef struct Farm Farm;
+
+typedef struct {
+    Farm     *farm;
+    int       index;
+    pthread_t thread;
+    bool      started; // Own thread (worker 0 is the caller)
+    u64       steals;
+} FarmWorker;
+
+struct Farm {
+    FarmJob    *jobs;
+    FarmShard  *shards;
+    FarmWorker *workers;
+    int         threads;
+    bool        pin;
+};
+
+// ---------------------------------------------
+// Shards
+// ---------------------------------------------
+
+static inline u64 farm_pack(u32 next, u32 end) {
+    return (u64)end << 32 | next;
+}
+
+static inline u64 farm_load(FarmShard *shard) {
+    return __atomic_load_n(&shard->range, __ATOMIC_ACQUIRE);
+}
+
+static inline bool farm_cas(FarmShard *shard, u64 *expected, u64 desired) {
+    return __atomic_compare_exchange_n(&shard->range, expected, desired, false, __ATOMIC_ACQ_REL,
+                                       __ATOMIC_ACQUIRE);
+}
+
+// Owner side: take the job at the front
+static bool farm_pop(FarmShard *shard, u32 *job) {
+    u64 range = farm_load(shard);
+
+    for (;;) {
+        u32 next = (u32)range;
+        u32 end  = (u32)(range >> 32);
+
+        if (next >= end)
+            return false;
+        if (farm_cas(shard, &range, farm_pack(next + 1, end))) {
+            *job = next;
+            return true;
+        }
+    }
+}
+
+// Thief side: take the back half (rounded up) of `victim`
+static bool farm_steal(FarmShard *victim, u32 *first, u32 *last) {
+    u64 range = farm_load(victim);
+
+    for (;;) {
+        u32 next = (u32)range;
+        u32 end  = (u32)(range >> 32);
+
+        if (next >= end)
+            return false;
+
+        u32 take = (end - next + 1) / 2;
+        if (farm_cas(victim, &range, farm_pack(next, end - take))) {
+            *first = end - take;
+            *last  = end;
+            return true;
+        }
+    }
+}
+
+// ---------------------------------------------
+// Workers
+// ---------------------------------------------
+
+void farm_run_job(FarmJob *job) {
+    if (job->frames) {
+        for (u64 f = 0; f < job->frames && job->gb->running; f++)
+            gb_run_frame(job->gb);
+    } else {
+        gb_run_cycles(job->gb, job->cycles);
+    }
+}
+
+static void farm_pin(int index) {
+#ifdef __linux__
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus <= 0)
+        return;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(index % cpus, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set); // Best effort
+#else
+    (void)index;
+#endif
+}
+
+static void *farm_worker(void *arg) {
+    FarmWorker *self = arg;
+    Farm       *farm = self->farm;
+    FarmShard  *own  = &farm->shards[self->index];
+    u32         job;
+
+    if (farm->pin)
+        farm_pin(self->index);
+
+    for (;;) {
+        while (farm_pop(own, &job))
+            farm_run_job(&farm->jobs[job]);
+
+        // Own shard is empty (thieves can't touch it): refill it from a victim
+        bool stole = false;
+        for (int i = 1; i < farm->threads && !stole; i++) {
+            u32 first, last;
+            if (farm_steal(&farm->shards[(self->index + i) % farm->threads], &first, &last)) {
+                __atomic_store_n(&own->range, farm_pack(first, last), __ATOMIC_RELEASE);
+                self->steals++;
+                stole = true;
+            }
+        }
+
+        if (!stole)
+            return NULL;
+    }
+}
+
+// ---------------------------------------------
+// Runner
+// ---------------------------------------------
+
+int farm_run(FarmJob *jobs, size_t count, const FarmOptions *opt, FarmStats *stats) {
+    int threads = opt ? opt->threads : 0;
+
+    if (threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads   = cpus > 0 ? (int)cpus : 1;
+    }
+    if (threads > FARM_MAX_THREADS)
+        threads = FARM_MAX_THREADS;
+    if ((size_t)threads > count)
+        threads = count ? (int)count : 1;
+
+    void *shards = NULL;
+    if (posix_memalign(&shards, FARM_CACHE_LINE, (size_t)threads * sizeof(FarmShard)) != 0)
+        return -1;
+
+    Farm farm = {
+        .jobs    = jobs,
+        .shards  = shards,
+        .workers = calloc((size_t)threads, sizeof(FarmWorker)),
+        .threads = threads,
+        .pin     = opt && opt->pin,
+    };
+
+    if (!farm.workers) {
+        free(shards);
+        return -1;
+    }
+
+    // Contiguous shards: neighbouring jobs (often the same ROM) stay on one worker
+    for (int i = 0; i < threads; i++) {
+        u32 first             = (u32)(count * (size_t)i / (size_t)threads);
+        u32 last              = (u32)(count * (size_t)(i + 1) / (size_t)threads);
+        farm.shards[i].range  = farm_pack(first, last);
+        farm.workers[i].farm  = &farm;
+        farm.workers[i].index = i;
+    }
+
+    // Worker 0 is the calling thread. If a thread can't be started its
+    // shard is simply left to the others to steal.
+    int started = 1;
+    for (int i = 1; i < threads; i++) {
+        FarmWorker *w = &farm.workers[i];
+        w->started    = pthread_create(&w->thread, NULL, farm_worker, w) == 0;
+        started      += w->started;
+    }
+    farm_worker(&farm.workers[0]);
+
+    u64 steals = farm.workers[0].steals;
+    for (int i = 1; i < threads; i++) {
+        if (!farm.workers[i].started)
+            continue;
+        pthread_join(farm.workers[i].thread, NULL);
+        steals += farm.workers[i].steals;
+    }
+
+    if (stats) {
+        stats->threads = started;
+        stats->steals  = steals;
+    }
+
+    free(farm.shards);
+    free(farm.workers);
+    return 0;
+}
+
+// ---------------------------------------------
+// Digest
+// ---------------------------------------------
+
+static u64 farm_fnv(u64 hash, const void *data, size_t size) {
+    const u8 *p = data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+u64 farm_digest(const GameBoy *gb) {
+    const CPU *cpu  = &gb->cpu;
+    u64        hash = 0xCBF29CE484222325ull;
+
+    // Registers one by one: the struct has padding
+    u8 regs[12] = {cpu->a, cpu->f, cpu->b, cpu->c, cpu->d, cpu->e, cpu->h, cpu->l,
+                   (u8)cpu->sp, (u8)(cpu->sp >> 8), (u8)cpu->pc, (u8)(cpu->pc >> 8)};
+
+    hash = farm_fnv(hash, regs, sizeof(regs));
+    hash = farm_fnv(hash, &gb->cycles, sizeof(gb->cycles));
+    hash = farm_fnv(hash, gb->vram, sizeof(gb->vram));
+    hash = farm_fnv(hash, gb->wram, sizeof(gb->wram));
+    hash = farm_fnv(hash, gb->oam, sizeof(gb->oam));
+    hash = farm_fnv(hash, gb->hram, sizeof(gb->hram));
+    hash = farm_fnv(hash, gb->ppu.frame[gb->ppu.back ^ 1], sizeof(gb->ppu.frame[0]));
+    if (gb->cart.ram)
+        hash = farm_fnv(hash, gb->cart.ram, gb->cart.ram_size);
+    return hash;
+}
@@ -0,0 +1,280 @@
+// src/frontend/sdl_frontend.c
+#include <frontend/frontend.h>
+#include <SDL.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+SDL frontend
+
+Two threads, neither of which ever waits for the other:
+
+- Emulation (emu_thread): runs one gb_run_frame(), draws the finished
+  frame into its back slot of the FrameExchange, publishes it & sleeps
+  until the frame's deadline on the monotonic clock. Deadlines are
+  absolute (no drift); after a stall of more than EMU_MAX_LAG_FRAMES the
+  schedule restarts from now instead of racing to catch up. It alone
+  touches the GameBoy once started.
+- Render (the caller, which SDL wants for the window): pumps events,
+  keeps the held keys in a mask & stores it atomically for the emulation
+  thread to pick up at the start of each frame, then presents the newest
+  published frame. A vsync wait or a window manager hiccup blocks only
+  this thread; a late emulated frame only means the last one is shown
+  again, never a half-drawn one.
+
+Sound goes the same way: the APU writes a frame's worth of samples to the
+AudioRing at the end of each frame & the SDL audio callback drains it,
+padding with silence when it runs dry.
+*/
+
+#define EMU_FRAME_NS ((u64)CYCLES_PER_FRAME * 1000000000ull / CPU_CLOCK_HZ)
+#define EMU_MAX_LAG_FRAMES 4
+
+#define AUDIO_RING_FRAMES 4096 // ~85 ms at 48 kHz
+#define AUDIO_DEVICE_FRAMES 512
+
+// Shades 0 - 3, lightest first (ARGB8888)
+static const u32 sdl_palette[4] = {0xFFE0F8D0, 0xFF88C070, 0xFF346856, 0xFF081820};
+
+typedef struct {
+    GameBoy      *gb;
+    FrameExchange frames;
+
+    // Written by the render thread, read by the emulation thread
+    u32           buttons; // JOYPAD_* mask
+    u32           quit;
+
+    AudioRing     ring; // Emulation thread -> audio callback
+} SdlFrontend;
+
+static u64 now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ull + (u64)ts.tv_nsec;
+}
+
+static void sleep_until(u64 ns) {
+    struct timespec ts = {(time_t)(ns / 1000000000ull), (long)(ns % 1000000000ull)};
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        ;
+}
+
+// ---------------------------------------------
+// Emulation Thread
+// ---------------------------------------------
+
+static void *emu_thread(void *arg) {
+    SdlFrontend *fe       = arg;
+    GameBoy     *gb       = fe->gb;
+    u64          deadline = now_ns();
+
+    while (!__atomic_load_n(&fe->quit, __ATOMIC_ACQUIRE)) {
+        joypad_set_buttons(gb, (u8)__atomic_load_n(&fe->buttons, __ATOMIC_ACQUIRE));
+        gb_run_frame(gb);
+
+        // Shades to colors, straight into the slot the render thread will show
+        const u8 *shades = ppu_framebuffer(gb);
+        u32      *pixels = frame_exchange_back(&fe->frames)->pixels;
+        for (int i = 0; i < SCREEN_HEIGHT * SCREEN_WIDTH; i++)
+            pixels[i] = sdl_palette[shades[i] & 3];
+        frame_exchange_publish(&fe->frames);
+
+        deadline += EMU_FRAME_NS;
+        u64 now   = now_ns();
+        if (now > deadline + EMU_MAX_LAG_FRAMES * EMU_FRAME_NS)
+            deadline = now; // Suspended, debugged, or the host is too slow
+        else
+            sleep_until(deadline);
+    }
+    return NULL;
+}
+
+// ---------------------------------------------
+// Audio
+// ---------------------------------------------
+
+static void sdl_audio_callback(void *userdata, Uint8 *stream, int len) {
+    SdlFrontend *fe = userdata;
+    audio_ring_read(&fe->ring, (i16 *)stream, (u32)len / (2 * sizeof(i16)));
+}
+
+// Open the default device & point the APU at it (0: opened, else no sound)
+static SDL_AudioDeviceID sdl_open_audio(SdlFrontend *fe) {
+    SDL_AudioSpec want = {0}, have;
+
+    if (!audio_ring_init(&fe->ring, AUDIO_RING_FRAMES))
+        return 0;
+
+    want.freq     = APU_SAMPLE_RATE;
+    want.format   = AUDIO_S16SYS;
+    want.channels = 2;
+    want.samples  = AUDIO_DEVICE_FRAMES;
+    want.callback = sdl_audio_callback;
+    want.userdata = fe;
+
+    SDL_AudioDeviceID dev =
+        SDL_OpenAudioDevice(NULL, 0, &want, &have, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
+    if (!dev) {
+        fprintf(stderr, "No audio: %s\n", SDL_GetError());
+        audio_ring_free(&fe->ring);
+        return 0;
+    }
+
+    apu_set_output(fe->gb, (u32)have.freq, &fe->ring);
+    SDL_PauseAudioDevice(dev, 0);
+    return dev;
+}
+
+// ---------------------------------------------
+// Input
+// ---------------------------------------------
+
+static u8 sdl_key_button(SDL_Keycode key) {
+    switch (key) {
+        case SDLK_RIGHT:
+            return JOYPAD_RIGHT;
+        case SDLK_LEFT:
+            return JOYPAD_LEFT;
+        case SDLK_UP:
+            return JOYPAD_UP;
+        case SDLK_DOWN:
+            return JOYPAD_DOWN;
+        case SDLK_z:
+            return JOYPAD_A;
+        case SDLK_x:
+            return JOYPAD_B;
+        case SDLK_BACKSPACE:
+        case SDLK_RSHIFT:
+            return JOYPAD_SELECT;
+        case SDLK_RETURN:
+            return JOYPAD_START;
+        default:
+            return 0;
+    }
+}
+
+// Drain the event queue into `buttons`; false once the window should close
+static bool sdl_poll_input(u8 *buttons) {
+    SDL_Event e;
+
+    while (SDL_PollEvent(&e)) {
+        switch (e.type) {
+            case SDL_QUIT:
+                return false;
+            case SDL_KEYDOWN:
+                if (e.key.keysym.sym == SDLK_ESCAPE)
+                    return false;
+                *buttons |= sdl_key_button(e.key.keysym.sym);
+                break;
+            case SDL_KEYUP:
+                *buttons &= (u8)~sdl_key_button(e.key.keysym.sym);
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+// ---------------------------------------------
+// Render Thread
+// ---------------------------------------------
+
+int sdl_frontend_run(GameBoy *gb, const FrontendOptions *opt) {
+    int          scale = opt->scale > 0 ? opt->scale : 4;
+    Uint32       flags = SDL_INIT_VIDEO | (opt->audio ? SDL_INIT_AUDIO : 0);
+    SdlFrontend *fe    = calloc(1, sizeof(SdlFrontend));
+
+    if (!fe)
+        return -1;
+    if (SDL_Init(flags) != 0) {
+        fprintf(stderr, "SDL_Init failed: %s\n", SDL_GetError());
+        free(fe);
+        return -1;
+    }
+
+    fe->gb = gb;
+    frame_exchange_init(&fe->frames);
+
+    char title[64];
+    snprintf(title, sizeof(title), "BareDMG - %s", gb->cart.header.title);
+    SDL_Window *window =
+        SDL_CreateWindow(title, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                         SCREEN_WIDTH * scale, SCREEN_HEIGHT * scale, SDL_WINDOW_RESIZABLE);
+    SDL_Renderer *renderer =
+        window ? SDL_CreateRenderer(window, -1, opt->vsync ? SDL_RENDERER_PRESENTVSYNC : 0) : NULL;
+    SDL_Texture *texture = renderer ? SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888,
+                                                        SDL_TEXTUREACCESS_STREAMING, SCREEN_WIDTH,
+                                                        SCREEN_HEIGHT)
+                                    : NULL;
+    if (!texture) {
+        fprintf(stderr, "Failed to open a window: %s\n", SDL_GetError());
+        if (renderer)
+            SDL_DestroyRenderer(renderer);
+        if (window)
+            SDL_DestroyWindow(window);
+        SDL_Quit();
+        free(fe);
+        return -1;
+    }
+    SDL_RenderSetLogicalSize(renderer, SCREEN_WIDTH, SCREEN_HEIGHT);
+
+    // Nobody listens without a device: keep only what games read back
+    SDL_AudioDeviceID audio = opt->audio ? sdl_open_audio(fe) : 0;
+    apu_set_mode(gb, audio ? APU_MODE_FULL : APU_MODE_REGISTERS);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, emu_thread, fe) != 0) {
+        fprintf(stderr, "Failed to start the emulation thread\n");
+        if (audio)
+            SDL_CloseAudioDevice(audio);
+        SDL_DestroyTexture(texture);
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        audio_ring_free(&fe->ring);
+        free(fe);
+        return -1;
+    }
+
+    u8  buttons = 0;
+    u64 shown   = 0;
+    while (sdl_poll_input(&buttons)) {
+        __atomic_store_n(&fe->buttons, buttons, __ATOMIC_RELEASE);
+
+        const FrameSlot *slot = frame_exchange_acquire(&fe->frames);
+        if (slot->serial != shown) {
+            SDL_UpdateTexture(texture, NULL, slot->pixels, SCREEN_WIDTH * sizeof(u32));
+            shown = slot->serial;
+        }
+        else if (!opt->vsync) {
+            SDL_Delay(1); // Nothing new & nothing to pace us: don't spin
+            continue;
+        }
+
+        SDL_RenderClear(renderer);
+        SDL_RenderCopy(renderer, texture, NULL, NULL);
+        SDL_RenderPresent(renderer); // May block on vsync; emulation runs on
+    }
+
+    __atomic_store_n(&fe->quit, 1, __ATOMIC_RELEASE);
+    pthread_join(thread, NULL);
+
+    if (audio) {
+        SDL_CloseAudioDevice(audio); // Stops the callback before the ring goes
+        apu_set_output(gb, 0, NULL);
+    }
+    audio_ring_free(&fe->ring);
+    SDL_DestroyTexture(texture);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+
+    printf("%llu frames, %llu never shown\n", (unsigned long long)fe->frames.published,
+           (unsigned long long)fe->frames.skipped);
+    free(fe);
+    return 0;
+}
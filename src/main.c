@@ -1,14 +1,30 @@
 #include <gbemu.h>
 #include <core/cartridge.h>
+#include <core/trace.h>
+#include <frontend/frontend.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#define PROFILE_DEFAULT_PATH "baredmg-profile.json"
 
 // Print the user Instructions
 static void print_usage(const char *program_name) {
-    printf("Usage: %s <path_to_rom>\n", program_name);
+    printf("Usage: %s <path_to_rom> [options]\n", program_name);
     printf("\n");
     printf("Options:\n");
     printf("  <path_to_rom>    Path to Game Boy ROM file (.gb)\n");
+    printf("  --jit            Run the CPU through the x86-64 block JIT\n");
+    printf("  --scale <n>      Window size in multiples of 160x144 (default: 4)\n");
+    printf("  --no-vsync       Don't wait for the display when presenting\n");
+    printf("  --mute           No audio device (the APU keeps only its registers)\n");
+    printf("  --trace <file>   Record every instruction to <file> (see baredmg-trace)\n");
+#ifdef BAREDMG_PROFILE
+    printf("  --profile <file> Where to write the guest profile at exit\n");
+    printf("                   (default: " PROFILE_DEFAULT_PATH ")\n");
+#endif
+    printf("\n");
+    printf("Keys: arrows, Z (A), X (B), Enter (Start), Backspace (Select), Esc (quit)\n");
 }
 
 int main(int argc, char *argv[]) {
@@ -32,6 +48,27 @@ int main(int argc, char *argv[]) {
     GameBoy gb;
     gb_init(&gb);
 
+    // Optional flags
+    FrontendOptions opt          = {.scale = 4, .vsync = true, .audio = true};
+    const char     *profile_path = PROFILE_DEFAULT_PATH;
+    const char     *trace_path   = NULL;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--jit") == 0)
+            gb.jit_enabled = cpu_jit_available();
+        else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc)
+            opt.scale = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--no-vsync") == 0)
+            opt.vsync = false;
+        else if (strcmp(argv[i], "--mute") == 0)
+            opt.audio = false;
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+            trace_path = argv[++i];
+#ifdef BAREDMG_PROFILE
+        else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+            profile_path = argv[++i];
+#endif
+    }
+
     // Load ROM && Print the parsed header
     printf("Loading ROM: %s\n", rom_path);
     gb_load_rom(&gb, rom_path);
@@ -45,8 +82,32 @@ int main(int argc, char *argv[]) {
     // ROM loaded Successfully
     printf("ROM Loaded Successfully!\n");
 
+    // From the first instruction; gb_unload() writes out the rest
+    if (trace_path && !trace_start(&gb, trace_path))
+        fprintf(stderr, "Failed to start the trace: %s\n", trace_path);
+
+#ifndef BAREDMG_NO_SDL
+    // Runs until the window is closed
+    if (sdl_frontend_run(&gb, &opt) != 0)
+        fprintf(stderr, "Failed to start the SDL frontend\n");
+#else
+    (void)opt;
+    printf("Built without SDL2: nothing to show it in\n");
+#endif
+
+#ifdef BAREDMG_PROFILE
+    if (profile_save_json(&gb.profile, profile_path) == 0)
+        printf("Profile written to %s\n", profile_path);
+    else
+        fprintf(stderr, "Failed to write the profile: %s\n", profile_path);
+#else
+    (void)profile_path;
+#endif
+
     // Clean up
-    cart_unload(&gb.cart);
+    if (!trace_stop(&gb))
+        fprintf(stderr, "Failed to write the trace: %s\n", trace_path);
+    gb_unload(&gb);
 
     puts("\nExiting...\n");
     return 0;
@@ -0,0 +1,89 @@
+// src/tracedump.c
+// baredmg-trace: turn a binary instruction trace (core/trace.h) into text
+#include <core/trace.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DUMP_CHUNK 4096 // Records per read
+
+// Print the user Instructions
+static void print_usage(const char *program_name) {
+    printf("Usage: %s [options] <trace>\n", program_name);
+    printf("\n");
+    printf("Options:\n");
+    printf("  --doctor         Gameboy Doctor lines (A:.. F:.. ... PC:.... PCMEM:..,..,..,..)\n");
+    printf("  --skip <n>       Start after the first n instructions\n");
+    printf("  --count <n>      Print at most n instructions\n");
+    printf("\n");
+    printf("Default lines: cycle, bank:pc, instruction bytes, registers, flags, IME.\n");
+}
+
+int main(int argc, char *argv[]) {
+    const char  *path  = NULL;
+    TraceFormat  fmt   = TRACE_TEXT;
+    u64          skip  = 0;
+    u64          count = UINT64_MAX;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg     = argv[i];
+        bool        has_val = i + 1 < argc;
+
+        if (strcmp(arg, "--doctor") == 0)
+            fmt = TRACE_DOCTOR;
+        else if (strcmp(arg, "--skip") == 0 && has_val)
+            skip = strtoull(argv[++i], NULL, 0);
+        else if (strcmp(arg, "--count") == 0 && has_val)
+            count = strtoull(argv[++i], NULL, 0);
+        else if (arg[0] == '-' || path) {
+            print_usage(argv[0]);
+            return -2;
+        }
+        else
+            path = arg;
+    }
+
+    if (!path) {
+        fprintf(stderr, "Error: No trace file specified\n\n");
+        print_usage(argv[0]);
+        return -2;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "Failed to open trace: %s\n", path);
+        return -3;
+    }
+
+    TraceFileHeader header;
+    if (fread(&header, sizeof(header), 1, f) != 1 ||
+        memcmp(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        fprintf(stderr, "Not a BareDMG trace: %s\n", path);
+        fclose(f);
+        return -3;
+    }
+    if (header.version != TRACE_VERSION || header.record_size != sizeof(TraceRecord)) {
+        fprintf(stderr, "Unsupported trace version %u (record size %u)\n", header.version,
+                header.record_size);
+        fclose(f);
+        return -3;
+    }
+
+    static TraceRecord records[DUMP_CHUNK];
+    char               line[128];
+    u64                index = 0;
+    size_t             n;
+
+    while (count && (n = fread(records, sizeof(TraceRecord), DUMP_CHUNK, f)) > 0) {
+        for (size_t i = 0; i < n && count; i++, index++) {
+            if (index < skip)
+                continue;
+            trace_format(&records[i], fmt, line, sizeof(line));
+            puts(line);
+            count--;
+        }
+    }
+
+    fclose(f);
+    return 0;
+}
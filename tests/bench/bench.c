@@ -0,0 +1,218 @@
+// tests/bench/bench.c
+// bench_micro: runs every suite, prints a table & optionally checks a baseline
+#include "bench.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#endif
+
+#define BENCH_MAX_SAMPLES 1001
+
+volatile u64 bench_sink;
+
+static u64 now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000ull + (u64)ts.tv_nsec;
+}
+
+static u64 tsc(void) {
+#ifdef BENCH_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static int cmp_double(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// ---------------------------------------------
+// Timing
+// ---------------------------------------------
+
+void bench_run(Bench *b, const char *name, BenchFn fn, void *ctx, u64 ops) {
+    static double ns[BENCH_MAX_SAMPLES], ticks[BENCH_MAX_SAMPLES];
+
+    if (b->opt.filter && !strstr(name, b->opt.filter))
+        return;
+    if (b->count == BENCH_MAX_CASES)
+        return;
+
+    // Grow the batch until it is long enough to time (this also warms up)
+    u64 iters = 1;
+    for (;;) {
+        u64 start = now_ns();
+        fn(ctx, iters);
+        if (now_ns() - start >= b->opt.min_ns || iters >= (1ull << 40))
+            break;
+        iters *= 2;
+    }
+
+    int samples = b->opt.samples;
+    for (int s = 0; s < samples; s++) {
+        u64 t0 = tsc();
+        u64 n0 = now_ns();
+        fn(ctx, iters);
+        u64 n1   = now_ns();
+        u64 t1   = tsc();
+        ns[s]    = (double)(n1 - n0) / (double)(iters * ops);
+        ticks[s] = (double)(t1 - t0) / (double)(iters * ops);
+    }
+
+    BenchResult *r = &b->results[b->count++];
+    double       sum = 0, sq = 0;
+    for (int s = 0; s < samples; s++)
+        sum += ns[s];
+    r->mean_ns = sum / samples;
+    for (int s = 0; s < samples; s++)
+        sq += (ns[s] - r->mean_ns) * (ns[s] - r->mean_ns);
+    r->stddev_pct = r->mean_ns > 0 ? 100.0 * sqrt(sq / samples) / r->mean_ns : 0;
+
+    qsort(ns, (size_t)samples, sizeof(double), cmp_double);
+    qsort(ticks, (size_t)samples, sizeof(double), cmp_double);
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    r->median_ns = ns[samples / 2];
+    r->min_ns    = ns[0];
+    r->p90_ns    = ns[samples * 9 / 10];
+    r->cycles    = ticks[samples / 2];
+
+    printf("%-36s %10.3f %10.3f %10.3f %6.1f%% %10.3f %9.2f\n", r->name, r->median_ns, r->min_ns,
+           r->mean_ns, r->stddev_pct, r->p90_ns, r->cycles);
+    fflush(stdout);
+}
+
+// ---------------------------------------------
+// Baseline
+// ---------------------------------------------
+// One "name median_ns" line per case (names may hold spaces: the number is
+// after the last one); lines starting with '#' are comments.
+
+static int bench_save(const Bench *b) {
+    FILE *f = fopen(b->opt.save, "w");
+    if (!f)
+        return -1;
+
+    fprintf(f, "# bench_micro baseline: case, median ns per operation\n");
+    for (int i = 0; i < b->count; i++)
+        fprintf(f, "%s %.6f\n", b->results[i].name, b->results[i].median_ns);
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+static int bench_compare(const Bench *b) {
+    FILE *f = fopen(b->opt.baseline, "r");
+    if (!f)
+        return -1;
+
+    char   line[256];
+    double base;
+    int    regressions = 0, compared = 0;
+
+    printf("\n%-36s %10s %10s %8s\n", "vs baseline", "base ns", "now ns", "change");
+    while (fgets(line, sizeof(line), f)) {
+        char *split = strrchr(line, ' ');
+        if (line[0] == '#' || !split || sscanf(split, "%lf", &base) != 1)
+            continue;
+        *split           = '\0';
+        const char *name = line;
+
+        for (int i = 0; i < b->count; i++) {
+            const BenchResult *r = &b->results[i];
+            if (strcmp(r->name, name) != 0)
+                continue;
+
+            double change = base > 0 ? 100.0 * (r->median_ns - base) / base : 0;
+            bool   slower = change > b->opt.threshold;
+            printf("%-36s %10.3f %10.3f %+7.1f%%%s\n", name, base, r->median_ns, change,
+                   slower ? "  REGRESSION" : "");
+            regressions += slower;
+            compared++;
+        }
+    }
+    fclose(f);
+
+    printf("%d cases compared, %d slower than %.1f%%\n", compared, regressions,
+           b->opt.threshold);
+    return regressions;
+}
+
+int bench_finish(Bench *b) {
+    if (b->opt.save && bench_save(b) != 0)
+        fprintf(stderr, "Failed to write baseline: %s\n", b->opt.save);
+    if (!b->opt.baseline)
+        return 0;
+
+    int regressions = bench_compare(b);
+    if (regressions < 0)
+        fprintf(stderr, "Failed to read baseline: %s\n", b->opt.baseline);
+    return regressions;
+}
+
+// ---------------------------------------------
+// Main
+// ---------------------------------------------
+
+static void print_usage(const char *program_name) {
+    printf("Usage: %s [options]\n", program_name);
+    printf("\n");
+    printf("Options:\n");
+    printf("  --filter <text>     Only cases whose name contains <text>\n");
+    printf("  --samples <n>       Timed batches per case (default: 21)\n");
+    printf("  --min-ms <ms>       Length of one batch (default: 2)\n");
+    printf("  --save <file>       Write the medians as a baseline\n");
+    printf("  --baseline <file>   Compare with a saved baseline\n");
+    printf("  --threshold <pct>   Slower by more than this is a regression (default: 10)\n");
+    printf("\n");
+    printf("Exits with 1 if a case regressed against the baseline.\n");
+}
+
+int main(int argc, char *argv[]) {
+    static Bench b;
+
+    b.opt = (BenchOptions){NULL, 21, 2000000, NULL, NULL, 10.0};
+    for (int i = 1; i < argc; i++) {
+        const char *arg     = argv[i];
+        bool        has_val = i + 1 < argc;
+
+        if (strcmp(arg, "--filter") == 0 && has_val)
+            b.opt.filter = argv[++i];
+        else if (strcmp(arg, "--samples") == 0 && has_val)
+            b.opt.samples = atoi(argv[++i]);
+        else if (strcmp(arg, "--min-ms") == 0 && has_val)
+            b.opt.min_ns = (u64)(atof(argv[++i]) * 1e6);
+        else if (strcmp(arg, "--save") == 0 && has_val)
+            b.opt.save = argv[++i];
+        else if (strcmp(arg, "--baseline") == 0 && has_val)
+            b.opt.baseline = argv[++i];
+        else if (strcmp(arg, "--threshold") == 0 && has_val)
+            b.opt.threshold = atof(argv[++i]);
+        else {
+            print_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (b.opt.samples < 1)
+        b.opt.samples = 1;
+    if (b.opt.samples > BENCH_MAX_SAMPLES)
+        b.opt.samples = BENCH_MAX_SAMPLES;
+
+    printf("%-36s %10s %10s %10s %7s %10s %9s\n", "case (per op)", "median ns", "min ns",
+           "mean ns", "stddev", "p90 ns", "tsc ticks");
+    bench_suite_bus(&b);
+    bench_suite_alu(&b);
+    bench_suite_cart(&b);
+    bench_suite_cpu(&b);
+    bench_suite_ppu(&b);
+    bench_suite_apu(&b);
+    bench_suite_state(&b);
+
+    int regressions = bench_finish(&b);
+    return regressions != 0 ? 1 : 0;
+}
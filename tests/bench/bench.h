@@ -0,0 +1,64 @@
+// tests/bench/bench.h
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <core/utils.h>
+
+// ---------------------------------------------
+// Micro-benchmark Harness
+// ---------------------------------------------
+// A case is a function running `iters` iterations of the code under test.
+// The harness grows the batch until one takes BenchOptions.min_ns, then
+// times `samples` batches (clock_gettime, & rdtsc on x86-64) & reports the
+// per-operation cost: median, min, mean, relative spread, p90. Results can
+// be saved to a baseline file & later runs compared against it.
+#define BENCH_MAX_CASES 256
+#define BENCH_NAME_MAX 48
+
+typedef void (*BenchFn)(void *ctx, u64 iters);
+
+typedef struct {
+    char   name[BENCH_NAME_MAX];
+    double median_ns; // Per operation
+    double min_ns;
+    double mean_ns;
+    double stddev_pct; // Of the mean
+    double p90_ns;
+    double cycles;     // TSC ticks per operation (median), 0 without a TSC
+} BenchResult;
+
+typedef struct {
+    const char *filter;    // Only cases whose name contains it (NULL: all)
+    int         samples;   // Timed batches per case
+    u64         min_ns;    // Batch length to aim for
+    const char *save;      // Write the medians here
+    const char *baseline;  // Compare the medians with this file
+    double      threshold; // Slower by more than this % is a regression
+} BenchOptions;
+
+typedef struct {
+    BenchOptions opt;
+    BenchResult  results[BENCH_MAX_CASES];
+    int          count;
+} Bench;
+
+// Keeps results alive: add anything computed in a case to it
+extern volatile u64 bench_sink;
+
+// Time one case; `ops` operations per iteration (e.g. 4096 reads per pass)
+void bench_run(Bench *b, const char *name, BenchFn fn, void *ctx, u64 ops);
+
+// Save and/or compare as the options say. Returns the number of regressions
+// (-1: the baseline couldn't be read).
+int  bench_finish(Bench *b);
+
+// Suites
+void bench_suite_bus(Bench *b);
+void bench_suite_alu(Bench *b);
+void bench_suite_cart(Bench *b);
+void bench_suite_cpu(Bench *b);
+void bench_suite_ppu(Bench *b);
+void bench_suite_apu(Bench *b);
+void bench_suite_state(Bench *b);
+
+#endif // BENCH_H
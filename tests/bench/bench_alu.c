@@ -0,0 +1,123 @@
+// tests/bench/bench_alu.c
+// Flag & BCD helpers of utils.c & the generated ALU tables, over every operand pair
+#include "bench.h"
+#include <core/alu_tables.h>
+
+// One pass: all 65536 (a, b) pairs
+#define ALU_PAIRS 65536
+
+static void alu_half_carry_add(void *ctx, u64 iters) {
+    u32 n = 0;
+    (void)ctx;
+    while (iters--)
+        for (u32 i = 0; i < ALU_PAIRS; i++)
+            n += check_half_carry_add((u8)i, (u8)(i >> 8));
+    bench_sink += n;
+}
+
+static void alu_carry_add(void *ctx, u64 iters) {
+    u32 n = 0;
+    (void)ctx;
+    while (iters--)
+        for (u32 i = 0; i < ALU_PAIRS; i++)
+            n += check_carry_add((u8)i, (u8)(i >> 8));
+    bench_sink += n;
+}
+
+static void alu_half_carry_sub(void *ctx, u64 iters) {
+    u32 n = 0;
+    (void)ctx;
+    while (iters--)
+        for (u32 i = 0; i < ALU_PAIRS; i++)
+            n += check_half_carry_sub((u8)i, (u8)(i >> 8));
+    bench_sink += n;
+}
+
+static void alu_carry_sub(void *ctx, u64 iters) {
+    u32 n = 0;
+    (void)ctx;
+    while (iters--)
+        for (u32 i = 0; i < ALU_PAIRS; i++)
+            n += check_carry_sub((u8)i, (u8)(i >> 8));
+    bench_sink += n;
+}
+
+static void alu_half_carry_add_u16(void *ctx, u64 iters) {
+    u32 n = 0;
+    (void)ctx;
+    while (iters--)
+        for (u32 i = 0; i < ALU_PAIRS; i++)
+            n += check_half_carry_add_u16((u16)(i * 0x0101), (u16)(i * 0x9E37));
+    bench_sink += n;
+}
+
+static void alu_carry_add_u16(void *ctx, u64 iters) {
+    u32 n = 0;
+    (void)ctx;
+    while (iters--)
+        for (u32 i = 0; i < ALU_PAIRS; i++)
+            n += check_carry_add_u16((u16)(i * 0x0101), (u16)(i * 0x9E37));
+    bench_sink += n;
+}
+
+// Every value with every N/C/H combination (2048), 32 times per pass
+static void alu_adjust_bcd(void *ctx, u64 iters) {
+    u32 n = 0;
+    (void)ctx;
+    while (iters--)
+        for (u32 i = 0; i < ALU_PAIRS; i++)
+            n += adjust_bcd((u8)i, i & 0x100, i & 0x200, i & 0x400);
+    bench_sink += n;
+}
+
+static void alu_sign_extend(void *ctx, u64 iters) {
+    u32 n = 0;
+    (void)ctx;
+    while (iters--)
+        for (u32 i = 0; i < ALU_PAIRS; i++)
+            n += (u16)sign_extend_i8((u8)i);
+    bench_sink += n;
+}
+
+static void alu_swap_bytes(void *ctx, u64 iters) {
+    u32 n = 0;
+    (void)ctx;
+    while (iters--)
+        for (u32 i = 0; i < ALU_PAIRS; i++)
+            n += swap_bytes((u16)i);
+    bench_sink += n;
+}
+
+// DAA table: the same 2048 inputs as adjust_bcd
+static void alu_daa_lookup(void *ctx, u64 iters) {
+    u32 n = 0;
+    (void)ctx;
+    while (iters--)
+        for (u32 i = 0; i < ALU_PAIRS; i++)
+            n += alu_daa_table[ALU_DAA_INDEX((u8)i, (i >> 4) & 0x70)];
+    bench_sink += n;
+}
+
+// Rotate/shift table: every kind, value & carry in (4096), 16 times per pass
+static void alu_shift_lookup(void *ctx, u64 iters) {
+    u32 n = 0;
+    (void)ctx;
+    while (iters--)
+        for (u32 i = 0; i < ALU_PAIRS; i++)
+            n += alu_shift_table[(i >> 9) & 7][i & 0x1FF];
+    bench_sink += n;
+}
+
+void bench_suite_alu(Bench *b) {
+    bench_run(b, "alu/check_half_carry_add", alu_half_carry_add, NULL, ALU_PAIRS);
+    bench_run(b, "alu/check_carry_add", alu_carry_add, NULL, ALU_PAIRS);
+    bench_run(b, "alu/check_half_carry_sub", alu_half_carry_sub, NULL, ALU_PAIRS);
+    bench_run(b, "alu/check_carry_sub", alu_carry_sub, NULL, ALU_PAIRS);
+    bench_run(b, "alu/check_half_carry_add_u16", alu_half_carry_add_u16, NULL, ALU_PAIRS);
+    bench_run(b, "alu/check_carry_add_u16", alu_carry_add_u16, NULL, ALU_PAIRS);
+    bench_run(b, "alu/adjust_bcd", alu_adjust_bcd, NULL, ALU_PAIRS);
+    bench_run(b, "alu/daa_table", alu_daa_lookup, NULL, ALU_PAIRS);
+    bench_run(b, "alu/shift_table", alu_shift_lookup, NULL, ALU_PAIRS);
+    bench_run(b, "alu/sign_extend_i8", alu_sign_extend, NULL, ALU_PAIRS);
+    bench_run(b, "alu/swap_bytes", alu_swap_bytes, NULL, ALU_PAIRS);
+}
@@ -0,0 +1,104 @@
+// tests/bench/bench_apu.c
+// APU cost per frame for a few channel setups, synthesized & in register mode
+#include "bench.h"
+#include "test_machine.h"
+#include <gbemu.h>
+#include <core/apu.h>
+#include <core/bus.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef enum {
+    APU_SCENE_OFF,
+    APU_SCENE_SQUARE,     // One square at 440 Hz
+    APU_SCENE_ALL,        // Both squares, wave & noise
+    APU_SCENE_ULTRASONIC, // A step every 4 cycles
+    APU_SCENE_COUNT,
+} ApuScene;
+
+// Square on channel c (0 or 1) at 131072 / (2048 - period) Hz
+static void apu_square(GameBoy *gb, int c, u16 period, u8 duty) {
+    u16 base = (u16)(0xFF10 + c * 5);
+    mmu_write(gb, base + 1, (u8)(duty << 6));
+    mmu_write(gb, base + 2, 0xF0);
+    mmu_write(gb, base + 3, (u8)period);
+    mmu_write(gb, base + 4, (u8)(0x80 | period >> 8));
+}
+
+static void apu_wave(GameBoy *gb, u16 period) {
+    for (u16 addr = 0xFF30; addr < 0xFF40; addr++)
+        mmu_write(gb, addr, (u8)((addr & 0x0F) * 0x11));
+    mmu_write(gb, 0xFF1A, 0x80);
+    mmu_write(gb, 0xFF1C, 0x20);
+    mmu_write(gb, 0xFF1D, (u8)period);
+    mmu_write(gb, 0xFF1E, (u8)(0x80 | period >> 8));
+}
+
+static void apu_noise(GameBoy *gb, u8 nr43) {
+    mmu_write(gb, 0xFF21, 0xF0);
+    mmu_write(gb, 0xFF22, nr43);
+    mmu_write(gb, 0xFF23, 0x80);
+}
+
+static void apu_scene(GameBoy *gb, ApuScene scene) {
+    apu_reset(gb);
+    mmu_write(gb, 0xFF24, 0x77);
+    mmu_write(gb, 0xFF25, 0xFF);
+
+    switch (scene) {
+        case APU_SCENE_OFF:
+            mmu_write(gb, 0xFF26, 0x00);
+            break;
+        case APU_SCENE_SQUARE:
+            apu_square(gb, 1, 2048 - 298, 2); // 440 Hz
+            break;
+        case APU_SCENE_ALL:
+            apu_square(gb, 0, 2048 - 298, 2);
+            apu_square(gb, 1, 2048 - 199, 1); // 659 Hz
+            apu_wave(gb, 2048 - 298);         // 220 Hz
+            apu_noise(gb, 0x21);              // ~16 kHz clock
+            break;
+        default:
+            apu_square(gb, 0, 2047, 2); // 131 kHz
+            apu_noise(gb, 0x00);        // 524 kHz clock
+            break;
+    }
+}
+
+// One frame per iteration; a game polling NR52 once a frame keeps register
+// mode catching up
+static void apu_frame(void *arg, u64 iters) {
+    GameBoy *gb  = arg;
+    u32      sum = 0;
+
+    while (iters--) {
+        gb->cycles += CYCLES_PER_FRAME;
+        apu_end_frame(gb);
+        sum += mmu_read(gb, 0xFF26);
+    }
+    bench_sink += sum;
+}
+
+void bench_suite_apu(Bench *b) {
+    static const char *scenes[APU_SCENE_COUNT] = {"off", "1 square", "4 channels", "ultrasonic"};
+    GameBoy           *gb                      = malloc(sizeof(GameBoy));
+    char               name[BENCH_NAME_MAX];
+
+    if (!gb)
+        return;
+    test_machine_init(gb, NULL, 0);
+    apu_set_output(gb, APU_SAMPLE_RATE, NULL);
+
+    for (int mode = 0; mode < 2; mode++) {
+        apu_set_mode(gb, mode ? APU_MODE_REGISTERS : APU_MODE_FULL);
+        for (int s = 0; s < APU_SCENE_COUNT; s++) {
+            apu_scene(gb, (ApuScene)s);
+            snprintf(name, sizeof(name), "apu/%s frame, %s", mode ? "registers" : "full",
+                     scenes[s]);
+            bench_run(b, name, apu_frame, gb, 1);
+        }
+    }
+
+    test_machine_free(gb);
+    free(gb);
+}
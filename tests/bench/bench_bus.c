@@ -0,0 +1,163 @@
+// tests/bench/bench_bus.c
+// mmu_read / mmu_write over a few address distributions
+#include "bench.h"
+#include <gbemu.h>
+#include <core/bus.h>
+#include <stdlib.h>
+
+#define BUS_ADDRS 4096
+
+typedef struct {
+    GameBoy *gb;
+    u16      addrs[BUS_ADDRS];
+} BusCtx;
+
+typedef enum {
+    BUS_MIX_CODE,    // Mostly ROM & WRAM, some HRAM & VRAM: what code & data fetches look like
+    BUS_MIX_IO,      // A third I/O registers & HRAM (polling loops, interrupt handlers)
+    BUS_MIX_UNIFORM, // Anywhere in the 64 KB
+    BUS_MIX_RAM,     // Writable memory only: WRAM, HRAM, VRAM & OAM
+    BUS_MIX_MBC,     // RAM writes with a bank switch every 64
+} BusMix;
+
+static void bus_fill(BusCtx *ctx, BusMix mix) {
+    u32 seed = 0x1234567;
+
+    for (int i = 0; i < BUS_ADDRS; i++) {
+        seed    = seed * 1103515245 + 12345;
+        u32 r   = seed >> 8;
+        u32 pct = r % 100;
+        u16 addr;
+
+        switch (mix) {
+            case BUS_MIX_CODE:
+                addr = pct < 45   ? r % 0x8000
+                       : pct < 80 ? 0xC000 + r % 0x2000
+                       : pct < 90 ? 0xFF80 + r % 0x7F
+                                  : 0x8000 + r % 0x2000;
+                break;
+            case BUS_MIX_IO:
+                addr = pct < 33   ? 0xFF00 + r % 0x4C
+                       : pct < 50 ? 0xFF80 + r % 0x7F
+                       : pct < 75 ? r % 0x8000
+                                  : 0xC000 + r % 0x2000;
+                break;
+            case BUS_MIX_UNIFORM:
+                addr = (u16)r;
+                break;
+            case BUS_MIX_RAM:
+            case BUS_MIX_MBC:
+            default:
+                addr = pct < 60   ? 0xC000 + r % 0x2000
+                       : pct < 80 ? 0xFF80 + r % 0x7F
+                       : pct < 95 ? 0x8000 + r % 0x2000
+                                  : 0xFE00 + r % 0xA0;
+                if (mix == BUS_MIX_MBC && i % 64 == 0)
+                    addr = 0x2000; // ROM bank number
+                break;
+        }
+        ctx->addrs[i] = addr;
+    }
+}
+
+static void bus_read(void *arg, u64 iters) {
+    BusCtx *ctx = arg;
+    u32     sum = 0;
+
+    while (iters--)
+        for (int i = 0; i < BUS_ADDRS; i++)
+            sum += mmu_read(ctx->gb, ctx->addrs[i]);
+    bench_sink += sum;
+}
+
+static void bus_read16(void *arg, u64 iters) {
+    BusCtx *ctx = arg;
+    u32     sum = 0;
+
+    while (iters--)
+        for (int i = 0; i < BUS_ADDRS; i++)
+            sum += mmu_read16(ctx->gb, ctx->addrs[i]);
+    bench_sink += sum;
+}
+
+static void bus_write(void *arg, u64 iters) {
+    BusCtx *ctx = arg;
+
+    while (iters--)
+        for (int i = 0; i < BUS_ADDRS; i++)
+            mmu_write(ctx->gb, ctx->addrs[i], (u8)(i | 1));
+}
+
+static void bus_write16(void *arg, u64 iters) {
+    BusCtx *ctx = arg;
+
+    while (iters--)
+        for (int i = 0; i < BUS_ADDRS; i++)
+            mmu_write16(ctx->gb, ctx->addrs[i], (u16)i);
+}
+
+// The address-decoding chain every page-table miss falls back to
+static void bus_read_slow(void *arg, u64 iters) {
+    BusCtx *ctx = arg;
+    u32     sum = 0;
+
+    while (iters--)
+        for (int i = 0; i < BUS_ADDRS; i++)
+            sum += mmu_read_slow(ctx->gb, ctx->addrs[i]);
+    bench_sink += sum;
+}
+
+static void bus_write_slow(void *arg, u64 iters) {
+    BusCtx *ctx = arg;
+
+    while (iters--)
+        for (int i = 0; i < BUS_ADDRS; i++)
+            mmu_write_slow(ctx->gb, ctx->addrs[i], (u8)(i | 1));
+}
+
+// Reads of the switchable ROM window with an MBC5 bank switch every 64
+static void bus_read_banked(void *arg, u64 iters) {
+    BusCtx *ctx = arg;
+    u32     sum = 0;
+
+    while (iters--)
+        for (int i = 0; i < BUS_ADDRS; i++) {
+            if (i % 64 == 0)
+                mmu_write(ctx->gb, 0x2000, (u8)(iters + i / 64));
+            sum += mmu_read(ctx->gb, 0x4000 | (ctx->addrs[i] & 0x3FFF));
+        }
+    bench_sink += sum;
+}
+
+void bench_suite_bus(Bench *b) {
+    static GameBoy gb;
+    static BusCtx  ctx;
+    size_t         rom_size = (size_t)64 * 0x4000;
+
+    // MBC5 cart, 1 MB of ROM: bank switches remap 0x4000 - 0x7FFF
+    gb_init(&gb);
+    gb.cart.rom      = calloc(1, rom_size);
+    gb.cart.rom_size = rom_size;
+    mbc_init(&gb.cart.mbc, 0x19, rom_size, 0);
+    mmu_map_init(&gb);
+    ctx.gb = &gb;
+
+    bus_fill(&ctx, BUS_MIX_CODE);
+    bench_run(b, "bus/read code mix", bus_read, &ctx, BUS_ADDRS);
+    bench_run(b, "bus/read16 code mix", bus_read16, &ctx, BUS_ADDRS);
+    bench_run(b, "bus/read code mix, slow path", bus_read_slow, &ctx, BUS_ADDRS);
+    bench_run(b, "bus/read banked, switch every 64", bus_read_banked, &ctx, BUS_ADDRS);
+    bus_fill(&ctx, BUS_MIX_IO);
+    bench_run(b, "bus/read io mix", bus_read, &ctx, BUS_ADDRS);
+    bus_fill(&ctx, BUS_MIX_UNIFORM);
+    bench_run(b, "bus/read uniform", bus_read, &ctx, BUS_ADDRS);
+
+    bus_fill(&ctx, BUS_MIX_RAM);
+    bench_run(b, "bus/write ram mix", bus_write, &ctx, BUS_ADDRS);
+    bench_run(b, "bus/write16 ram mix", bus_write16, &ctx, BUS_ADDRS);
+    bench_run(b, "bus/write ram mix, slow path", bus_write_slow, &ctx, BUS_ADDRS);
+    bus_fill(&ctx, BUS_MIX_MBC);
+    bench_run(b, "bus/write ram + bank switch", bus_write, &ctx, BUS_ADDRS);
+
+    gb_unload(&gb);
+}
@@ -0,0 +1,158 @@
+// tests/bench/bench_cart.c
+// Cartridge header parsing & checksum, loading a ROM the store already holds
+#include "bench.h"
+#include "test_machine.h"
+#include <core/cartridge.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define CART_HEADERS 64
+#define CART_ROM_SIZE (1 << 20)
+
+typedef struct {
+    RawRomHeader raw[CART_HEADERS];
+    u8          *roms[CART_HEADERS];
+    Cartridge    carts[CART_HEADERS];
+} CartCtx;
+
+// Headers of every flavor: CGB flags, old & new licensee codes, MBCs
+static void cart_fill(CartCtx *ctx) {
+    static const u8 types[] = {0x00, 0x01, 0x03, 0x06, 0x10, 0x13, 0x19, 0x1B, 0x1E, 0xFF};
+    u32             seed    = 0xC0FFEE;
+
+    for (int i = 0; i < CART_HEADERS; i++) {
+        RawRomHeader *raw = &ctx->raw[i];
+        memset(raw, 0, sizeof(*raw));
+
+        for (int c = 0; c < 16; c++) {
+            seed          = seed * 1103515245 + 12345;
+            raw->title[c] = (u8)('A' + (seed >> 16) % 26);
+        }
+        raw->title[15]    = i % 3 == 0 ? 0x80 : i % 3 == 1 ? 0xC0 : 0x00;
+        raw->sgb_flag     = i % 2 ? 0x03 : 0x00;
+        raw->type         = types[i % sizeof(types)];
+        raw->rom_size     = (u8)(i % 9);
+        raw->ram_size     = (u8)(i % 6);
+        raw->old_lic_code = i % 4 ? 0x33 : (u8)i;
+        raw->new_lic_hi   = '0' + i % 10;
+        raw->new_lic_lo   = '1';
+        raw->version      = (u8)i;
+
+        // A ROM whose header area holds the same bytes, for the checksum
+        ctx->roms[i] = calloc(1, 0x150);
+        memcpy(ctx->roms[i] + 0x100, raw, sizeof(*raw));
+        ctx->carts[i].rom      = ctx->roms[i];
+        ctx->carts[i].rom_size = 0x150;
+    }
+}
+
+static void cart_parse(void *arg, u64 iters) {
+    CartCtx   *ctx = arg;
+    CartHeader out;
+    u32        sum = 0;
+
+    while (iters--)
+        for (int i = 0; i < CART_HEADERS; i++) {
+            parse_header(&ctx->raw[i], &out);
+            sum += out.lic_code + out.has_battery;
+        }
+    bench_sink += sum;
+}
+
+static void cart_checksum(void *arg, u64 iters) {
+    CartCtx *ctx = arg;
+    u32      sum = 0;
+
+    while (iters--)
+        for (int i = 0; i < CART_HEADERS; i++)
+            sum += cart_verify_header_checksum(&ctx->carts[i]);
+    bench_sink += sum;
+}
+
+typedef struct {
+    char path[32];
+    u8  *rom;
+} CartLoadCtx;
+
+// 1 MB MBC1 image with a valid header checksum
+static void cart_make_rom(u8 *rom) {
+    for (size_t i = 0; i < CART_ROM_SIZE; i++)
+        rom[i] = (u8)(i * 31 + (i >> 8));
+    rom[0x0147] = 0x01;
+    rom[0x0148] = 0x05;
+    rom[0x0149] = 0x00;
+    test_rom_checksum(rom);
+}
+
+// Another instance of a ROM file already open: a path lookup, no mapping or hashing
+// (cart_load without its messages)
+static void cart_load_file(void *arg, u64 iters) {
+    CartLoadCtx *ctx = arg;
+    Cartridge    cart;
+    RomImage    *image;
+
+    while (iters--) {
+        memset(&cart, 0, sizeof(cart));
+        if (rom_store_open(ctx->path, &image) != 0)
+            return;
+        cart_load_image(&cart, image);
+        rom_store_release(image);
+        cart_unload(&cart);
+    }
+}
+
+// Another instance of a ROM already in memory: a CRC-32 & compare
+static void cart_load_mem(void *arg, u64 iters) {
+    CartLoadCtx *ctx = arg;
+    Cartridge    cart;
+
+    while (iters--) {
+        memset(&cart, 0, sizeof(cart));
+        cart_load_buffer(&cart, ctx->rom, CART_ROM_SIZE);
+        cart_unload(&cart);
+    }
+}
+
+static void bench_cart_load(Bench *b) {
+    static CartLoadCtx ctx = {"/tmp/bench_cartXXXXXX", NULL};
+    Cartridge          file = {0}, mem = {0};
+    RomImage          *image;
+
+    ctx.rom = malloc(CART_ROM_SIZE);
+    if (!ctx.rom)
+        return;
+    cart_make_rom(ctx.rom);
+
+    int fd = mkstemp(ctx.path);
+    if (fd >= 0 && write(fd, ctx.rom, CART_ROM_SIZE) == CART_ROM_SIZE &&
+        rom_store_open(ctx.path, &image) == 0) {
+        // One resident instance each keeps the images in the store
+        cart_load_image(&file, image);
+        rom_store_release(image);
+        cart_load_buffer(&mem, ctx.rom, CART_ROM_SIZE);
+
+        bench_run(b, "cart/load file, store hit", cart_load_file, &ctx, 1);
+        bench_run(b, "cart/load_buffer, store hit", cart_load_mem, &ctx, 1);
+
+        cart_unload(&file);
+        cart_unload(&mem);
+    }
+    if (fd >= 0) {
+        close(fd);
+        unlink(ctx.path);
+    }
+    free(ctx.rom);
+}
+
+void bench_suite_cart(Bench *b) {
+    static CartCtx ctx;
+
+    cart_fill(&ctx);
+    bench_run(b, "cart/parse_header", cart_parse, &ctx, CART_HEADERS);
+    bench_run(b, "cart/verify_header_checksum", cart_checksum, &ctx, CART_HEADERS);
+
+    for (int i = 0; i < CART_HEADERS; i++)
+        free(ctx.roms[i]);
+    bench_cart_load(b);
+}
@@ -0,0 +1,65 @@
+// tests/bench/bench_cpu.c
+// Interpreter (& JIT) throughput on a tight ALU / memory loop
+#include "bench.h"
+#include "test_machine.h"
+#include <gbemu.h>
+#include <core/bus.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CPU_BUDGET CYCLES_PER_FRAME
+
+typedef struct {
+    GameBoy *gb;
+    bool     jit;
+} CpuCtx;
+
+// JP 0x150; LD HL,0xC000; then INC/ADD/DEC/XOR, a WRAM store & load, SWAP,
+// ADD/CP immediates & both taken and untaken branches, forever
+static const u8 cpu_program[] = {
+    0x21, 0x00, 0xC0,             // 0x150: LD HL, 0xC000
+    0x3C, 0x80, 0x05, 0xA9, 0x0C, // 0x153: INC A; ADD B; DEC B; XOR C; INC C
+    0x77, 0x7E, 0xCB, 0x37,       //        LD (HL), A; LD A, (HL); SWAP A
+    0xC6, 0x03, 0xFE, 0x10,       //        ADD 3; CP 0x10
+    0x20, 0xF1,                   //        JR NZ, 0x153
+    0x18, 0xEF,                   //        JR 0x153
+};
+
+static void cpu_loop(void *arg, u64 iters) {
+    CpuCtx *ctx = arg;
+
+    while (iters--)
+        (ctx->jit ? cpu_jit_run : cpu_run)(ctx->gb, CPU_BUDGET);
+}
+
+// Instructions one call retires (the loop is steady, so every call is alike)
+static u64 cpu_ops(CpuCtx *ctx) {
+    u64 before = ctx->gb->cpu.instructions;
+    cpu_loop(ctx, 1);
+    return ctx->gb->cpu.instructions - before;
+}
+
+void bench_suite_cpu(Bench *b) {
+    static const u8 entry[] = {0xC3, 0x50, 0x01}; // JP 0x150
+    GameBoy        *gb      = malloc(sizeof(GameBoy));
+    CpuCtx          ctx;
+
+    if (!gb)
+        return;
+    test_machine_init(gb, entry, sizeof(entry));
+    memcpy(gb->cart.rom + 0x150, cpu_program, sizeof(cpu_program));
+
+    ctx = (CpuCtx){gb, false};
+    bench_run(b, "cpu/interpreter instruction", cpu_loop, &ctx, cpu_ops(&ctx));
+    gb->decode_enabled = true;
+    bench_run(b, "cpu/interpreter + decode cache", cpu_loop, &ctx, cpu_ops(&ctx));
+    gb->decode_enabled = false;
+
+    if (cpu_jit_available()) {
+        ctx.jit = true;
+        bench_run(b, "cpu/jit instruction", cpu_loop, &ctx, cpu_ops(&ctx));
+    }
+
+    test_machine_free(gb);
+    free(gb);
+}
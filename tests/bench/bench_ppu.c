@@ -0,0 +1,139 @@
+// tests/bench/bench_ppu.c
+// PPU scanline rendering on tile-heavy scenes, tile data writes & the pixel kernels
+#include "bench.h"
+#include "test_machine.h"
+#include <gbemu.h>
+#include <core/bus.h>
+#include <core/pixel.h>
+#include <core/ppu.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define PPU_VRAM_WRITES 4096
+
+static u32 rng_next(u32 *state) {
+    u32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+// Random tiles & maps, unaligned scroll, a window & 40 sprites (used when LCDC says so)
+static void ppu_fill(GameBoy *gb, u8 lcdc) {
+    u32 rng = 0x9E3779B9;
+
+    for (u16 addr = 0x8000; addr < 0xA000; addr++)
+        mmu_write(gb, addr, (u8)rng_next(&rng));
+
+    for (int i = 0; i < 40; i++) {
+        mmu_write(gb, (u16)(0xFE00 + i * 4), (u8)(16 + (i % 18) * 8));
+        mmu_write(gb, (u16)(0xFE00 + i * 4 + 1), (u8)(8 + (i * 37) % 160));
+        mmu_write(gb, (u16)(0xFE00 + i * 4 + 2), (u8)rng_next(&rng));
+        mmu_write(gb, (u16)(0xFE00 + i * 4 + 3), (u8)(rng_next(&rng) & 0xF0));
+    }
+
+    mmu_write(gb, 0xFF43, 3);
+    mmu_write(gb, 0xFF42, 5);
+    mmu_write(gb, 0xFF4A, 40);
+    mmu_write(gb, 0xFF4B, 67);
+    mmu_write(gb, 0xFF47, 0xE4);
+    mmu_write(gb, 0xFF48, 0xD2);
+    mmu_write(gb, 0xFF49, 0x1B);
+    mmu_write(gb, 0xFF40, lcdc);
+}
+
+// One whole frame per iteration, counted per visible line
+static void ppu_frame(void *arg, u64 iters) {
+    GameBoy *gb = arg;
+
+    while (iters--) {
+        gb->cycles += PPU_FRAME_CYCLES;
+        ppu_sync(gb);
+    }
+    bench_sink += ppu_framebuffer(gb)[SCREEN_WIDTH * SCREEN_HEIGHT / 2];
+}
+
+// Tile data writes pay for keeping the decoded tiles up to date
+static void ppu_vram_write(void *arg, u64 iters) {
+    GameBoy *gb  = arg;
+    u32      rng = 1;
+
+    while (iters--)
+        for (int i = 0; i < PPU_VRAM_WRITES; i++)
+            mmu_write(gb, (u16)(0x8000 + (rng_next(&rng) & 0x17FF)), (u8)i);
+}
+
+typedef struct {
+    const PixelKernels *k;
+    u8                  planes[SCREEN_WIDTH / 4];
+    u8                  colors[SCREEN_WIDTH];
+    u8                  shades[SCREEN_WIDTH];
+} PixelCtx;
+
+// One scanline per iteration: decode 20 tile rows, map 160 pixels
+static void pixel_decode(void *arg, u64 iters) {
+    PixelCtx *ctx = arg;
+
+    while (iters--) {
+        ctx->planes[0] = (u8)iters; // Keep the calls from being hoisted
+        ctx->k->decode(ctx->colors, ctx->planes, SCREEN_WIDTH / 8, false);
+    }
+    bench_sink += ctx->colors[SCREEN_WIDTH / 2];
+}
+
+static void pixel_palette(void *arg, u64 iters) {
+    PixelCtx *ctx = arg;
+
+    while (iters--)
+        ctx->k->palette(ctx->shades, ctx->colors, (u8)iters, SCREEN_WIDTH);
+    bench_sink += ctx->shades[SCREEN_WIDTH / 2];
+}
+
+static void bench_pixel(Bench *b) {
+    static PixelCtx ctx;
+    char            name[BENCH_NAME_MAX];
+    u32             rng = 7;
+
+    for (size_t i = 0; i < sizeof(ctx.planes); i++)
+        ctx.planes[i] = (u8)rng_next(&rng);
+
+    for (int isa = 0; isa < PIXEL_ISA_COUNT; isa++) {
+        ctx.k = pixel_kernels((PixelIsa)isa);
+        if (!ctx.k)
+            continue;
+        snprintf(name, sizeof(name), "pixel/%s decode line", ctx.k->name);
+        bench_run(b, name, pixel_decode, &ctx, 1);
+        snprintf(name, sizeof(name), "pixel/%s palette line", ctx.k->name);
+        bench_run(b, name, pixel_palette, &ctx, 1);
+    }
+}
+
+void bench_suite_ppu(Bench *b) {
+    static const struct {
+        const char *name;
+        u8          lcdc;
+    } scenes[] = {
+        {"ppu/scanline bg", 0x91},
+        {"ppu/scanline bg+win", 0x91 | LCDC_WIN_ENABLE | LCDC_WIN_MAP},
+        {"ppu/scanline bg+obj", 0x91 | LCDC_OBJ_ENABLE},
+        {"ppu/scanline bg+win+obj", 0x91 | LCDC_WIN_ENABLE | LCDC_WIN_MAP | LCDC_OBJ_ENABLE},
+        {"ppu/scanline bg+win+obj 8x16", 0x81 | LCDC_WIN_ENABLE | LCDC_OBJ_ENABLE | LCDC_OBJ_SIZE},
+    };
+    GameBoy *gb = malloc(sizeof(GameBoy));
+
+    if (!gb)
+        return;
+    test_machine_init(gb, NULL, 0);
+
+    for (size_t i = 0; i < sizeof(scenes) / sizeof(scenes[0]); i++) {
+        ppu_reset(gb);
+        ppu_fill(gb, scenes[i].lcdc);
+        bench_run(b, scenes[i].name, ppu_frame, gb, SCREEN_HEIGHT);
+    }
+    bench_run(b, "ppu/tile data write", ppu_vram_write, gb, PPU_VRAM_WRITES);
+
+    test_machine_free(gb);
+    free(gb);
+    bench_pixel(b);
+}
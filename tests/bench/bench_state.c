@@ -0,0 +1,105 @@
+// tests/bench/bench_state.c
+// Save states & the rewind ring on a program that keeps rewriting memory
+#include "bench.h"
+#include "test_machine.h"
+#include <gbemu.h>
+#include <core/rewind.h>
+#include <stdlib.h>
+
+typedef struct {
+    GameBoy *gb;
+    u8      *state;
+    size_t   size;
+    Rewind   rewind;
+} StateCtx;
+
+// Keeps rewriting tile data, WRAM & cart RAM
+static const u8 state_program[] = {
+    0x21, 0x00, 0x80, // LD HL, 0x8000
+    0x22,             // loop: LD (HL+), A
+    0xEA, 0x00, 0xC0, // LD (0xC000), A
+    0xEA, 0x00, 0xA0, // LD (0xA000), A
+    0x3C,             // INC A
+    0x47,             // LD B, A
+    0x7C,             // LD A, H
+    0xFE, 0x98,       // CP 0x98
+    0x78,             // LD A, B
+    0x20, 0xF1,       // JR NZ, loop
+    0x21, 0x00, 0x80, // LD HL, 0x8000
+    0x3C,             // INC A (a different sequence every pass)
+    0x18, 0xEB,       // JR loop
+};
+
+static void state_save(void *arg, u64 iters) {
+    StateCtx *ctx = arg;
+
+    while (iters--)
+        gb_save_state(ctx->gb, ctx->state, ctx->size);
+}
+
+// The machine is already in that state: RAM pages compare equal, nothing is invalidated
+static void state_load(void *arg, u64 iters) {
+    StateCtx *ctx = arg;
+
+    while (iters--)
+        gb_load_state(ctx->gb, ctx->state, ctx->size);
+}
+
+static void state_frame(void *arg, u64 iters) {
+    StateCtx *ctx = arg;
+
+    while (iters--)
+        gb_run_frame(ctx->gb);
+}
+
+// Back one frame every frame: every VRAM page changed (tile cache rebuilt)
+static void state_frame_load(void *arg, u64 iters) {
+    StateCtx *ctx = arg;
+
+    while (iters--) {
+        gb_run_frame(ctx->gb);
+        gb_load_state(ctx->gb, ctx->state, ctx->size);
+    }
+}
+
+// The rewind ring at its defaults: one capture per frame into 8 MB
+static void state_frame_rewind(void *arg, u64 iters) {
+    StateCtx *ctx = arg;
+
+    while (iters--) {
+        gb_run_frame(ctx->gb);
+        rewind_frame(&ctx->rewind, ctx->gb);
+    }
+}
+
+void bench_suite_state(Bench *b) {
+    static StateCtx ctx;
+    static u8       rom[TEST_ROM_SIZE];
+
+    ctx.gb = malloc(sizeof(GameBoy));
+    if (!ctx.gb)
+        return;
+    test_rom_build(rom, TEST_ROM_SIZE, 0x08, 0x02, state_program, sizeof(state_program)); // + RAM
+    gb_init(ctx.gb);
+    if (!gb_load_rom_buffer(ctx.gb, rom, TEST_ROM_SIZE)) {
+        free(ctx.gb);
+        return;
+    }
+    gb_run_frame(ctx.gb);
+
+    ctx.size  = gb_state_size(ctx.gb);
+    ctx.state = malloc(ctx.size);
+    if (ctx.state && rewind_init(&ctx.rewind, ctx.gb, NULL)) {
+        gb_save_state(ctx.gb, ctx.state, ctx.size);
+        bench_run(b, "state/save", state_save, &ctx, 1);
+        bench_run(b, "state/load unchanged", state_load, &ctx, 1);
+        bench_run(b, "state/frame", state_frame, &ctx, 1);
+        bench_run(b, "state/frame + load one frame back", state_frame_load, &ctx, 1);
+        bench_run(b, "state/frame + rewind capture", state_frame_rewind, &ctx, 1);
+        rewind_free(&ctx.rewind);
+    }
+
+    free(ctx.state);
+    gb_unload(ctx.gb);
+    free(ctx.gb);
+}
@@ -0,0 +1,499 @@
+// tests/test_apu.c
+#include <check.h>
+#include <gbemu.h>
+#include <core/bus.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_machine.h"
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// 32 KB ROM that spins on `JR -2`
+static GameBoy *load_idle(void) {
+    static const u8 program[] = {0x18, 0xFE}; // JR -2
+    GameBoy        *gb        = malloc(sizeof(GameBoy));
+    u8             *rom       = malloc(TEST_ROM_SIZE);
+
+    test_rom_build(rom, TEST_ROM_SIZE, 0x00, 0x00, program, sizeof(program));
+    gb_init(gb);
+    ck_assert(gb_load_rom_buffer(gb, rom, TEST_ROM_SIZE));
+    free(rom);
+    return gb;
+}
+
+static void unload(GameBoy *gb) {
+    gb_unload(gb);
+    free(gb);
+}
+
+static bool channel_on(GameBoy *gb, int c) {
+    return CHECK_BIT(mmu_read(gb, 0xFF26), c);
+}
+
+// Channel 2 square at 131072 / (2048 - period) Hz, full volume, both sides
+static void play_square(GameBoy *gb, u16 period) {
+    mmu_write(gb, 0xFF25, 0x22); // NR51: channel 2 left & right
+    mmu_write(gb, 0xFF24, 0x77); // NR50: full volume
+    mmu_write(gb, 0xFF16, 0x80); // NR21: 50% duty
+    mmu_write(gb, 0xFF17, 0xF0); // NR22: volume 15, no envelope
+    mmu_write(gb, 0xFF18, (u8)period);
+    mmu_write(gb, 0xFF19, (u8)(0x80 | period >> 8)); // Trigger
+}
+
+// ============================================================================
+// Audio Ring Tests
+// ============================================================================
+
+START_TEST(test_ring_wrap) {
+    AudioRing ring;
+    i16       in[2 * 200], out[2 * 200];
+
+    for (int i = 0; i < 2 * 200; i++)
+        in[i] = (i16)i;
+
+    ck_assert(audio_ring_init(&ring, 100));
+    ck_assert_uint_eq(ring.capacity, 128);
+
+    ck_assert_uint_eq(audio_ring_write(&ring, in, 100), 100);
+    ck_assert_uint_eq(audio_ring_read(&ring, out, 60), 60);
+    ck_assert_mem_eq(out, in, 60 * 2 * sizeof(i16));
+
+    // Wraps around the end; what doesn't fit is dropped
+    ck_assert_uint_eq(audio_ring_write(&ring, in, 100), 88);
+    ck_assert_uint_eq(ring.dropped, 12);
+    ck_assert_uint_eq(audio_ring_available(&ring), 128);
+
+    // Reading past the end pads with silence
+    ck_assert_uint_eq(audio_ring_read(&ring, out, 200), 128);
+    ck_assert_mem_eq(out, in + 2 * 60, 40 * 2 * sizeof(i16));
+    ck_assert_mem_eq(out + 2 * 40, in, 88 * 2 * sizeof(i16));
+    for (int i = 2 * 128; i < 2 * 200; i++)
+        ck_assert_int_eq(out[i], 0);
+    ck_assert_uint_eq(ring.silence, 72);
+
+    audio_ring_free(&ring);
+}
+END_TEST
+
+#define RING_TOTAL 200000
+
+static void *ring_producer(void *arg) {
+    AudioRing *ring = arg;
+    i16        chunk[2 * 37];
+    u32        sent = 0;
+
+    while (sent < RING_TOTAL) {
+        u32 n = RING_TOTAL - sent < 37 ? RING_TOTAL - sent : 37;
+        for (u32 i = 0; i < n; i++) {
+            chunk[2 * i]     = (i16)(sent + i);
+            chunk[2 * i + 1] = (i16)~(sent + i);
+        }
+        u32 written = audio_ring_write(ring, chunk, n); // What didn't fit goes again
+        if (!written)
+            sched_yield();
+        sent += written;
+    }
+    return NULL;
+}
+
+START_TEST(test_ring_threads) {
+    AudioRing ring;
+    pthread_t producer;
+    i16       out[2 * 64];
+    u32       got = 0, wrong = 0;
+
+    ck_assert(audio_ring_init(&ring, 256));
+    pthread_create(&producer, NULL, ring_producer, &ring);
+
+    // Every frame arrives once, in order, with both halves from the same write
+    while (got < RING_TOTAL) {
+        u32 n = audio_ring_read(&ring, out, 64);
+        if (!n)
+            sched_yield();
+        for (u32 i = 0; i < n; i++, got++)
+            wrong += out[2 * i] != (i16)got || out[2 * i + 1] != (i16)~got;
+    }
+
+    pthread_join(producer, NULL);
+    ck_assert_uint_eq(wrong, 0);
+    ck_assert_uint_eq(audio_ring_available(&ring), 0);
+    audio_ring_free(&ring);
+}
+END_TEST
+
+// ============================================================================
+// Register Tests
+// ============================================================================
+
+START_TEST(test_apu_post_boot) {
+    GameBoy *gb = load_idle();
+
+    ck_assert_uint_eq(mmu_read(gb, 0xFF26), 0xF1); // Channel 1 left on
+    ck_assert_uint_eq(mmu_read(gb, 0xFF10), 0x80);
+    ck_assert_uint_eq(mmu_read(gb, 0xFF11), 0xBF);
+    ck_assert_uint_eq(mmu_read(gb, 0xFF13), 0xFF); // Write only
+    ck_assert_uint_eq(mmu_read(gb, 0xFF24), 0x77);
+    ck_assert_uint_eq(mmu_read(gb, 0xFF25), 0xF3);
+    ck_assert_uint_eq(mmu_read(gb, 0xFF27), 0xFF); // Unused
+
+    // Duty bits read back, length bits don't
+    mmu_write(gb, 0xFF16, 0x5A);
+    ck_assert_uint_eq(mmu_read(gb, 0xFF16), 0x7F);
+
+    // Wave RAM is plain memory
+    mmu_write(gb, 0xFF30, 0x12);
+    mmu_write(gb, 0xFF3F, 0xEF);
+    ck_assert_uint_eq(mmu_read(gb, 0xFF30), 0x12);
+    ck_assert_uint_eq(mmu_read(gb, 0xFF3F), 0xEF);
+    unload(gb);
+}
+END_TEST
+
+START_TEST(test_apu_power_off) {
+    GameBoy *gb = load_idle();
+
+    mmu_write(gb, 0xFF30, 0x34);
+    mmu_write(gb, 0xFF26, 0x00);
+
+    // Registers cleared & locked, wave RAM kept
+    ck_assert_uint_eq(mmu_read(gb, 0xFF26), 0x70);
+    ck_assert_uint_eq(mmu_read(gb, 0xFF10), 0x80);
+    ck_assert_uint_eq(mmu_read(gb, 0xFF24), 0x00);
+    mmu_write(gb, 0xFF24, 0x77);
+    ck_assert_uint_eq(mmu_read(gb, 0xFF24), 0x00);
+    ck_assert_uint_eq(mmu_read(gb, 0xFF30), 0x34);
+
+    mmu_write(gb, 0xFF26, 0x80);
+    ck_assert_uint_eq(mmu_read(gb, 0xFF26), 0xF0);
+    mmu_write(gb, 0xFF24, 0x77);
+    ck_assert_uint_eq(mmu_read(gb, 0xFF24), 0x77);
+    unload(gb);
+}
+END_TEST
+
+START_TEST(test_apu_length) {
+    GameBoy *gb = load_idle();
+
+    // Length 16: 16 length steps (every other frame sequencer step, one
+    // more if enabling it lands right after one) & the channel stops
+    mmu_write(gb, 0xFF17, 0xF0);
+    mmu_write(gb, 0xFF16, 0x30);
+    mmu_write(gb, 0xFF19, 0xC0);
+    ck_assert(channel_on(gb, 1));
+
+    gb_run_cycles(gb, 28 * APU_FRAME_SEQ_CYCLES);
+    ck_assert(channel_on(gb, 1));
+    gb_run_cycles(gb, 8 * APU_FRAME_SEQ_CYCLES);
+    ck_assert(!channel_on(gb, 1));
+
+    // Without length enabled it plays on
+    mmu_write(gb, 0xFF16, 0x3E);
+    mmu_write(gb, 0xFF19, 0x80);
+    gb_run_cycles(gb, 8 * APU_FRAME_SEQ_CYCLES);
+    ck_assert(channel_on(gb, 1));
+
+    // Turning the DAC off stops it at once
+    mmu_write(gb, 0xFF17, 0x00);
+    ck_assert(!channel_on(gb, 1));
+    unload(gb);
+}
+END_TEST
+
+START_TEST(test_apu_sweep) {
+    GameBoy *gb = load_idle();
+
+    // Adding period >> 1 to 0x700 overflows: stopped at the trigger
+    mmu_write(gb, 0xFF12, 0xF0);
+    mmu_write(gb, 0xFF10, 0x11);
+    mmu_write(gb, 0xFF13, 0x00);
+    mmu_write(gb, 0xFF14, 0x87);
+    ck_assert(!channel_on(gb, 0));
+
+    // 0x400 + 0x200 fits; the next sweep step (+0x300) doesn't
+    mmu_write(gb, 0xFF14, 0x84);
+    ck_assert(channel_on(gb, 0));
+    gb_run_cycles(gb, 8 * APU_FRAME_SEQ_CYCLES);
+    ck_assert(!channel_on(gb, 0));
+
+    // Subtracting never overflows
+    mmu_write(gb, 0xFF10, 0x19);
+    mmu_write(gb, 0xFF14, 0x87);
+    gb_run_cycles(gb, 16 * APU_FRAME_SEQ_CYCLES);
+    ck_assert(channel_on(gb, 0));
+
+    // Back to addition after a subtraction: stopped
+    mmu_write(gb, 0xFF10, 0x11);
+    ck_assert(!channel_on(gb, 0));
+    unload(gb);
+}
+END_TEST
+
+START_TEST(test_apu_div_reset) {
+    GameBoy *gb = load_idle();
+
+    // Resetting DIV before bit 12 sets: the frame sequencer never steps
+    mmu_write(gb, 0xFF04, 0);
+    u8 step = gb->apu.fs_step;
+    for (int i = 0; i < 20; i++) {
+        gb_run_cycles(gb, 4000);
+        mmu_write(gb, 0xFF04, 0);
+    }
+    ck_assert_uint_eq(gb->apu.fs_step, step);
+
+    // Resetting it while bit 12 is set is a falling edge: one step
+    gb_run_cycles(gb, 5000);
+    mmu_write(gb, 0xFF04, 0);
+    ck_assert_uint_eq(gb->apu.fs_step, (step + 1) & 7);
+
+    // Left alone it steps every 8192 cycles
+    gb_run_cycles(gb, 3 * APU_FRAME_SEQ_CYCLES);
+    ck_assert_uint_eq(gb->apu.fs_step, (step + 4) & 7);
+    unload(gb);
+}
+END_TEST
+
+// ============================================================================
+// Output Tests
+// ============================================================================
+
+START_TEST(test_apu_output) {
+    GameBoy  *gb = load_idle();
+    AudioRing ring;
+    int       frames = 30;
+
+    ck_assert(audio_ring_init(&ring, 1 << 16));
+    apu_set_output(gb, 48000, &ring);
+    play_square(gb, 2048 - 131); // ~1000.5 Hz
+
+    for (int i = 0; i < frames; i++)
+        gb_run_frame(gb);
+
+    // One frame's worth of samples per frame, all handed over
+    u32 expected = (u32)((u64)frames * CYCLES_PER_FRAME * 48000 / CPU_CLOCK_HZ);
+    u32 avail    = audio_ring_available(&ring);
+    ck_assert_uint_ge(avail, expected - 1);
+    ck_assert_uint_le(avail, expected + 1);
+    ck_assert_uint_eq(gb->apu.samples, avail);
+
+    i16 *pcm = malloc(avail * 2 * sizeof(i16));
+    audio_ring_read(&ring, pcm, avail);
+
+    // Both sides the same; a 1 kHz square crosses zero twice per period
+    int crossings = 0, peak = 0;
+    for (u32 i = 4800; i < avail; i++) {
+        ck_assert_int_eq(pcm[2 * i], pcm[2 * i + 1]);
+        if ((pcm[2 * i - 2] < 0) != (pcm[2 * i] < 0))
+            crossings++;
+        peak = abs(pcm[2 * i]) > peak ? abs(pcm[2 * i]) : peak;
+    }
+    double seconds = (avail - 4800) / 48000.0;
+    ck_assert_int_ge(crossings, (int)(2 * 1000.5 * seconds * 0.97));
+    ck_assert_int_le(crossings, (int)(2 * 1000.5 * seconds * 1.03));
+    ck_assert_int_gt(peak, 15 * 8 * 64 / 4);
+
+    // Muted by NR51: silence (once the filter settles)
+    mmu_write(gb, 0xFF25, 0x00);
+    for (int i = 0; i < frames; i++)
+        gb_run_frame(gb);
+    avail = audio_ring_available(&ring);
+    pcm   = realloc(pcm, avail * 2 * sizeof(i16));
+    audio_ring_read(&ring, pcm, avail);
+    ck_assert_int_eq(pcm[2 * (avail - 1)], 0);
+
+    free(pcm);
+    unload(gb);
+    audio_ring_free(&ring);
+}
+END_TEST
+
+START_TEST(test_apu_state) {
+    GameBoy *gb = load_idle();
+
+    play_square(gb, 0x700);
+    mmu_write(gb, 0xFF30, 0x5A);
+    gb_run_cycles(gb, 10000);
+
+    size_t size  = gb_state_size(gb);
+    u8    *state = malloc(size);
+    ck_assert_uint_eq(gb_save_state(gb, state, size), size);
+
+    mmu_write(gb, 0xFF26, 0x00);
+    mmu_write(gb, 0xFF30, 0x00);
+    ck_assert_int_eq(gb_load_state(gb, state, size), GB_STATE_OK);
+
+    // Saving right after loading gives the same state
+    u8 *again = malloc(size);
+    ck_assert_uint_eq(gb_save_state(gb, again, size), size);
+    ck_assert_mem_eq(again, state, size);
+
+    ck_assert_uint_eq(mmu_read(gb, 0xFF26), 0xF3);
+    ck_assert_uint_eq(mmu_read(gb, 0xFF24), 0x77);
+    ck_assert_uint_eq(mmu_read(gb, 0xFF30), 0x5A);
+
+    free(again);
+    free(state);
+    unload(gb);
+}
+END_TEST
+
+// ============================================================================
+// Register Mode Tests
+// ============================================================================
+
+// Length, sweep & envelopes on all four channels, NR52 sampled every frame
+static void run_script(GameBoy *gb, u8 *nr52, int frames) {
+    mmu_write(gb, 0xFF24, 0x77);
+    mmu_write(gb, 0xFF25, 0xFF);
+    mmu_write(gb, 0xFF12, 0xF1); // Channel 1: envelope down, sweep up until overflow
+    mmu_write(gb, 0xFF10, 0x21);
+    mmu_write(gb, 0xFF13, 0x00);
+    mmu_write(gb, 0xFF14, 0x83);
+    mmu_write(gb, 0xFF17, 0x0B); // Channel 2: envelope up, length 32
+    mmu_write(gb, 0xFF16, 0x20);
+    mmu_write(gb, 0xFF19, 0xC6);
+    mmu_write(gb, 0xFF1A, 0x80); // Channel 3: length 200
+    mmu_write(gb, 0xFF1B, 56);
+    mmu_write(gb, 0xFF1E, 0xC7);
+    mmu_write(gb, 0xFF21, 0xA3); // Channel 4: envelope down
+    mmu_write(gb, 0xFF22, 0x35);
+    mmu_write(gb, 0xFF23, 0x80);
+
+    for (int i = 0; i < frames; i++) {
+        gb_run_frame(gb);
+        nr52[i] = mmu_read(gb, 0xFF26);
+        if (i == frames / 2)
+            mmu_write(gb, 0xFF25, 0x0F); // Mixer writes don't change state either
+    }
+}
+
+START_TEST(test_apu_registers_mode) {
+    GameBoy  *full = load_idle();
+    GameBoy  *regs = load_idle();
+    AudioRing ring;
+    u8        nr52_full[120], nr52_regs[120];
+
+    ck_assert(audio_ring_init(&ring, 1 << 12));
+    apu_set_output(regs, 48000, &ring);
+    apu_set_mode(regs, APU_MODE_REGISTERS);
+    run_script(full, nr52_full, 120);
+    run_script(regs, nr52_regs, 120);
+
+    // Same status bits every frame (channels 1 & 2 stop along the way)
+    ck_assert_mem_eq(nr52_regs, nr52_full, sizeof(nr52_full));
+    ck_assert_uint_eq(nr52_full[119] & 0x03, 0);
+    ck_assert_uint_eq(nr52_full[0] & 0x0F, 0x0F);
+
+    // & the same frame sequencer state behind them
+    ck_assert_mem_eq(regs->apu.regs, full->apu.regs, APU_REG_COUNT);
+    for (int c = 0; c < 4; c++) {
+        ck_assert_uint_eq(regs->apu.ch[c].length, full->apu.ch[c].length);
+        ck_assert_uint_eq(regs->apu.ch[c].volume, full->apu.ch[c].volume);
+        ck_assert_uint_eq(regs->apu.ch[c].period, full->apu.ch[c].period);
+    }
+    ck_assert_uint_eq(regs->apu.sweep_shadow, full->apu.sweep_shadow);
+    ck_assert_uint_eq(regs->apu.fs_step, full->apu.fs_step);
+
+    // Without a single sample
+    ck_assert_uint_gt(full->apu.samples, 0);
+    ck_assert_uint_eq(regs->apu.samples, 0);
+    ck_assert_uint_eq(audio_ring_available(&ring), 0);
+
+    unload(full);
+    unload(regs);
+    audio_ring_free(&ring);
+}
+END_TEST
+
+START_TEST(test_apu_mode_switch) {
+    GameBoy  *gb = load_idle();
+    AudioRing ring;
+    int       frames = 30;
+
+    ck_assert(audio_ring_init(&ring, 1 << 16));
+    apu_set_output(gb, 48000, &ring);
+    apu_set_mode(gb, APU_MODE_REGISTERS);
+    play_square(gb, 2048 - 131); // ~1000.5 Hz
+    for (int i = 0; i < frames; i++)
+        gb_run_frame(gb);
+    ck_assert_uint_eq(audio_ring_available(&ring), 0);
+
+    // Back to full: the square picks up where it is, at its level
+    apu_set_mode(gb, APU_MODE_FULL);
+    for (int i = 0; i < frames; i++)
+        gb_run_frame(gb);
+
+    u32 avail = audio_ring_available(&ring);
+    u32 expected = (u32)((u64)frames * CYCLES_PER_FRAME * 48000 / CPU_CLOCK_HZ);
+    ck_assert_uint_ge(avail, expected - 1);
+    ck_assert_uint_le(avail, expected + 1);
+
+    i16 *pcm = malloc(avail * 2 * sizeof(i16));
+    audio_ring_read(&ring, pcm, avail);
+    int crossings = 0;
+    for (u32 i = 4800; i < avail; i++)
+        if ((pcm[2 * i - 2] < 0) != (pcm[2 * i] < 0))
+            crossings++;
+    double seconds = (avail - 4800) / 48000.0;
+    ck_assert_int_ge(crossings, (int)(2 * 1000.5 * seconds * 0.97));
+    ck_assert_int_le(crossings, (int)(2 * 1000.5 * seconds * 1.03));
+
+    free(pcm);
+    unload(gb);
+    audio_ring_free(&ring);
+}
+END_TEST
+
+// ============================================================================
+// Test Suite
+// ============================================================================
+
+Suite *apu_suite(void) {
+    Suite *s;
+    TCase *tc_ring, *tc_regs, *tc_output, *tc_mode;
+
+    s       = suite_create("APU");
+
+    tc_ring = tcase_create("Audio Ring");
+    tcase_add_test(tc_ring, test_ring_wrap);
+    tcase_add_test(tc_ring, test_ring_threads);
+    suite_add_tcase(s, tc_ring);
+
+    tc_regs = tcase_create("Registers");
+    tcase_add_test(tc_regs, test_apu_post_boot);
+    tcase_add_test(tc_regs, test_apu_power_off);
+    tcase_add_test(tc_regs, test_apu_length);
+    tcase_add_test(tc_regs, test_apu_sweep);
+    tcase_add_test(tc_regs, test_apu_div_reset);
+    suite_add_tcase(s, tc_regs);
+
+    tc_output = tcase_create("Output");
+    tcase_add_test(tc_output, test_apu_output);
+    tcase_add_test(tc_output, test_apu_state);
+    suite_add_tcase(s, tc_output);
+
+    tc_mode = tcase_create("Register Mode");
+    tcase_add_test(tc_mode, test_apu_registers_mode);
+    tcase_add_test(tc_mode, test_apu_mode_switch);
+    suite_add_tcase(s, tc_mode);
+
+    return s;
+}
+
+int main(void) {
+    int      number_failed;
+    Suite   *s;
+    SRunner *sr;
+
+    s  = apu_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
@@ -1,8 +1,14 @@
 // tests/test_cartridge.c
 #include <check.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <core/cartridge.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "test_machine.h"
 
 // ============================================================================
 // Helper Functions Tests
@@ -293,6 +299,321 @@ START_TEST(test_header_checksum_invalid) {
 }
 END_TEST
 
+// ============================================================================
+// Loading Tests
+// ============================================================================
+
+#define ROM_SIZE 0x8000
+
+// 32 KB ROM of cart `type` with RAM code `ram`, a valid header checksum &
+// some content to compare
+static void make_rom(u8 *rom, u8 type, u8 ram) {
+    for (size_t i = 0; i < ROM_SIZE; i++)
+        rom[i] = (u8)(i * 31 + (i >> 8));
+
+    rom[0x0147] = type;
+    rom[0x0149] = ram;
+    test_rom_checksum(rom);
+}
+
+START_TEST(test_cart_load_file) {
+    static u8 rom[ROM_SIZE];
+    char      path[] = "/tmp/baredmg_romXXXXXX";
+    Cartridge cart   = {0};
+    Cartridge copy   = {0};
+
+    make_rom(rom, 0x00, 0x00); // ROM only
+    int fd = mkstemp(path);
+    ck_assert_int_ge(fd, 0);
+    ck_assert_int_eq(write(fd, rom, ROM_SIZE), ROM_SIZE);
+    close(fd);
+
+    ck_assert_int_eq(cart_load(&cart, path), 0);
+    unlink(path); // The mapping outlives the name
+#ifndef BAREDMG_NO_MMAP
+    ck_assert(cart.image->mapped);
+#endif
+    ck_assert_uint_eq(cart.rom_size, ROM_SIZE);
+    ck_assert(memcmp(cart.rom, rom, ROM_SIZE) == 0);
+
+    // Same content from memory: the same image, no copy
+    ck_assert_int_eq(cart_load_buffer(&copy, rom, ROM_SIZE), 0);
+    ck_assert_ptr_eq(copy.image, cart.image);
+    ck_assert_ptr_eq(copy.rom, cart.rom);
+    ck_assert(cart.rom_hash == copy.rom_hash);
+
+    cart_unload(&cart);
+    cart_unload(&copy);
+    ck_assert_ptr_null(cart.rom);
+    ck_assert_ptr_null(cart.image);
+}
+END_TEST
+
+START_TEST(test_cart_load_pipe) {
+    static u8 rom[ROM_SIZE];
+    char      path[] = "/tmp/baredmg_fifoXXXXXX";
+    Cartridge cart   = {0};
+
+    // A FIFO can't be mapped (or measured up front): the heap path reads it
+    make_rom(rom, 0x00, 0x00); // ROM only
+    int fd = mkstemp(path);
+    ck_assert_int_ge(fd, 0);
+    close(fd);
+    unlink(path);
+    ck_assert_int_eq(mkfifo(path, 0600), 0);
+
+    pid_t writer = fork();
+    ck_assert_int_ge(writer, 0);
+    if (writer == 0) {
+        int out = open(path, O_WRONLY);
+        for (size_t done = 0; out >= 0 && done < ROM_SIZE;) {
+            size_t  chunk = ROM_SIZE - done < 1000 ? ROM_SIZE - done : 1000; // Short reads
+            ssize_t n     = write(out, rom + done, chunk);
+            if (n <= 0)
+                _exit(1);
+            done += (size_t)n;
+        }
+        _exit(0);
+    }
+
+    int err = cart_load(&cart, path);
+    waitpid(writer, NULL, 0);
+    unlink(path);
+
+    ck_assert_int_eq(err, 0);
+    ck_assert(!cart.image->mapped);
+    ck_assert_uint_eq(cart.rom_size, ROM_SIZE);
+    ck_assert(memcmp(cart.rom, rom, ROM_SIZE) == 0);
+    cart_unload(&cart);
+}
+END_TEST
+
+START_TEST(test_rom_store_sharing) {
+    static Cartridge carts[100];
+    static u8        rom[ROM_SIZE];
+    char             path[] = "/tmp/baredmg_romXXXXXX";
+    char             twin[] = "/tmp/baredmg_romXXXXXX";
+    Cartridge        other  = {0};
+    RomStoreStats    stats;
+    u8               sha1[SHA1_SIZE];
+
+    make_rom(rom, 0x00, 0x00); // ROM only
+    for (int f = 0; f < 2; f++) {
+        int fd = mkstemp(f ? twin : path);
+        ck_assert_int_ge(fd, 0);
+        ck_assert_int_eq(write(fd, rom, ROM_SIZE), ROM_SIZE);
+        close(fd);
+    }
+
+    // One image however many cartridges run it
+    for (int i = 0; i < 100; i++)
+        ck_assert_int_eq(cart_load(&carts[i], path), 0);
+    rom_store_stats(&stats);
+    ck_assert_uint_eq(stats.images, 1);
+    ck_assert_uint_eq(stats.refs, 100);
+    ck_assert_uint_eq(stats.bytes, ROM_SIZE);
+    ck_assert_ptr_eq(carts[99].rom, carts[0].rom);
+
+    // Named by content
+    compute_sha1(rom, ROM_SIZE, sha1);
+    ck_assert_uint_eq(carts[0].image->crc32, compute_crc32(rom, ROM_SIZE));
+    ck_assert(memcmp(carts[0].image->sha1, sha1, SHA1_SIZE) == 0);
+
+    // Same bytes in another file: still that image
+    cart_unload(&carts[99]);
+    ck_assert_int_eq(cart_load(&carts[99], twin), 0);
+    ck_assert_ptr_eq(carts[99].image, carts[0].image);
+
+    // Different content: a second image
+    rom[0x0200] ^= 0xFF;
+    ck_assert_int_eq(cart_load_buffer(&other, rom, ROM_SIZE), 0);
+    rom_store_stats(&stats);
+    ck_assert_uint_eq(stats.images, 2);
+    ck_assert(other.rom_hash != carts[0].rom_hash);
+
+    // The last unload lets go of each
+    cart_unload(&other);
+    for (int i = 0; i < 100; i++)
+        cart_unload(&carts[i]);
+    rom_store_stats(&stats);
+    ck_assert_uint_eq(stats.images, 0);
+    ck_assert_uint_eq(stats.refs, 0);
+
+    unlink(path);
+    unlink(twin);
+}
+END_TEST
+
+START_TEST(test_cart_load_errors) {
+    static u8 rom[0x100];
+    char      path[] = "/tmp/baredmg_romXXXXXX";
+    Cartridge cart   = {0};
+
+    ck_assert_int_eq(cart_load(&cart, "/nonexistent/rom.gb"), 1);
+
+    // Too small for a header
+    int fd = mkstemp(path);
+    ck_assert_int_ge(fd, 0);
+    ck_assert_int_eq(write(fd, rom, sizeof(rom)), sizeof(rom));
+    close(fd);
+    ck_assert_int_eq(cart_load(&cart, path), 2);
+    ck_assert_ptr_null(cart.rom);
+
+    // Bigger than any header can describe (sparse: nothing is written)
+    fd = open(path, O_WRONLY);
+    ck_assert_int_ge(fd, 0);
+    ck_assert_int_eq(ftruncate(fd, 8 * 1024 * 1024 + 1), 0);
+    close(fd);
+    ck_assert_int_eq(cart_load(&cart, path), 6);
+    ck_assert_ptr_null(cart.rom);
+    unlink(path);
+}
+END_TEST
+
+// ============================================================================
+// Battery Save Tests
+// ============================================================================
+
+// Write a make_rom() image of cart of `type` with RAM code `ram` to a new
+// /tmp/...gb file (path is a mkstemps template ending in ".gb")
+static void write_rom_file(char *path, u8 type, u8 ram) {
+    static u8 rom[ROM_SIZE];
+
+    make_rom(rom, type, ram);
+
+    int fd = mkstemps(path, 3);
+    ck_assert_int_ge(fd, 0);
+    ck_assert_int_eq(write(fd, rom, ROM_SIZE), ROM_SIZE);
+    close(fd);
+}
+
+START_TEST(test_cart_save_path) {
+    static const char *cases[][2] = {
+        {"roms/tetris.gb", "roms/tetris.sav"},
+        {"x.tar.gbc", "x.tar.sav"},
+        {"dir.d/rom", "dir.d/rom.sav"},
+        {".hidden", ".hidden.sav"},
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        char *save = cart_save_path(cases[i][0]);
+        ck_assert_str_eq(save, cases[i][1]);
+        free(save);
+    }
+
+    ck_assert(cart_has_battery(0x03));
+    ck_assert(cart_has_battery(0x1B));
+    ck_assert(cart_has_battery(0xFF));
+    ck_assert(!cart_has_battery(0x02));
+    ck_assert(!cart_has_battery(0x1A));
+}
+END_TEST
+
+START_TEST(test_cart_battery_save) {
+    char      path[] = "/tmp/baredmg_batXXXXXX.gb";
+    Cartridge cart   = {0};
+    u8        file[0x8000];
+
+    write_rom_file(path, 0x03, 0x03); // MBC1+RAM+BATTERY, 32 KB
+    ck_assert_int_eq(cart_load(&cart, path), 0);
+    ck_assert(cart.header.has_battery);
+    ck_assert_ptr_nonnull(cart.save_path);
+    ck_assert(strcmp(cart.save_path + strlen(cart.save_path) - 4, ".sav") == 0);
+#ifndef BAREDMG_NO_MMAP
+    ck_assert(cart.ram_mapped);
+#endif
+
+    // New save file: the RAM's size, zeroed
+    struct stat st;
+    ck_assert_int_eq(stat(cart.save_path, &st), 0);
+    ck_assert_int_eq(st.st_size, 0x8000);
+    ck_assert_uint_eq(cart.ram[0x10], 0);
+
+    // Two pages written: one flush writes both, nothing left for the next
+    cart.ram[0x0010] = 0x42;
+    cart.ram[0x5000] = 0x99;
+    cart_ram_mark_dirty(&cart, 0x0010, 1);
+    cart_ram_mark_dirty(&cart, 0x5000, 1);
+    ck_assert(cart_ram_is_dirty(&cart, 0x00FF));
+    ck_assert(!cart_ram_is_dirty(&cart, 0x0100));
+    ck_assert_uint_eq(cart_save_flush(&cart), 2);
+    ck_assert_uint_eq(cart_save_flush(&cart), 0);
+    ck_assert_uint_eq(cart.save_flushes, 1);
+
+    FILE *f = fopen(cart.save_path, "rb");
+    ck_assert_ptr_nonnull(f);
+    ck_assert_uint_eq(fread(file, 1, sizeof(file), f), sizeof(file));
+    fclose(f);
+    ck_assert_uint_eq(file[0x0010], 0x42);
+    ck_assert_uint_eq(file[0x5000], 0x99);
+
+    // Unloading flushes the rest; the next load picks it all up
+    char *save = cart_save_path(path);
+    cart.ram[0x7FFF] = 0x5A;
+    cart_ram_mark_dirty(&cart, 0x7FFF, 1);
+    cart_unload(&cart);
+    ck_assert_ptr_null(cart.save_path);
+    ck_assert_ptr_null(cart.ram);
+
+    ck_assert_int_eq(cart_load(&cart, path), 0);
+    ck_assert_uint_eq(cart.ram[0x0010], 0x42);
+    ck_assert_uint_eq(cart.ram[0x5000], 0x99);
+    ck_assert_uint_eq(cart.ram[0x7FFF], 0x5A);
+    cart_unload(&cart);
+
+    unlink(save);
+    unlink(path);
+    free(save);
+}
+END_TEST
+
+#ifdef BAREDMG_NO_MMAP
+START_TEST(test_cart_save_write_error) {
+    char      path[] = "/tmp/baredmg_batXXXXXX.gb";
+    Cartridge cart   = {0};
+
+    write_rom_file(path, 0x03, 0x03); // MBC1+RAM+BATTERY, 32 KB
+    ck_assert_int_eq(cart_load(&cart, path), 0);
+    char *save = cart_save_path(path);
+
+    // A device that takes no data: nothing is flushed & all of it stays dirty
+    free(cart.save_path);
+    cart.save_path = strdup("/dev/full");
+    cart_ram_mark_dirty(&cart, 0, 0x8000);
+    ck_assert_uint_eq(cart_save_flush(&cart), 0);
+    ck_assert_uint_eq(cart.save_flushes, 0);
+    ck_assert(cart_ram_is_dirty(&cart, 0x0000));
+    ck_assert(cart_ram_is_dirty(&cart, 0x7FFF));
+
+    cart_unload(&cart);
+    unlink(save);
+    unlink(path);
+    free(save);
+}
+END_TEST
+#endif
+
+START_TEST(test_cart_no_battery) {
+    char      path[] = "/tmp/baredmg_batXXXXXX.gb";
+    Cartridge cart   = {0};
+
+    // RAM without a battery: plain heap RAM, no file
+    write_rom_file(path, 0x02, 0x02);
+    ck_assert_int_eq(cart_load(&cart, path), 0);
+    ck_assert(!cart.header.has_battery);
+    ck_assert_ptr_nonnull(cart.ram);
+    ck_assert_ptr_null(cart.save_path);
+    ck_assert_uint_eq(cart_save_flush(&cart), 0);
+
+    char *save = cart_save_path(path);
+    ck_assert_int_ne(access(save, F_OK), 0);
+    free(save);
+
+    cart_unload(&cart);
+    unlink(path);
+}
+END_TEST
+
 // ============================================================================
 // Test Suite Setup
 // ============================================================================
@@ -300,7 +621,7 @@ END_TEST
 Suite *cartridge_suite(void) {
     Suite *s;
     TCase *tc_ram_size, *tc_rom_size, *tc_cart_type, *tc_publisher;
-    TCase *tc_parse, *tc_checksum;
+    TCase *tc_parse, *tc_checksum, *tc_load, *tc_save;
 
     s           = suite_create("Cartridge");
 
@@ -358,6 +679,24 @@ Suite *cartridge_suite(void) {
     tcase_add_test(tc_checksum, test_header_checksum_invalid);
     suite_add_tcase(s, tc_checksum);
 
+    // Loading from files (mapped) & pipes (read into the heap), the ROM store
+    tc_load = tcase_create("Loading");
+    tcase_add_test(tc_load, test_cart_load_file);
+    tcase_add_test(tc_load, test_cart_load_pipe);
+    tcase_add_test(tc_load, test_rom_store_sharing);
+    tcase_add_test(tc_load, test_cart_load_errors);
+    suite_add_tcase(s, tc_load);
+
+    // Battery RAM in .sav files
+    tc_save = tcase_create("Battery Saves");
+    tcase_add_test(tc_save, test_cart_save_path);
+    tcase_add_test(tc_save, test_cart_battery_save);
+    tcase_add_test(tc_save, test_cart_no_battery);
+#ifdef BAREDMG_NO_MMAP
+    tcase_add_test(tc_save, test_cart_save_write_error);
+#endif
+    suite_add_tcase(s, tc_save);
+
     return s;
 }
 
@@ -0,0 +1,1026 @@
+// tests/test_cpu.c
+#include <check.h>
+#include <gbemu.h>
+#include <core/bus.h>
+#include <core/cpu.h>
+#include <core/trace.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "test_machine.h"
+
+// ============================================================================
+// Load & Register Tests
+// ============================================================================
+
+START_TEST(test_reset_state) {
+    GameBoy gb;
+    u8      prog[] = {0x00};
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    ck_assert_uint_eq(gb.cpu.pc, 0x0100);
+    ck_assert_uint_eq(gb.cpu.sp, 0xFFFE);
+    ck_assert_uint_eq(cpu_get_af(&gb.cpu), 0x01B0);
+    ck_assert_uint_eq(cpu_get_bc(&gb.cpu), 0x0013);
+    ck_assert_uint_eq(cpu_get_de(&gb.cpu), 0x00D8);
+    ck_assert_uint_eq(cpu_get_hl(&gb.cpu), 0x014D);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_ld_immediate) {
+    GameBoy gb;
+    u8      prog[] = {
+        0x3E, 0x42,       // LD A, 0x42
+        0x01, 0x34, 0x12, // LD BC, 0x1234
+        0x21, 0x00, 0xC0, // LD HL, 0xC000
+        0x77,             // LD (HL), A
+        0x46,             // LD B, (HL)
+    };
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    for (int i = 0; i < 5; i++)
+        cpu_step(&gb);
+
+    ck_assert_uint_eq(gb.cpu.a, 0x42);
+    ck_assert_uint_eq(gb.cpu.c, 0x34);
+    ck_assert_uint_eq(gb.wram[0], 0x42);
+    ck_assert_uint_eq(gb.cpu.b, 0x42);
+    ck_assert_uint_eq(gb.cpu.pc, 0x010A);
+    ck_assert_uint_eq(gb.cycles, 8 + 12 + 12 + 8 + 8);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_ld_hl_inc_dec) {
+    GameBoy gb;
+    u8      prog[] = {
+        0x21, 0x00, 0xC0, // LD HL, 0xC000
+        0x3E, 0x11,       // LD A, 0x11
+        0x22,             // LD (HL+), A
+        0x32,             // LD (HL-), A
+    };
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    for (int i = 0; i < 4; i++)
+        cpu_step(&gb);
+
+    ck_assert_uint_eq(gb.wram[0], 0x11);
+    ck_assert_uint_eq(gb.wram[1], 0x11);
+    ck_assert_uint_eq(cpu_get_hl(&gb.cpu), 0xC000);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+// ============================================================================
+// ALU Tests
+// ============================================================================
+
+START_TEST(test_add_flags) {
+    GameBoy gb;
+    u8      prog[] = {
+        0x3E, 0x0F, // LD A, 0x0F
+        0xC6, 0x01, // ADD A, 0x01  -> 0x10, H
+        0xC6, 0xF0, // ADD A, 0xF0  -> 0x00, Z C
+    };
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    cpu_step(&gb);
+    cpu_step(&gb);
+    ck_assert_uint_eq(gb.cpu.a, 0x10);
+    ck_assert_uint_eq(gb.cpu.f, FLAG_H);
+
+    cpu_step(&gb);
+    ck_assert_uint_eq(gb.cpu.a, 0x00);
+    ck_assert_uint_eq(gb.cpu.f, FLAG_Z | FLAG_C);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_adc_sbc) {
+    GameBoy gb;
+    u8      prog[] = {
+        0x37,       // SCF
+        0x3E, 0x0E, // LD A, 0x0E
+        0xCE, 0x01, // ADC A, 0x01 -> 0x10, H
+        0x37,       // SCF
+        0xDE, 0x0F, // SBC A, 0x0F -> 0x00, Z N H
+    };
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    for (int i = 0; i < 3; i++)
+        cpu_step(&gb);
+    ck_assert_uint_eq(gb.cpu.a, 0x10);
+    ck_assert_uint_eq(gb.cpu.f, FLAG_H);
+
+    cpu_step(&gb);
+    cpu_step(&gb);
+    ck_assert_uint_eq(gb.cpu.a, 0x00);
+    ck_assert_uint_eq(gb.cpu.f, FLAG_Z | FLAG_N | FLAG_H);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_sub_cp) {
+    GameBoy gb;
+    u8      prog[] = {
+        0x3E, 0x10, // LD A, 0x10
+        0xFE, 0x20, // CP 0x20     -> N C, A unchanged
+        0xD6, 0x01, // SUB 0x01    -> 0x0F, N H
+    };
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    cpu_step(&gb);
+    cpu_step(&gb);
+    ck_assert_uint_eq(gb.cpu.a, 0x10);
+    ck_assert_uint_eq(gb.cpu.f, FLAG_N | FLAG_C);
+
+    cpu_step(&gb);
+    ck_assert_uint_eq(gb.cpu.a, 0x0F);
+    ck_assert_uint_eq(gb.cpu.f, FLAG_N | FLAG_H);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_inc_dec_keep_carry) {
+    GameBoy gb;
+    u8      prog[] = {
+        0x37,       // SCF
+        0x06, 0xFF, // LD B, 0xFF
+        0x04,       // INC B -> 0x00, Z H C(kept)
+        0x05,       // DEC B -> 0xFF, N H C(kept)
+    };
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    for (int i = 0; i < 3; i++)
+        cpu_step(&gb);
+    ck_assert_uint_eq(gb.cpu.b, 0x00);
+    ck_assert_uint_eq(gb.cpu.f, FLAG_Z | FLAG_H | FLAG_C);
+
+    cpu_step(&gb);
+    ck_assert_uint_eq(gb.cpu.b, 0xFF);
+    ck_assert_uint_eq(gb.cpu.f, FLAG_N | FLAG_H | FLAG_C);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_add_hl_and_sp) {
+    GameBoy gb;
+    u8      prog[] = {
+        0x21, 0xFF, 0x0F, // LD HL, 0x0FFF
+        0x01, 0x01, 0x00, // LD BC, 0x0001
+        0x09,             // ADD HL, BC -> 0x1000, H
+        0x31, 0xF8, 0xFF, // LD SP, 0xFFF8
+        0xE8, 0x08,       // ADD SP, 8 -> 0x0000, H C
+        0xF8, 0xFF,       // LD HL, SP - 1 -> 0xFFFF
+    };
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    for (int i = 0; i < 3; i++)
+        cpu_step(&gb);
+    ck_assert_uint_eq(cpu_get_hl(&gb.cpu), 0x1000);
+    ck_assert_uint_eq(gb.cpu.f & (FLAG_N | FLAG_H | FLAG_C), FLAG_H);
+
+    cpu_step(&gb);
+    cpu_step(&gb);
+    ck_assert_uint_eq(gb.cpu.sp, 0x0000);
+    ck_assert_uint_eq(gb.cpu.f, FLAG_H | FLAG_C);
+
+    cpu_step(&gb);
+    ck_assert_uint_eq(cpu_get_hl(&gb.cpu), 0xFFFF);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_daa) {
+    GameBoy gb;
+    u8      prog[] = {
+        0x3E, 0x19, // LD A, 0x19
+        0xC6, 0x28, // ADD A, 0x28 -> 0x41 (H)
+        0x27,       // DAA -> 0x47
+        0xD6, 0x08, // SUB 0x08 -> 0x3F (N H)
+        0x27,       // DAA -> 0x39
+    };
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    for (int i = 0; i < 3; i++)
+        cpu_step(&gb);
+    ck_assert_uint_eq(gb.cpu.a, 0x47);
+
+    cpu_step(&gb);
+    cpu_step(&gb);
+    ck_assert_uint_eq(gb.cpu.a, 0x39);
+    ck_assert_uint_eq(gb.cpu.f, FLAG_N);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+// ============================================================================
+// CB Prefix Tests
+// ============================================================================
+
+START_TEST(test_cb_ops) {
+    GameBoy gb;
+    u8      prog[] = {
+        0x3E, 0xF1,       // LD A, 0xF1
+        0xCB, 0x37,       // SWAP A -> 0x1F
+        0xCB, 0x7F,       // BIT 7, A -> Z
+        0x21, 0x00, 0xC0, // LD HL, 0xC000
+        0xCB, 0xC6,       // SET 0, (HL)
+        0xCB, 0x3E,       // SRL (HL) -> 0, Z C
+    };
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    cpu_step(&gb);
+    u64 before = gb.cycles;
+    cpu_step(&gb);
+    ck_assert_uint_eq(gb.cpu.a, 0x1F);
+    ck_assert_uint_eq(gb.cycles - before, 8);
+
+    cpu_step(&gb);
+    ck_assert_uint_eq(gb.cpu.f, FLAG_Z | FLAG_H);
+
+    cpu_step(&gb);
+    before = gb.cycles;
+    cpu_step(&gb);
+    ck_assert_uint_eq(gb.wram[0], 0x01);
+    ck_assert_uint_eq(gb.cycles - before, 16);
+
+    cpu_step(&gb);
+    ck_assert_uint_eq(gb.wram[0], 0x00);
+    ck_assert_uint_eq(gb.cpu.f, FLAG_Z | FLAG_C);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+// ============================================================================
+// Control Flow Tests
+// ============================================================================
+
+START_TEST(test_jr_cycles) {
+    GameBoy gb;
+    u8      prog[] = {
+        0xAF,       // XOR A -> Z
+        0x20, 0x10, // JR NZ, +16 (not taken, 8 cycles)
+        0x28, 0x02, // JR Z, +2 (taken, 12 cycles)
+        0x00, 0x00, // skipped
+        0x18, 0xFE, // JR -2 (loop forever)
+    };
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    cpu_step(&gb);
+    u64 before = gb.cycles;
+    cpu_step(&gb);
+    ck_assert_uint_eq(gb.cycles - before, 8);
+    ck_assert_uint_eq(gb.cpu.pc, 0x0103);
+
+    before = gb.cycles;
+    cpu_step(&gb);
+    ck_assert_uint_eq(gb.cycles - before, 12);
+    ck_assert_uint_eq(gb.cpu.pc, 0x0107);
+
+    cpu_step(&gb);
+    ck_assert_uint_eq(gb.cpu.pc, 0x0107);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_call_ret_push_pop) {
+    GameBoy gb;
+    u8      prog[] = {
+        0xCD, 0x10, 0x01, // CALL 0x0110
+        0x00,             // NOP (return here)
+    };
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    // Subroutine at 0x0110: PUSH AF with dirty F, POP AF masks low nibble, RET
+    u8 sub[] = {
+        0x01, 0xFF, 0x12, // LD BC, 0x12FF
+        0xC5,             // PUSH BC
+        0xF1,             // POP AF
+        0xC9,             // RET
+    };
+    memcpy(gb.cart.rom + 0x0110, sub, sizeof(sub));
+
+    cpu_step(&gb);
+    ck_assert_uint_eq(gb.cpu.pc, 0x0110);
+    ck_assert_uint_eq(gb.cpu.sp, 0xFFFC);
+    ck_assert_uint_eq(mmu_read16(&gb, 0xFFFC), 0x0103);
+
+    for (int i = 0; i < 4; i++)
+        cpu_step(&gb);
+    ck_assert_uint_eq(cpu_get_af(&gb.cpu), 0x12F0);
+    ck_assert_uint_eq(gb.cpu.pc, 0x0103);
+    ck_assert_uint_eq(gb.cpu.sp, 0xFFFE);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_run_budget) {
+    GameBoy gb;
+    u8      prog[] = {0x18, 0xFE}; // JR -2: 12 cycles per iteration
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    // The budget is a minimum: the last instruction may overshoot it
+    u32 used = cpu_run(&gb, 100);
+    ck_assert_uint_eq(used, 108);
+    ck_assert_uint_eq(gb.cycles, 108);
+    ck_assert_uint_eq(gb.cpu.instructions, 9);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_illegal_opcode_locks) {
+    GameBoy gb;
+    u8      prog[] = {0xD3, 0x00};
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    cpu_run(&gb, 64);
+    ck_assert(gb.cpu.locked);
+    ck_assert_uint_eq(gb.cpu.pc, 0x0101);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+// ============================================================================
+// Interrupt Tests
+// ============================================================================
+
+START_TEST(test_interrupt_dispatch) {
+    GameBoy gb;
+    u8      prog[] = {
+        0xFB, // EI
+        0x00, // NOP (runs before the interrupt is taken)
+        0x00, // NOP
+    };
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    gb.ie_register = INT_TIMER | INT_VBLANK;
+    cpu_request_interrupt(&gb, INT_TIMER | INT_VBLANK);
+
+    cpu_step(&gb); // EI
+    ck_assert(!gb.cpu.ime);
+    cpu_step(&gb); // NOP, IME now on
+    ck_assert(gb.cpu.ime);
+    ck_assert_uint_eq(gb.cpu.pc, 0x0102);
+
+    // VBlank has priority over Timer
+    u64 before = gb.cycles;
+    cpu_step(&gb);
+    ck_assert_uint_eq(gb.cycles - before, 20);
+    ck_assert_uint_eq(gb.cpu.pc, 0x0040);
+    ck_assert(!gb.cpu.ime);
+    ck_assert_uint_eq(gb.if_register, INT_TIMER);
+    ck_assert_uint_eq(mmu_read16(&gb, gb.cpu.sp), 0x0102);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_halt_wakeup) {
+    GameBoy gb;
+    u8      prog[] = {
+        0x76, // HALT
+        0x3C, // INC A
+    };
+    test_machine_init(&gb, prog, sizeof(prog));
+    gb.ie_register = INT_TIMER;
+
+    cpu_run(&gb, 100);
+    ck_assert(gb.cpu.halted);
+    ck_assert_uint_eq(gb.cpu.pc, 0x0101);
+
+    // IME off: the interrupt only wakes the CPU, no dispatch
+    cpu_request_interrupt(&gb, INT_TIMER);
+    cpu_step(&gb);
+    ck_assert(!gb.cpu.halted);
+    ck_assert_uint_eq(gb.cpu.a, 0x02);
+    ck_assert_uint_eq(gb.cpu.pc, 0x0102);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_halt_fast_forward) {
+    // Halt until TIMA overflows, count the wake-up, clear IF & halt again.
+    // One long cpu_run() skips each idle stretch in one go; cpu_step() only
+    // idles up to its 1-cycle budget (one M-cycle) per call, like before
+    // skipping existed. Both must land on the same cycle in the same state.
+    GameBoy gb, ref;
+    u8      prog[] = {
+        0x3E, 0x05, // LD A, 0x05      (timer on, 16 cycles per tick)
+        0xE0, 0x07, // LDH (TAC), A
+        0x3E, 0x04, // LD A, INT_TIMER
+        0xE0, 0xFF, // LDH (IE), A
+        0xAF,       // XOR A           <- loop
+        0xE0, 0x0F, // LDH (IF), A
+        0x76,       // HALT (IME=0: just wakes up)
+        0x04,       // INC B
+        0x18, 0xF9, // JR loop
+    };
+    test_machine_init(&gb, prog, sizeof(prog));
+    test_machine_init(&ref, prog, sizeof(prog));
+
+    cpu_run(&gb, 2 * CYCLES_PER_FRAME);
+    while (ref.cycles < gb.cycles)
+        cpu_step(&ref);
+
+    ck_assert_uint_eq(ref.cycles, gb.cycles);
+    ck_assert_uint_eq(ref.cpu.pc, gb.cpu.pc);
+    ck_assert_uint_eq(ref.cpu.b, gb.cpu.b);
+    ck_assert_uint_ge(gb.cpu.b, 30); // 4096 cycles per overflow
+    ck_assert_uint_eq(ref.cpu.idle_cycles, gb.cpu.idle_cycles);
+
+    // Mostly idle, skipped about once per event (timer & PPU)
+    ck_assert_uint_gt(gb.cpu.idle_cycles, CYCLES_PER_FRAME);
+    ck_assert_uint_lt(gb.cpu.idle_skips, ref.cpu.idle_skips / 50);
+
+    test_machine_free(&gb);
+    test_machine_free(&ref);
+}
+END_TEST
+
+START_TEST(test_halt_bug) {
+    GameBoy gb;
+    u8      prog[] = {
+        0x76, // HALT with IME=0 & an interrupt pending
+        0x3C, // INC A (executed twice)
+        0x00,
+    };
+    test_machine_init(&gb, prog, sizeof(prog));
+    gb.ie_register = INT_TIMER;
+    cpu_request_interrupt(&gb, INT_TIMER);
+
+    cpu_step(&gb);
+    ck_assert(!gb.cpu.halted);
+    cpu_step(&gb);
+    cpu_step(&gb);
+    ck_assert_uint_eq(gb.cpu.a, 0x03);
+    ck_assert_uint_eq(gb.cpu.pc, 0x0102);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+// ============================================================================
+// Decode Cache Tests
+// ============================================================================
+
+START_TEST(test_decode_cache_hits) {
+    GameBoy gb;
+    u8      prog[] = {
+        0x3E, 0x01,       // LD A, 0x01
+        0xC6, 0x02,       // ADD A, 0x02
+        0xC3, 0x00, 0x01, // JP 0x0100
+    };
+    test_machine_init(&gb, prog, sizeof(prog));
+    gb.decode_enabled = true;
+
+    // First pass decodes, later passes hit the cached records
+    for (int i = 0; i < 30; i++)
+        cpu_step(&gb);
+
+    CpuDecodeStats stats;
+    cpu_decode_get_stats(&gb, &stats);
+    ck_assert_uint_eq(stats.misses, 3);
+    ck_assert_uint_eq(stats.hits, 27);
+    ck_assert_uint_eq(gb.cpu.a, 0x03);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_decode_cache_off_by_default) {
+    GameBoy gb;
+    u8      prog[] = {
+        0x3E, 0x01,       // LD A, 0x01
+        0xC6, 0x02,       // ADD A, 0x02
+        0xC3, 0x00, 0x01, // JP 0x0100
+    };
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    // Fetched straight from memory: no cache is built & nothing is counted
+    for (int i = 0; i < 30; i++)
+        cpu_step(&gb);
+
+    CpuDecodeStats stats;
+    cpu_decode_get_stats(&gb, &stats);
+    ck_assert_ptr_null(gb.decode);
+    ck_assert_uint_eq(stats.misses, 0);
+    ck_assert_uint_eq(stats.hits, 0);
+    ck_assert_uint_eq(gb.cpu.a, 0x03);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_decode_cache_ram_invalidation) {
+    // Run `LD B, 0x11; RET` from WRAM, patch the immediate through the MMU,
+    // then run it again: the stale record must not be used
+    GameBoy gb;
+    u8      prog[] = {
+        0x21, 0x00, 0xC0, // LD HL, 0xC000
+        0x36, 0x06,       // LD (HL), 0x06    (LD B, d8)
+        0x2C,             // INC L
+        0x36, 0x11,       // LD (HL), 0x11
+        0x2C,             // INC L
+        0x36, 0xC9,       // LD (HL), 0xC9    (RET)
+        0xCD, 0x00, 0xC0, // CALL 0xC000
+        0x3E, 0x22,       // LD A, 0x22
+        0xEA, 0x01, 0xC0, // LD (0xC001), A
+        0xCD, 0x00, 0xC0, // CALL 0xC000
+    };
+    test_machine_init(&gb, prog, sizeof(prog));
+    gb.decode_enabled = true;
+
+    for (int i = 0; i < 9; i++)
+        cpu_step(&gb);
+    ck_assert_uint_eq(gb.cpu.b, 0x11);
+
+    for (int i = 0; i < 5; i++)
+        cpu_step(&gb);
+    ck_assert_uint_eq(gb.cpu.b, 0x22);
+
+    CpuDecodeStats stats;
+    cpu_decode_get_stats(&gb, &stats);
+    ck_assert_uint_eq(stats.invalidations, 1);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+// ============================================================================
+// Lazy Flag Tests
+// ============================================================================
+// Every flag-setting instruction runs from WRAM followed by
+//   PUSH AF; JR NZ, +2; LD D, 1; JR NC, +2; LD E, 1; JR -2
+// in one cpu_run() call, so F is only ever read through the lazy state: by
+// PUSH AF (all of F) & by the branches (Z & C). Both are compared with F as
+// the removed eager code computed it, written out again here.
+
+#define LAZY_PROG 0xC000
+#define LAZY_STACK 0xD000
+
+#define REF_FLAGS(z, n, h, c)                                                                      \
+    (u8)(((z) ? FLAG_Z : 0) | ((n) ? FLAG_N : 0) | ((h) ? FLAG_H : 0) | ((c) ? FLAG_C : 0))
+
+typedef struct {
+    u8  a, b, f;
+    u16 hl, sp;
+} LazyState;
+
+// Instructions are their bytes, little-endian: 0x80 is ADD A, B, 0x10CB is
+// RL B, 0x05E8 is ADD SP, 5
+static void eager_step(LazyState *s, u16 insn) {
+    u8   op  = insn & 0xFF;
+    u8   imm = insn >> 8;
+    u8   a   = s->a;
+    u8   b   = s->b;
+    u8   f   = s->f;
+    bool c   = f & FLAG_C;
+
+    switch (op) {
+        case 0x00: // NOP
+            return;
+        case 0x04: // INC B
+            s->b = b + 1;
+            s->f = (f & FLAG_C) | REF_FLAGS(s->b == 0, 0, check_half_carry_add(b, 1), 0);
+            return;
+        case 0x05: // DEC B
+            s->b = b - 1;
+            s->f = (f & FLAG_C) | REF_FLAGS(s->b == 0, 1, check_half_carry_sub(b, 1), 0);
+            return;
+        case 0x07: // RLCA
+            s->a = (u8)(a << 1) | (a >> 7);
+            s->f = REF_FLAGS(0, 0, 0, a & 0x80);
+            return;
+        case 0x0F: // RRCA
+            s->a = (u8)(a >> 1) | (u8)(a << 7);
+            s->f = REF_FLAGS(0, 0, 0, a & 0x01);
+            return;
+        case 0x17: // RLA
+            s->a = (u8)(a << 1) | c;
+            s->f = REF_FLAGS(0, 0, 0, a & 0x80);
+            return;
+        case 0x1F: // RRA
+            s->a = (a >> 1) | (c ? 0x80 : 0);
+            s->f = REF_FLAGS(0, 0, 0, a & 0x01);
+            return;
+        case 0x27: { // DAA
+            bool n = f & FLAG_N;
+            s->a   = adjust_bcd(a, n, c, f & FLAG_H);
+            s->f   = REF_FLAGS(s->a == 0, n, 0, c || (!n && a > 0x99));
+            return;
+        }
+        case 0x2F: // CPL
+            s->a = ~a;
+            s->f = f | FLAG_N | FLAG_H;
+            return;
+        case 0x37: // SCF
+            s->f = (f & FLAG_Z) | FLAG_C;
+            return;
+        case 0x3F: // CCF
+            s->f = (f & FLAG_Z) | (c ? 0 : FLAG_C);
+            return;
+        case 0x09: { // ADD HL, BC (C is 0)
+            u16 bc = MAKE_U16(b, 0);
+            s->f   = (f & FLAG_Z) | REF_FLAGS(0, 0, check_half_carry_add_u16(s->hl, bc),
+                                              check_carry_add_u16(s->hl, bc));
+            s->hl += bc;
+            return;
+        }
+        case 0xE8: // ADD SP, e8
+        case 0xF8: { // LD HL, SP + e8
+            u8  sp_lo = GET_LOW_BYTE(s->sp);
+            u16 sum   = (u16)(s->sp + sign_extend_i8(imm));
+            s->f = REF_FLAGS(0, 0, check_half_carry_add(sp_lo, imm), check_carry_add(sp_lo, imm));
+            if (op == 0xE8)
+                s->sp = sum;
+            else
+                s->hl = sum;
+            return;
+        }
+        case 0x80: // ADD A, B
+            s->a = a + b;
+            s->f = REF_FLAGS(s->a == 0, 0, check_half_carry_add(a, b), check_carry_add(a, b));
+            return;
+        case 0x88: // ADC A, B
+            s->a = a + b + c;
+            s->f = REF_FLAGS(s->a == 0, 0, (a & 0x0F) + (b & 0x0F) + c > 0x0F, a + b + c > 0xFF);
+            return;
+        case 0x90: // SUB B
+            s->a = a - b;
+            s->f = REF_FLAGS(s->a == 0, 1, check_half_carry_sub(a, b), check_carry_sub(a, b));
+            return;
+        case 0x98: // SBC A, B
+            s->a = a - b - c;
+            s->f = REF_FLAGS(s->a == 0, 1, (a & 0x0F) < (b & 0x0F) + c, a < b + c);
+            return;
+        case 0xA0: // AND B
+            s->a = a & b;
+            s->f = REF_FLAGS(s->a == 0, 0, 1, 0);
+            return;
+        case 0xA8: // XOR B
+            s->a = a ^ b;
+            s->f = REF_FLAGS(s->a == 0, 0, 0, 0);
+            return;
+        case 0xB0: // OR B
+            s->a = a | b;
+            s->f = REF_FLAGS(s->a == 0, 0, 0, 0);
+            return;
+        case 0xB8: // CP B
+            s->f = REF_FLAGS(a == b, 1, check_half_carry_sub(a, b), check_carry_sub(a, b));
+            return;
+        case 0xCB:
+            break;
+        default:
+            ck_abort_msg("no reference for opcode %02X", op);
+    }
+
+    // CB xx on B
+    u8 res;
+    switch (imm & 0xF8) {
+        case 0x00: // RLC
+            res = (u8)(b << 1) | (b >> 7);
+            break;
+        case 0x08: // RRC
+            res = (u8)(b >> 1) | (u8)(b << 7);
+            break;
+        case 0x10: // RL
+            res = (u8)(b << 1) | c;
+            break;
+        case 0x18: // RR
+            res = (b >> 1) | (c ? 0x80 : 0);
+            break;
+        case 0x20: // SLA
+            res = (u8)(b << 1);
+            break;
+        case 0x28: // SRA
+            res = (b >> 1) | (b & 0x80);
+            break;
+        case 0x30: // SWAP
+            res = (u8)(b << 4) | (b >> 4);
+            break;
+        case 0x38: // SRL
+            res = b >> 1;
+            break;
+        default: // BIT n
+            s->f = (f & FLAG_C) | REF_FLAGS(!CHECK_BIT(b, (imm >> 3) & 7), 0, 1, 0);
+            return;
+    }
+    bool out = (imm & 0x08) ? b & 0x01 : b & 0x80; // Right or left
+    s->b     = res;
+    s->f     = REF_FLAGS(res == 0, 0, 0, (imm & 0xF8) == 0x30 ? 0 : out);
+}
+
+// Write `first`, `second` & the flag readers to WRAM
+static void lazy_load(GameBoy *gb, u16 first, u16 second) {
+    static const u8 tail[] = {0xF5, 0x20, 0x02, 0x16, 0x01, 0x30, 0x02, 0x1E, 0x01, 0x18, 0xFE};
+    u16             insns[2] = {first, second};
+    u16             addr     = LAZY_PROG;
+
+    for (int i = 0; i < 2; i++) {
+        mmu_write(gb, addr++, insns[i] & 0xFF);
+        if (cpu_op_length[insns[i] & 0xFF] == 2)
+            mmu_write(gb, addr++, insns[i] >> 8);
+    }
+    for (size_t i = 0; i < sizeof(tail); i++)
+        mmu_write(gb, addr++, tail[i]);
+}
+
+// Run the loaded program from state `in` & compare with `first` then
+// `second` evaluated eagerly
+static void lazy_check(GameBoy *gb, LazyState in, u16 first, u16 second) {
+    CPU      *cpu  = &gb->cpu;
+    LazyState want = in;
+    eager_step(&want, first);
+    eager_step(&want, second);
+
+    cpu->a  = in.a;
+    cpu->b  = in.b;
+    cpu->c  = 0;
+    cpu->f  = in.f;
+    cpu->d  = 0;
+    cpu->e  = 0;
+    cpu->sp = in.sp;
+    cpu->pc = LAZY_PROG;
+    cpu_set_hl(cpu, in.hl);
+    cpu_run(gb, 200);
+
+    u8 pushed = mmu_read(gb, cpu->sp); // PUSH AF: F below A
+    if (pushed != want.f || cpu->f != want.f || cpu->a != want.a || cpu->b != want.b ||
+        cpu->d != !!(want.f & FLAG_Z) || cpu->e != !!(want.f & FLAG_C) ||
+        cpu_get_hl(cpu) != want.hl || cpu->sp + 2 != want.sp)
+        ck_abort_msg("%04X, %04X from A=%02X B=%02X F=%02X HL=%04X SP=%04X: "
+                     "A=%02X B=%02X F=%02X/%02X D=%u E=%u HL=%04X SP=%04X, expected "
+                     "A=%02X B=%02X F=%02X HL=%04X SP=%04X",
+                     first, second, in.a, in.b, in.f, in.hl, in.sp, cpu->a, cpu->b, pushed,
+                     cpu->f, cpu->d, cpu->e, cpu_get_hl(cpu), cpu->sp + 2, want.a, want.b, want.f,
+                     want.hl, want.sp);
+}
+
+static const u16 lazy_alu[] = {0x80, 0x88, 0x90, 0x98, 0xA0, 0xA8, 0xB0, 0xB8};
+
+// One-operand instructions (on A or B) & the CB group
+static const u16 lazy_unary[] = {
+    0x04,   0x05,   0x07,   0x0F,   0x17,   0x1F,   0x27,   0x2F,   0x37,   0x3F,   0x00CB,
+    0x08CB, 0x10CB, 0x18CB, 0x20CB, 0x28CB, 0x30CB, 0x38CB, 0x40CB, 0x58CB, 0x78CB,
+};
+
+START_TEST(test_lazy_flags_alu) {
+    GameBoy gb;
+    u8      prog[] = {0x00};
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    // Every A, operand & carry in
+    for (size_t i = 0; i < sizeof(lazy_alu) / sizeof(lazy_alu[0]); i++) {
+        lazy_load(&gb, lazy_alu[i], 0x00);
+        for (u32 ab = 0; ab < 0x10000; ab++)
+            for (u8 f = 0; f < 2; f++) {
+                LazyState in = {ab >> 8, ab & 0xFF, f ? 0xF0 : 0x00, 0, LAZY_STACK};
+                lazy_check(&gb, in, lazy_alu[i], 0x00);
+            }
+    }
+
+    // Every value & F in
+    for (size_t i = 0; i < sizeof(lazy_unary) / sizeof(lazy_unary[0]); i++) {
+        lazy_load(&gb, lazy_unary[i], 0x00);
+        for (u32 v = 0; v < 0x100; v++)
+            for (u32 f = 0; f < 0x100; f += 0x10) {
+                LazyState in = {v, v ^ 0x5A, f, 0, LAZY_STACK};
+                lazy_check(&gb, in, lazy_unary[i], 0x00);
+            }
+    }
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_lazy_flags_chained) {
+    // Each kind of lazy state, then whatever reads or keeps part of it
+    static const u8 values[] = {0x00, 0x01, 0x0F, 0x10, 0x1F, 0x7F, 0x80,
+                                0x90, 0x99, 0x9A, 0xF0, 0xFE, 0xFF};
+    GameBoy         gb;
+    u8              prog[] = {0x00};
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    size_t n_alu   = sizeof(lazy_alu) / sizeof(lazy_alu[0]);
+    size_t n_unary = sizeof(lazy_unary) / sizeof(lazy_unary[0]);
+    size_t n_vals  = sizeof(values);
+
+    for (size_t i = 0; i < n_alu + n_unary + 2; i++) {
+        u16 first = i < n_alu ? lazy_alu[i] : i < n_alu + n_unary ? lazy_unary[i - n_alu] : 0x09;
+        if (i == n_alu + n_unary + 1)
+            first = 0x85E8; // ADD SP, -123
+
+        for (size_t j = 0; j < n_alu + n_unary; j++) {
+            u16 second = j < n_alu ? lazy_alu[j] : lazy_unary[j - n_alu];
+            lazy_load(&gb, first, second);
+
+            for (size_t x = 0; x < n_vals; x++)
+                for (size_t y = 0; y < n_vals; y++) {
+                    LazyState in = {values[x], values[y], (u8)((x + y) << 4),
+                                    MAKE_U16(values[y], values[x]), LAZY_STACK | values[x]};
+                    lazy_check(&gb, in, first, second);
+                }
+        }
+    }
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_lazy_flags_16bit) {
+    GameBoy gb;
+    u8      prog[] = {0x00};
+    test_machine_init(&gb, prog, sizeof(prog));
+
+    // ADD SP, e8 & LD HL, SP + e8: every low byte of SP & every offset
+    for (u32 imm = 0; imm < 0x100; imm++) {
+        lazy_load(&gb, (u16)(imm << 8 | 0xE8), 0x00);
+        for (u32 lo = 0; lo < 0x100; lo++) {
+            LazyState in = {0x12, 0x34, 0xF0, 0x0000, (u16)(LAZY_STACK | lo)};
+            lazy_check(&gb, in, (u16)(imm << 8 | 0xE8), 0x00);
+        }
+        lazy_load(&gb, (u16)(imm << 8 | 0xF8), 0x00);
+        for (u32 lo = 0; lo < 0x100; lo++) {
+            LazyState in = {0x12, 0x34, 0x00, 0xFFFF, (u16)(LAZY_STACK | lo)};
+            lazy_check(&gb, in, (u16)(imm << 8 | 0xF8), 0x00);
+        }
+    }
+
+    // ADD HL, BC: every B, HL in steps of 0xF7 (carries out of bits 11 & 15 both ways)
+    lazy_load(&gb, 0x09, 0x00);
+    for (u32 hl = 0; hl < 0x10000; hl += 0xF7)
+        for (u32 b = 0; b < 0x100; b++)
+            for (u8 f = 0; f < 2; f++) {
+                LazyState in = {0x00, b, f ? 0xF0 : 0x00, hl, LAZY_STACK};
+                lazy_check(&gb, in, 0x09, 0x00);
+            }
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+// ============================================================================
+// Trace Tests
+// ============================================================================
+
+START_TEST(test_trace_records) {
+    GameBoy gb;
+    u8      prog[] = {
+        0x3E, 0x42,       // LD A, 0x42
+        0x01, 0x34, 0x12, // LD BC, 0x1234
+        0x18, 0xFE,       // JR -2 (forever)
+    };
+    char path[] = "/tmp/baredmg_trace_XXXXXX";
+    int  fd     = mkstemp(path);
+    ck_assert_int_ge(fd, 0);
+    close(fd);
+
+    test_machine_init(&gb, prog, sizeof(prog));
+    ck_assert(trace_start(&gb, path));
+
+    // Several times around the ring
+    const u32 steps = 3 * TRACE_RING_RECORDS + 123;
+    for (u32 i = 0; i < steps; i++)
+        cpu_step(&gb);
+    ck_assert(trace_stop(&gb));
+    ck_assert_ptr_null(gb.trace);
+
+    FILE           *f = fopen(path, "rb");
+    TraceFileHeader header;
+    TraceRecord     r[3], last;
+    ck_assert_ptr_nonnull(f);
+    ck_assert_uint_eq(fread(&header, sizeof(header), 1, f), 1);
+    ck_assert_str_eq(header.magic, TRACE_MAGIC);
+    ck_assert_uint_eq(header.record_size, sizeof(TraceRecord));
+    ck_assert_uint_eq(fread(r, sizeof(TraceRecord), 3, f), 3);
+
+    // State before each instruction, bytes at pc
+    ck_assert_uint_eq(r[0].pc, 0x0100);
+    ck_assert_uint_eq(r[0].a, 0x01);
+    ck_assert_uint_eq(r[0].length, 2);
+    ck_assert_uint_eq(r[1].pc, 0x0102);
+    ck_assert_uint_eq(r[1].a, 0x42);
+    ck_assert_uint_eq(r[1].cycles, r[0].cycles + 8);
+    ck_assert_uint_eq(r[2].b, 0x12);
+    ck_assert_uint_eq(r[2].bank, 0);
+
+    char line[128];
+    trace_format(&r[1], TRACE_DOCTOR, line, sizeof(line));
+    ck_assert_str_eq(line, "A:42 F:B0 B:00 C:13 D:00 E:D8 H:01 L:4D SP:FFFE PC:0102 "
+                           "PCMEM:01,34,12,18");
+
+    // Every instruction is there, in order
+    ck_assert_int_eq(fseek(f, -(long)sizeof(TraceRecord), SEEK_END), 0);
+    ck_assert_uint_eq(fread(&last, sizeof(last), 1, f), 1);
+    ck_assert_uint_eq(ftell(f), sizeof(header) + (long)steps * sizeof(TraceRecord));
+    ck_assert_uint_eq(last.pc, 0x0105);
+    ck_assert_uint_eq(last.cycles, gb.cycles - 12);
+
+    fclose(f);
+    unlink(path);
+    test_machine_free(&gb);
+}
+END_TEST
+
+// ============================================================================
+// Test Suite Setup
+// ============================================================================
+
+Suite *cpu_suite(void) {
+    Suite *s;
+    TCase *tc_load, *tc_alu, *tc_cb, *tc_flow, *tc_irq, *tc_decode, *tc_lazy, *tc_trace;
+
+    s       = suite_create("CPU");
+
+    // Loads & registers
+    tc_load = tcase_create("Loads");
+    tcase_add_test(tc_load, test_reset_state);
+    tcase_add_test(tc_load, test_ld_immediate);
+    tcase_add_test(tc_load, test_ld_hl_inc_dec);
+    suite_add_tcase(s, tc_load);
+
+    // ALU
+    tc_alu = tcase_create("ALU");
+    tcase_add_test(tc_alu, test_add_flags);
+    tcase_add_test(tc_alu, test_adc_sbc);
+    tcase_add_test(tc_alu, test_sub_cp);
+    tcase_add_test(tc_alu, test_inc_dec_keep_carry);
+    tcase_add_test(tc_alu, test_add_hl_and_sp);
+    tcase_add_test(tc_alu, test_daa);
+    suite_add_tcase(s, tc_alu);
+
+    // CB prefix
+    tc_cb = tcase_create("CB Prefix");
+    tcase_add_test(tc_cb, test_cb_ops);
+    suite_add_tcase(s, tc_cb);
+
+    // Control flow & timing
+    tc_flow = tcase_create("Control Flow");
+    tcase_add_test(tc_flow, test_jr_cycles);
+    tcase_add_test(tc_flow, test_call_ret_push_pop);
+    tcase_add_test(tc_flow, test_run_budget);
+    tcase_add_test(tc_flow, test_illegal_opcode_locks);
+    suite_add_tcase(s, tc_flow);
+
+    // Interrupts & HALT
+    tc_irq = tcase_create("Interrupts");
+    tcase_add_test(tc_irq, test_interrupt_dispatch);
+    tcase_add_test(tc_irq, test_halt_wakeup);
+    tcase_add_test(tc_irq, test_halt_fast_forward);
+    tcase_add_test(tc_irq, test_halt_bug);
+    suite_add_tcase(s, tc_irq);
+
+    // Decode cache
+    tc_decode = tcase_create("Decode Cache");
+    tcase_add_test(tc_decode, test_decode_cache_hits);
+    tcase_add_test(tc_decode, test_decode_cache_off_by_default);
+    tcase_add_test(tc_decode, test_decode_cache_ram_invalidation);
+    suite_add_tcase(s, tc_decode);
+
+    // Lazy flags against eager evaluation
+    tc_lazy = tcase_create("Lazy Flags");
+    tcase_add_test(tc_lazy, test_lazy_flags_alu);
+    tcase_add_test(tc_lazy, test_lazy_flags_chained);
+    tcase_add_test(tc_lazy, test_lazy_flags_16bit);
+    suite_add_tcase(s, tc_lazy);
+
+    // Instruction trace
+    tc_trace = tcase_create("Trace");
+    tcase_add_test(tc_trace, test_trace_records);
+    suite_add_tcase(s, tc_trace);
+
+    return s;
+}
+
+int main(void) {
+    int      number_failed;
+    Suite   *s;
+    SRunner *sr;
+
+    s  = cpu_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
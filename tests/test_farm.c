@@ -0,0 +1,159 @@
+// tests/test_farm.c
+#include <check.h>
+#include <frontend/headless.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_machine.h"
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+#define INSTANCES 24
+
+// 32 KB ROM-only image whose program fills tile data with a sequence
+// depending on `seed`
+static void make_rom(u8 *rom, u8 seed) {
+    const u8 program[] = {
+        0x3E, seed,       // LD A, seed
+        0x21, 0x00, 0x80, // LD HL, 0x8000
+        0x22,             // loop: LD (HL+), A
+        0xC6, 0x35,       // ADD A, 0x35
+        0xAD,             // XOR L
+        0x47,             // LD B, A
+        0x7C,             // LD A, H
+        0xFE, 0x98,       // CP 0x98
+        0x78,             // LD A, B
+        0x20, 0xF5,       // JR NZ, loop
+        0x21, 0x00, 0x80, // LD HL, 0x8000
+        0x18, 0xF0,       // JR loop
+    };
+
+    test_rom_build(rom, TEST_ROM_SIZE, 0x00, 0x00, program, sizeof(program));
+}
+
+// INSTANCES machines, every other one through the JIT (if available)
+static void setup(GameBoy **gbs, FarmJob *jobs, u64 frames, u64 cycles) {
+    u8 *rom = malloc(TEST_ROM_SIZE);
+
+    for (int i = 0; i < INSTANCES; i++) {
+        make_rom(rom, (u8)(i * 37));
+        gbs[i] = malloc(sizeof(GameBoy));
+        gb_init(gbs[i]);
+        gbs[i]->jit_enabled = (i & 1) && cpu_jit_available();
+        ck_assert(gb_load_rom_buffer(gbs[i], rom, TEST_ROM_SIZE));
+        jobs[i] = (FarmJob){gbs[i], frames, cycles};
+    }
+    free(rom);
+}
+
+static void teardown(GameBoy **gbs) {
+    for (int i = 0; i < INSTANCES; i++) {
+        gb_unload(gbs[i]);
+        free(gbs[i]);
+    }
+}
+
+// ============================================================================
+// Farm Tests
+// ============================================================================
+
+START_TEST(test_farm_thread_count_invariant) {
+    static const int threads[] = {1, 2, 3, 5, 8, 64};
+    GameBoy         *gbs[INSTANCES];
+    FarmJob          jobs[INSTANCES];
+    u64              ref[INSTANCES];
+
+    // Reference: every job on this thread, no pool
+    setup(gbs, jobs, 3, 0);
+    for (int i = 0; i < INSTANCES; i++) {
+        farm_run_job(&jobs[i]);
+        ref[i] = farm_digest(gbs[i]);
+    }
+    teardown(gbs);
+
+    // Different seeds give different machines, so the comparison means something
+    ck_assert_uint_ne(ref[0], ref[2]);
+
+    for (size_t t = 0; t < sizeof(threads) / sizeof(threads[0]); t++) {
+        FarmOptions opt = {.threads = threads[t], .pin = t & 1};
+        FarmStats   stats;
+
+        setup(gbs, jobs, 3, 0);
+        ck_assert_int_eq(farm_run(jobs, INSTANCES, &opt, &stats), 0);
+        ck_assert_int_eq(stats.threads, threads[t] < INSTANCES ? threads[t] : INSTANCES);
+
+        for (int i = 0; i < INSTANCES; i++)
+            ck_assert_msg(farm_digest(gbs[i]) == ref[i], "instance %d differs with %d threads", i,
+                          threads[t]);
+        teardown(gbs);
+    }
+}
+END_TEST
+
+START_TEST(test_farm_budgets) {
+    GameBoy *gbs[INSTANCES];
+    FarmJob  jobs[INSTANCES];
+
+    // Cycle budget: every instance stops within one instruction of it
+    setup(gbs, jobs, 0, 10000);
+    ck_assert_int_eq(farm_run(jobs, INSTANCES, &(FarmOptions){.threads = 4}, NULL), 0);
+    for (int i = 0; i < INSTANCES; i++) {
+        ck_assert_uint_ge(gbs[i]->cycles, 10000);
+        ck_assert_uint_lt(gbs[i]->cycles, 10000 + 24);
+    }
+    teardown(gbs);
+
+    // Frame budget: runs end at frame boundaries (plus the last instruction)
+    setup(gbs, jobs, 2, 0);
+    ck_assert_int_eq(farm_run(jobs, INSTANCES, NULL, NULL), 0);
+    for (int i = 0; i < INSTANCES; i++) {
+        ck_assert_uint_ge(gbs[i]->cycles, 2 * CYCLES_PER_FRAME);
+        ck_assert_uint_lt(gbs[i]->cycles, 2 * CYCLES_PER_FRAME + 24);
+    }
+    teardown(gbs);
+}
+END_TEST
+
+START_TEST(test_farm_empty) {
+    FarmStats stats;
+    ck_assert_int_eq(farm_run(NULL, 0, &(FarmOptions){.threads = 8}, &stats), 0);
+    ck_assert_int_eq(stats.threads, 1);
+    ck_assert_uint_eq(stats.steals, 0);
+}
+END_TEST
+
+// ============================================================================
+// Test Suite
+// ============================================================================
+
+Suite *farm_suite(void) {
+    Suite *s;
+    TCase *tc_farm;
+
+    s = suite_create("Farm");
+
+    tc_farm = tcase_create("Farm");
+    tcase_set_timeout(tc_farm, 30);
+    tcase_add_test(tc_farm, test_farm_thread_count_invariant);
+    tcase_add_test(tc_farm, test_farm_budgets);
+    tcase_add_test(tc_farm, test_farm_empty);
+    suite_add_tcase(s, tc_farm);
+
+    return s;
+}
+
+int main(void) {
+    int      number_failed;
+    Suite   *s;
+    SRunner *sr;
+
+    s  = farm_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
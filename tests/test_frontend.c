@@ -0,0 +1,150 @@
+// tests/test_frontend.c
+#include <check.h>
+#include <frontend/frontend.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+#define FRAME_PIXELS (SCREEN_HEIGHT * SCREEN_WIDTH)
+
+// Draw frame n: every pixel holds n
+static void draw(FrameExchange *fx, u32 n) {
+    FrameSlot *slot = frame_exchange_back(fx);
+    for (int i = 0; i < FRAME_PIXELS; i++)
+        slot->pixels[i] = n;
+}
+
+// Whole frame: every pixel the same as the first & the serial
+static bool whole(const FrameSlot *slot) {
+    for (int i = 0; i < FRAME_PIXELS; i++)
+        if (slot->pixels[i] != (u32)slot->serial)
+            return false;
+    return true;
+}
+
+// ============================================================================
+// Frame Exchange Tests
+// ============================================================================
+
+START_TEST(test_frame_exchange_swap) {
+    FrameExchange *fx = malloc(sizeof(FrameExchange));
+    frame_exchange_init(fx);
+
+    // Nothing published: a blank slot
+    const FrameSlot *slot = frame_exchange_acquire(fx);
+    ck_assert_uint_eq(slot->serial, 0);
+
+    // Published frames come out whole, the newest one wins
+    draw(fx, 1);
+    frame_exchange_publish(fx);
+    slot = frame_exchange_acquire(fx);
+    ck_assert_uint_eq(slot->serial, 1);
+    ck_assert(whole(slot));
+
+    draw(fx, 2);
+    frame_exchange_publish(fx);
+    draw(fx, 3);
+    frame_exchange_publish(fx);
+    slot = frame_exchange_acquire(fx);
+    ck_assert_uint_eq(slot->serial, 3);
+    ck_assert(whole(slot));
+    ck_assert_uint_eq(fx->skipped, 1);
+
+    // Nothing new: the same slot again
+    ck_assert_ptr_eq(frame_exchange_acquire(fx), slot);
+
+    // The producer never draws into the slot being shown
+    for (u32 n = 4; n < 20; n++) {
+        ck_assert_ptr_ne(frame_exchange_back(fx), slot);
+        draw(fx, n);
+        frame_exchange_publish(fx);
+        if (n % 3 == 0)
+            slot = frame_exchange_acquire(fx);
+    }
+    ck_assert(whole(slot));
+    ck_assert_uint_eq(fx->published, 19);
+
+    free(fx);
+}
+END_TEST
+
+#define EXCHANGE_FRAMES 3000
+
+static void *frame_producer(void *arg) {
+    FrameExchange *fx = arg;
+
+    for (u32 n = 1; n <= EXCHANGE_FRAMES; n++) {
+        draw(fx, n);
+        frame_exchange_publish(fx);
+        if (n % 8 == 0)
+            sched_yield();
+    }
+    return NULL;
+}
+
+START_TEST(test_frame_exchange_threads) {
+    FrameExchange *fx = malloc(sizeof(FrameExchange));
+    pthread_t      producer;
+    u64            last = 0;
+    u32            torn = 0, backwards = 0, shown = 0;
+
+    frame_exchange_init(fx);
+    pthread_create(&producer, NULL, frame_producer, fx);
+
+    // Whatever the interleaving: whole frames, never an older one
+    while (last < EXCHANGE_FRAMES) {
+        const FrameSlot *slot = frame_exchange_acquire(fx);
+        if (slot->serial == last) {
+            sched_yield();
+            continue;
+        }
+        torn      += !whole(slot);
+        backwards += slot->serial < last;
+        last       = slot->serial;
+        shown++;
+    }
+
+    pthread_join(producer, NULL);
+    ck_assert_uint_eq(torn, 0);
+    ck_assert_uint_eq(backwards, 0);
+    ck_assert_uint_eq(shown + fx->skipped, EXCHANGE_FRAMES);
+    free(fx);
+}
+END_TEST
+
+// ============================================================================
+// Test Suite
+// ============================================================================
+
+Suite *frontend_suite(void) {
+    Suite *s;
+    TCase *tc_frames;
+
+    s         = suite_create("Frontend");
+
+    tc_frames = tcase_create("Frame Exchange");
+    tcase_add_test(tc_frames, test_frame_exchange_swap);
+    tcase_add_test(tc_frames, test_frame_exchange_threads);
+    suite_add_tcase(s, tc_frames);
+
+    return s;
+}
+
+int main(void) {
+    int      number_failed;
+    Suite   *s;
+    SRunner *sr;
+
+    s  = frontend_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
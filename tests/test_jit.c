@@ -0,0 +1,544 @@
+// tests/test_jit.c
+#include <check.h>
+#include <gbemu.h>
+#include <core/bus.h>
+#include <core/cpu.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_machine.h"
+
+// ============================================================================
+// Helpers
+// ============================================================================
+// Every test runs the same program on two machines, one through the
+// interpreter and one through the JIT, and checks that they never diverge.
+
+static void assert_same(const GameBoy *ref, const GameBoy *jit) {
+    const CPU *a = &ref->cpu;
+    const CPU *b = &jit->cpu;
+
+    ck_assert_uint_eq(a->pc, b->pc);
+    ck_assert_uint_eq(a->sp, b->sp);
+    ck_assert_uint_eq(cpu_get_af(a), cpu_get_af(b));
+    ck_assert_uint_eq(cpu_get_bc(a), cpu_get_bc(b));
+    ck_assert_uint_eq(cpu_get_de(a), cpu_get_de(b));
+    ck_assert_uint_eq(cpu_get_hl(a), cpu_get_hl(b));
+    ck_assert_int_eq(a->ime, b->ime);
+    ck_assert_int_eq(a->ime_pending, b->ime_pending);
+    ck_assert_int_eq(a->halted, b->halted);
+    ck_assert_int_eq(a->locked, b->locked);
+    ck_assert_uint_eq(a->instructions, b->instructions);
+    ck_assert_uint_eq(ref->cycles, jit->cycles);
+    ck_assert_uint_eq(ref->if_register, jit->if_register);
+    ck_assert_uint_eq(ref->ie_register, jit->ie_register);
+    ck_assert_int_eq(memcmp(ref->wram, jit->wram, sizeof(ref->wram)), 0);
+    ck_assert_int_eq(memcmp(ref->vram, jit->vram, sizeof(ref->vram)), 0);
+    ck_assert_int_eq(memcmp(ref->hram, jit->hram, sizeof(ref->hram)), 0);
+}
+
+// xorshift32: deterministic programs on every host
+static u32 rng_next(u32 *state) {
+    u32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+// Random opcode that keeps the CPU running (no STOP/HALT/illegal opcodes)
+static u8 random_opcode(u32 *rng) {
+    for (;;) {
+        u8 op = (u8)rng_next(rng);
+        switch (op) {
+            case 0x10:
+            case 0x76:
+            case 0xD3:
+            case 0xDB:
+            case 0xDD:
+            case 0xE3:
+            case 0xE4:
+            case 0xEB:
+            case 0xEC:
+            case 0xED:
+            case 0xF4:
+            case 0xFC:
+            case 0xFD:
+                continue;
+            default:
+                return op;
+        }
+    }
+}
+
+// ============================================================================
+// Targeted Tests
+// ============================================================================
+
+START_TEST(test_straight_line_block) {
+    if (!cpu_jit_available())
+        return;
+
+    GameBoy ref, jit;
+    u8      prog[] = {
+        0x3E, 0x0F,       // LD A, 0x0F
+        0x06, 0x01,       // LD B, 0x01
+        0x80,             // ADD A, B     (H)
+        0x21, 0x00, 0xC0, // LD HL, 0xC000
+        0x22,             // LD (HL+), A
+        0x2F,             // CPL
+        0x77,             // LD (HL), A
+        0x23,             // INC HL
+        0x37,             // SCF
+        0xCE, 0x10,       // ADC A, 0x10
+        0x18, 0xFE,       // JR -2 (loop forever)
+    };
+    test_machine_init(&ref, prog, sizeof(prog));
+    test_machine_init(&jit, prog, sizeof(prog));
+    jit.jit_enabled = true;
+
+    cpu_run(&ref, 200);
+    cpu_jit_run(&jit, 200);
+    assert_same(&ref, &jit);
+
+    CpuJitStats stats;
+    cpu_jit_get_stats(&jit, &stats);
+    ck_assert_uint_gt(stats.blocks_compiled, 0);
+    ck_assert_uint_gt(stats.blocks_executed, 0);
+
+    test_machine_free(&ref);
+    test_machine_free(&jit);
+}
+END_TEST
+
+START_TEST(test_setup_failure_sticky) {
+    // Once setting the JIT up has failed, it is not tried again: the machine
+    // runs in the interpreter & stays in step with a plain one
+    GameBoy ref, jit;
+    u8      prog[] = {0x04, 0x0C, 0x18, 0xFC}; // INC B; INC C; JR -4
+    test_machine_init(&ref, prog, sizeof(prog));
+    test_machine_init(&jit, prog, sizeof(prog));
+    jit.jit_enabled = true;
+    jit.jit_failed  = true;
+
+    for (int i = 0; i < 4; i++) {
+        cpu_run(&ref, 100);
+        cpu_jit_run(&jit, 100);
+        assert_same(&ref, &jit);
+    }
+    ck_assert_ptr_null(jit.jit);
+    ck_assert(!jit.jit_enabled);
+
+    test_machine_free(&ref);
+    test_machine_free(&jit);
+}
+END_TEST
+
+START_TEST(test_self_modifying_code) {
+    if (!cpu_jit_available())
+        return;
+
+    // Copy `INC B; RET` to WRAM, call it, patch it to `DEC B; RET`, call it again
+    GameBoy ref, jit;
+    u8      prog[] = {
+        0x21, 0x00, 0xC0, // LD HL, 0xC000
+        0x36, 0x04,       // LD (HL), 0x04    (INC B)
+        0x2C,             // INC L
+        0x36, 0xC9,       // LD (HL), 0xC9    (RET)
+        0x06, 0x10,       // LD B, 0x10
+        0xCD, 0x00, 0xC0, // CALL 0xC000      (B = 0x11)
+        0x3E, 0x05,       // LD A, 0x05       (DEC B)
+        0xEA, 0x00, 0xC0, // LD (0xC000), A
+        0xCD, 0x00, 0xC0, // CALL 0xC000      (B = 0x10)
+        0xCD, 0x00, 0xC0, // CALL 0xC000      (B = 0x0F)
+        0x18, 0xFE,       // JR -2
+    };
+    test_machine_init(&ref, prog, sizeof(prog));
+    test_machine_init(&jit, prog, sizeof(prog));
+
+    cpu_run(&ref, 500);
+    cpu_jit_run(&jit, 500);
+    assert_same(&ref, &jit);
+    ck_assert_uint_eq(jit.cpu.b, 0x0F);
+
+    CpuJitStats stats;
+    cpu_jit_get_stats(&jit, &stats);
+    ck_assert_uint_gt(stats.invalidations, 0);
+
+    test_machine_free(&ref);
+    test_machine_free(&jit);
+}
+END_TEST
+
+START_TEST(test_budget_boundary) {
+    if (!cpu_jit_available())
+        return;
+
+    // A long block must not run past the budget: both backends stop at the
+    // same instruction for every budget
+    GameBoy ref, jit;
+    u8      prog[] = {0x04, 0x0C, 0x14, 0x1C, 0x24, 0x2C, 0x3C, 0x00,
+                      0x01, 0x00, 0x00, 0x11, 0x00, 0x00, 0xC3, 0x00, 0x01};
+
+    for (u32 budget = 1; budget < 120; budget++) {
+        test_machine_init(&ref, prog, sizeof(prog));
+        test_machine_init(&jit, prog, sizeof(prog));
+
+        cpu_run(&ref, budget);
+        cpu_jit_run(&jit, budget);
+        assert_same(&ref, &jit);
+
+        test_machine_free(&ref);
+        test_machine_free(&jit);
+    }
+}
+END_TEST
+
+START_TEST(test_timer_interrupt_lockstep) {
+    if (!cpu_jit_available())
+        return;
+
+    // Blocks must stop at scheduler deadlines so timer interrupts land on the
+    // same instruction in both backends
+    GameBoy ref, jit;
+    u8      prog[] = {
+        0x3E, 0x05,       // LD A, 0x05
+        0xE0, 0x07,       // LDH (TAC), A   ; 262144 Hz
+        0x3E, 0x04,       // LD A, INT_TIMER
+        0xE0, 0xFF,       // LDH (IE), A
+        0xFB,             // EI
+        0x04,             // loop: INC B
+        0x14,             //       INC D
+        0x18, 0xFC,       //       JR loop
+    };
+    u8      isr[] = {0x0C, 0xD9}; // INC C; RETI
+
+    test_machine_init(&ref, prog, sizeof(prog));
+    test_machine_init(&jit, prog, sizeof(prog));
+    memcpy(ref.cart.rom + 0x50, isr, sizeof(isr));
+    memcpy(jit.cart.rom + 0x50, isr, sizeof(isr));
+
+    for (u32 budget = 1; ref.cycles < 200000; budget = budget * 7 % 1000 + 1) {
+        cpu_run(&ref, budget);
+        cpu_jit_run(&jit, budget);
+        assert_same(&ref, &jit);
+    }
+    ck_assert_uint_gt(ref.cpu.c, 0);
+
+    test_machine_free(&ref);
+    test_machine_free(&jit);
+}
+END_TEST
+
+START_TEST(test_stack_halt_lockstep) {
+    if (!cpu_jit_available())
+        return;
+
+    // PUSH/POP, the SP arithmetic & (HL) read-modify-writes with the stack in
+    // HRAM (every push takes the slow path), then HALT until the timer fires
+    GameBoy ref, jit;
+    u8      prog[] = {
+        0x31, 0xFE, 0xFF, // LD SP, 0xFFFE
+        0x3E, 0x05,       // LD A, 0x05
+        0xE0, 0x07,       // LDH (TAC), A   ; 262144 Hz
+        0x3E, 0x04,       // LD A, INT_TIMER
+        0xE0, 0xFF,       // LDH (IE), A
+        0xFB,             // EI
+        0x01, 0x34, 0x12, // loop: LD BC, 0x1234
+        0xC5,             //       PUSH BC
+        0xF1,             //       POP AF
+        0xF5,             //       PUSH AF
+        0xD1,             //       POP DE
+        0xE8, 0xFE,       //       ADD SP, -2
+        0xF8, 0x03,       //       LD HL, SP + 3
+        0x08, 0x00, 0xC0, //       LD (0xC000), SP
+        0x21, 0x00, 0xC0, //       LD HL, 0xC000
+        0x34,             //       INC (HL)
+        0xCB, 0x16,       //       RL (HL)
+        0xCB, 0x46,       //       BIT 0, (HL)
+        0xCB, 0xFE,       //       SET 7, (HL)
+        0x27,             //       DAA
+        0x39,             //       ADD HL, SP
+        0xE8, 0x02,       //       ADD SP, 2
+        0x76,             //       HALT
+        0x18, 0xE1,       //       JR loop
+    };
+    u8      isr[] = {0x0C, 0xD9}; // INC C; RETI
+
+    test_machine_init(&ref, prog, sizeof(prog));
+    test_machine_init(&jit, prog, sizeof(prog));
+    memcpy(ref.cart.rom + 0x50, isr, sizeof(isr));
+    memcpy(jit.cart.rom + 0x50, isr, sizeof(isr));
+
+    for (u32 budget = 1; ref.cycles < 200000; budget = budget * 7 % 1000 + 1) {
+        cpu_run(&ref, budget);
+        cpu_jit_run(&jit, budget);
+        assert_same(&ref, &jit);
+    }
+    ck_assert_uint_gt(ref.cpu.c, 0);
+
+    CpuJitStats stats;
+    cpu_jit_get_stats(&jit, &stats);
+    ck_assert_uint_gt(stats.blocks_executed, 0);
+
+    test_machine_free(&ref);
+    test_machine_free(&jit);
+}
+END_TEST
+
+// ============================================================================
+// Exhaustive Flag Tests
+// ============================================================================
+// The translator takes Z/H/C from the host flags, so check every ALU op for
+// every operand pair & carry-in against the interpreter.
+
+START_TEST(test_alu_flags_exhaustive) {
+    if (!cpu_jit_available())
+        return;
+
+    for (u8 alu = 0; alu < 8; alu++) {
+        GameBoy ref, jit;
+        u8      prog[] = {(u8)(0x80 | (alu << 3)), 0x18, 0xFD}; // ALU A, B; JR -3
+        test_machine_init(&ref, prog, sizeof(prog));
+        test_machine_init(&jit, prog, sizeof(prog));
+
+        for (u32 i = 0; i < 0x20000; i++) {
+            u8 a = i & 0xFF, b = (i >> 8) & 0xFF, f = (i & 0x10000) ? FLAG_C : 0;
+
+            ref.cpu.a = jit.cpu.a = a;
+            ref.cpu.b = jit.cpu.b = b;
+            ref.cpu.f = jit.cpu.f = f;
+
+            // ALU + JR: one block, 16 cycles
+            cpu_run(&ref, 16);
+            cpu_jit_run(&jit, 16);
+
+            if (ref.cpu.a != jit.cpu.a || ref.cpu.f != jit.cpu.f)
+                ck_abort_msg("ALU op %u: A=%02X B=%02X F=%02X -> ref %02X/%02X, jit %02X/%02X",
+                             alu, a, b, f, ref.cpu.a, ref.cpu.f, jit.cpu.a, jit.cpu.f);
+        }
+
+        assert_same(&ref, &jit);
+        test_machine_free(&ref);
+        test_machine_free(&jit);
+    }
+}
+END_TEST
+
+START_TEST(test_inc_dec_flags_exhaustive) {
+    if (!cpu_jit_available())
+        return;
+
+    for (u8 dec = 0; dec < 2; dec++) {
+        GameBoy ref, jit;
+        u8      prog[] = {dec ? 0x3D : 0x3C, 0x18, 0xFD}; // INC/DEC A; JR -3
+        test_machine_init(&ref, prog, sizeof(prog));
+        test_machine_init(&jit, prog, sizeof(prog));
+
+        for (u32 i = 0; i < 0x1000; i++) {
+            u8 a = i & 0xFF, f = (u8)((i >> 8) << 4);
+
+            ref.cpu.a = jit.cpu.a = a;
+            ref.cpu.f = jit.cpu.f = f;
+
+            cpu_run(&ref, 16);
+            cpu_jit_run(&jit, 16);
+
+            if (ref.cpu.a != jit.cpu.a || ref.cpu.f != jit.cpu.f)
+                ck_abort_msg("%s A=%02X F=%02X -> ref %02X/%02X, jit %02X/%02X",
+                             dec ? "DEC" : "INC", a, f, ref.cpu.a, ref.cpu.f, jit.cpu.a,
+                             jit.cpu.f);
+        }
+
+        test_machine_free(&ref);
+        test_machine_free(&jit);
+    }
+}
+END_TEST
+
+// Rotates, shifts, SWAP & BIT (on B), the A rotates & DAA run through C
+// helpers that build F themselves: every value & flag combination
+START_TEST(test_cb_daa_flags_exhaustive) {
+    if (!cpu_jit_available())
+        return;
+
+    u8 ops[21][2];
+    u32 count = 0;
+    for (u32 cb = 0x00; cb < 0x80; cb += 8) {
+        ops[count][0]   = 0xCB;
+        ops[count++][1] = (u8)cb;
+    }
+    for (u32 op = 0x07; op <= 0x27; op += 8) {
+        ops[count][0]   = (u8)op; // RLCA, RRCA, RLA, RRA, DAA
+        ops[count++][1] = 0x00;   // NOP
+    }
+
+    for (u32 n = 0; n < count; n++) {
+        GameBoy ref, jit;
+        u8      prog[] = {ops[n][0], ops[n][1], 0x18, 0xFC}; // op; JR -4
+        test_machine_init(&ref, prog, sizeof(prog));
+        test_machine_init(&jit, prog, sizeof(prog));
+
+        for (u32 i = 0; i < 0x1000; i++) {
+            u8 val = i & 0xFF, f = (u8)((i >> 8) << 4);
+
+            ref.cpu.a = jit.cpu.a = val;
+            ref.cpu.b = jit.cpu.b = val;
+            ref.cpu.f = jit.cpu.f = f;
+
+            // 8 cycles (CB op, or A op + NOP) + JR: one block
+            cpu_run(&ref, 20);
+            cpu_jit_run(&jit, 20);
+
+            if (ref.cpu.a != jit.cpu.a || ref.cpu.b != jit.cpu.b || ref.cpu.f != jit.cpu.f)
+                ck_abort_msg("%02X %02X: A=B=%02X F=%02X -> ref %02X/%02X/%02X, jit %02X/%02X/%02X",
+                             ops[n][0], ops[n][1], val, f, ref.cpu.a, ref.cpu.b, ref.cpu.f,
+                             jit.cpu.a, jit.cpu.b, jit.cpu.f);
+        }
+
+        assert_same(&ref, &jit);
+        test_machine_free(&ref);
+        test_machine_free(&jit);
+    }
+}
+END_TEST
+
+// ============================================================================
+// Lockstep Tests
+// ============================================================================
+
+// Random code in ROM & WRAM with random budgets & interrupts
+START_TEST(test_random_programs_lockstep) {
+    if (!cpu_jit_available())
+        return;
+
+    for (u32 seed = 1; seed <= 64; seed++) {
+        GameBoy ref, jit;
+        u32     rng   = seed * 2654435761u;
+        u8      nop[] = {0x00};
+
+        test_machine_init(&ref, nop, sizeof(nop));
+        test_machine_init(&jit, nop, sizeof(nop));
+
+        for (u32 addr = 0x0100; addr < 0x8000; addr++)
+            ref.cart.rom[addr] = jit.cart.rom[addr] = random_opcode(&rng);
+        for (u32 addr = 0; addr < sizeof(ref.wram); addr++)
+            ref.wram[addr] = jit.wram[addr] = random_opcode(&rng);
+
+        ref.ie_register = jit.ie_register = (u8)rng_next(&rng) & INT_MASK;
+
+        for (int slice = 0; slice < 64; slice++) {
+            u32 budget = 1 + rng_next(&rng) % 4000;
+
+            if ((rng_next(&rng) & 7) == 0) {
+                u8 irq = (u8)BIT(rng_next(&rng) % 5);
+                cpu_request_interrupt(&ref, irq);
+                cpu_request_interrupt(&jit, irq);
+            }
+
+            cpu_run(&ref, budget);
+            cpu_jit_run(&jit, budget);
+            assert_same(&ref, &jit);
+
+            if (ref.cpu.locked)
+                break;
+        }
+
+        test_machine_free(&ref);
+        test_machine_free(&jit);
+    }
+}
+END_TEST
+
+// Whole ROMs from $BAREDMG_TEST_ROMS (e.g. Blargg's cpu_instrs), skipped if unset
+START_TEST(test_rom_dir_lockstep) {
+    const char *dir_path = getenv("BAREDMG_TEST_ROMS");
+    if (!dir_path || !cpu_jit_available())
+        return;
+
+    DIR *dir = opendir(dir_path);
+    ck_assert_ptr_nonnull(dir);
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        size_t len = strlen(entry->d_name);
+        if (len < 4 || strcmp(entry->d_name + len - 3, ".gb") != 0)
+            continue;
+
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s", dir_path, entry->d_name);
+
+        GameBoy ref, jit;
+        gb_init(&ref);
+        gb_init(&jit);
+        gb_load_rom(&ref, path);
+        gb_load_rom(&jit, path);
+        jit.jit_enabled = true;
+
+        for (int frame = 0; frame < 600 && ref.running; frame++) {
+            gb_run_frame(&ref);
+            gb_run_frame(&jit);
+            assert_same(&ref, &jit);
+        }
+
+        gb_unload(&ref);
+        gb_unload(&jit);
+    }
+
+    closedir(dir);
+}
+END_TEST
+
+// ============================================================================
+// Test Suite Setup
+// ============================================================================
+
+Suite *jit_suite(void) {
+    Suite *s;
+    TCase *tc_blocks, *tc_flags, *tc_lockstep;
+
+    s = suite_create("JIT");
+
+    // Block translation
+    tc_blocks = tcase_create("Blocks");
+    tcase_add_test(tc_blocks, test_straight_line_block);
+    tcase_add_test(tc_blocks, test_setup_failure_sticky);
+    tcase_add_test(tc_blocks, test_self_modifying_code);
+    tcase_add_test(tc_blocks, test_budget_boundary);
+    tcase_add_test(tc_blocks, test_timer_interrupt_lockstep);
+    tcase_add_test(tc_blocks, test_stack_halt_lockstep);
+    suite_add_tcase(s, tc_blocks);
+
+    // Host flag mapping
+    tc_flags = tcase_create("Flags");
+    tcase_add_test(tc_flags, test_alu_flags_exhaustive);
+    tcase_add_test(tc_flags, test_inc_dec_flags_exhaustive);
+    tcase_add_test(tc_flags, test_cb_daa_flags_exhaustive);
+    tcase_set_timeout(tc_flags, 60);
+    suite_add_tcase(s, tc_flags);
+
+    // Interpreter vs JIT
+    tc_lockstep = tcase_create("Lockstep");
+    tcase_add_test(tc_lockstep, test_random_programs_lockstep);
+    tcase_add_test(tc_lockstep, test_rom_dir_lockstep);
+    tcase_set_timeout(tc_lockstep, 120);
+    suite_add_tcase(s, tc_lockstep);
+
+    return s;
+}
+
+int main(void) {
+    int      number_failed;
+    Suite   *s;
+    SRunner *sr;
+
+    s  = jit_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
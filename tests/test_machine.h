@@ -0,0 +1,88 @@
+// tests/test_machine.h
+// Shared fixture for the tests & benchmarks: machines that drive the core
+// directly & ROM images for the ones that load a cartridge
+#ifndef TEST_MACHINE_H
+#define TEST_MACHINE_H
+
+#include <gbemu.h>
+#include <core/bus.h>
+#include <core/cpu.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_ROM_SIZE 0x8000
+
+// Build a 32 KB ROM-only machine with `program` (NULL: all NOPs) at 0x0100,
+// the post-boot PC. Only the CPU is reset; the caller resets what else it uses.
+static inline void test_machine_init(GameBoy *gb, const u8 *program, size_t len) {
+    gb_init(gb);
+    gb->cart.rom      = calloc(1, TEST_ROM_SIZE);
+    gb->cart.rom_size = TEST_ROM_SIZE;
+    if (program)
+        memcpy(gb->cart.rom + 0x0100, program, len);
+    mmu_map_init(gb);
+    cpu_reset(&gb->cpu);
+}
+
+// Release everything the machine picked up (ROM, decode cache, JIT, trace)
+static inline void test_machine_free(GameBoy *gb) {
+    gb_unload(gb);
+}
+
+// Header checksum (0x014D) over 0x0134 - 0x014C, as the boot ROM checks it
+static inline void test_rom_checksum(u8 *rom) {
+    u8 checksum = 0;
+    for (u16 addr = 0x0134; addr <= 0x014C; addr++)
+        checksum = checksum - rom[addr] - 1;
+    rom[0x014D] = checksum;
+}
+
+// Zeroed `size`-byte image of cart `type` with RAM code `ram_code`, a valid
+// header checksum and `program` (NULL: none) at 0x0150 behind a JP 0x0150
+// at the entry point
+static inline void test_rom_build(u8 *rom, size_t size, u8 type, u8 ram_code, const u8 *program,
+                                  size_t len) {
+    memset(rom, 0, size);
+    rom[0x0100] = 0xC3; // JP 0x0150
+    rom[0x0101] = 0x50;
+    rom[0x0102] = 0x01;
+    rom[0x0147] = type;
+    rom[0x0149] = ram_code;
+    if (program)
+        memcpy(rom + 0x0150, program, len);
+    test_rom_checksum(rom);
+}
+
+// 32 KB ROM + 8 KB RAM image for the save state & rewind tests. The program
+// copies a routine to WRAM that rewrites its own immediate (starting at
+// `seed`) on every call, stores the results to VRAM & cart RAM & runs the
+// timer, so restoring a state has to bring back memory, the PPU, the timer
+// and any code decoded or translated from WRAM.
+static inline void test_rom_build_smc(u8 *rom, u8 seed) {
+    const u8 program[] = {
+        0x21, 0x00, 0xC0, // LD HL, 0xC000
+        0x36, 0x3E, 0x23, // LD (HL), 0x3E ; INC HL   (LD A, n)
+        0x36, seed, 0x23, // LD (HL), seed ; INC HL
+        0x36, 0x3C, 0x23, // LD (HL), 0x3C ; INC HL   (INC A)
+        0x36, 0xEA, 0x23, // LD (HL), 0xEA ; INC HL   (LD (0xC001), A)
+        0x36, 0x01, 0x23, // LD (HL), 0x01 ; INC HL
+        0x36, 0xC0, 0x23, // LD (HL), 0xC0 ; INC HL
+        0x36, 0xC9,       // LD (HL), 0xC9            (RET)
+        0x3E, 0x05,       // LD A, 0x05
+        0xE0, 0x07,       // LDH (0x07), A            (TAC: timer on)
+        0x11, 0x00, 0x80, // LD DE, 0x8000
+        0xCD, 0x00, 0xC0, // loop: CALL 0xC000
+        0x12,             // LD (DE), A
+        0xEA, 0x00, 0xA0, // LD (0xA000), A
+        0x13,             // INC DE
+        0x7A,             // LD A, D
+        0xFE, 0x98,       // CP 0x98
+        0x20, 0xF3,       // JR NZ, loop
+        0x11, 0x00, 0x80, // LD DE, 0x8000
+        0x18, 0xEE,       // JR loop
+    };
+
+    test_rom_build(rom, TEST_ROM_SIZE, 0x08, 0x02, program, sizeof(program)); // ROM + RAM, 8 KB
+}
+
+#endif // TEST_MACHINE_H
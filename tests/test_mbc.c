@@ -0,0 +1,411 @@
+// tests/test_mbc.c
+#include <check.h>
+#include <gbemu.h>
+#include <core/bus.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_machine.h"
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+#define BANK_SIZE 0x4000
+
+// ROM of `banks` 16 KB banks; every bank starts with its number (lo, hi)
+static u8 *make_rom(size_t banks, u8 type, u8 ram_code) {
+    u8 *rom = malloc(banks * BANK_SIZE);
+
+    test_rom_build(rom, banks * BANK_SIZE, type, ram_code, NULL, 0);
+    for (size_t b = 0; b < banks; b++) {
+        rom[b * BANK_SIZE + 0] = (u8)b;
+        rom[b * BANK_SIZE + 1] = (u8)(b >> 8);
+    }
+    return rom;
+}
+
+static GameBoy *load(size_t banks, u8 type, u8 ram_code) {
+    GameBoy *gb  = malloc(sizeof(GameBoy));
+    u8      *rom = make_rom(banks, type, ram_code);
+
+    gb_init(gb);
+    ck_assert(gb_load_rom_buffer(gb, rom, banks * BANK_SIZE));
+    free(rom);
+    return gb;
+}
+
+static void unload(GameBoy *gb) {
+    gb_unload(gb);
+    free(gb);
+}
+
+// Bank number shown at 0x4000 (or 0x0000), read through the page table
+static u16 bank_at(GameBoy *gb, u16 window) {
+    return mmu_read16(gb, window);
+}
+
+// ============================================================================
+// MBC1 Tests
+// ============================================================================
+
+START_TEST(test_mbc1_rom_banks) {
+    GameBoy *gb = load(128, 0x01, 0x00); // 2 MB
+
+    ck_assert_int_eq(gb->cart.mbc.type, MBC_1);
+    ck_assert_uint_eq(bank_at(gb, 0x4000), 1);
+
+    // Switching only moves the page table: reads stay direct
+    mmu_write(gb, 0x2000, 5);
+    ck_assert_uint_eq(bank_at(gb, 0x4000), 5);
+    ck_assert(gb->read_map[0x40] == gb->cart.rom + 5 * BANK_SIZE);
+    ck_assert(gb->read_map[0x7F] == gb->cart.rom + 6 * BANK_SIZE - 0x100);
+
+    // Bank 0 selects 1; only 5 bits count
+    mmu_write(gb, 0x3FFF, 0);
+    ck_assert_uint_eq(bank_at(gb, 0x4000), 1);
+    mmu_write(gb, 0x2000, 0x23);
+    ck_assert_uint_eq(bank_at(gb, 0x4000), 3);
+
+    // Upper bits from 0x4000 - 0x5FFF
+    mmu_write(gb, 0x4000, 2);
+    ck_assert_uint_eq(bank_at(gb, 0x4000), 0x43);
+    ck_assert_uint_eq(bank_at(gb, 0x0000), 0);
+
+    // Mode 1: they bank 0x0000 - 0x3FFF too
+    mmu_write(gb, 0x6000, 1);
+    ck_assert_uint_eq(bank_at(gb, 0x0000), 0x40);
+    ck_assert_uint_eq(bank_at(gb, 0x4000), 0x43);
+    mmu_write(gb, 0x6000, 0);
+    ck_assert_uint_eq(bank_at(gb, 0x0000), 0);
+
+    unload(gb);
+
+    // Banks past the end of the ROM wrap
+    gb = load(8, 0x01, 0x00); // 128 KB
+    mmu_write(gb, 0x2000, 0x0B);
+    ck_assert_uint_eq(bank_at(gb, 0x4000), 3);
+    unload(gb);
+}
+END_TEST
+
+START_TEST(test_mbc1_ram) {
+    GameBoy *gb = load(4, 0x02, 0x03); // MBC1+RAM, 32 KB RAM
+
+    // Disabled at power-on: open bus, writes dropped
+    ck_assert(gb->read_map[0xA0] == NULL);
+    mmu_write(gb, 0xA000, 0x11);
+    ck_assert_uint_eq(mmu_read(gb, 0xA000), 0xFF);
+    ck_assert_uint_eq(gb->cart.ram[0], 0);
+
+    // Enabled: bank 0, direct
+    mmu_write(gb, 0x0000, 0x0A);
+    ck_assert(gb->read_map[0xA0] == gb->cart.ram);
+    mmu_write(gb, 0xA000, 0x11);
+    ck_assert_uint_eq(gb->cart.ram[0], 0x11);
+
+    // RAM banks need mode 1
+    mmu_write(gb, 0x4000, 2);
+    ck_assert_uint_eq(mmu_read(gb, 0xA000), 0x11);
+    mmu_write(gb, 0x6000, 1);
+    ck_assert(gb->read_map[0xA0] == gb->cart.ram + 2 * 0x2000);
+    mmu_write(gb, 0xBFFF, 0x22);
+    ck_assert_uint_eq(gb->cart.ram[3 * 0x2000 - 1], 0x22);
+    mmu_write(gb, 0x6000, 0);
+    ck_assert_uint_eq(mmu_read(gb, 0xA000), 0x11);
+
+    // Anything but 0x0A in the low nibble disables it again
+    mmu_write(gb, 0x1FFF, 0x1B);
+    ck_assert(gb->read_map[0xA0] == NULL);
+    ck_assert_uint_eq(mmu_read(gb, 0xA000), 0xFF);
+    unload(gb);
+}
+END_TEST
+
+// ============================================================================
+// MBC2 Tests
+// ============================================================================
+
+START_TEST(test_mbc2) {
+    GameBoy *gb = load(16, 0x05, 0x00);
+
+    ck_assert_int_eq(gb->cart.mbc.type, MBC_2);
+    ck_assert_uint_eq(gb->cart.ram_size, MBC2_RAM_SIZE);
+
+    // Address bit 8 set: ROM bank (4 bits)
+    mmu_write(gb, 0x2100, 0x13);
+    ck_assert_uint_eq(bank_at(gb, 0x4000), 3);
+    mmu_write(gb, 0x0100, 0);
+    ck_assert_uint_eq(bank_at(gb, 0x4000), 1);
+
+    // Address bit 8 clear: RAM enable (no bank change)
+    mmu_write(gb, 0x0000, 0x0A);
+    ck_assert_uint_eq(bank_at(gb, 0x4000), 1);
+
+    // 4-bit cells, upper nibble reads as 1s, mirrored every 512 bytes
+    mmu_write(gb, 0xA000, 0x5C);
+    ck_assert_uint_eq(gb->cart.ram[0], 0x0C);
+    ck_assert_uint_eq(mmu_read(gb, 0xA000), 0xFC);
+    ck_assert_uint_eq(mmu_read(gb, 0xA200), 0xFC);
+    ck_assert_uint_eq(mmu_read(gb, 0xBE00), 0xFC);
+
+    mmu_write(gb, 0x0000, 0x00);
+    ck_assert_uint_eq(mmu_read(gb, 0xA000), 0xFF);
+    unload(gb);
+}
+END_TEST
+
+// ============================================================================
+// MBC3 Tests
+// ============================================================================
+
+static u8 rtc_read(GameBoy *gb, u8 reg) {
+    mmu_write(gb, 0x4000, reg);
+    return mmu_read(gb, 0xA000);
+}
+
+static void rtc_write(GameBoy *gb, u8 reg, u8 value) {
+    mmu_write(gb, 0x4000, reg);
+    mmu_write(gb, 0xA000, value);
+}
+
+static void rtc_latch(GameBoy *gb) {
+    mmu_write(gb, 0x6000, 0x00);
+    mmu_write(gb, 0x6000, 0x01);
+}
+
+START_TEST(test_mbc3_banks) {
+    GameBoy *gb = load(128, 0x12, 0x03); // MBC3+RAM, 2 MB, 32 KB RAM
+
+    // 7-bit ROM bank
+    mmu_write(gb, 0x2000, 0x7F);
+    ck_assert_uint_eq(bank_at(gb, 0x4000), 0x7F);
+    mmu_write(gb, 0x2000, 0x00);
+    ck_assert_uint_eq(bank_at(gb, 0x4000), 1);
+
+    // RAM banks 0 - 3, no mode register
+    mmu_write(gb, 0x0000, 0x0A);
+    mmu_write(gb, 0x4000, 3);
+    mmu_write(gb, 0xA123, 0x33);
+    ck_assert_uint_eq(gb->cart.ram[3 * 0x2000 + 0x123], 0x33);
+
+    // No clock on this cart: registers 0x08 - 0x0C show nothing
+    ck_assert_uint_eq(rtc_read(gb, 0x08), 0xFF);
+    unload(gb);
+}
+END_TEST
+
+START_TEST(test_mbc3_rtc) {
+    GameBoy *gb = load(4, 0x10, 0x02); // MBC3+TIMER+RAM+BATTERY
+
+    ck_assert(gb->cart.mbc.has_rtc);
+    mmu_write(gb, 0x0000, 0x0A);
+
+    // Set 0d 23:59:58, latch: reads hold still until the next latch
+    rtc_write(gb, 0x08, 58);
+    rtc_write(gb, 0x09, 59);
+    rtc_write(gb, 0x0A, 23);
+    rtc_latch(gb);
+    ck_assert_uint_eq(rtc_read(gb, 0x08), 58);
+    ck_assert_uint_eq(rtc_read(gb, 0x09), 59);
+    ck_assert(gb->read_map[0xA0] == NULL);
+
+    // Three emulated seconds later: day 1, 00:00:01
+    gb->cycles += 3 * CPU_CLOCK_HZ;
+    ck_assert_uint_eq(rtc_read(gb, 0x08), 58);
+    rtc_latch(gb);
+    ck_assert_uint_eq(rtc_read(gb, 0x08), 1);
+    ck_assert_uint_eq(rtc_read(gb, 0x09), 0);
+    ck_assert_uint_eq(rtc_read(gb, 0x0A), 0);
+    ck_assert_uint_eq(rtc_read(gb, 0x0B), 1);
+
+    // Halted: time doesn't count
+    rtc_write(gb, 0x0C, 0x40);
+    gb->cycles += 10 * CPU_CLOCK_HZ;
+    rtc_latch(gb);
+    ck_assert_uint_eq(rtc_read(gb, 0x08), 1);
+
+    // Day 511 -> 0 sets the carry bit
+    rtc_write(gb, 0x0B, 0xFF);
+    rtc_write(gb, 0x0A, 23);
+    rtc_write(gb, 0x09, 59);
+    rtc_write(gb, 0x08, 59);
+    rtc_write(gb, 0x0C, 0x01);
+    gb->cycles += CPU_CLOCK_HZ;
+    rtc_latch(gb);
+    ck_assert_uint_eq(rtc_read(gb, 0x0B), 0);
+    ck_assert_uint_eq(rtc_read(gb, 0x0C), 0x80);
+
+    // RAM banks still work next to the clock
+    mmu_write(gb, 0x4000, 0x00);
+    mmu_write(gb, 0xA000, 0x44);
+    ck_assert_uint_eq(gb->cart.ram[0], 0x44);
+    unload(gb);
+}
+END_TEST
+
+// ============================================================================
+// MBC5 Tests
+// ============================================================================
+
+START_TEST(test_mbc5) {
+    GameBoy *gb = load(512, 0x1A, 0x04); // MBC5+RAM, 8 MB, 128 KB RAM
+
+    ck_assert_int_eq(gb->cart.mbc.type, MBC_5);
+    ck_assert_uint_eq(bank_at(gb, 0x4000), 1);
+
+    // 9-bit ROM bank in two registers; bank 0 is allowed
+    mmu_write(gb, 0x2000, 0x23);
+    mmu_write(gb, 0x3000, 0x01);
+    ck_assert_uint_eq(bank_at(gb, 0x4000), 0x123);
+    mmu_write(gb, 0x2000, 0x00);
+    ck_assert_uint_eq(bank_at(gb, 0x4000), 0x100);
+    mmu_write(gb, 0x3000, 0x00);
+    ck_assert_uint_eq(bank_at(gb, 0x4000), 0);
+
+    // 16 RAM banks
+    mmu_write(gb, 0x0000, 0x0A);
+    mmu_write(gb, 0x4000, 0x0F);
+    mmu_write(gb, 0xA000, 0x55);
+    ck_assert_uint_eq(gb->cart.ram[15 * 0x2000], 0x55);
+    unload(gb);
+}
+END_TEST
+
+// ============================================================================
+// Machine Tests
+// ============================================================================
+
+// Bank 0 calls a routine at 0x4000 in banks 1 - 7 in turn & stores what
+// each returns to WRAM, forever. Every bank's routine is `LD A, bank * 3; RET`.
+static u8 *make_banked_program(void) {
+    static const u8 program[] = {
+        0x21, 0x00, 0xC0, // start: LD HL, 0xC000
+        0x06, 0x01,       // LD B, 1
+        0x78,             // loop: LD A, B
+        0xEA, 0x00, 0x20, // LD (0x2000), A
+        0xCD, 0x00, 0x40, // CALL 0x4000
+        0x22,             // LD (HL+), A
+        0x04,             // INC B
+        0x78,             // LD A, B
+        0xFE, 0x08,       // CP 8
+        0x20, 0xF3,       // JR NZ, loop
+        0x18, 0xEC,       // JR start
+    };
+    u8 *rom = malloc(8 * BANK_SIZE);
+
+    test_rom_build(rom, 8 * BANK_SIZE, 0x01, 0x00, program, sizeof(program)); // MBC1
+    for (int b = 1; b < 8; b++) {
+        rom[b * BANK_SIZE + 0] = 0x3E; // LD A, b * 3
+        rom[b * BANK_SIZE + 1] = (u8)(b * 3);
+        rom[b * BANK_SIZE + 2] = 0xC9; // RET
+    }
+    return rom;
+}
+
+START_TEST(test_mbc_code_in_banks) {
+    u8 *rom = make_banked_program();
+
+    // Plain interpreter, then with the decode cache, then the JIT. The cache
+    // & the JIT both key code by host address, so the same guest address in
+    // another bank is other code
+    for (int mode = 0; mode < 3; mode++) {
+        GameBoy *gb = malloc(sizeof(GameBoy));
+        gb_init(gb);
+        gb->decode_enabled = mode == 1;
+        gb->jit_enabled    = mode == 2 && cpu_jit_available();
+        ck_assert(gb_load_rom_buffer(gb, rom, 8 * BANK_SIZE));
+
+        for (int frame = 0; frame < 2; frame++) {
+            gb_run_frame(gb);
+            for (int b = 1; b < 8; b++)
+                ck_assert_uint_eq(gb->wram[b - 1], b * 3);
+        }
+        unload(gb);
+    }
+    free(rom);
+}
+END_TEST
+
+START_TEST(test_mbc_save_state) {
+    GameBoy *gb    = load(16, 0x03, 0x03); // MBC1+RAM+BATTERY, 32 KB RAM
+    GameBoy *fresh = load(16, 0x03, 0x03);
+
+    mmu_write(gb, 0x2000, 7);
+    mmu_write(gb, 0x0000, 0x0A);
+    mmu_write(gb, 0x6000, 1);
+    mmu_write(gb, 0x4000, 2);
+    mmu_write(gb, 0xA000, 0x77);
+
+    size_t size  = gb_state_size(gb);
+    u8    *state = malloc(size);
+    ck_assert_uint_eq(gb_save_state(gb, state, size), size);
+
+    // Banks come back with the registers, mapped
+    mmu_write(gb, 0x2000, 2);
+    mmu_write(gb, 0x4000, 0);
+    mmu_write(gb, 0x0000, 0x00);
+    ck_assert_int_eq(gb_load_state(gb, state, size), GB_STATE_OK);
+    ck_assert_uint_eq(bank_at(gb, 0x4000), 7);
+    ck_assert(gb->read_map[0xA0] == gb->cart.ram + 2 * 0x2000);
+    ck_assert_uint_eq(mmu_read(gb, 0xA000), 0x77);
+
+    ck_assert_int_eq(gb_load_state(fresh, state, size), GB_STATE_OK);
+    ck_assert_uint_eq(bank_at(fresh, 0x4000), 7);
+    ck_assert_uint_eq(mmu_read(fresh, 0xA000), 0x77);
+
+    free(state);
+    unload(gb);
+    unload(fresh);
+}
+END_TEST
+
+// ============================================================================
+// Test Suite
+// ============================================================================
+
+Suite *mbc_suite(void) {
+    Suite *s;
+    TCase *tc_mbc1, *tc_mbc2, *tc_mbc3, *tc_mbc5, *tc_machine;
+
+    s       = suite_create("MBC");
+
+    tc_mbc1 = tcase_create("MBC1");
+    tcase_add_test(tc_mbc1, test_mbc1_rom_banks);
+    tcase_add_test(tc_mbc1, test_mbc1_ram);
+    suite_add_tcase(s, tc_mbc1);
+
+    tc_mbc2 = tcase_create("MBC2");
+    tcase_add_test(tc_mbc2, test_mbc2);
+    suite_add_tcase(s, tc_mbc2);
+
+    tc_mbc3 = tcase_create("MBC3");
+    tcase_add_test(tc_mbc3, test_mbc3_banks);
+    tcase_add_test(tc_mbc3, test_mbc3_rtc);
+    suite_add_tcase(s, tc_mbc3);
+
+    tc_mbc5 = tcase_create("MBC5");
+    tcase_add_test(tc_mbc5, test_mbc5);
+    suite_add_tcase(s, tc_mbc5);
+
+    tc_machine = tcase_create("Machine");
+    tcase_add_test(tc_machine, test_mbc_code_in_banks);
+    tcase_add_test(tc_machine, test_mbc_save_state);
+    suite_add_tcase(s, tc_machine);
+
+    return s;
+}
+
+int main(void) {
+    int      number_failed;
+    Suite   *s;
+    SRunner *sr;
+
+    s  = mbc_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
@@ -2,7 +2,9 @@
 #include <check.h>
 #include <gbemu.h>
 #include <core/bus.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <unistd.h>
 
 // ============================================================================
 // WRAM Tests
@@ -136,13 +138,272 @@ START_TEST(test_ie_register) {
 }
 END_TEST
 
+// ============================================================================
+// Page Table Tests
+// ============================================================================
+
+START_TEST(test_page_table_rom_mapped) {
+    GameBoy gb = {0};
+    gb_init(&gb);
+
+    gb.cart.rom         = calloc(1, 0x10000);
+    gb.cart.rom_size    = 0x10000;
+    gb.cart.rom[0x0150] = 0x12;
+    gb.cart.rom[0x4000] = 0x34;
+    gb.cart.rom[0x8000] = 0x56; // First byte of bank 2
+    mmu_map_init(&gb);
+
+    // ROM pages now have direct pointers
+    ck_assert(gb.read_map[0x01] == gb.cart.rom + 0x0100);
+    ck_assert(gb.write_map[0x01] == NULL);
+    ck_assert_uint_eq(mmu_read(&gb, 0x0150), 0x12);
+    ck_assert_uint_eq(mmu_read(&gb, 0x4000), 0x34);
+
+    // Switching the ROM window only updates the table
+    mmu_map_rom_bank(&gb, 0x4000, 0x8000);
+    ck_assert_uint_eq(mmu_read(&gb, 0x4000), 0x56);
+    ck_assert_uint_eq(mmu_read(&gb, 0x0150), 0x12);
+
+    free(gb.cart.rom);
+}
+END_TEST
+
+START_TEST(test_page_table_slow_pages) {
+    GameBoy gb = {0};
+    gb_init(&gb);
+
+    // OAM, unusable, I/O & HRAM always take the slow path
+    ck_assert(gb.read_map[0xFE] == NULL);
+    ck_assert(gb.read_map[0xFF] == NULL);
+    ck_assert(gb.write_map[0xFF] == NULL);
+
+    // Plain RAM pages are mapped
+    ck_assert(gb.read_map[0xC0] == gb.wram);
+    ck_assert(gb.write_map[0xFD] == gb.wram + 0x1D00);
+    ck_assert(gb.read_map[0x80] == gb.vram);
+}
+END_TEST
+
+START_TEST(test_read_write16) {
+    GameBoy gb = {0};
+    gb_init(&gb);
+
+    // Same page
+    mmu_write16(&gb, 0xC010, 0xBEEF);
+    ck_assert_uint_eq(mmu_read(&gb, 0xC010), 0xEF);
+    ck_assert_uint_eq(mmu_read(&gb, 0xC011), 0xBE);
+    ck_assert_uint_eq(mmu_read16(&gb, 0xC010), 0xBEEF);
+
+    // Straddling two pages
+    mmu_write16(&gb, 0xC0FF, 0x1234);
+    ck_assert_uint_eq(mmu_read(&gb, 0xC0FF), 0x34);
+    ck_assert_uint_eq(mmu_read(&gb, 0xC100), 0x12);
+    ck_assert_uint_eq(mmu_read16(&gb, 0xC0FF), 0x1234);
+
+    // Both bytes on the slow path (HRAM -> IE)
+    mmu_write16(&gb, 0xFFFE, 0xA55A);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFFFE), 0x5A);
+    ck_assert_uint_eq(gb.ie_register, 0xA5);
+}
+END_TEST
+
+START_TEST(test_fast_matches_slow) {
+    GameBoy gb = {0};
+    gb_init(&gb);
+
+    gb.cart.rom      = malloc(0x8000);
+    gb.cart.rom_size = 0x8000;
+    gb.cart.ram      = calloc(1, 0x2000);
+    gb.cart.ram_size = 0x2000;
+    for (u32 i = 0; i < 0x8000; i++)
+        gb.cart.rom[i] = (u8)(i * 7);
+    mmu_map_init(&gb);
+
+    for (u32 addr = 0; addr < 0x10000; addr++)
+        mmu_write(&gb, addr, (u8)(addr ^ (addr >> 8)));
+
+    // The table must never disagree with the address-decoding slow path
+    for (u32 addr = 0; addr < 0x10000; addr++)
+        ck_assert_uint_eq(mmu_read(&gb, addr), mmu_read_slow(&gb, addr));
+
+    free(gb.cart.rom);
+    free(gb.cart.ram);
+}
+END_TEST
+
+// ============================================================================
+// Battery RAM Tests
+// ============================================================================
+
+START_TEST(test_battery_ram_dirty_pages) {
+    char    path[] = "/tmp/baredmg_savXXXXXX";
+    GameBoy gb     = {0};
+    gb_init(&gb);
+
+    int fd = mkstemp(path);
+    ck_assert_int_ge(fd, 0);
+    close(fd);
+
+    // 32 KB of NOPs & 8 KB of RAM backed by the save file
+    gb.cart.rom      = calloc(1, 0x8000);
+    gb.cart.rom_size = 0x8000;
+    gb.cart.ram      = calloc(1, 0x2000);
+    gb.cart.ram_size = 0x2000;
+    ck_assert_int_eq(cart_attach_save(&gb.cart, path), 0);
+    mmu_map_init(&gb);
+    gb.running = true;
+
+    // Clean pages are watched; the first write marks the page & maps it back
+    ck_assert(gb.write_map[0xA0] == NULL);
+    mmu_write(&gb, 0xA010, 0x11);
+    ck_assert(cart_ram_is_dirty(&gb.cart, 0x0010));
+    ck_assert(!cart_ram_is_dirty(&gb.cart, 0x0100));
+    ck_assert(gb.write_map[0xA0] == gb.cart.ram);
+    ck_assert(gb.write_map[0xA1] == NULL);
+
+    // A flush writes it & watches it again; with nothing dirty it does nothing
+    gb_flush_save(&gb);
+    ck_assert_uint_eq(gb.cart.save_flushes, 1);
+    ck_assert(!cart_ram_is_dirty(&gb.cart, 0x0010));
+    ck_assert(gb.write_map[0xA0] == NULL);
+    gb_flush_save(&gb);
+    ck_assert_uint_eq(gb.cart.save_flushes, 1);
+
+    // Writing every frame: one flush per interval, not per write
+    gb.save_interval = 10;
+    for (int frame = 0; frame < 100; frame++) {
+        mmu_write(&gb, (u16)(0xA000 + frame * 0x40), (u8)frame);
+        gb_run_frame(&gb);
+    }
+    ck_assert_uint_eq(gb.cart.save_flushes, 11);
+
+    // The file holds what the game wrote
+    mmu_write(&gb, 0xBFFF, 0x77);
+    gb_unload(&gb);
+
+    u8    file[0x2000];
+    FILE *f = fopen(path, "rb");
+    ck_assert_ptr_nonnull(f);
+    ck_assert_uint_eq(fread(file, 1, sizeof(file), f), sizeof(file));
+    fclose(f);
+    ck_assert_uint_eq(file[0x0000], 0);
+    ck_assert_uint_eq(file[0x0040], 1);
+    ck_assert_uint_eq(file[99 * 0x40], 99);
+    ck_assert_uint_eq(file[0x1FFF], 0x77);
+
+    unlink(path);
+}
+END_TEST
+
+// ============================================================================
+// Joypad Tests
+// ============================================================================
+
+START_TEST(test_joypad_rows) {
+    GameBoy gb = {0};
+    gb_init(&gb);
+    joypad_reset(&gb);
+
+    // Nothing selected: all released
+    joypad_set_buttons(&gb, JOYPAD_A | JOYPAD_DOWN);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF00), 0xFF);
+
+    // D-pad row: Down (bit 3) reads 0
+    mmu_write(&gb, 0xFF00, 0x20);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF00), 0xE7);
+
+    // Buttons row: A (bit 0)
+    mmu_write(&gb, 0xFF00, 0x10);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF00), 0xDE);
+
+    // Both rows ANDed
+    mmu_write(&gb, 0xFF00, 0x00);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF00), 0xC6);
+}
+END_TEST
+
+START_TEST(test_joypad_interrupt) {
+    GameBoy gb = {0};
+    gb_init(&gb);
+    joypad_reset(&gb);
+
+    // A key on a row nobody selected: no interrupt
+    mmu_write(&gb, 0xFF00, 0x20);
+    joypad_set_buttons(&gb, JOYPAD_START);
+    ck_assert_uint_eq(gb.if_register & INT_JOYPAD, 0);
+
+    // Pressing on the selected row does
+    joypad_set_buttons(&gb, JOYPAD_START | JOYPAD_LEFT);
+    ck_assert_uint_eq(gb.if_register & INT_JOYPAD, INT_JOYPAD);
+
+    // So does selecting a row with a key already held (a line falls)
+    gb.if_register = 0;
+    mmu_write(&gb, 0xFF00, 0x10);
+    ck_assert_uint_eq(gb.if_register & INT_JOYPAD, INT_JOYPAD);
+
+    // Releasing doesn't
+    gb.if_register = 0;
+    joypad_set_buttons(&gb, 0);
+    ck_assert_uint_eq(gb.if_register & INT_JOYPAD, 0);
+}
+END_TEST
+
+// ============================================================================
+// Profile Tests
+// ============================================================================
+
+START_TEST(test_profile_regions) {
+    static const struct {
+        u16        addr;
+        ProfRegion region;
+    } edges[] = {
+        {0x3FFF, PROF_ROM0}, {0x4000, PROF_ROMX},     {0x9FFF, PROF_VRAM}, {0xA000, PROF_SRAM},
+        {0xDFFF, PROF_WRAM}, {0xFDFF, PROF_ECHO},     {0xFE9F, PROF_OAM},  {0xFEA0, PROF_UNUSABLE},
+        {0xFF7F, PROF_IO},   {0xFF80, PROF_HRAM},     {0xFFFE, PROF_HRAM}, {0xFFFF, PROF_IE},
+    };
+    for (size_t i = 0; i < sizeof(edges) / sizeof(edges[0]); i++)
+        ck_assert_int_eq(profile_region(edges[i].addr), edges[i].region);
+
+    // I/O accesses are also counted by register
+    static Profile p, sum;
+    profile_access(p.reads, p.io_reads, 0xFF44);
+    profile_access(p.reads, p.io_reads, 0xFF44);
+    profile_access(p.reads, p.io_reads, 0xC000);
+    ck_assert_uint_eq(p.reads[PROF_IO], 2);
+    ck_assert_uint_eq(p.io_reads[0x44], 2);
+    ck_assert_uint_eq(p.reads[PROF_WRAM], 1);
+
+    profile_add(&sum, &p);
+    profile_add(&sum, &p);
+    ck_assert_uint_eq(sum.io_reads[0x44], 4);
+}
+END_TEST
+
+#ifdef BAREDMG_PROFILE
+START_TEST(test_profile_counts) {
+    GameBoy gb = {0};
+    gb_init(&gb);
+
+    mmu_write(&gb, 0xC000, 1);   // Fast path
+    mmu_read(&gb, 0xFF40);       // Slow path (I/O)
+    mmu_read16(&gb, 0xFF80);     // Two bytes
+    mmu_write16(&gb, 0xC0FF, 2); // Across a page
+
+    ck_assert_uint_eq(gb.profile.writes[PROF_WRAM], 3);
+    ck_assert_uint_eq(gb.profile.reads[PROF_IO], 1);
+    ck_assert_uint_eq(gb.profile.io_reads[0x40], 1);
+    ck_assert_uint_eq(gb.profile.reads[PROF_HRAM], 2);
+}
+END_TEST
+#endif
+
 // ============================================================================
 // Test Suite Setup
 // ============================================================================
 
 Suite *mmu_suite(void) {
     Suite *s;
-    TCase *tc_wram, *tc_hram, *tc_rom, *tc_special;
+    TCase *tc_wram, *tc_hram, *tc_rom, *tc_special, *tc_map, *tc_save, *tc_joypad, *tc_profile;
 
     s       = suite_create("MMU");
 
@@ -169,6 +430,33 @@ Suite *mmu_suite(void) {
     tcase_add_test(tc_special, test_ie_register);
     suite_add_tcase(s, tc_special);
 
+    // Page table
+    tc_map = tcase_create("Page Table");
+    tcase_add_test(tc_map, test_page_table_rom_mapped);
+    tcase_add_test(tc_map, test_page_table_slow_pages);
+    tcase_add_test(tc_map, test_read_write16);
+    tcase_add_test(tc_map, test_fast_matches_slow);
+    suite_add_tcase(s, tc_map);
+
+    // Battery RAM
+    tc_save = tcase_create("Battery RAM");
+    tcase_add_test(tc_save, test_battery_ram_dirty_pages);
+    suite_add_tcase(s, tc_save);
+
+    // Joypad
+    tc_joypad = tcase_create("Joypad");
+    tcase_add_test(tc_joypad, test_joypad_rows);
+    tcase_add_test(tc_joypad, test_joypad_interrupt);
+    suite_add_tcase(s, tc_joypad);
+
+    // Profile counters (BAREDMG_PROFILE)
+    tc_profile = tcase_create("Profile");
+    tcase_add_test(tc_profile, test_profile_regions);
+#ifdef BAREDMG_PROFILE
+    tcase_add_test(tc_profile, test_profile_counts);
+#endif
+    suite_add_tcase(s, tc_profile);
+
     return s;
 }
 
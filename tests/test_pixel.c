@@ -0,0 +1,185 @@
+// tests/test_pixel.c
+#include <check.h>
+#include <core/pixel.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+#define ALL_ROWS 0x10000 // Every (low plane, high plane) byte pair
+
+// Straight from the 2bpp definition: bit 7 is the leftmost pixel
+static u8 ref_color(u8 lo, u8 hi, int x, bool xflip) {
+    int bit = xflip ? x : 7 - x;
+    return (u8)((((hi >> bit) & 1) << 1) | ((lo >> bit) & 1));
+}
+
+static u8 ref_shade(u8 palette, u8 color) {
+    return (palette >> (color * 2)) & 3;
+}
+
+static u8 *all_planes(void) {
+    u8 *planes = malloc(ALL_ROWS * 2);
+    for (u32 i = 0; i < ALL_ROWS; i++) {
+        planes[i * 2]     = (u8)i;
+        planes[i * 2 + 1] = (u8)(i >> 8);
+    }
+    return planes;
+}
+
+// ============================================================================
+// Decode Tests
+// ============================================================================
+
+START_TEST(test_decode_all_rows) {
+    const PixelKernels *k = pixel_kernels((PixelIsa)_i);
+    if (!k)
+        return; // Not available in this build or on this host
+
+    u8 *planes = all_planes();
+    u8 *out    = malloc(ALL_ROWS * 8);
+
+    for (int flip = 0; flip < 2; flip++) {
+        k->decode(out, planes, ALL_ROWS, flip);
+        for (u32 i = 0; i < ALL_ROWS; i++)
+            for (int x = 0; x < 8; x++)
+                ck_assert_msg(out[i * 8 + x] == ref_color((u8)i, (u8)(i >> 8), x, flip),
+                              "%s: lo %02X hi %02X x %d flip %d", k->name, i & 0xFF, i >> 8, x,
+                              flip);
+    }
+
+    free(out);
+    free(planes);
+}
+END_TEST
+
+START_TEST(test_decode_lengths) {
+    const PixelKernels *k = pixel_kernels((PixelIsa)_i);
+    if (!k)
+        return;
+
+    u8 planes[2 * 21 + 1];
+    u8 out[8 * 21 + 2];
+
+    for (size_t i = 0; i < sizeof(planes); i++)
+        planes[i] = (u8)(i * 37 + 11);
+
+    // Every length up to one scanline & one row more, unaligned source & destination
+    for (size_t rows = 0; rows <= 21; rows++) {
+        memset(out, 0xAA, sizeof(out));
+        k->decode(out + 1, planes + 1, rows, false);
+
+        ck_assert_uint_eq(out[0], 0xAA);
+        for (size_t r = 0; r < rows; r++)
+            for (int x = 0; x < 8; x++)
+                ck_assert_uint_eq(out[1 + r * 8 + x],
+                                  ref_color(planes[1 + r * 2], planes[2 + r * 2], x, false));
+        ck_assert_uint_eq(out[1 + rows * 8], 0xAA);
+    }
+}
+END_TEST
+
+// ============================================================================
+// Palette Tests
+// ============================================================================
+
+START_TEST(test_palette_all) {
+    const PixelKernels *k = pixel_kernels((PixelIsa)_i);
+    if (!k)
+        return;
+
+    u8 src[160], out[160];
+    for (int i = 0; i < 160; i++)
+        src[i] = (u8)((i ^ (i >> 2)) & 3);
+
+    // Every palette value with every color, a full scanline at a time
+    for (int p = 0; p < 256; p++) {
+        k->palette(out, src, (u8)p, 160);
+        for (int i = 0; i < 160; i++)
+            ck_assert_msg(out[i] == ref_shade((u8)p, src[i]), "%s: palette %02X color %d",
+                          k->name, p, src[i]);
+    }
+}
+END_TEST
+
+START_TEST(test_palette_lengths) {
+    const PixelKernels *k = pixel_kernels((PixelIsa)_i);
+    if (!k)
+        return;
+
+    u8 src[162], out[162];
+    for (int i = 0; i < 162; i++)
+        src[i] = (u8)((i * 7) & 3);
+
+    // Spans start & end anywhere in a line
+    for (size_t n = 0; n <= 160; n++) {
+        memset(out, 0xAA, sizeof(out));
+        k->palette(out + 1, src + 1, 0x1B, n);
+
+        ck_assert_uint_eq(out[0], 0xAA);
+        for (size_t i = 0; i < n; i++)
+            ck_assert_uint_eq(out[1 + i], ref_shade(0x1B, src[1 + i]));
+        ck_assert_uint_eq(out[1 + n], 0xAA);
+    }
+}
+END_TEST
+
+START_TEST(test_dispatch) {
+    const PixelKernels *best = pixel_kernels_best();
+
+    ck_assert_ptr_nonnull(best);
+    ck_assert_ptr_nonnull(pixel_kernels(PIXEL_SCALAR));
+    ck_assert_ptr_null(pixel_kernels(PIXEL_ISA_COUNT));
+
+    // Nothing better than the pick is available
+    for (int isa = PIXEL_ISA_COUNT - 1; isa >= 0; isa--) {
+        const PixelKernels *k = pixel_kernels((PixelIsa)isa);
+        if (k) {
+            ck_assert_ptr_eq(best, k);
+            break;
+        }
+    }
+}
+END_TEST
+
+// ============================================================================
+// Test Suite
+// ============================================================================
+
+Suite *pixel_suite(void) {
+    Suite *s;
+    TCase *tc_decode, *tc_palette;
+
+    s = suite_create("Pixel");
+
+    // Loop tests run once per PixelIsa
+    tc_decode = tcase_create("Decode");
+    tcase_add_loop_test(tc_decode, test_decode_all_rows, 0, PIXEL_ISA_COUNT);
+    tcase_add_loop_test(tc_decode, test_decode_lengths, 0, PIXEL_ISA_COUNT);
+    tcase_add_test(tc_decode, test_dispatch);
+    suite_add_tcase(s, tc_decode);
+
+    tc_palette = tcase_create("Palette");
+    tcase_add_loop_test(tc_palette, test_palette_all, 0, PIXEL_ISA_COUNT);
+    tcase_add_loop_test(tc_palette, test_palette_lengths, 0, PIXEL_ISA_COUNT);
+    suite_add_tcase(s, tc_palette);
+
+    return s;
+}
+
+int main(void) {
+    int      number_failed;
+    Suite   *s;
+    SRunner *sr;
+
+    s  = pixel_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,405 @@
+// tests/test_ppu.c
+#include <check.h>
+#include <gbemu.h>
+#include <core/bus.h>
+#include <core/cpu.h>
+#include <core/ppu.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_machine.h"
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// Build a 32 KB ROM-only machine running NOPs (4 cycles each) with the LCD on
+static void setup(GameBoy *gb) {
+    test_machine_init(gb, NULL, 0);
+    ppu_reset(gb);
+}
+
+// Fill tile `index` (0x8000 addressing) with a single color
+static void fill_tile(GameBoy *gb, u8 index, u8 color) {
+    for (u16 i = 0; i < 16; i += 2) {
+        mmu_write(gb, (u16)(0x8000 + index * 16 + i), (color & 1) ? 0xFF : 0x00);
+        mmu_write(gb, (u16)(0x8000 + index * 16 + i + 1), (color & 2) ? 0xFF : 0x00);
+    }
+}
+
+// Point every entry of a tile map at `index`
+static void fill_map(GameBoy *gb, u16 map, u8 index) {
+    for (u16 i = 0; i < 0x400; i++)
+        mmu_write(gb, (u16)(map + i), index);
+}
+
+static u8 pixel(GameBoy *gb, int x, int y) {
+    return ppu_framebuffer(gb)[y * SCREEN_WIDTH + x];
+}
+
+// ============================================================================
+// Timing Tests
+// ============================================================================
+
+START_TEST(test_ly_and_modes) {
+    GameBoy gb;
+    setup(&gb);
+
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF44), 0);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF41) & STAT_MODE, PPU_MODE_OAM);
+
+    cpu_run(&gb, PPU_OAM_CYCLES);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF41) & STAT_MODE, PPU_MODE_DRAW);
+
+    cpu_run(&gb, PPU_DRAW_CYCLES);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF41) & STAT_MODE, PPU_MODE_HBLANK);
+
+    cpu_run(&gb, PPU_LINE_CYCLES - PPU_OAM_CYCLES - PPU_DRAW_CYCLES);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF44), 1);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF41) & STAT_MODE, PPU_MODE_OAM);
+
+    // LY == LYC flag
+    mmu_write(&gb, 0xFF45, 1);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF41) & STAT_LYC_EQUAL, STAT_LYC_EQUAL);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_vblank_interrupt) {
+    GameBoy gb;
+    setup(&gb);
+
+    cpu_run(&gb, SCREEN_HEIGHT * PPU_LINE_CYCLES - 4);
+    ck_assert_uint_eq(gb.if_register & INT_VBLANK, 0);
+
+    cpu_run(&gb, 4);
+    ck_assert_uint_eq(gb.if_register & INT_VBLANK, INT_VBLANK);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF44), SCREEN_HEIGHT);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF41) & STAT_MODE, PPU_MODE_VBLANK);
+    ck_assert_uint_eq(gb.ppu.frames, 1);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_stat_hblank_interrupts) {
+    GameBoy gb;
+    setup(&gb);
+
+    mmu_write(&gb, 0xFF41, STAT_HBLANK_INT);
+
+    // One STAT interrupt per visible line
+    int count = 0;
+    for (u32 t = 0; t < PPU_FRAME_CYCLES; t += 4) {
+        cpu_run(&gb, 4);
+        if (gb.if_register & INT_STAT) {
+            count++;
+            gb.if_register &= (u8)~INT_STAT;
+        }
+    }
+    ck_assert_int_eq(count, SCREEN_HEIGHT);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_stat_lyc_interrupt) {
+    GameBoy gb;
+    setup(&gb);
+
+    mmu_write(&gb, 0xFF45, 10);
+    mmu_write(&gb, 0xFF41, STAT_LYC_INT);
+
+    while (!(gb.if_register & INT_STAT))
+        cpu_run(&gb, 4);
+
+    ck_assert_uint_eq(gb.cycles, 10 * PPU_LINE_CYCLES);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF44), 10);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_lazy_sync) {
+    GameBoy gb;
+    setup(&gb);
+
+    // Nothing looked at the PPU: nothing was drawn
+    cpu_run(&gb, 1000);
+    ck_assert_uint_eq(gb.ppu.synced, 0);
+
+    // Reading LY catches up
+    mmu_read(&gb, 0xFF44);
+    ck_assert_uint_eq(gb.ppu.synced, gb.cycles);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+// ============================================================================
+// Rendering Tests
+// ============================================================================
+
+START_TEST(test_render_background) {
+    GameBoy gb;
+    setup(&gb);
+
+    fill_tile(&gb, 1, 3);
+    mmu_write(&gb, 0x9800, 1); // Top-left tile only
+    mmu_write(&gb, 0xFF47, 0xE4);
+
+    gb.running = true;
+    gb_run_frame(&gb);
+    gb_run_frame(&gb);
+
+    ck_assert_uint_eq(pixel(&gb, 0, 0), 3);
+    ck_assert_uint_eq(pixel(&gb, 7, 7), 3);
+    ck_assert_uint_eq(pixel(&gb, 8, 0), 0);
+    ck_assert_uint_eq(pixel(&gb, 0, 8), 0);
+
+    // SCX scrolls the tile off to the left
+    mmu_write(&gb, 0xFF43, 4);
+    gb_run_frame(&gb);
+    ck_assert_uint_eq(pixel(&gb, 3, 0), 3);
+    ck_assert_uint_eq(pixel(&gb, 4, 0), 0);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_drawing_off) {
+    GameBoy gb;
+    setup(&gb);
+
+    fill_tile(&gb, 1, 3);
+    mmu_write(&gb, 0x9800, 1);
+    mmu_write(&gb, 0xFF47, 0xE4);
+    gb.running = true;
+    gb_run_frame(&gb);
+    gb_run_frame(&gb);
+    ck_assert_uint_eq(pixel(&gb, 0, 0), 3);
+
+    // Off: frames & interrupts go on, the picture & the tile cache don't
+    ppu_set_drawing(&gb, false);
+    fill_tile(&gb, 1, 1);
+    u64 frames     = gb.ppu.frames;
+    gb.if_register = 0;
+    gb_run_frame(&gb);
+    gb_run_frame(&gb);
+    ck_assert_uint_eq(gb.ppu.frames, frames + 2);
+    ck_assert_uint_eq(gb.if_register & INT_VBLANK, INT_VBLANK);
+    ck_assert_uint_eq(pixel(&gb, 0, 0), 3);
+
+    // Back on: the tiles written meanwhile show up
+    ppu_set_drawing(&gb, true);
+    gb_run_frame(&gb);
+    gb_run_frame(&gb);
+    ck_assert_uint_eq(pixel(&gb, 0, 0), 1);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_mid_scanline_write) {
+    GameBoy gb;
+    setup(&gb);
+
+    fill_tile(&gb, 0, 3);
+    mmu_write(&gb, 0xFF47, 0xE4);
+
+    // Change BGP while pixel 40 of line 5 is due
+    gb.cycles = 5 * PPU_LINE_CYCLES + PPU_OAM_CYCLES + 40;
+    mmu_write(&gb, 0xFF47, 0x00);
+
+    gb.cycles = PPU_FRAME_CYCLES;
+    ck_assert_uint_eq(pixel(&gb, 39, 5), 3);
+    ck_assert_uint_eq(pixel(&gb, 40, 5), 0);
+    ck_assert_uint_eq(pixel(&gb, 0, 4), 3);
+    ck_assert_uint_eq(pixel(&gb, 0, 6), 0);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_window) {
+    GameBoy gb;
+    setup(&gb);
+
+    fill_tile(&gb, 1, 2);
+    fill_map(&gb, 0x9C00, 1);
+    mmu_write(&gb, 0xFF47, 0xE4);
+    mmu_write(&gb, 0xFF4A, 16);     // WY
+    mmu_write(&gb, 0xFF4B, 80 + 7); // WX
+    mmu_write(&gb, 0xFF40, 0x91 | LCDC_WIN_ENABLE | LCDC_WIN_MAP);
+
+    gb.cycles = PPU_FRAME_CYCLES * 2;
+    ck_assert_uint_eq(pixel(&gb, 79, 16), 0);
+    ck_assert_uint_eq(pixel(&gb, 80, 16), 2);
+    ck_assert_uint_eq(pixel(&gb, 80, 15), 0);
+    ck_assert_uint_eq(pixel(&gb, 159, 143), 2);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_sprites) {
+    GameBoy gb;
+    setup(&gb);
+
+    fill_tile(&gb, 1, 1);
+    fill_tile(&gb, 2, 2);
+    mmu_write(&gb, 0x9800, 2); // BG color 2 under the top-left tile
+    mmu_write(&gb, 0xFF47, 0xE4);
+    mmu_write(&gb, 0xFF48, 0xE4);
+    mmu_write(&gb, 0xFF40, 0x91 | LCDC_OBJ_ENABLE);
+
+    // Sprite 0 at screen (4, 0), behind BG; sprite 1 at (20, 10) in front
+    u8 oam[8] = {16, 12, 1, OBJ_PRIORITY, 26, 28, 1, 0};
+    for (u16 i = 0; i < sizeof(oam); i++)
+        mmu_write(&gb, (u16)(0xFE00 + i), oam[i]);
+
+    gb.cycles = PPU_FRAME_CYCLES * 2;
+    ck_assert_uint_eq(pixel(&gb, 5, 0), 2);  // BG color 2 wins over the sprite
+    ck_assert_uint_eq(pixel(&gb, 9, 0), 1);  // Over BG color 0 it shows
+    ck_assert_uint_eq(pixel(&gb, 20, 10), 1);
+    ck_assert_uint_eq(pixel(&gb, 27, 17), 1);
+    ck_assert_uint_eq(pixel(&gb, 28, 10), 0);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_lcd_off) {
+    GameBoy gb;
+    setup(&gb);
+
+    mmu_write(&gb, 0xFF40, 0x11);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF44), 0);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF41) & STAT_MODE, PPU_MODE_HBLANK);
+
+    // No VBlank while the LCD is off
+    cpu_run(&gb, PPU_FRAME_CYCLES);
+    ck_assert_uint_eq(gb.if_register & INT_VBLANK, 0);
+
+    // Switching it back on restarts the frame at line 0
+    mmu_write(&gb, 0xFF40, 0x91);
+    cpu_run(&gb, PPU_LINE_CYCLES);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF44), 1);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+// ============================================================================
+// Tile Cache Tests
+// ============================================================================
+
+// Check every decoded tile row against the 2bpp data in VRAM
+static void assert_tiles_match(const GameBoy *gb) {
+    for (int tile = 0; tile < TILE_COUNT; tile++) {
+        for (int row = 0; row < 8; row++) {
+            u8 lo = gb->vram[tile * 16 + row * 2];
+            u8 hi = gb->vram[tile * 16 + row * 2 + 1];
+
+            for (int x = 0; x < 8; x++) {
+                u8 color = (u8)((((hi >> (7 - x)) & 1) << 1) | ((lo >> (7 - x)) & 1));
+                ck_assert_uint_eq(gb->ppu.tiles[tile][row][x], color);
+#ifndef BAREDMG_NO_TILE_XFLIP
+                ck_assert_uint_eq(gb->ppu.tiles_xflip[tile][row][7 - x], color);
+#endif
+            }
+        }
+    }
+}
+
+START_TEST(test_tile_cache_writes) {
+    GameBoy gb;
+    setup(&gb);
+
+    // Random tile data writes, including single bytes of a row
+    u32 rng = 12345;
+    for (int i = 0; i < 20000; i++) {
+        rng = rng * 1103515245 + 12345;
+        mmu_write(&gb, (u16)(0x8000 + (rng >> 8) % 0x1800), (u8)(rng >> 20));
+    }
+    assert_tiles_match(&gb);
+
+    // Tile map writes leave the cache alone
+    mmu_write(&gb, 0x9800, 0x55);
+    assert_tiles_match(&gb);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_tile_cache_refresh) {
+    GameBoy gb;
+    setup(&gb);
+
+    // Direct VRAM writes bypass the cache until it is refreshed
+    for (u16 i = 0; i < 0x1800; i++)
+        gb.vram[i] = (u8)(i * 7 + (i >> 8));
+    ppu_refresh_tiles(&gb);
+    assert_tiles_match(&gb);
+
+    // Signed addressing: BG tile 0x00 with LCDC.4 clear is tile 0x100 (0x9000)
+    mmu_write(&gb, 0xFF47, 0xE4);
+    mmu_write(&gb, 0xFF40, 0x81);
+    fill_map(&gb, 0x9800, 0x00);
+    gb.cycles = PPU_FRAME_CYCLES * 2;
+    for (int x = 0; x < 8; x++)
+        ck_assert_uint_eq(pixel(&gb, x, 2), gb.ppu.tiles[0x100][2][x]);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+// ============================================================================
+// Test Suite
+// ============================================================================
+
+Suite *ppu_suite(void) {
+    Suite *s;
+    TCase *tc_timing, *tc_render, *tc_tiles;
+
+    s = suite_create("PPU");
+
+    tc_timing = tcase_create("Timing");
+    tcase_add_test(tc_timing, test_ly_and_modes);
+    tcase_add_test(tc_timing, test_vblank_interrupt);
+    tcase_add_test(tc_timing, test_stat_hblank_interrupts);
+    tcase_add_test(tc_timing, test_stat_lyc_interrupt);
+    tcase_add_test(tc_timing, test_lazy_sync);
+    tcase_add_test(tc_timing, test_lcd_off);
+    suite_add_tcase(s, tc_timing);
+
+    tc_render = tcase_create("Rendering");
+    tcase_add_test(tc_render, test_render_background);
+    tcase_add_test(tc_render, test_drawing_off);
+    tcase_add_test(tc_render, test_mid_scanline_write);
+    tcase_add_test(tc_render, test_window);
+    tcase_add_test(tc_render, test_sprites);
+    suite_add_tcase(s, tc_render);
+
+    tc_tiles = tcase_create("Tile Cache");
+    tcase_add_test(tc_tiles, test_tile_cache_writes);
+    tcase_add_test(tc_tiles, test_tile_cache_refresh);
+    suite_add_tcase(s, tc_tiles);
+
+    return s;
+}
+
+int main(void) {
+    int      number_failed;
+    Suite   *s;
+    SRunner *sr;
+
+    s  = ppu_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+// tests/test_rewind.c
+#include <check.h>
+#include <core/rewind.h>
+#include <gbemu.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_machine.h"
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+#define FRAMES 60
+
+static void setup(GameBoy *gb) {
+    u8 *rom = malloc(TEST_ROM_SIZE);
+    test_rom_build_smc(rom, 0x00);
+    gb_init(gb);
+    ck_assert(gb_load_rom_buffer(gb, rom, TEST_ROM_SIZE));
+    free(rom);
+}
+
+// Run `frames` frames through the ring, keeping every frame's state in refs
+static void run(GameBoy *gb, Rewind *r, u8 **refs, int frames, size_t size) {
+    for (int f = 0; f < frames; f++) {
+        gb_run_frame(gb);
+        rewind_frame(r, gb);
+        refs[f] = malloc(size);
+        ck_assert_uint_eq(gb_save_state(gb, refs[f], size), size);
+    }
+}
+
+static void assert_state(const GameBoy *gb, const u8 *ref, size_t size) {
+    u8 *now = malloc(size);
+    ck_assert_uint_eq(gb_save_state(gb, now, size), size);
+    ck_assert_msg(memcmp(now, ref, size) == 0, "rewound state differs");
+    free(now);
+}
+
+static void free_refs(u8 **refs, int frames) {
+    for (int f = 0; f < frames; f++)
+        free(refs[f]);
+}
+
+// ============================================================================
+// Rewind Tests
+// ============================================================================
+
+START_TEST(test_rewind_steps) {
+    static GameBoy gb;
+    static u8     *refs[FRAMES];
+    const u32      interval = (u32)_i; // Loop test: 1 to 3
+    Rewind         r;
+    RewindStats    stats;
+
+    setup(&gb);
+    size_t size = gb_state_size(&gb);
+    ck_assert(rewind_init(&r, &gb, &(RewindConfig){.interval = interval}));
+    run(&gb, &r, refs, FRAMES, size);
+
+    // Captures after frames 0, interval, 2 * interval, ...
+    int last = (FRAMES - 1) / (int)interval * (int)interval;
+    rewind_stats(&r, &stats);
+    ck_assert_uint_eq(stats.states, (u32)(last / (int)interval) + (last != FRAMES - 1));
+    ck_assert_uint_eq(stats.frames, FRAMES - 1);
+    ck_assert(stats.ratio > 1.0);
+
+    // All the way back, one capture at a time
+    for (int f = last; f >= 0; f -= (int)interval) {
+        if (f == FRAMES - 1)
+            continue; // Already there: the first step goes further back
+        ck_assert(rewind_step(&r, &gb));
+        assert_state(&gb, refs[f], size);
+    }
+    ck_assert(!rewind_step(&r, &gb));
+    assert_state(&gb, refs[0], size);
+
+    rewind_free(&r);
+    free_refs(refs, FRAMES);
+    gb_unload(&gb);
+}
+END_TEST
+
+START_TEST(test_rewind_branch) {
+    static GameBoy gb;
+    static u8     *refs[FRAMES], *more[FRAMES];
+    Rewind         r;
+
+    setup(&gb);
+    size_t size = gb_state_size(&gb);
+    ck_assert(rewind_init(&r, &gb, &(RewindConfig){.interval = 2}));
+    run(&gb, &r, refs, 20, size);
+
+    // Back to frame 14, play on from there & come back again
+    for (int i = 0; i < 3; i++)
+        ck_assert(rewind_step(&r, &gb));
+    assert_state(&gb, refs[14], size);
+
+    run(&gb, &r, more, 5, size);
+    ck_assert(rewind_step(&r, &gb)); // Since the capture after more[3]
+    assert_state(&gb, more[3], size);
+    ck_assert(rewind_step(&r, &gb));
+    assert_state(&gb, more[1], size);
+    ck_assert(rewind_step(&r, &gb));
+    assert_state(&gb, refs[14], size);
+    ck_assert(rewind_step(&r, &gb));
+    assert_state(&gb, refs[12], size);
+
+    rewind_free(&r);
+    free_refs(refs, 20);
+    free_refs(more, 5);
+    gb_unload(&gb);
+}
+END_TEST
+
+START_TEST(test_rewind_memory_cap) {
+    static GameBoy gb;
+    static u8     *refs[FRAMES];
+    Rewind         r;
+    RewindStats    stats;
+
+    setup(&gb);
+    size_t size = gb_state_size(&gb);
+
+    // Too small for the working buffers
+    ck_assert(!rewind_init(&r, &gb, &(RewindConfig){.memory = size}));
+
+    // Room for a handful of deltas: the oldest go
+    RewindConfig cfg = {.memory = 3 * size + (16 << 10)};
+    ck_assert(rewind_init(&r, &gb, &cfg));
+    run(&gb, &r, refs, FRAMES, size);
+
+    rewind_stats(&r, &stats);
+    ck_assert_uint_le(stats.memory, cfg.memory);
+    ck_assert_uint_gt(stats.states, 2);
+    ck_assert_uint_lt(stats.states, FRAMES - 1);
+
+    // What is left is still exact
+    for (u32 i = 1; i <= stats.states; i++) {
+        ck_assert(rewind_step(&r, &gb));
+        assert_state(&gb, refs[FRAMES - 1 - i], size);
+    }
+    ck_assert(!rewind_step(&r, &gb));
+
+    rewind_free(&r);
+    free_refs(refs, FRAMES);
+    gb_unload(&gb);
+}
+END_TEST
+
+// ============================================================================
+// Test Suite
+// ============================================================================
+
+Suite *rewind_suite(void) {
+    Suite *s;
+    TCase *tc_rewind;
+
+    s = suite_create("Rewind");
+
+    tc_rewind = tcase_create("Rewind");
+    tcase_add_loop_test(tc_rewind, test_rewind_steps, 1, 4);
+    tcase_add_test(tc_rewind, test_rewind_branch);
+    tcase_add_test(tc_rewind, test_rewind_memory_cap);
+    suite_add_tcase(s, tc_rewind);
+
+    return s;
+}
+
+int main(void) {
+    int      number_failed;
+    Suite   *s;
+    SRunner *sr;
+
+    s  = rewind_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,218 @@
+// tests/test_scheduler.c
+#include <check.h>
+#include <gbemu.h>
+#include <core/bus.h>
+#include <core/cpu.h>
+#include <core/scheduler.h>
+#include <core/serial.h>
+#include <core/timer.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_machine.h"
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// Build a 32 KB ROM-only machine running NOPs (4 cycles each) from 0x0100
+static void setup(GameBoy *gb) {
+    test_machine_init(gb, NULL, 0);
+    timer_reset(gb);
+    serial_reset(gb);
+}
+
+// ============================================================================
+// Scheduler Tests
+// ============================================================================
+
+START_TEST(test_sched_order) {
+    Scheduler sched;
+    sched_init(&sched);
+    ck_assert_uint_eq(sched.next, SCHED_NEVER);
+
+    sched_add(&sched, SCHED_RUN_END, 300);
+    sched_add(&sched, SCHED_SERIAL, 100);
+    sched_add(&sched, SCHED_TIMER, 200);
+
+    ck_assert_uint_eq(sched.count, 3);
+    ck_assert_uint_eq(sched.next, 100);
+    ck_assert_uint_eq(sched.entries[0].event, SCHED_SERIAL);
+    ck_assert_uint_eq(sched.entries[1].event, SCHED_TIMER);
+    ck_assert_uint_eq(sched.entries[2].event, SCHED_RUN_END);
+
+    // Same deadline: lower kinds run first
+    sched_add(&sched, SCHED_SERIAL, 200);
+    ck_assert_uint_eq(sched.entries[0].event, SCHED_TIMER);
+    ck_assert_uint_eq(sched.entries[1].event, SCHED_SERIAL);
+    ck_assert_uint_eq(sched.next, 200);
+}
+END_TEST
+
+START_TEST(test_sched_reschedule_cancel) {
+    Scheduler sched;
+    sched_init(&sched);
+
+    // Adding a pending event moves it instead of adding a second one
+    sched_add(&sched, SCHED_TIMER, 500);
+    sched_add(&sched, SCHED_TIMER, 50);
+    ck_assert_uint_eq(sched.count, 1);
+    ck_assert_uint_eq(sched_when(&sched, SCHED_TIMER), 50);
+
+    sched_add(&sched, SCHED_SERIAL, 80);
+    sched_cancel(&sched, SCHED_TIMER);
+    ck_assert_uint_eq(sched.count, 1);
+    ck_assert_uint_eq(sched.next, 80);
+    ck_assert_uint_eq(sched_when(&sched, SCHED_TIMER), SCHED_NEVER);
+
+    sched_cancel(&sched, SCHED_SERIAL);
+    ck_assert_uint_eq(sched.next, SCHED_NEVER);
+}
+END_TEST
+
+START_TEST(test_sched_run_end) {
+    GameBoy gb;
+    setup(&gb);
+
+    // The budget is honoured & the RUN_END event doesn't outlive cpu_run()
+    ck_assert_uint_eq(cpu_run(&gb, 100), 100);
+    ck_assert_uint_eq(gb.cycles, 100);
+    ck_assert_uint_eq(sched_when(&gb.sched, SCHED_RUN_END), SCHED_NEVER);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+// ============================================================================
+// Timer Tests
+// ============================================================================
+
+START_TEST(test_timer_div) {
+    GameBoy gb;
+    setup(&gb);
+
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF04), 0xAB);
+
+    // Writing DIV resets it, then it counts at 16384 Hz
+    mmu_write(&gb, 0xFF04, 0x55);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF04), 0x00);
+    cpu_run(&gb, 0x300);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF04), 0x03);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+START_TEST(test_timer_overflow_interrupt) {
+    static const u8  clocks[4]  = {0x04, 0x05, 0x06, 0x07};
+    static const u32 periods[4] = {1024, 16, 64, 256};
+
+    for (int i = 0; i < 4; i++) {
+        GameBoy gb;
+        setup(&gb);
+
+        mmu_write(&gb, 0xFF04, 0x00); // Align the divider
+        mmu_write(&gb, 0xFF06, 0x80); // TMA
+        mmu_write(&gb, 0xFF05, 0xF0); // TIMA: 16 ticks to overflow
+        mmu_write(&gb, 0xFF07, clocks[i]);
+
+        // Halfway there, read lazily
+        cpu_run(&gb, periods[i] * 8);
+        ck_assert_uint_eq(mmu_read(&gb, 0xFF05), 0xF8);
+
+        // One instruction short of the overflow
+        cpu_run(&gb, periods[i] * 8 - 4);
+        ck_assert_uint_eq(gb.if_register & INT_TIMER, 0);
+
+        cpu_run(&gb, 4);
+        ck_assert_uint_eq(gb.if_register & INT_TIMER, INT_TIMER);
+        ck_assert_uint_eq(gb.timer.tima, 0x80);
+
+        test_machine_free(&gb);
+    }
+}
+END_TEST
+
+START_TEST(test_timer_stopped) {
+    GameBoy gb;
+    setup(&gb);
+
+    mmu_write(&gb, 0xFF05, 0xFF);
+    mmu_write(&gb, 0xFF07, 0x01); // Fastest clock, but not enabled
+    ck_assert_uint_eq(sched_when(&gb.sched, SCHED_TIMER), SCHED_NEVER);
+
+    cpu_run(&gb, 1000);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF05), 0xFF);
+    ck_assert_uint_eq(gb.if_register & INT_TIMER, 0);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+// ============================================================================
+// Serial Tests
+// ============================================================================
+
+START_TEST(test_serial_transfer) {
+    GameBoy gb;
+    setup(&gb);
+
+    mmu_write(&gb, 0xFF01, 0x42);
+    mmu_write(&gb, 0xFF02, SC_START | SC_CLOCK);
+
+    cpu_run(&gb, SERIAL_CYCLES_PER_BYTE - 4);
+    ck_assert_uint_eq(gb.if_register & INT_SERIAL, 0);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF01), 0x42);
+
+    // Nothing connected: 0xFF shifts in & the transfer completes
+    cpu_run(&gb, 4);
+    ck_assert_uint_eq(gb.if_register & INT_SERIAL, INT_SERIAL);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF01), 0xFF);
+    ck_assert_uint_eq(mmu_read(&gb, 0xFF02) & SC_START, 0);
+
+    test_machine_free(&gb);
+}
+END_TEST
+
+// ============================================================================
+// Test Suite
+// ============================================================================
+
+Suite *scheduler_suite(void) {
+    Suite *s;
+    TCase *tc_sched, *tc_timer, *tc_serial;
+
+    s = suite_create("Scheduler");
+
+    tc_sched = tcase_create("Scheduler");
+    tcase_add_test(tc_sched, test_sched_order);
+    tcase_add_test(tc_sched, test_sched_reschedule_cancel);
+    tcase_add_test(tc_sched, test_sched_run_end);
+    suite_add_tcase(s, tc_sched);
+
+    tc_timer = tcase_create("Timer");
+    tcase_add_test(tc_timer, test_timer_div);
+    tcase_add_test(tc_timer, test_timer_overflow_interrupt);
+    tcase_add_test(tc_timer, test_timer_stopped);
+    suite_add_tcase(s, tc_timer);
+
+    tc_serial = tcase_create("Serial");
+    tcase_add_test(tc_serial, test_serial_transfer);
+    suite_add_tcase(s, tc_serial);
+
+    return s;
+}
+
+int main(void) {
+    int      number_failed;
+    Suite   *s;
+    SRunner *sr;
+
+    s  = scheduler_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+// tests/test_state.c
+#include <check.h>
+#include <gbemu.h>
+#include <stdlib.h>
+#include <string.h>
+#include "test_machine.h"
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+// mode: 0 plain interpreter, 1 with the decode cache, 2 JIT
+static void setup(GameBoy *gb, u8 seed, int mode) {
+    u8 *rom = malloc(TEST_ROM_SIZE);
+    test_rom_build_smc(rom, seed);
+    gb_init(gb);
+    gb->decode_enabled = mode == 1;
+    gb->jit_enabled    = mode == 2 && cpu_jit_available();
+    ck_assert(gb_load_rom_buffer(gb, rom, TEST_ROM_SIZE));
+    free(rom);
+}
+
+static void run_frames(GameBoy *gb, int frames) {
+    for (int i = 0; i < frames; i++)
+        gb_run_frame(gb);
+}
+
+// Save into a fresh buffer (caller frees)
+static u8 *save(const GameBoy *gb, size_t *size) {
+    *size  = gb_state_size(gb);
+    u8 *buf = malloc(*size);
+    ck_assert_uint_eq(gb_save_state(gb, buf, *size), *size);
+    return buf;
+}
+
+static void assert_same_state(const GameBoy *gb, const u8 *state, size_t size) {
+    size_t now_size;
+    u8    *now = save(gb, &now_size);
+    ck_assert_uint_eq(now_size, size);
+    ck_assert_msg(memcmp(now, state, size) == 0, "machine state differs");
+    free(now);
+}
+
+// ============================================================================
+// Save State Tests
+// ============================================================================
+
+START_TEST(test_state_roundtrip) {
+    static GameBoy gb, fresh;
+    size_t         size, later_size;
+
+    // Loop test: interpreter, decode cache, JIT
+    setup(&gb, 0x10, _i);
+    run_frames(&gb, 2);
+    u8 *state = save(&gb, &size);
+
+    // Run on, then go back & run the same frames again
+    run_frames(&gb, 3);
+    u8 *later = save(&gb, &later_size);
+    ck_assert_uint_eq(later_size, size); // Fixed for a ROM, whatever is pending
+
+    ck_assert_int_eq(gb_load_state(&gb, state, size), GB_STATE_OK);
+    assert_same_state(&gb, state, size);
+    run_frames(&gb, 3);
+    assert_same_state(&gb, later, later_size);
+
+    // A freshly started machine with the same ROM continues the same way
+    setup(&fresh, 0x10, _i);
+    run_frames(&fresh, 1);
+    ck_assert_int_eq(gb_load_state(&fresh, state, size), GB_STATE_OK);
+    run_frames(&fresh, 3);
+    assert_same_state(&fresh, later, later_size);
+
+    free(state);
+    free(later);
+    gb_unload(&gb);
+    gb_unload(&fresh);
+}
+END_TEST
+
+START_TEST(test_state_rejects) {
+    static GameBoy gb, other;
+    size_t         size, before_size;
+
+    setup(&gb, 0x10, 0);
+    setup(&other, 0x20, 0);
+    run_frames(&gb, 1);
+    run_frames(&other, 1);
+
+    u8 *state  = save(&other, &size);
+    u8 *before = save(&gb, &before_size);
+
+    // Different ROM
+    ck_assert_int_eq(gb_load_state(&gb, state, size), GB_STATE_WRONG_ROM);
+
+    // Too small a buffer to save into
+    ck_assert_uint_eq(gb_save_state(&gb, state, size - 1), 0);
+    free(state);
+    state = save(&gb, &size);
+
+    // Truncated, bad magic, unknown version
+    ck_assert_int_eq(gb_load_state(&gb, state, size - 1), GB_STATE_CORRUPT);
+    ck_assert_int_eq(gb_load_state(&gb, state, 16), GB_STATE_CORRUPT);
+    state[0] ^= 0xFF;
+    ck_assert_int_eq(gb_load_state(&gb, state, size), GB_STATE_BAD_MAGIC);
+    state[0] ^= 0xFF;
+    state[8]++;
+    ck_assert_int_eq(gb_load_state(&gb, state, size), GB_STATE_BAD_VERSION);
+    state[8]--;
+
+    // A known section with the wrong size (CPU, the second one)
+    u8 *cpu_size = state + 32 + 8 + 8 + 4;
+    (*cpu_size)++;
+    ck_assert_int_eq(gb_load_state(&gb, state, size), GB_STATE_CORRUPT);
+    (*cpu_size)--;
+
+    // None of that touched the machine
+    assert_same_state(&gb, before, before_size);
+
+    free(state);
+    free(before);
+    gb_unload(&gb);
+    gb_unload(&other);
+}
+END_TEST
+
+START_TEST(test_state_unknown_section) {
+    static GameBoy gb;
+    size_t         size;
+
+    setup(&gb, 0x10, 0);
+    run_frames(&gb, 1);
+    u8 *state = save(&gb, &size);
+
+    // Append a section from a "newer build": header count & size grow
+    u8 *ext = malloc(size + 8 + 5);
+    memcpy(ext, state, size);
+    memcpy(ext + size, "XTRA\x05\0\0\0hello", 13);
+    u32 total = (u32)(size + 13), sections;
+    memcpy(ext + 12, &total, 4);
+    memcpy(&sections, ext + 24, 4);
+    sections++;
+    memcpy(ext + 24, &sections, 4);
+
+    run_frames(&gb, 1);
+    ck_assert_int_eq(gb_load_state(&gb, ext, size + 13), GB_STATE_OK);
+    assert_same_state(&gb, state, size);
+
+    free(ext);
+    free(state);
+    gb_unload(&gb);
+}
+END_TEST
+
+// ============================================================================
+// Test Suite
+// ============================================================================
+
+Suite *state_suite(void) {
+    Suite *s;
+    TCase *tc_state;
+
+    s = suite_create("SaveState");
+
+    tc_state = tcase_create("SaveState");
+    tcase_add_loop_test(tc_state, test_state_roundtrip, 0, 3);
+    tcase_add_test(tc_state, test_state_rejects);
+    tcase_add_test(tc_state, test_state_unknown_section);
+    suite_add_tcase(s, tc_state);
+
+    return s;
+}
+
+int main(void) {
+    int      number_failed;
+    Suite   *s;
+    SRunner *sr;
+
+    s  = state_suite();
+    sr = srunner_create(s);
+
+    srunner_run_all(sr, CK_NORMAL);
+    number_failed = srunner_ntests_failed(sr);
+    srunner_free(sr);
+
+    return (number_failed == 0) ? 0 : 1;
+}
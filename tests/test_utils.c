@@ -1,6 +1,9 @@
 // tests/test_utils.c
 #include <check.h>
 #include <core/utils.h>
+#include <core/alu_tables.h>
+#include <stdio.h>
+#include <string.h>
 
 // ==================================
 // Bit Manipulation Tests
@@ -240,13 +243,138 @@ START_TEST(test_sign_extend_zero) {
 }
 END_TEST
 
+// ==================================
+// BCD Adjustment Tests
+// ==================================
+
+START_TEST(test_adjust_bcd_add) {
+    // 0x19 + 0x28 = 0x41 (half carry) -> 0x47
+    ck_assert_uint_eq(adjust_bcd(0x41, false, false, true), 0x47);
+    // 0x09 + 0x01 = 0x0A -> 0x10
+    ck_assert_uint_eq(adjust_bcd(0x0A, false, false, false), 0x10);
+    // 0x99 + 0x01 = 0x9A -> 0x00 (carry out)
+    ck_assert_uint_eq(adjust_bcd(0x9A, false, false, false), 0x00);
+    // 0x90 + 0x90 = 0x120 (carry) -> 0x80
+    ck_assert_uint_eq(adjust_bcd(0x20, false, true, false), 0x80);
+}
+END_TEST
+
+START_TEST(test_adjust_bcd_sub) {
+    // 0x47 - 0x08 = 0x3F (half borrow) -> 0x39
+    ck_assert_uint_eq(adjust_bcd(0x3F, true, false, true), 0x39);
+    // 0x10 - 0x20 = 0xF0 (borrow) -> 0x90
+    ck_assert_uint_eq(adjust_bcd(0xF0, true, true, false), 0x90);
+    // No adjustment needed
+    ck_assert_uint_eq(adjust_bcd(0x25, true, false, false), 0x25);
+}
+END_TEST
+
+// ==================================
+// ALU Table Tests (generated, core/alu_tables.h)
+// ==================================
+
+START_TEST(test_alu_daa_table) {
+    // Every A with every N/H/C, against adjust_bcd() & the DAA flag rules
+    for (u32 i = 0; i < 0x800; i++) {
+        u8   a     = i & 0xFF;
+        u8   f     = (i >> 4) & 0x70;
+        bool n     = f & FLAG_N;
+        bool c     = f & FLAG_C;
+        u8   res   = adjust_bcd(a, n, c, f & FLAG_H);
+        bool carry = c || (!n && a > 0x99);
+        u8   flags = (res == 0 ? FLAG_Z : 0) | (n ? FLAG_N : 0) | (carry ? FLAG_C : 0);
+
+        ck_assert_uint_eq(ALU_DAA_INDEX(a, f | FLAG_Z), i); // Z doesn't count
+        ck_assert_uint_eq(alu_daa_table[i], MAKE_U16(flags, res));
+    }
+}
+END_TEST
+
+START_TEST(test_alu_shift_table) {
+    // Every kind, value & carry in
+    for (u32 kind = ALU_RLC; kind <= ALU_SRL; kind++)
+        for (u32 i = 0; i < 0x200; i++) {
+            u8   v = i & 0xFF;
+            bool c = i >> 8;
+            u8   res;
+            bool out;
+
+            switch (kind) {
+                case ALU_RLC:
+                    res = (u8)((v << 1) | (v >> 7)), out = v >> 7;
+                    break;
+                case ALU_RRC:
+                    res = (u8)((v >> 1) | (v << 7)), out = v & 1;
+                    break;
+                case ALU_RL:
+                    res = (u8)((v << 1) | c), out = v >> 7;
+                    break;
+                case ALU_RR:
+                    res = (u8)((v >> 1) | (c << 7)), out = v & 1;
+                    break;
+                case ALU_SLA:
+                    res = (u8)(v << 1), out = v >> 7;
+                    break;
+                case ALU_SRA:
+                    res = (u8)((v >> 1) | (v & 0x80)), out = v & 1;
+                    break;
+                case ALU_SWAP:
+                    res = (u8)((v << 4) | (v >> 4)), out = false;
+                    break;
+                default: // SRL
+                    res = v >> 1, out = v & 1;
+                    break;
+            }
+            ck_assert_uint_eq(alu_shift_table[kind][i], res | (out << 8));
+        }
+}
+END_TEST
+
+// ==================================
+// Checksum Tests
+// ==================================
+
+START_TEST(test_crc32) {
+    static u8 zeros[4096];
+
+    ck_assert_uint_eq(compute_crc32("", 0), 0x00000000);
+    ck_assert_uint_eq(compute_crc32("a", 1), 0xE8B7BE43);
+    ck_assert_uint_eq(compute_crc32("123456789", 9), 0xCBF43926);
+    ck_assert_uint_eq(compute_crc32("The quick brown fox jumps over the lazy dog", 43), 0x414FA339);
+    ck_assert_uint_eq(compute_crc32(zeros, sizeof(zeros)), 0xC71C0011);
+}
+END_TEST
+
+static void assert_sha1(const char *msg, size_t size, const char *hex) {
+    u8   digest[SHA1_SIZE];
+    char text[SHA1_SIZE * 2 + 1];
+
+    compute_sha1(msg, size, digest);
+    for (int i = 0; i < SHA1_SIZE; i++)
+        sprintf(text + i * 2, "%02x", digest[i]);
+    ck_assert_str_eq(text, hex);
+}
+
+START_TEST(test_sha1) {
+    static char million[1000000];
+    const char *two_blocks = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+
+    assert_sha1("", 0, "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+    assert_sha1("abc", 3, "a9993e364706816aba3e25717850c26c9cd0d89d");
+    assert_sha1(two_blocks, strlen(two_blocks), "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+
+    memset(million, 'a', sizeof(million));
+    assert_sha1(million, sizeof(million), "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+}
+END_TEST
+
 // ==================================
 // Test Suite Setup
 // ==================================
 
 Suite *utils_suite(void) {
     Suite *s;
-    TCase *tc_bits, *tc_u16, *tc_carry8, *tc_carry16, *tc_sign;
+    TCase *tc_bits, *tc_u16, *tc_carry8, *tc_carry16, *tc_sign, *tc_bcd, *tc_alu, *tc_hash;
 
     s       = suite_create("Utils");
 
@@ -296,6 +424,24 @@ Suite *utils_suite(void) {
     tcase_add_test(tc_sign, test_sign_extend_zero);
     suite_add_tcase(s, tc_sign);
 
+    // BCD tests
+    tc_bcd = tcase_create("BCD Adjustment");
+    tcase_add_test(tc_bcd, test_adjust_bcd_add);
+    tcase_add_test(tc_bcd, test_adjust_bcd_sub);
+    suite_add_tcase(s, tc_bcd);
+
+    // Generated ALU tables
+    tc_alu = tcase_create("ALU Tables");
+    tcase_add_test(tc_alu, test_alu_daa_table);
+    tcase_add_test(tc_alu, test_alu_shift_table);
+    suite_add_tcase(s, tc_alu);
+
+    // Checksum tests
+    tc_hash = tcase_create("Checksums");
+    tcase_add_test(tc_hash, test_crc32);
+    tcase_add_test(tc_hash, test_sha1);
+    suite_add_tcase(s, tc_hash);
+
     return s;
 }
 